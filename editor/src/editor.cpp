@@ -2,6 +2,7 @@
 
 #include "glitch/asset/asset_system.h"
 #include "glitch/core/application.h"
+#include "glitch/renderer/geometry_arena.h"
 #include "glitch/renderer/mesh.h"
 #include "glitch/renderer/texture.h"
 #include "glitch/scene/components.h"
@@ -18,6 +19,9 @@
 #include <misc/cpp/imgui_stdlib.h>
 #include <tinyfiledialogs/tinyfiledialogs.h>
 
+// Seconds between incremental saves of the opened scene.
+constexpr float AUTOSAVE_INTERVAL = 30.0f;
+
 // Helper to draw components cleanly
 template <typename T>
 void EditorLayer::_draw_component(
@@ -34,6 +38,9 @@ void EditorLayer::_draw_component(
 void EditorLayer::start() {
 	renderer_settings.vsync = true;
 
+	// Pick up changes made to asset files while editing
+	AssetSystem::set_hot_reload(true);
+
 	scene = std::make_shared<Scene>();
 	runtime_scene = std::make_shared<Scene>();
 
@@ -78,6 +85,17 @@ void EditorLayer::update(float p_dt) {
 		runtime_scene->update(p_dt);
 	}
 
+	// Autosave only appends modified entities so it is cheap to do often
+	if (!is_running && scene_path && scene->is_dirty()) {
+		autosave_timer += p_dt;
+		if (autosave_timer >= AUTOSAVE_INTERVAL) {
+			autosave_timer = 0.0f;
+			if (!Scene::serialize_incremental(scene_path->string(), scene)) {
+				GL_LOG_ERROR("Unable to autosave scene");
+			}
+		}
+	}
+
 	// Sync camera controller
 	for (Entity camera : _get_scene()->view<CameraComponent>()) {
 		CameraComponent* cc = camera.get_component<CameraComponent>();
@@ -123,6 +141,12 @@ void EditorLayer::update(float p_dt) {
 		ImGui::Begin("Inspector");
 		if (selected_entity.is_valid()) {
 			_render_inspector(selected_entity);
+
+			// Components are edited in place, so track edits from the widgets
+			if (!is_running && ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows) &&
+					ImGui::IsAnyItemActive()) {
+				scene->mark_dirty(selected_entity.get_uid());
+			}
 		}
 		ImGui::End();
 
@@ -140,6 +164,8 @@ void EditorLayer::update(float p_dt) {
 }
 
 void EditorLayer::destroy() {
+	AssetSystem::set_hot_reload(false);
+
 	Renderer::get_backend()->device_wait();
 	for (const auto& [_, desc] : thumb_texture_descriptors) {
 		Renderer::get_backend()->imgui_image_free(desc);
@@ -185,7 +211,7 @@ void EditorLayer::_render_menubar() {
 			if (!is_running) {
 				if (ImGui::MenuItem("Save Scene")) {
 					if (scene_path && fs::exists(*scene_path)) {
-						if (!Scene::serialize(scene_path->string(), scene)) {
+						if (!Scene::serialize_incremental(scene_path->string(), scene)) {
 							GL_LOG_ERROR("Unable to serialize scene");
 						}
 					} else {
@@ -297,6 +323,17 @@ void EditorLayer::_render_stats() {
 	ImGui::SeparatorText("Renderer");
 	ImGui::Text("Draw Calls: %d", stats.renderer_stats.draw_calls);
 	ImGui::Text("Indices: %d", stats.renderer_stats.index_count);
+
+	const GeometryArenaStats arena_stats = GeometryArena::get_stats();
+	ImGui::SeparatorText("Geometry");
+	ImGui::Text("Ranges: %u", arena_stats.range_count);
+	ImGui::Text("Vertices: %.1f / %.1f MiB", arena_stats.vertex_used / (1024.0f * 1024.0f),
+			arena_stats.vertex_capacity / (1024.0f * 1024.0f));
+	ImGui::Text("Indices: %.1f / %.1f MiB", arena_stats.index_used / (1024.0f * 1024.0f),
+			arena_stats.index_capacity / (1024.0f * 1024.0f));
+	if (ImGui::Button("Compact")) {
+		GeometryArena::compact();
+	}
 	ImGui::End();
 }
 
@@ -334,6 +371,9 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 		ImGui::SeparatorText("GLTF Info");
 		auto* c = p_entity.get_component<GLTFSourceComponent>();
 		ImGui::TextWrapped("Path: %s", c->asset_path.c_str());
+		ImGui::Text("Vertex Format: %s",
+				c->options.vertex_format == MeshVertexFormat::QUANTIZED ? "Quantized" : "Full");
+		ImGui::Text("LOD Count: %u", c->options.lod_count);
 	}
 
 	_draw_component<CameraComponent>("Camera", p_entity, [](CameraComponent& cc) {
@@ -355,13 +395,14 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 	});
 
 	_draw_component<MeshComponent>("Mesh Component", p_entity, [this](MeshComponent& mc) {
-		ImGui::Text("Mesh ID: %u", mc.mesh.get_value().value);
+		ImGui::Text("Mesh ID: %u:%u", mc.mesh.index, mc.mesh.generation);
 		const auto mesh = AssetSystem::get<StaticMesh>(mc.mesh);
 		if (!mesh) {
 			return;
 		}
 
-		ImGui::Text("Index Count: %u", mesh->index_count);
+		ImGui::Text("Index Count: %u (%zu bit)", mesh->index_count, mesh->get_index_size() * 8);
+		ImGui::Text("LODs: %zu", mesh->lods.size());
 	});
 
 	_draw_component<
@@ -378,6 +419,8 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 			if (const auto definition =
 							AssetSystem::get_by_path<MaterialDefinition>(s_definition_path)) {
 				if (const auto handle = AssetSystem::create<Material>(s_definition_path)) {
+					AssetSystem::retain<Material>(*handle);
+					AssetSystem::release<Material>(mc.handle);
 					mc.handle = *handle;
 					mc.definition_path = s_definition_path;
 				} else {
@@ -390,6 +433,8 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 				if (const auto definition =
 								AssetSystem::load<MaterialDefinition>(s_definition_path)) {
 					if (const auto handle = AssetSystem::create<Material>(s_definition_path)) {
+						AssetSystem::retain<Material>(*handle);
+						AssetSystem::release<Material>(mc.handle);
 						mc.handle = *handle;
 						mc.definition_path = s_definition_path;
 					}
@@ -465,6 +510,8 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 												arg = *res;
 
 												mat->set_param(uniform.name, arg);
+												AssetSystem::update_dependencies<Material>(
+														mc.handle);
 											}
 										} else {
 											// Otherwise create an texture asset and load it.
@@ -478,14 +525,19 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 														texture, metadata_path.string());
 
 												mat->set_param(uniform.name, arg);
+												AssetSystem::update_dependencies<Material>(
+														mc.handle);
 											}
 										}
 									}
 								};
 
-								if (tex) {
+								// Thumbnails sample the image, keep it resident while shown
+								AssetSystem::mark_used<Texture>(arg);
+
+								if (tex && tex->make_resident()) {
 									// Try to find existing descriptor in cache
-									const auto it = thumb_texture_descriptors.find(arg.get_value());
+									const auto it = thumb_texture_descriptors.find(arg.pack());
 
 									if (it != thumb_texture_descriptors.end()) {
 										desc_to_render = it->second;
@@ -494,7 +546,7 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 										desc_to_render =
 												Renderer::get_backend()->imgui_image_upload(
 														tex->get_image(), tex->get_sampler());
-										thumb_texture_descriptors[arg.get_value()] = desc_to_render;
+										thumb_texture_descriptors[arg.pack()] = desc_to_render;
 									}
 
 									// Render Image (Thumbnail)
@@ -525,8 +577,9 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 											open_texture_dialog();
 										}
 										if (ImGui::MenuItem("Clear Texture")) {
-											arg = AssetHandle(); // Reset to invalid/null handle
+											arg = INVALID_ASSET_HANDLE;
 											mat->set_param(uniform.name, arg);
+											AssetSystem::update_dependencies<Material>(mc.handle);
 										}
 										ImGui::EndPopup();
 									}
@@ -641,17 +694,21 @@ void EditorLayer::_render_inspector(Entity& p_entity) {
 	}
 
 	if (ImGui::BeginPopup("ADD_COMPONENT_POPUP")) {
+		bool added = false;
 		if (!p_entity.has_component<DirectionalLight>()) {
 			if (ImGui::MenuItem("Directional Light"))
-				p_entity.add_component<DirectionalLight>();
+				added = p_entity.add_component<DirectionalLight>() != nullptr;
 		}
 		if (!p_entity.has_component<PointLight>()) {
 			if (ImGui::MenuItem("Point Light"))
-				p_entity.add_component<PointLight>();
+				added = p_entity.add_component<PointLight>() != nullptr;
 		}
 		if (!p_entity.has_component<Script>()) {
 			if (ImGui::MenuItem("Script"))
-				p_entity.add_component<Script>();
+				added = p_entity.add_component<Script>() != nullptr;
+		}
+		if (added) {
+			_get_scene()->mark_dirty(p_entity.get_uid());
 		}
 		ImGui::EndPopup();
 	}
@@ -730,7 +787,6 @@ void EditorLayer::_render_hierarchy_context_menu(Entity p_entity) {
 				if (selected_entity && selected_entity.get_uid() == p_entity.get_uid())
 					selected_entity = INVALID_ENTITY;
 				_get_scene()->destroy(p_entity);
-				AssetSystem::collect_garbage();
 			});
 		}
 		ImGui::EndPopup();
@@ -753,21 +809,22 @@ void EditorLayer::_render_asset_registry() {
 						ImGuiTableColumnFlags_NoResize);
 		ImGui::TableHeadersRow();
 
-		for (const auto& [handle, metadata] : AssetSystem::get_asset_metadata()) {
-			ImGui::TableNextRow();
+		AssetSystem::for_each_asset(
+				[](const AssetHandle& p_handle, const AssetMetadataView& p_metadata) {
+					ImGui::TableNextRow();
 
-			ImGui::TableNextColumn();
-			ImGui::Text("%s", metadata.type_name);
+					ImGui::TableNextColumn();
+					ImGui::Text("%s", p_metadata.type_name);
 
-			ImGui::TableNextColumn();
-			ImGui::Text("%u", handle.get_value().value);
+					ImGui::TableNextColumn();
+					ImGui::Text("%u:%u", p_handle.index, p_handle.generation);
 
-			ImGui::TableNextColumn();
-			ImGui::Text("%u", handle.get_ref_count());
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", p_metadata.ref_count);
 
-			ImGui::TableNextColumn();
-			ImGui::Text("%s", metadata.path.c_str());
-		}
+					ImGui::TableNextColumn();
+					ImGui::Text("%.*s", int(p_metadata.path.size()), p_metadata.path.data());
+				});
 
 		ImGui::EndTable();
 	}
@@ -50,6 +50,7 @@ private:
 
 	std::shared_ptr<Scene> scene;
 	std::optional<fs::path> scene_path = std::nullopt;
+	float autosave_timer = 0.0f;
 
 	CameraController camera_controller;
 	std::shared_ptr<GridPass> grid_pass;
@@ -34,6 +34,35 @@ concept IsReflectedAsset = requires {
 	{ T::get_type_name() } -> std::same_as<const char*>;
 };
 
+// Enforces that T reports the memory it uses in bytes.
+template <typename T>
+concept IsSizedAsset = requires(const T& p_asset) {
+	{ p_asset.get_memory_size() } -> std::convertible_to<size_t>;
+};
+
+/**
+ * Enforces that T can drop the GPU data it holds while keeping the asset itself
+ * alive. `make_resident` restores the data on demand and `get_memory_size` reports
+ * the resident size only.
+ *
+ * `evict` returns `false` if the data can not be restored later on.
+ */
+template <typename T>
+concept IsEvictableAsset = IsSizedAsset<T> && requires(T& p_asset) {
+	{ std::as_const(p_asset).is_resident() } -> std::same_as<bool>;
+	{ p_asset.evict() } -> std::same_as<bool>;
+	{ p_asset.make_resident() } -> std::same_as<bool>;
+};
+
+/**
+ * Enforces that T evicts multiple assets at once, `enforce_memory_budget` prefers it over
+ * `evict` to share the cost of the eviction. Returns whether each of the assets got evicted.
+ */
+template <typename T>
+concept IsBatchEvictableAsset = IsEvictableAsset<T> && requires(std::span<T* const> p_assets) {
+	{ T::evict_batch(p_assets) } -> std::same_as<std::vector<uint8_t>>;
+};
+
 #define GL_REFLECT_ASSET(x)                                                                        \
 	static constexpr const char* get_type_name() { return x; }
 
@@ -0,0 +1,265 @@
+#include "glitch/asset/asset_load_trace.h"
+
+namespace gl {
+
+using Clock = std::chrono::steady_clock;
+
+struct AssetLoadFrame {
+	AssetLoadRecord record;
+	Clock::time_point start;
+	// `AssetLoadStage::MAX` outside of a stage
+	AssetLoadStage stage = AssetLoadStage::MAX;
+	Clock::time_point stage_start;
+};
+
+// Loads being traced on this thread, nested loads are pushed on top
+static thread_local std::vector<AssetLoadFrame> s_frames;
+
+// Add the time since the stage got entered or last flushed to the stage.
+static void _flush_stage(AssetLoadFrame& p_frame, Clock::time_point p_now) {
+	if (p_frame.stage != AssetLoadStage::MAX) {
+		p_frame.record.stages[size_t(p_frame.stage)] += p_now - p_frame.stage_start;
+	}
+	p_frame.stage_start = p_now;
+}
+
+static double _to_milliseconds(std::chrono::nanoseconds p_duration) {
+	return std::chrono::duration<double, std::milli>(p_duration).count();
+}
+
+AssetLoadTrace::LoadScope::LoadScope(std::string_view p_path, std::string_view p_type) :
+		active(is_enabled()) {
+	if (!active) {
+		return;
+	}
+
+	const Clock::time_point now = Clock::now();
+
+	// Time of the nested load is not counted in the stage of the outer one
+	if (!s_frames.empty()) {
+		_flush_stage(s_frames.back(), now);
+	}
+
+	AssetLoadFrame& frame = s_frames.emplace_back();
+	frame.record.path = p_path;
+	frame.record.type = p_type;
+	frame.start = now;
+	frame.stage_start = now;
+}
+
+AssetLoadTrace::LoadScope::~LoadScope() {
+	if (!active) {
+		return;
+	}
+
+	const Clock::time_point now = Clock::now();
+
+	AssetLoadFrame& frame = s_frames.back();
+	_flush_stage(frame, now);
+	frame.record.total = now - frame.start;
+
+	GL_PROFILE_PLOT("Asset load time (ms)", _to_milliseconds(frame.record.total));
+	GL_PROFILE_PLOT("Asset bytes read", int64_t(frame.record.bytes_read));
+	GL_PROFILE_PLOT("Asset GPU bytes", int64_t(frame.record.gpu_bytes));
+
+	{
+		std::lock_guard lock(s_records_mutex);
+		s_records.push_back(std::move(frame.record));
+	}
+
+	s_frames.pop_back();
+
+	if (!s_frames.empty()) {
+		s_frames.back().stage_start = now;
+	}
+}
+
+void AssetLoadTrace::LoadScope::set_succeeded(bool p_succeeded) {
+	if (active) {
+		s_frames.back().record.succeeded = p_succeeded;
+	}
+}
+
+AssetLoadTrace::StageScope::StageScope(AssetLoadStage p_stage) :
+		active(!s_frames.empty()), prev_stage(AssetLoadStage::MAX) {
+	if (!active) {
+		return;
+	}
+
+	AssetLoadFrame& frame = s_frames.back();
+	_flush_stage(frame, Clock::now());
+
+	prev_stage = frame.stage;
+	frame.stage = p_stage;
+}
+
+AssetLoadTrace::StageScope::~StageScope() {
+	if (!active) {
+		return;
+	}
+
+	AssetLoadFrame& frame = s_frames.back();
+	_flush_stage(frame, Clock::now());
+
+	frame.stage = prev_stage;
+}
+
+AssetLoadTrace::ParallelScope::ParallelScope() : active(!s_frames.empty()) {
+	if (active) {
+		_flush_stage(s_frames.back(), Clock::now());
+	}
+}
+
+AssetLoadTrace::ParallelScope::~ParallelScope() {
+	if (!active) {
+		return;
+	}
+
+	// Workers are done, their time replaces the time the thread spent waiting for them
+	AssetLoadFrame& frame = s_frames.back();
+	frame.stage_start = Clock::now();
+
+	for (size_t i = 0; i < frame.record.stages.size(); i++) {
+		frame.record.stages[i] += worker_totals.stages[i];
+	}
+	frame.record.bytes_read += worker_totals.bytes_read;
+	frame.record.gpu_bytes += worker_totals.gpu_bytes;
+}
+
+AssetLoadTrace::WorkerScope::WorkerScope(ParallelScope& p_parallel) :
+		parallel(p_parallel.active ? &p_parallel : nullptr) {
+	if (!parallel) {
+		return;
+	}
+
+	// Collects the work of this thread like a nested load that is not recorded
+	const Clock::time_point now = Clock::now();
+
+	if (!s_frames.empty()) {
+		_flush_stage(s_frames.back(), now);
+	}
+
+	AssetLoadFrame& frame = s_frames.emplace_back();
+	frame.start = now;
+	frame.stage_start = now;
+}
+
+AssetLoadTrace::WorkerScope::~WorkerScope() {
+	if (!parallel) {
+		return;
+	}
+
+	const Clock::time_point now = Clock::now();
+
+	AssetLoadFrame& frame = s_frames.back();
+	_flush_stage(frame, now);
+
+	{
+		std::lock_guard lock(parallel->mutex);
+
+		AssetLoadRecord& totals = parallel->worker_totals;
+		for (size_t i = 0; i < totals.stages.size(); i++) {
+			totals.stages[i] += frame.record.stages[i];
+		}
+		totals.bytes_read += frame.record.bytes_read;
+		totals.gpu_bytes += frame.record.gpu_bytes;
+	}
+
+	s_frames.pop_back();
+
+	if (!s_frames.empty()) {
+		s_frames.back().stage_start = now;
+	}
+}
+
+void AssetLoadTrace::set_enabled(bool p_enabled) { s_enabled = p_enabled; }
+
+bool AssetLoadTrace::is_enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+void AssetLoadTrace::add_bytes_read(uint64_t p_size) {
+	if (!s_frames.empty()) {
+		s_frames.back().record.bytes_read += p_size;
+	}
+}
+
+void AssetLoadTrace::add_gpu_bytes(uint64_t p_size) {
+	if (!s_frames.empty()) {
+		s_frames.back().record.gpu_bytes += p_size;
+	}
+}
+
+std::vector<AssetLoadRecord> AssetLoadTrace::get_records() {
+	std::lock_guard lock(s_records_mutex);
+	return s_records;
+}
+
+std::optional<AssetLoadRecord> AssetLoadTrace::find_record(std::string_view p_path) {
+	std::lock_guard lock(s_records_mutex);
+
+	const auto it = std::find_if(s_records.rbegin(), s_records.rend(),
+			[&](const AssetLoadRecord& p_record) { return p_record.path == p_path; });
+	if (it == s_records.rend()) {
+		return std::nullopt;
+	}
+
+	return *it;
+}
+
+void AssetLoadTrace::clear() {
+	std::lock_guard lock(s_records_mutex);
+	s_records.clear();
+}
+
+static void _set_record_fields(json& p_json, const AssetLoadRecord& p_record) {
+	p_json["total_ms"] = _to_milliseconds(p_record.total);
+	p_json["io_ms"] = _to_milliseconds(p_record.get_stage(AssetLoadStage::IO));
+	p_json["decode_ms"] = _to_milliseconds(p_record.get_stage(AssetLoadStage::DECODE));
+	p_json["upload_ms"] = _to_milliseconds(p_record.get_stage(AssetLoadStage::UPLOAD));
+	p_json["register_ms"] = _to_milliseconds(p_record.get_stage(AssetLoadStage::REGISTER));
+	p_json["bytes_read"] = p_record.bytes_read;
+	p_json["gpu_bytes"] = p_record.gpu_bytes;
+}
+
+json AssetLoadTrace::to_json() {
+	const std::vector<AssetLoadRecord> records = get_records();
+
+	json j;
+	j["records"] = json::array();
+
+	// Nested loads are already part of the total of their parent, the total of every load
+	// is the sum of the stages instead
+	AssetLoadRecord totals = {};
+	for (const AssetLoadRecord& record : records) {
+		json j_record;
+		j_record["path"] = record.path;
+		j_record["type"] = record.type;
+		j_record["succeeded"] = record.succeeded;
+		_set_record_fields(j_record, record);
+
+		j["records"].push_back(std::move(j_record));
+
+		for (size_t i = 0; i < totals.stages.size(); i++) {
+			totals.stages[i] += record.stages[i];
+			totals.total += record.stages[i];
+		}
+		totals.bytes_read += record.bytes_read;
+		totals.gpu_bytes += record.gpu_bytes;
+	}
+
+	j["totals"]["count"] = records.size();
+	_set_record_fields(j["totals"], totals);
+
+	return j;
+}
+
+bool AssetLoadTrace::dump(const fs::path& p_path) {
+	if (json_save(p_path.string(), to_json()) != JSONLoadError::NONE) {
+		GL_LOG_ERROR("[AssetLoadTrace::dump] Unable to write load trace to '{}'.",
+				p_path.string());
+		return false;
+	}
+
+	return true;
+}
+
+} //namespace gl
@@ -0,0 +1,150 @@
+/**
+ * @file asset_load_trace.h
+ *
+ */
+
+#pragma once
+
+namespace gl {
+
+enum class AssetLoadStage : uint8_t {
+	IO,
+	DECODE,
+	UPLOAD,
+	REGISTER,
+	MAX,
+};
+
+/**
+ * Timings and sizes of a single asset load. Stage times are exclusive, time spent in a
+ * nested stage or in a nested load (e.g. textures of a model) is not counted twice,
+ * `total` includes them. Stages of work spread across threads add up the time of every
+ * thread, so they might exceed `total`.
+ */
+struct AssetLoadRecord {
+	std::string path;
+	std::string type;
+	std::array<std::chrono::nanoseconds, size_t(AssetLoadStage::MAX)> stages = {};
+	std::chrono::nanoseconds total = {};
+	uint64_t bytes_read = 0;
+	uint64_t gpu_bytes = 0;
+	bool succeeded = false;
+
+	std::chrono::nanoseconds get_stage(AssetLoadStage p_stage) const {
+		return stages[size_t(p_stage)];
+	}
+};
+
+/**
+ * Records where asset load time goes, per thread so asynchronous loads are attributed to
+ * the right asset. Disabled by default, scopes opened while disabled cost a single atomic
+ * load.
+ *
+ * Every method is thread safe.
+ */
+class GL_API AssetLoadTrace {
+public:
+	/**
+	 * Traces a load on the current thread until destroyed, stages and byte counts
+	 * reported in between are attributed to it.
+	 */
+	class GL_API LoadScope {
+	public:
+		LoadScope(std::string_view p_path, std::string_view p_type);
+		~LoadScope();
+
+		LoadScope(const LoadScope&) = delete;
+		LoadScope& operator=(const LoadScope&) = delete;
+
+		void set_succeeded(bool p_succeeded);
+
+	private:
+		bool active;
+	};
+
+	// Attributes the time until destroyed to the stage of the current load.
+	class GL_API StageScope {
+	public:
+		StageScope(AssetLoadStage p_stage);
+		~StageScope();
+
+		StageScope(const StageScope&) = delete;
+		StageScope& operator=(const StageScope&) = delete;
+
+	private:
+		bool active;
+		AssetLoadStage prev_stage;
+	};
+
+	class WorkerScope;
+
+	/**
+	 * Lets the current load of the thread be credited from other threads, e.g. the jobs of
+	 * `JobSystem::parallel_for`. Time of the current stage is not counted until destroyed,
+	 * the stages and byte counts of the `WorkerScope`s are added instead.
+	 */
+	class GL_API ParallelScope {
+	public:
+		ParallelScope();
+		~ParallelScope();
+
+		ParallelScope(const ParallelScope&) = delete;
+		ParallelScope& operator=(const ParallelScope&) = delete;
+
+	private:
+		bool active;
+		AssetLoadRecord worker_totals;
+		std::mutex mutex;
+
+		friend class WorkerScope;
+	};
+
+	// Traces the work of the current thread on behalf of the load of `p_parallel`.
+	class GL_API WorkerScope {
+	public:
+		WorkerScope(ParallelScope& p_parallel);
+		~WorkerScope();
+
+		WorkerScope(const WorkerScope&) = delete;
+		WorkerScope& operator=(const WorkerScope&) = delete;
+
+	private:
+		ParallelScope* parallel;
+	};
+
+	static void set_enabled(bool p_enabled);
+
+	static bool is_enabled();
+
+	static void add_bytes_read(uint64_t p_size);
+
+	static void add_gpu_bytes(uint64_t p_size);
+
+	// Finished loads in completion order.
+	static std::vector<AssetLoadRecord> get_records();
+
+	// Returns the latest load of the path.
+	static std::optional<AssetLoadRecord> find_record(std::string_view p_path);
+
+	static void clear();
+
+	/**
+	 * Every record and the totals per stage, durations are in milliseconds:
+	 * {
+	 *  "totals" : { "count", "total_ms", "io_ms", "decode_ms", "upload_ms", "register_ms",
+	 *               "bytes_read", "gpu_bytes" },
+	 *  "records" : [ { "path", "type", "succeeded", ...same fields as totals } ]
+	 * }
+	 */
+	static json to_json();
+
+	static bool dump(const fs::path& p_path);
+
+private:
+	inline static std::atomic_bool s_enabled = false;
+
+	inline static std::vector<AssetLoadRecord> s_records;
+	inline static std::mutex s_records_mutex;
+};
+
+} //namespace gl
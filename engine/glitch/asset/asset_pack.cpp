@@ -0,0 +1,250 @@
+#include "glitch/asset/asset_pack.h"
+
+#include "glitch/core/compression.h"
+#include "glitch/core/hash.h"
+#include "glitch/platform/mapped_file.h"
+
+namespace gl {
+
+static bool _compare_entry_hash(const AssetPackEntry& p_entry, uint64_t p_hash) {
+	return p_entry.path_hash < p_hash;
+}
+
+AssetPack::~AssetPack() = default;
+
+std::shared_ptr<AssetPack> AssetPack::open(const fs::path& p_path) {
+	std::unique_ptr<MappedFile> file = MappedFile::open(p_path);
+	if (!file) {
+		GL_LOG_ERROR("[AssetPack::open] Unable to open pack file '{}'.", p_path.string());
+		return nullptr;
+	}
+
+	const uint8_t* data = file->data();
+	const size_t size = file->size();
+
+	AssetPackHeader header;
+	if (size < sizeof(header)) {
+		GL_LOG_ERROR("[AssetPack::open] File '{}' is not a pack file.", p_path.string());
+		return nullptr;
+	}
+	memcpy(&header, data, sizeof(header));
+
+	if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION) {
+		GL_LOG_ERROR("[AssetPack::open] File '{}' is not a pack file or has an unsupported "
+					 "version.",
+				p_path.string());
+		return nullptr;
+	}
+
+	const uint64_t entries_end =
+			sizeof(header) + uint64_t(header.entry_count) * sizeof(AssetPackEntry);
+	const uint64_t strings_end = entries_end + header.string_table_size;
+	if (strings_end > size) {
+		GL_LOG_ERROR("[AssetPack::open] Table of contents of '{}' is truncated.", p_path.string());
+		return nullptr;
+	}
+
+	const std::span<const AssetPackEntry> entries(
+			reinterpret_cast<const AssetPackEntry*>(data + sizeof(header)), header.entry_count);
+
+	// Validate once so that lookups can trust the table
+	for (size_t i = 0; i < entries.size(); i++) {
+		const AssetPackEntry& entry = entries[i];
+
+		const bool sorted = i == 0 || entries[i - 1].path_hash <= entry.path_hash;
+		const bool path_valid =
+				uint64_t(entry.path_offset) + entry.path_length <= header.string_table_size;
+		const bool payload_valid = entry.offset <= size && entry.stored_size <= size - entry.offset;
+		const bool compression_valid = entry.compression == AssetPackCompression::NONE ||
+				entry.compression == AssetPackCompression::LZ;
+		// Reads allocate `size` bytes up front, it cannot exceed what the payload expands to
+		const bool size_valid = entry.compression == AssetPackCompression::LZ
+				? entry.size <= lz_decompress_bound(entry.stored_size)
+				: entry.size == entry.stored_size;
+
+		if (!sorted || !path_valid || !payload_valid || !compression_valid || !size_valid) {
+			GL_LOG_ERROR("[AssetPack::open] Entry {} of '{}' is corrupted.", i, p_path.string());
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr<AssetPack> pack(new AssetPack());
+	pack->path = p_path;
+	pack->entries = entries;
+	pack->string_table = std::string_view(
+			reinterpret_cast<const char*>(data + entries_end), header.string_table_size);
+	pack->file = std::move(file);
+
+	return pack;
+}
+
+bool AssetPack::contains(std::string_view p_path) const { return _find(p_path) != nullptr; }
+
+std::optional<std::span<const uint8_t>> AssetPack::get_view(std::string_view p_path) const {
+	const AssetPackEntry* entry = _find(p_path);
+	if (!entry || entry->compression != AssetPackCompression::NONE) {
+		return std::nullopt;
+	}
+
+	return std::span<const uint8_t>(file->data() + entry->offset, entry->stored_size);
+}
+
+std::optional<std::vector<uint8_t>> AssetPack::read(std::string_view p_path) const {
+	GL_PROFILE_SCOPE;
+
+	const AssetPackEntry* entry = _find(p_path);
+	if (!entry) {
+		return std::nullopt;
+	}
+
+	const std::span<const uint8_t> payload(file->data() + entry->offset, entry->stored_size);
+
+	switch (entry->compression) {
+		case AssetPackCompression::NONE:
+			return std::vector<uint8_t>(payload.begin(), payload.end());
+		case AssetPackCompression::LZ: {
+			std::vector<uint8_t> data(entry->size);
+			if (!lz_decompress(payload, data)) {
+				GL_LOG_ERROR("[AssetPack::read] Unable to decompress '{}' of pack '{}'.", p_path,
+						path.string());
+				return std::nullopt;
+			}
+			return data;
+		}
+	}
+
+	return std::nullopt;
+}
+
+std::vector<std::string_view> AssetPack::get_paths() const {
+	std::vector<std::string_view> paths;
+	paths.reserve(entries.size());
+	for (const AssetPackEntry& entry : entries) {
+		paths.push_back(_get_entry_path(entry));
+	}
+
+	return paths;
+}
+
+const AssetPackEntry* AssetPack::_find(std::string_view p_path) const {
+	const uint64_t hash = fnv1a64(p_path);
+
+	// Paths are compared as well in case of hash collisions
+	auto it = std::lower_bound(entries.begin(), entries.end(), hash, _compare_entry_hash);
+	for (; it != entries.end() && it->path_hash == hash; it++) {
+		if (_get_entry_path(*it) == p_path) {
+			return &*it;
+		}
+	}
+
+	return nullptr;
+}
+
+std::string_view AssetPack::_get_entry_path(const AssetPackEntry& p_entry) const {
+	return string_table.substr(p_entry.path_offset, p_entry.path_length);
+}
+
+void AssetPackWriter::add_file(std::string_view p_path, std::vector<uint8_t> p_data,
+		AssetPackCompression p_compression) {
+	PackedFile packed = {
+		std::string(p_path),
+		{},
+		p_data.size(),
+		AssetPackCompression::NONE,
+	};
+
+	if (p_compression == AssetPackCompression::LZ) {
+		std::vector<uint8_t> compressed = lz_compress(p_data);
+		if (compressed.size() < p_data.size()) {
+			packed.payload = std::move(compressed);
+			packed.compression = AssetPackCompression::LZ;
+		}
+	}
+
+	if (packed.compression == AssetPackCompression::NONE) {
+		packed.payload = std::move(p_data);
+	}
+
+	files.insert_or_assign(packed.path, std::move(packed));
+}
+
+bool AssetPackWriter::write(const fs::path& p_path) const {
+	GL_PROFILE_SCOPE;
+
+	std::vector<std::pair<AssetPackEntry, const PackedFile*>> entries;
+	entries.reserve(files.size());
+
+	std::string string_table;
+	for (const auto& [_, packed] : files) {
+		entries.emplace_back(
+				AssetPackEntry{
+						fnv1a64(packed.path),
+						0,
+						packed.size,
+						packed.payload.size(),
+						uint32_t(string_table.size()),
+						uint32_t(packed.path.size()),
+						packed.compression,
+						0,
+				},
+				&packed);
+		string_table += packed.path;
+	}
+
+	std::stable_sort(entries.begin(), entries.end(), [](const auto& p_lhs, const auto& p_rhs) {
+		return p_lhs.first.path_hash < p_rhs.first.path_hash;
+	});
+
+	const auto align = [](uint64_t p_offset) {
+		return (p_offset + ASSET_PACK_ALIGNMENT - 1) & ~(ASSET_PACK_ALIGNMENT - 1);
+	};
+
+	uint64_t offset = align(sizeof(AssetPackHeader) + entries.size() * sizeof(AssetPackEntry) +
+			string_table.size());
+	for (auto& [entry, _] : entries) {
+		entry.offset = offset;
+		offset = align(offset + entry.stored_size);
+	}
+	const uint64_t file_size = offset;
+
+	std::ofstream file(p_path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[AssetPackWriter::write] Unable to open file '{}'.", p_path.string());
+		return false;
+	}
+
+	const AssetPackHeader header = {
+		ASSET_PACK_MAGIC,
+		ASSET_PACK_VERSION,
+		uint32_t(entries.size()),
+		uint32_t(string_table.size()),
+	};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for (const auto& [entry, _] : entries) {
+		file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	}
+	file.write(string_table.data(), string_table.size());
+
+	const auto pad_to = [&file](uint64_t p_offset) {
+		for (uint64_t i = uint64_t(file.tellp()); i < p_offset; i++) {
+			file.put(0);
+		}
+	};
+
+	for (const auto& [entry, packed] : entries) {
+		pad_to(entry.offset);
+		file.write(reinterpret_cast<const char*>(packed->payload.data()), packed->payload.size());
+	}
+	// Trailing entries might be empty, keep their offsets inside of the file
+	pad_to(file_size);
+
+	if (!file.good()) {
+		GL_LOG_ERROR("[AssetPackWriter::write] Unable to write file '{}'.", p_path.string());
+		return false;
+	}
+
+	return true;
+}
+
+} //namespace gl
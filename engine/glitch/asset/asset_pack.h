@@ -0,0 +1,125 @@
+/**
+ * @file asset_pack.h
+ *
+ */
+
+#pragma once
+
+namespace gl {
+
+class MappedFile;
+
+enum class AssetPackCompression : uint32_t {
+	NONE = 0,
+	LZ = 1,
+};
+
+/**
+ * Pack file layout, every integer is little endian:
+ *
+ * header | entries sorted by path hash | path strings | payloads
+ *
+ * Payloads start at `ASSET_PACK_ALIGNMENT` aligned offsets so that uncompressed ones
+ * can be handed to APIs expecting page aligned memory.
+ */
+struct AssetPackHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t string_table_size;
+};
+
+struct AssetPackEntry {
+	uint64_t path_hash;
+	// Offset of the payload from the start of the file
+	uint64_t offset;
+	uint64_t size;
+	// Size of the payload in the file, differs from `size` if it is compressed
+	uint64_t stored_size;
+	uint32_t path_offset;
+	uint32_t path_length;
+	AssetPackCompression compression;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 16);
+static_assert(sizeof(AssetPackEntry) == 48);
+
+inline constexpr uint32_t ASSET_PACK_MAGIC = 0x4b504c47; // "GLPK"
+inline constexpr uint32_t ASSET_PACK_VERSION = 1;
+inline constexpr uint64_t ASSET_PACK_ALIGNMENT = 4096;
+
+/**
+ * Read only archive of asset files, the file is memory mapped and the table of contents
+ * is searched in place so opening a pack does not read or allocate per entry.
+ *
+ * Paths are relative to the root of the pack and use '/' as the separator, they are
+ * addressed as `pack://<path>` through the AssetSystem. Every method is thread safe.
+ */
+class GL_API AssetPack {
+public:
+	~AssetPack();
+
+	// Returns null if the file does not exist or is not a valid pack.
+	static std::shared_ptr<AssetPack> open(const fs::path& p_path);
+
+	bool contains(std::string_view p_path) const;
+
+	/**
+	 * Payload of the entry in the mapped file without copying.
+	 *
+	 * @returns `std::nullopt` if the entry does not exist or is compressed.
+	 */
+	std::optional<std::span<const uint8_t>> get_view(std::string_view p_path) const;
+
+	// Copy or decompress the entry, `std::nullopt` if it does not exist or is corrupted.
+	std::optional<std::vector<uint8_t>> read(std::string_view p_path) const;
+
+	std::vector<std::string_view> get_paths() const;
+
+	size_t get_entry_count() const { return entries.size(); }
+
+	const fs::path& get_path() const { return path; }
+
+private:
+	AssetPack() = default;
+
+	const AssetPackEntry* _find(std::string_view p_path) const;
+
+	std::string_view _get_entry_path(const AssetPackEntry& p_entry) const;
+
+private:
+	fs::path path;
+	std::unique_ptr<MappedFile> file;
+	std::span<const AssetPackEntry> entries;
+	std::string_view string_table;
+};
+
+/**
+ * Builds pack files, see `programs/packer` for the command line frontend.
+ */
+class GL_API AssetPackWriter {
+public:
+	/**
+	 * Add or replace the file at `p_path`, compressed payloads that do not get smaller
+	 * are stored uncompressed.
+	 */
+	void add_file(std::string_view p_path, std::vector<uint8_t> p_data,
+			AssetPackCompression p_compression = AssetPackCompression::NONE);
+
+	bool write(const fs::path& p_path) const;
+
+	size_t get_file_count() const { return files.size(); }
+
+private:
+	struct PackedFile {
+		std::string path;
+		std::vector<uint8_t> payload;
+		uint64_t size;
+		AssetPackCompression compression;
+	};
+
+	std::map<std::string, PackedFile, std::less<>> files;
+};
+
+} //namespace gl
@@ -1,52 +1,353 @@
 #include "glitch/asset/asset_system.h"
 
+#include "glitch/asset/asset_pack.h"
+#include "glitch/platform/file_watcher.h"
 #include "glitch/platform/os.h"
 #include "glitch/renderer/material.h"
 #include "glitch/renderer/texture.h"
 
 namespace gl {
 
+void to_json(json& p_json, const AssetHandle& p_handle) {
+	if (p_handle) {
+		p_json = p_handle.pack();
+	} else {
+		p_json = json::value_t::null;
+	}
+}
+
+void from_json(const json& p_json, AssetHandle& p_handle) {
+	p_handle = p_json.is_null() ? INVALID_ASSET_HANDLE
+								: AssetHandle::unpack(p_json.get<uint64_t>());
+}
+
 bool AssetMetadata::is_memory_asset() const { return path.empty() || path.starts_with("mem://"); }
 
 void AssetSystem::clear() {
-	for (auto& [_, reg] : s_registries) {
-		reg->clear();
+	{
+		std::shared_lock lock(s_registries_mutex);
+		for (auto& [_, reg] : s_registries) {
+			reg->clear();
+		}
 	}
+
+	{
+		std::lock_guard lock(s_dependency_mutex);
+		s_dependency_graph.clear();
+	}
+
+	// Loads in flight will find their entries erased and never complete
+	std::lock_guard lock(s_load_mutex);
+	s_load_callbacks.clear();
+	s_completed_loads.clear();
 }
 
 void AssetSystem::clear_non_persistent() {
+	std::shared_lock lock(s_registries_mutex);
 	for (auto& [_, reg] : s_registries) {
 		reg->clear_non_persistent();
 	}
 }
 
 void AssetSystem::collect_garbage() {
+	std::shared_lock lock(s_registries_mutex);
 	for (auto& [_, reg] : s_registries) {
 		reg->collect_garbage();
 	}
 }
 
+void AssetSystem::collect_garbage(std::chrono::microseconds p_budget) {
+	GL_PROFILE_SCOPE;
+
+	const auto deadline = std::chrono::steady_clock::now() + p_budget;
+
+	std::shared_lock lock(s_registries_mutex);
+	if (s_registries.empty()) {
+		return;
+	}
+
+	// Registries are visited in turns, each one is finished at most once per call
+	for (size_t i = 0; i < s_registries.size(); i++) {
+		const size_t index = s_gc_registry_index % s_registries.size();
+		IAssetRegistry* reg = std::next(s_registries.begin(), index)->second;
+
+		if (!reg->collect_garbage(deadline)) {
+			break;
+		}
+
+		s_gc_registry_index = index + 1;
+		if (std::chrono::steady_clock::now() >= deadline) {
+			break;
+		}
+	}
+}
+
+void AssetSystem::set_deletion_handler(std::function<void(AssetDeletionFn&&)> p_handler) {
+	s_deletion_handler = p_handler;
+}
+
+void AssetSystem::defer_deletion(AssetDeletionFn&& p_function) {
+	if (s_deletion_handler) {
+		s_deletion_handler(std::move(p_function));
+	} else {
+		p_function();
+	}
+}
+
+uint64_t AssetSystem::get_frame() { return s_frame.load(std::memory_order_relaxed); }
+
+void AssetSystem::enforce_memory_budgets() {
+	GL_PROFILE_SCOPE;
+
+	// Assets drawn by the previous frame are likely to be drawn again
+	const uint64_t frame = get_frame();
+	const uint64_t keep_after = frame > 0 ? frame - 1 : 0;
+
+	std::vector<AssetHandle> evicted;
+	{
+		std::shared_lock lock(s_registries_mutex);
+		for (auto& [_, reg] : s_registries) {
+			const std::vector<AssetHandle> handles = reg->enforce_memory_budget(keep_after);
+			evicted.insert(evicted.end(), handles.begin(), handles.end());
+		}
+	}
+
+	if (!evicted.empty()) {
+		GL_LOG_TRACE("[AssetSystem::enforce_memory_budgets] Evicted {} assets", evicted.size());
+		_notify_dependents(evicted);
+	}
+}
+
 void AssetSystem::reload_all() {
-	for (auto& [_, reg] : s_registries) {
+	for (IAssetRegistry* reg : _get_registries()) {
 		reg->reload_all();
 	}
 }
 
+void AssetSystem::set_hot_reload(bool p_enabled) {
+	if (p_enabled == is_hot_reload_enabled()) {
+		return;
+	}
+
+	if (!p_enabled) {
+		s_file_watcher.store(nullptr);
+
+		s_hot_reload_thread.request_stop();
+		s_hot_reload_thread.join();
+
+		std::lock_guard lock(s_reload_mutex);
+		s_pending_reloads.clear();
+		return;
+	}
+
+	s_file_watcher.store(FileWatcher::create());
+
+	// Assets registered from now on are watched by the registries
+	for_each_asset([](const AssetHandle& p_handle, const AssetMetadataView& p_metadata) {
+		_watch_path(p_metadata.path);
+	});
+
+	s_hot_reload_thread = std::jthread(_hot_reload_loop);
+}
+
+bool AssetSystem::is_hot_reload_enabled() { return s_file_watcher.load() != nullptr; }
+
+void AssetSystem::update() {
+	GL_PROFILE_SCOPE;
+
+	s_frame.fetch_add(1, std::memory_order_relaxed);
+
+	std::vector<std::function<void()>> reloads;
+	{
+		std::lock_guard lock(s_reload_mutex);
+		reloads.swap(s_pending_reloads);
+	}
+
+	for (const auto& swap : reloads) {
+		swap();
+	}
+
+	std::vector<std::tuple<AssetHandle, AssetLoadState, std::vector<AssetLoadCallback>>> finished;
+	{
+		std::lock_guard lock(s_load_mutex);
+		finished.reserve(s_completed_loads.size());
+
+		for (auto& [handle, state] : s_completed_loads) {
+			const auto it = s_load_callbacks.find(handle);
+			if (it == s_load_callbacks.end()) {
+				continue;
+			}
+
+			finished.emplace_back(std::move(handle), state, std::move(it->second));
+			s_load_callbacks.erase(it);
+		}
+
+		s_completed_loads.clear();
+	}
+
+	// Callbacks are free to start new loads
+	for (const auto& [handle, state, callbacks] : finished) {
+		for (const auto& callback : callbacks) {
+			callback(handle, state);
+		}
+	}
+}
+
 std::unordered_map<AssetHandle, AssetMetadata> AssetSystem::get_asset_metadata() {
-	size_t total_asset_count = 0;
+	std::unordered_map<AssetHandle, AssetMetadata> result;
+	result.reserve(get_asset_count());
+
+	for_each_asset([&](const AssetHandle& p_handle, const AssetMetadataView& p_metadata) {
+		result.emplace(p_handle,
+				AssetMetadata{
+						p_metadata.type_name, std::string(p_metadata.path), p_metadata.ref_count });
+	});
+
+	return result;
+}
+
+void AssetSystem::for_each_asset(const AssetVisitor& p_fn) {
+	std::shared_lock lock(s_registries_mutex);
+
 	for (const auto& [_, reg] : s_registries) {
-		total_asset_count += reg->get_asset_size();
+		reg->for_each_asset(p_fn);
 	}
+}
 
-	std::unordered_map<AssetHandle, AssetMetadata> result;
-	result.reserve(total_asset_count);
+uint64_t AssetSystem::get_version() {
+	std::shared_lock lock(s_registries_mutex);
 
+	uint64_t version = 0;
 	for (const auto& [_, reg] : s_registries) {
-		auto metadatas = reg->get_asset_metadata();
-		result.merge(metadatas);
+		version += reg->get_version();
 	}
 
-	return result;
+	return version;
+}
+
+size_t AssetSystem::get_asset_count() {
+	std::shared_lock lock(s_registries_mutex);
+
+	size_t count = 0;
+	for (const auto& [_, reg] : s_registries) {
+		count += reg->get_asset_size();
+	}
+
+	return count;
+}
+
+std::vector<AssetHandle> AssetSystem::get_dependencies(const AssetHandle& p_handle) {
+	std::lock_guard lock(s_dependency_mutex);
+
+	const auto it = s_dependency_graph.find(p_handle);
+	return it != s_dependency_graph.end() ? it->second.dependencies : std::vector<AssetHandle>{};
+}
+
+std::vector<AssetHandle> AssetSystem::get_dependents(const AssetHandle& p_handle) {
+	std::lock_guard lock(s_dependency_mutex);
+
+	const auto it = s_dependency_graph.find(p_handle);
+	return it != s_dependency_graph.end() ? it->second.dependents : std::vector<AssetHandle>{};
+}
+
+size_t AssetSystem::get_memory_footprint(const AssetHandle& p_handle) {
+	IAssetRegistry* root_registry = _find_registry(p_handle);
+	if (!root_registry) {
+		return 0;
+	}
+
+	std::vector<DependencyRef> assets = { { root_registry, p_handle } };
+	{
+		std::lock_guard lock(s_dependency_mutex);
+
+		std::unordered_set<AssetHandle> visited = { p_handle };
+		for (size_t i = 0; i < assets.size(); i++) {
+			const auto it = s_dependency_graph.find(assets[i].handle);
+			if (it == s_dependency_graph.end()) {
+				continue;
+			}
+
+			for (const AssetHandle& dependency : it->second.dependencies) {
+				if (visited.insert(dependency).second) {
+					assets.push_back({ s_dependency_graph.at(dependency).registry, dependency });
+				}
+			}
+		}
+	}
+
+	size_t size = 0;
+	for (const auto& [registry, handle] : assets) {
+		size += registry->get_memory_size(handle);
+	}
+
+	return size;
+}
+
+void AssetSystem::_watch_path(std::string_view p_path) {
+	const std::shared_ptr<FileWatcher> watcher = s_file_watcher.load();
+	if (!watcher || p_path.starts_with("mem://") || p_path.starts_with("pack://")) {
+		return;
+	}
+
+	if (const auto path = get_absolute_path(p_path)) {
+		watcher->watch(*path);
+	}
+}
+
+void AssetSystem::_unwatch_path(std::string_view p_path) {
+	const std::shared_ptr<FileWatcher> watcher = s_file_watcher.load();
+	if (!watcher || p_path.starts_with("mem://") || p_path.starts_with("pack://")) {
+		return;
+	}
+
+	if (const auto path = get_absolute_path(p_path)) {
+		watcher->unwatch(*path);
+	}
+}
+
+void AssetSystem::_hot_reload_loop(std::stop_token p_stop_token) {
+	while (!p_stop_token.stop_requested()) {
+		const std::shared_ptr<FileWatcher> watcher = s_file_watcher.load();
+		if (!watcher) {
+			break;
+		}
+
+		for (const fs::path& path : watcher->wait(std::chrono::milliseconds(100))) {
+			// Assets might be registered with either form of the path
+			std::vector<std::string> asset_paths = { path.string() };
+			if (const char* working_dir = os::getenv("GL_WORKING_DIR")) {
+				const fs::path relative_path = path.lexically_relative(working_dir);
+				if (!relative_path.empty() && *relative_path.begin() != "..") {
+					asset_paths.push_back("res://" + relative_path.generic_string());
+				}
+			}
+
+			GL_LOG_TRACE("[AssetSystem::_hot_reload_loop] Reloading assets of '{}'",
+					path.string());
+
+			for (IAssetRegistry* reg : _get_registries()) {
+				for (const std::string& asset_path : asset_paths) {
+					if (auto swap = reg->reload(asset_path)) {
+						std::lock_guard reload_lock(s_reload_mutex);
+						s_pending_reloads.push_back(std::move(swap));
+					}
+				}
+			}
+		}
+	}
+}
+
+std::vector<IAssetRegistry*> AssetSystem::_get_registries() {
+	// Registries live as long as the program, the pointers stay valid after unlocking
+	std::shared_lock lock(s_registries_mutex);
+
+	std::vector<IAssetRegistry*> registries;
+	registries.reserve(s_registries.size());
+	for (const auto& [_, reg] : s_registries) {
+		registries.push_back(reg);
+	}
+
+	return registries;
 }
 
 Result<fs::path, PathProcessError> AssetSystem::get_absolute_path(std::string_view p_path) {
@@ -54,6 +355,10 @@ Result<fs::path, PathProcessError> AssetSystem::get_absolute_path(std::string_vi
 		return make_err<fs::path>(PathProcessError::EMPTY_PATH);
 	}
 
+	if (p_path.starts_with("pack://")) {
+		return fs::path(p_path.begin(), p_path.end());
+	}
+
 	if (!p_path.starts_with("res://")) {
 		if (p_path.find("://") == std::string::npos) {
 			return fs::path(p_path.begin(), p_path.end());
@@ -77,11 +382,98 @@ Result<fs::path, PathProcessError> AssetSystem::get_absolute_path(std::string_vi
 	return absolute_path;
 }
 
-void AssetSystem::serialize(json& p_json) {
+bool AssetSystem::mount_pack(const fs::path& p_path) {
+	std::shared_ptr<AssetPack> pack = AssetPack::open(p_path);
+	if (!pack) {
+		return false;
+	}
+
+	GL_LOG_TRACE("[AssetSystem::mount_pack] Mounted '{}' with {} entries.", p_path.string(),
+			pack->get_entry_count());
+
+	std::unique_lock lock(s_packs_mutex);
+	s_packs.push_back(std::move(pack));
+
+	return true;
+}
+
+void AssetSystem::unmount_packs() {
+	std::unique_lock lock(s_packs_mutex);
+	s_packs.clear();
+}
+
+static std::string_view _get_pack_path(std::string_view p_path) {
+	constexpr size_t identifier_len = sizeof("pack://") - 1; // minus \0
+	return p_path.substr(identifier_len);
+}
+
+Result<std::vector<uint8_t>, AssetLoadingError> AssetSystem::read_file(std::string_view p_path) {
+	GL_PROFILE_SCOPE;
+
+	AssetLoadTrace::StageScope stage(AssetLoadStage::IO);
+
+	if (p_path.starts_with("pack://")) {
+		const std::string_view pack_path = _get_pack_path(p_path);
+
+		std::shared_lock lock(s_packs_mutex);
+		for (auto it = s_packs.rbegin(); it != s_packs.rend(); it++) {
+			if (!(*it)->contains(pack_path)) {
+				continue;
+			}
+
+			if (auto data = (*it)->read(pack_path)) {
+				AssetLoadTrace::add_bytes_read(data->size());
+				return std::move(*data);
+			}
+			return make_err<std::vector<uint8_t>>(AssetLoadingError::PARSING_ERROR);
+		}
+
+		return make_err<std::vector<uint8_t>>(AssetLoadingError::FILE_ERROR);
+	}
+
+	const auto path = get_absolute_path(p_path);
+	if (!path) {
+		return make_err<std::vector<uint8_t>>(AssetLoadingError::FILE_ERROR);
+	}
+
+	std::ifstream file(*path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		return make_err<std::vector<uint8_t>>(AssetLoadingError::FILE_ERROR);
+	}
+
+	std::vector<uint8_t> data(size_t(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+	if (!file) {
+		return make_err<std::vector<uint8_t>>(AssetLoadingError::FILE_ERROR);
+	}
+
+	AssetLoadTrace::add_bytes_read(data.size());
+
+	return data;
+}
+
+bool AssetSystem::file_exists(std::string_view p_path) {
+	if (p_path.starts_with("pack://")) {
+		const std::string_view pack_path = _get_pack_path(p_path);
+
+		std::shared_lock lock(s_packs_mutex);
+		return std::any_of(s_packs.begin(), s_packs.end(),
+				[&](const auto& p_pack) { return p_pack->contains(pack_path); });
+	}
+
+	const auto path = get_absolute_path(p_path);
+	std::error_code err;
+	return path && fs::is_regular_file(*path, err);
+}
+
+void AssetSystem::serialize(json& p_json, bool p_save_assets) {
+	std::shared_lock lock(s_registries_mutex);
+
 	p_json = json();
 	for (const auto& [type_name, reg] : s_registries) {
 		json j;
-		reg->serialize(j);
+		reg->serialize(j, p_save_assets);
 
 		if (!j.is_null()) {
 			p_json[type_name] = j;
@@ -89,18 +481,26 @@ void AssetSystem::serialize(json& p_json) {
 	}
 }
 
-void AssetSystem::deserialize(const json& p_json) {
+void AssetSystem::deserialize(const json& p_json, AssetHandleRemap* p_remap) {
 	clear_non_persistent();
 
 	// Register types so that we can deserialize
 	get_registry<MaterialDefinition>();
 	get_registry<Texture>();
 
+	// Used if the caller is not interested in the new handles
+	AssetHandleRemap remap;
+
 	for (const auto& [type_name, items] : p_json.items()) {
-		const auto it = s_registries.find(type_name);
-		if (it != s_registries.end()) {
-			IAssetRegistry* reg = it->second;
-			reg->deserialize(items);
+		IAssetRegistry* reg = nullptr;
+		{
+			std::shared_lock lock(s_registries_mutex);
+			const auto it = s_registries.find(type_name);
+			reg = it != s_registries.end() ? it->second : nullptr;
+		}
+
+		if (reg) {
+			reg->deserialize(items, p_remap ? *p_remap : remap);
 		} else {
 			GL_LOG_WARNING("[AssetSystem::deserialize] Asset type '{}' found in save file but not "
 						   "registered in AssetSystem.",
@@ -111,4 +511,207 @@ void AssetSystem::deserialize(const json& p_json) {
 	reload_all();
 }
 
+IAssetRegistry& AssetSystem::_add_registry(
+		std::string_view p_type_name, IAssetRegistry& p_registry) {
+	std::unique_lock lock(s_registries_mutex);
+	s_registries.emplace(p_type_name, &p_registry);
+	return p_registry;
+}
+
+void AssetSystem::_complete_load(const AssetHandle& p_handle, AssetLoadState p_state) {
+	std::lock_guard lock(s_load_mutex);
+	s_completed_loads.emplace_back(p_handle, p_state);
+}
+
+uint32_t AssetSystem::_next_generation() {
+	static std::atomic_uint32_t s_generation = 0;
+
+	uint32_t generation = ++s_generation;
+	// Zero is reserved for invalid handles
+	while (generation == 0) {
+		generation = ++s_generation;
+	}
+
+	return generation;
+}
+
+IAssetRegistry* AssetSystem::_find_registry(const AssetHandle& p_handle) {
+	if (!p_handle) {
+		return nullptr;
+	}
+
+	std::shared_lock lock(s_registries_mutex);
+	for (const auto& [_, reg] : s_registries) {
+		if (reg->contains(p_handle)) {
+			return reg;
+		}
+	}
+
+	return nullptr;
+}
+
+void AssetSystem::_set_dependencies(IAssetRegistry* p_registry, const AssetHandle& p_handle,
+		const std::vector<AssetHandle>& p_dependencies) {
+	// Retain the new dependencies before releasing the old ones since they might overlap
+	std::vector<DependencyRef> retained;
+	retained.reserve(p_dependencies.size());
+	for (const AssetHandle& dependency : p_dependencies) {
+		if (dependency == p_handle) {
+			continue;
+		}
+
+		IAssetRegistry* registry = _find_registry(dependency);
+		if (registry && registry->retain(dependency)) {
+			retained.push_back({ registry, dependency });
+		}
+	}
+
+	std::vector<DependencyRef> released;
+	{
+		std::lock_guard lock(s_dependency_mutex);
+
+		auto it = s_dependency_graph.find(p_handle);
+		if (it == s_dependency_graph.end()) {
+			if (retained.empty()) {
+				return;
+			}
+
+			it = s_dependency_graph.emplace(p_handle, DependencyNode{}).first;
+		}
+
+		DependencyNode& node = it->second;
+		node.registry = p_registry;
+
+		for (const AssetHandle& dependency : node.dependencies) {
+			DependencyNode& dependency_node = s_dependency_graph.at(dependency);
+			std::erase(dependency_node.dependents, p_handle);
+			released.push_back({ dependency_node.registry, dependency });
+		}
+
+		node.dependencies.clear();
+		for (const auto& [registry, dependency] : retained) {
+			node.dependencies.push_back(dependency);
+
+			DependencyNode& dependency_node = s_dependency_graph[dependency];
+			dependency_node.registry = registry;
+			dependency_node.dependents.push_back(p_handle);
+		}
+
+		// Nodes without edges are not kept around
+		for (const auto& [_, dependency] : released) {
+			const auto dependency_it = s_dependency_graph.find(dependency);
+			if (dependency_it != s_dependency_graph.end() &&
+					dependency_it->second.dependencies.empty() &&
+					dependency_it->second.dependents.empty()) {
+				s_dependency_graph.erase(dependency_it);
+			}
+		}
+
+		if (node.dependencies.empty() && node.dependents.empty()) {
+			s_dependency_graph.erase(p_handle);
+		}
+	}
+
+	// Old dependencies are left to the GC even if they lost their last reference
+	for (const auto& [registry, dependency] : released) {
+		registry->release(dependency);
+	}
+}
+
+std::vector<AssetSystem::DependencyRef> AssetSystem::_remove_dependency_node(
+		const AssetHandle& p_handle) {
+	std::vector<DependencyRef> released;
+	{
+		std::lock_guard lock(s_dependency_mutex);
+
+		const auto it = s_dependency_graph.find(p_handle);
+		if (it == s_dependency_graph.end()) {
+			return {};
+		}
+
+		const DependencyNode node = std::move(it->second);
+		s_dependency_graph.erase(it);
+
+		const auto unlink = [](const AssetHandle& p_node, auto p_edges, const AssetHandle& p_edge) {
+			const auto node_it = s_dependency_graph.find(p_node);
+			if (node_it == s_dependency_graph.end()) {
+				return;
+			}
+
+			DependencyNode& other = node_it->second;
+			std::erase(other.*p_edges, p_edge);
+
+			if (other.dependencies.empty() && other.dependents.empty()) {
+				s_dependency_graph.erase(node_it);
+			}
+		};
+
+		for (const AssetHandle& dependency : node.dependencies) {
+			if (const auto dependency_it = s_dependency_graph.find(dependency);
+					dependency_it != s_dependency_graph.end()) {
+				released.push_back({ dependency_it->second.registry, dependency });
+			}
+
+			unlink(dependency, &DependencyNode::dependents, p_handle);
+		}
+
+		// References held by the dependents are gone along with the asset
+		for (const AssetHandle& dependent : node.dependents) {
+			unlink(dependent, &DependencyNode::dependencies, p_handle);
+		}
+	}
+
+	for (const auto& [registry, dependency] : released) {
+		registry->release(dependency);
+	}
+
+	return released;
+}
+
+uint64_t AssetSystem::_get_dependents_last_used_frame(const AssetHandle& p_handle) {
+	std::lock_guard lock(s_dependency_mutex);
+
+	const auto it = s_dependency_graph.find(p_handle);
+	if (it == s_dependency_graph.end()) {
+		return 0;
+	}
+
+	uint64_t last_used_frame = 0;
+	for (const AssetHandle& dependent : it->second.dependents) {
+		const DependencyNode& node = s_dependency_graph.at(dependent);
+		last_used_frame =
+				std::max(last_used_frame, node.registry->get_last_used_frame(dependent));
+	}
+
+	return last_used_frame;
+}
+
+void AssetSystem::_notify_dependents(const std::vector<AssetHandle>& p_handles) {
+	std::vector<DependencyRef> dependents;
+	{
+		std::lock_guard lock(s_dependency_mutex);
+
+		std::unordered_set<AssetHandle> visited(p_handles.begin(), p_handles.end());
+		std::vector<AssetHandle> queue = p_handles;
+		for (size_t i = 0; i < queue.size(); i++) {
+			const auto it = s_dependency_graph.find(queue[i]);
+			if (it == s_dependency_graph.end()) {
+				continue;
+			}
+
+			for (const AssetHandle& dependent : it->second.dependents) {
+				if (visited.insert(dependent).second) {
+					queue.push_back(dependent);
+					dependents.push_back({ s_dependency_graph.at(dependent).registry, dependent });
+				}
+			}
+		}
+	}
+
+	// Direct dependents get notified before the indirect ones
+	for (const auto& [registry, dependent] : dependents) {
+		registry->notify_dependency_reloaded(dependent);
+	}
+}
+
 } //namespace gl
@@ -6,38 +6,74 @@
 #pragma once
 
 #include "glitch/asset/asset.h"
-#include "glitch/core/ref_counted.h"
-#include "glitch/core/uid.h"
+#include "glitch/asset/asset_load_trace.h"
+#include "glitch/core/hash.h"
+#include "glitch/core/job_system.h"
 
 namespace gl {
 
-// Counted atomic reference for GC system.
-class AssetHandle : public RefCounted<UID> {
-public:
-	AssetHandle() : RefCounted<UID>(UID()) {}
-	AssetHandle(UID p_id) : RefCounted<UID>(std::move(p_id)) {}
+class AssetPack;
+class FileWatcher;
+
+/**
+ * Generational handle of an asset, indexing the slot map of its registry.
+ *
+ * Handles are plain values, copying one does not keep the asset alive. Owners of
+ * an asset hold a reference with `AssetSystem::retain` and give it back with
+ * `AssetSystem::release`, assets with no references are removed by the GC.
+ */
+struct AssetHandle {
+	uint32_t index = 0;
+	// Unique among all registered assets, zero for invalid handles.
+	uint32_t generation = 0;
+
+	constexpr bool is_valid() const { return generation != 0; }
 
-	AssetHandle(const AssetHandle& p_rhs) : RefCounted<UID>(p_rhs) {}
-	AssetHandle(AssetHandle&& p_rhs) noexcept : RefCounted<UID>(std::move(p_rhs)) {}
+	constexpr explicit operator bool() const { return is_valid(); }
 
-	virtual ~AssetHandle() override = default;
+	constexpr bool operator==(const AssetHandle& p_other) const = default;
 
-	AssetHandle& operator=(const AssetHandle& p_rhs) {
-		RefCounted<UID>::operator=(p_rhs);
-		return *this;
+	// Serialized form of the handle.
+	constexpr uint64_t pack() const { return (uint64_t(generation) << 32) | index; }
+
+	static constexpr AssetHandle unpack(uint64_t p_value) {
+		return AssetHandle{ uint32_t(p_value & UINT32_MAX), uint32_t(p_value >> 32) };
 	}
+};
 
-	AssetHandle& operator=(AssetHandle&& p_rhs) noexcept {
-		RefCounted<UID>::operator=(std::move(p_rhs));
-		return *this;
+static_assert(std::is_trivially_copyable_v<AssetHandle>);
+
+inline constexpr AssetHandle INVALID_ASSET_HANDLE = {};
+
+void to_json(json& p_json, const AssetHandle& p_handle);
+void from_json(const json& p_json, AssetHandle& p_handle);
+
+} // namespace gl
+
+namespace std {
+template <> struct hash<gl::AssetHandle> {
+	size_t operator()(const gl::AssetHandle& p_handle) const {
+		return std::hash<uint64_t>{}(p_handle.pack());
 	}
 };
+} //namespace std
+
+namespace gl {
 
-const AssetHandle INVALID_ASSET_HANDLE = AssetHandle();
+/**
+ * Enforces that T reports the assets it depends on, see
+ * `AssetSystem::update_dependencies`. T may also define `on_dependency_reloaded()`
+ * which is called after one of its dependencies got hot reloaded.
+ */
+template <typename T>
+concept IsDependentAsset = requires(const T& p_asset) {
+	{ p_asset.get_dependencies() } -> std::same_as<std::vector<AssetHandle>>;
+};
 
 struct AssetMetadata {
 	const char* type_name;
 	std::string path;
+	uint32_t ref_count = 0;
 
 	/**
 	 * A memory asset is an asset, created by engine or other resources,
@@ -47,78 +83,304 @@ struct AssetMetadata {
 	bool is_memory_asset() const;
 };
 
+/**
+ * Metadata handed to `AssetSystem::for_each_asset` visitors, `path` is only valid during
+ * the visit.
+ */
+struct AssetMetadataView {
+	const char* type_name;
+	std::string_view path;
+	uint32_t ref_count = 0;
+};
+
+typedef std::function<void(const AssetHandle&, const AssetMetadataView&)> AssetVisitor;
+
+enum class AssetLoadState : uint8_t {
+	// Waiting for a worker to pick up the load
+	QUEUED,
+	LOADING,
+	READY,
+	// Loading failed or got cancelled
+	FAILED,
+};
+
+typedef std::function<void(const AssetHandle&, AssetLoadState)> AssetLoadCallback;
+
+// Handles of a save file mapped to the handles they got registered with.
+typedef std::unordered_map<AssetHandle, AssetHandle> AssetHandleRemap;
+
 struct IAssetRegistry {
 	virtual ~IAssetRegistry() = default;
 
 	virtual size_t get_asset_size() const = 0;
 
+	/**
+	 * Incremented whenever an asset is registered, freed or its entry changes (e.g. path
+	 * or load state), reference counts are not covered.
+	 */
+	virtual uint64_t get_version() const = 0;
+
 	virtual void collect_garbage() = 0;
 
+	/**
+	 * Continue collecting from where the previous call stopped until `p_deadline`.
+	 *
+	 * @returns `true` if the end of the registry is reached.
+	 */
+	virtual bool collect_garbage(std::chrono::steady_clock::time_point p_deadline) = 0;
+
 	virtual void clear() = 0;
 	virtual void clear_non_persistent() = 0;
 
-	virtual std::unordered_map<AssetHandle, AssetMetadata> get_asset_metadata() const = 0;
+	// Visit every registered asset without copying their metadata.
+	virtual void for_each_asset(const AssetVisitor& p_fn) const = 0;
 
 	virtual void reload_all() = 0;
 
-	virtual void serialize(json& p_out_json) const = 0;
-	virtual void deserialize(const json& p_in_json) = 0;
+	/**
+	 * Load the assets registered with `p_path` again without publishing them.
+	 *
+	 * @returns Function swapping the reloaded assets in, null if nothing got reloaded.
+	 */
+	virtual std::function<void()> reload(std::string_view p_path) = 0;
+
+	// Type erased counterparts of the typed methods, used by the dependency graph.
+	virtual bool contains(const AssetHandle& p_handle) const = 0;
+	virtual bool retain(const AssetHandle& p_handle) = 0;
+	virtual bool release(const AssetHandle& p_handle) = 0;
+	virtual uint32_t get_ref_count(const AssetHandle& p_handle) const = 0;
+
+	// Free the asset if it is garbage, returns `true` if it got freed.
+	virtual bool collect(const AssetHandle& p_handle) = 0;
+
+	// Returns zero if the type does not satisfy `IsSizedAsset`.
+	virtual size_t get_memory_size(const AssetHandle& p_handle) const = 0;
+
+	virtual void notify_dependency_reloaded(const AssetHandle& p_handle) = 0;
+
+	// Frame the asset was last marked as used in, see `AssetSystem::mark_used`.
+	virtual uint64_t get_last_used_frame(const AssetHandle& p_handle) const = 0;
+
+	// Memory used by the resident assets in bytes.
+	virtual size_t get_memory_usage() const = 0;
+
+	/**
+	 * Evict least recently used assets until the memory usage fits the budget of the
+	 * registry, does nothing if the type does not satisfy `IsEvictableAsset`.
+	 *
+	 * @param p_frame Assets used at or after this frame are never evicted.
+	 * @returns Handles of the evicted assets.
+	 */
+	virtual std::vector<AssetHandle> enforce_memory_budget(uint64_t p_frame) = 0;
+
+	virtual void serialize(json& p_out_json, bool p_save_assets = true) const = 0;
+	virtual void deserialize(const json& p_in_json, AssetHandleRemap& p_remap) = 0;
 };
 
+/**
+ * Registry of a single asset type, safe to use from multiple threads.
+ *
+ * Assets live in a paged slot map indexed by `AssetHandle::index`. Pages never move
+ * once allocated, so lookups are a single array index without taking any lock while
+ * mutations are serialized by the registry. Every slot stores the reference count
+ * of its asset next to the generation, a handle is only accepted if its generation
+ * matches the one of the slot.
+ *
+ * A secondary path index is kept in sync with the slots so path lookups done by
+ * loaders to deduplicate assets do not scan the whole registry.
+ */
 template <IsReflectedAsset T> struct AssetRegistry : public IAssetRegistry {
 	struct AssetEntry {
+		AssetHandle handle;
 		std::shared_ptr<T> instance;
 		std::string path;
 		bool is_persistent = false;
+		AssetLoadState state = AssetLoadState::READY;
+		// Job of the asynchronous load, if any
+		JobHandle job;
 	};
 
-	std::unordered_map<AssetHandle, AssetEntry> assets;
+	struct Slot {
+		// Generation in the upper 32 bits and the reference count in the lower ones, so that
+		// retaining a handle and freeing the slot can not interleave.
+		std::atomic_uint64_t state = 0;
+		// Entries are immutable, modifications publish a new entry.
+		std::atomic<std::shared_ptr<const AssetEntry>> entry;
+		std::atomic_uint64_t last_used_frame = 0;
+	};
+
+	static constexpr uint32_t PAGE_SIZE = 1024;
+	static constexpr uint32_t MAX_PAGES = 1024;
+
+	using Page = std::array<Slot, PAGE_SIZE>;
+
+	// Same path might be registered under multiple handles
+	using PathIndex =
+			std::unordered_multimap<std::string, AssetHandle, StringHash, std::equal_to<>>;
 
-	virtual ~AssetRegistry() = default;
+	virtual ~AssetRegistry();
 
 	static AssetRegistry& get();
 
 	size_t get_asset_size() const override;
 
+	uint64_t get_version() const override;
+
+	// Remove non persistent assets without any references.
 	void collect_garbage() override;
 
+	bool collect_garbage(std::chrono::steady_clock::time_point p_deadline) override;
+
 	/**
 	 * Registers given asset to the registry, so that it would automatically deleted
 	 * if no other reference is pointing to it.
 	 *
 	 * @param p_path Path of the asset to be registered
-	 * @param p_prev_handle Handle of the asset to be registered. Default is a random UID
+	 * @param p_prev_handle Handle whose asset should be replaced, a new handle is allocated
+	 * if it is not alive.
 	 */
 	AssetHandle register_asset(std::shared_ptr<T> p_asset, const std::string& p_path,
 			std::optional<AssetHandle> p_prev_handle = std::nullopt);
 
 	/**
 	 * Registers an asset that will live for the lifetime of the application.
-	 * Garbage collection will skip this asset even if the reference count is 1.
+	 * Garbage collection will skip this asset even if it has no references.
 	 */
 	AssetHandle register_asset_persistent(
 			std::shared_ptr<T> p_asset, const std::string& p_path = "");
 
-	std::shared_ptr<T> get_asset(const AssetHandle& p_handle);
+	// Lock-free lookup, safe to call while other threads register assets.
+	std::shared_ptr<T> get_asset(const AssetHandle& p_handle) const;
+
+	std::shared_ptr<T> get_asset_by_path(std::string_view p_path) const;
+
+	std::optional<AssetHandle> get_handle_by_path(std::string_view p_path) const;
+
+	std::optional<AssetMetadata> get_metadata(const AssetHandle& p_handle) const;
+
+	std::optional<AssetLoadState> get_state(const AssetHandle& p_handle) const;
+
+	/**
+	 * Increment the reference count of the asset.
+	 *
+	 * @returns `false` if the handle is not alive.
+	 */
+	bool retain(const AssetHandle& p_handle) override;
+
+	// Decrement the reference count of the asset, it is not freed until the next GC.
+	bool release(const AssetHandle& p_handle) override;
+
+	uint32_t get_ref_count(const AssetHandle& p_handle) const override;
+
+	bool contains(const AssetHandle& p_handle) const override;
+
+	bool collect(const AssetHandle& p_handle) override;
+
+	size_t get_memory_size(const AssetHandle& p_handle) const override;
 
-	std::shared_ptr<T> get_asset_by_path(const std::string& p_path);
+	void notify_dependency_reloaded(const AssetHandle& p_handle) override;
 
-	std::optional<AssetHandle> get_handle_by_path(const std::string& p_path) const;
+	// Stamp the asset with `p_frame`, lock-free.
+	void mark_used(const AssetHandle& p_handle, uint64_t p_frame);
 
-	std::optional<AssetMetadata> get_metadata(const AssetHandle& p_handle);
+	uint64_t get_last_used_frame(const AssetHandle& p_handle) const override;
 
-	bool erase(AssetHandle p_handle);
+	// Zero means the type is not limited.
+	void set_memory_budget(size_t p_budget);
+
+	size_t get_memory_budget() const;
+
+	size_t get_memory_usage() const override;
+
+	std::vector<AssetHandle> enforce_memory_budget(uint64_t p_frame) override;
+
+	bool erase(const AssetHandle& p_handle);
 
 	void clear() override;
 	void clear_non_persistent() override;
 
-	std::unordered_map<AssetHandle, AssetMetadata> get_asset_metadata() const override;
+	// Lock-free, assets registered or freed during the visit might be skipped.
+	void for_each_asset(const AssetVisitor& p_fn) const override;
 
 	void reload_all() override;
 
-	void serialize(json& p_out_json) const override;
+	std::function<void()> reload(std::string_view p_path) override;
+
+	void serialize(json& p_out_json, bool p_save_assets = true) const override;
+
+	void deserialize(const json& p_in_json, AssetHandleRemap& p_remap) override;
+
+private:
+	// Returns null if the slot was never allocated.
+	Slot* _get_slot(uint32_t p_index) const;
 
-	void deserialize(const json& p_in_json) override;
+	// Returns the entry only if it belongs to `p_handle`.
+	std::shared_ptr<const AssetEntry> _get_entry(const AssetHandle& p_handle) const;
+
+	/**
+	 * Store the entry into a free slot, `handle` of the entry is assigned here.
+	 * Must be called while holding `write_mutex`.
+	 */
+	AssetHandle _allocate_locked(AssetEntry p_entry);
+
+	// Must be called while holding `write_mutex`, returns the removed entry.
+	std::shared_ptr<const AssetEntry> _free_locked(uint32_t p_index);
+
+	// Free the slot if it is garbage, must be called while holding `write_mutex`.
+	std::shared_ptr<const AssetEntry> _collect_locked(uint32_t p_index);
+
+	/**
+	 * Remove the dependency edges of the freed entries and destroy them, must be called
+	 * without holding any lock.
+	 *
+	 * @param p_collected Whether the entries are garbage, dependencies left without
+	 * references are collected along with them.
+	 */
+	void _on_freed(std::vector<std::shared_ptr<const AssetEntry>> p_entries, bool p_collected);
+
+	AssetHandle _insert(AssetEntry p_entry);
+
+	/**
+	 * Free the alive slots matching `p_pred`.
+	 *
+	 * @returns Number of freed slots.
+	 */
+	template <typename Pred> size_t _free_if(Pred&& p_pred);
+
+	std::shared_ptr<const AssetEntry> _find_by_path(std::string_view p_path) const;
+
+	// Callers must hold `path_index_mutex` exclusively.
+	void _index_path(const AssetEntry& p_entry);
+	void _unindex_path(const AssetEntry& p_entry);
+
+	/**
+	 * Publish a modified copy of the entry of `p_handle` if `p_fn` returns true,
+	 * `p_fn` has to update the path index itself if it changes the path.
+	 *
+	 * @returns `false` if the entry does not exist or `p_fn` returned false.
+	 */
+	template <typename Fn> bool _update_entry(const AssetHandle& p_handle, Fn&& p_fn);
+
+private:
+	std::array<std::atomic<Page*>, MAX_PAGES> pages = {};
+	// Number of slots ever allocated, slots below it can be read without locking
+	std::atomic_uint32_t slot_count = 0;
+	std::atomic_size_t asset_count = 0;
+	std::atomic_uint64_t version = 0;
+
+	std::vector<uint32_t> free_slots;
+	std::mutex write_mutex;
+
+	// Next slot to be visited by the incremental GC, guarded by `write_mutex`
+	uint32_t gc_cursor = 0;
+
+	std::atomic_size_t memory_budget = 0;
+
+	// Lock order is `write_mutex` then the index, readers only take the index lock.
+	PathIndex path_index;
+	mutable std::shared_mutex path_index_mutex;
+
+	friend class AssetSystem;
 };
 
 enum class PathProcessError {
@@ -150,20 +412,77 @@ public:
 	// Remove unusued assets from the registry
 	static void collect_garbage();
 
+	/**
+	 * Collect garbage incrementally, continuing from where the previous call stopped
+	 * until `p_budget` runs out. Called by the application once per frame.
+	 */
+	static void collect_garbage(std::chrono::microseconds p_budget);
+
+	/**
+	 * Hand destruction of garbage collected assets over to `p_handler`, so that GPU
+	 * resources can be freed once the frames using them are finished. Assets are destroyed
+	 * right away if there is no handler.
+	 */
+	static void set_deletion_handler(std::function<void(AssetDeletionFn&&)> p_handler);
+
+	/**
+	 * Run `p_function` through the deletion handler, right away if there is none. Used by
+	 * assets freeing GPU resources while they stay alive, e.g. on eviction.
+	 */
+	static void defer_deletion(AssetDeletionFn&& p_function);
+
 	// Reload all loadable assets
 	static void reload_all();
 
+	/**
+	 * Watch the files of registered assets and reload the modified ones on a background
+	 * thread. Reloaded assets are swapped in together by the next `update`.
+	 */
+	static void set_hot_reload(bool p_enabled);
+
+	static bool is_hot_reload_enabled();
+
 	/**
 	 * Loads and registers the asset to the compatible asset registry.
-	 * If given path already loaded creates a new handle pointing to that instance.
+	 * If given path already loaded returns the handle of that instance.
 	 *
-	 * @param p_prev_handle Custom asset handle to give. Used by scene deserialization.
+	 * @param p_prev_handle Handle whose asset should be replaced by the loaded one.
 	 */
 	template <IsReflectedAsset T>
 		requires IsLoadableAsset<T>
 	static Result<AssetHandle, AssetLoadingError> load(
 			const std::string& p_path, std::optional<AssetHandle> p_prev_handle = std::nullopt);
 
+	/**
+	 * Queue the asset to be loaded on the JobSystem and return its handle immediately,
+	 * `get` returns null until the state of the handle becomes `READY`. Loading the
+	 * same path again joins the load in flight.
+	 *
+	 * @param p_callback Called from `AssetSystem::update` once the load finishes.
+	 */
+	template <IsReflectedAsset T>
+		requires IsLoadableAsset<T>
+	static AssetHandle load_async(const std::string& p_path, AssetLoadCallback p_callback = nullptr,
+			JobPriority p_priority = JobPriority::NORMAL);
+
+	/**
+	 * Cancel an asynchronous load that did not start yet, state of the handle
+	 * becomes `FAILED`.
+	 *
+	 * @returns `true` if the load got cancelled.
+	 */
+	template <IsReflectedAsset T> static bool cancel_load(const AssetHandle& p_handle);
+
+	// Returns `std::nullopt` if the handle is not registered.
+	template <IsReflectedAsset T>
+	static std::optional<AssetLoadState> get_state(const AssetHandle& p_handle);
+
+	/**
+	 * Swap in hot reloaded assets and run callbacks of finished asynchronous loads, called by
+	 * the main thread every frame.
+	 */
+	static void update();
+
 	// Creates and registers the asset to the compatible registry
 	template <IsReflectedAsset T, typename... Args>
 		requires IsCreatableAsset<T> || IsCreatableAsset<T, Args...>
@@ -172,7 +491,7 @@ public:
 	// Retrieve asset from registry
 	template <IsReflectedAsset T> static std::shared_ptr<T> get(const AssetHandle& p_handle);
 
-	template <IsReflectedAsset T> static std::shared_ptr<T> get_by_path(const std::string& p_path);
+	template <IsReflectedAsset T> static std::shared_ptr<T> get_by_path(std::string_view p_path);
 
 	// Retrieve asset metadata from registry
 	template <IsReflectedAsset T>
@@ -182,12 +501,33 @@ public:
 	 * Registers an asset type to the registry, type is guaranteed to get destroyed if no other
 	 * reference exists.
 	 *
-	 * @param p_prev_handle Handle of the asset to be registered. Default is a random UID.
+	 * @param p_prev_handle Handle whose asset should be replaced if it is still alive.
 	 */
 	template <IsReflectedAsset T>
 	static AssetHandle register_asset(std::shared_ptr<T> p_asset, const std::string& p_path = "",
 			std::optional<AssetHandle> p_prev_handle = std::nullopt);
 
+	/**
+	 * Returns the alive asset registered with the same content hash, otherwise registers
+	 * the asset `p_create` returns. Lets loaders share identical data across files, e.g.
+	 * the same texture embedded into many models.
+	 *
+	 * `p_create` might run concurrently for the same hash, only one of the results is kept.
+	 *
+	 * @returns `INVALID_ASSET_HANDLE` if `p_create` fails.
+	 */
+	template <IsReflectedAsset T>
+	static AssetHandle find_or_register(
+			uint64_t p_content_hash, const std::function<std::shared_ptr<T>()>& p_create);
+
+	/**
+	 * Returns the alive asset registered with the content hash by `find_or_register`, lets
+	 * loaders create the missing assets of a batch together.
+	 *
+	 * @returns `INVALID_ASSET_HANDLE` if there is none.
+	 */
+	template <IsReflectedAsset T> static AssetHandle find(uint64_t p_content_hash);
+
 	/**
 	 * Registers an asset type to the registry that persists through garbage collection.
 	 */
@@ -198,33 +538,224 @@ public:
 	// Release given asset handle from registry.
 	template <IsReflectedAsset T> static bool free(const AssetHandle& p_handle);
 
+	/**
+	 * Hold a reference to the asset, so that it is not removed by the GC.
+	 *
+	 * @returns `false` if the handle is not alive.
+	 */
+	template <IsReflectedAsset T> static bool retain(const AssetHandle& p_handle);
+
+	// Give back a reference taken by `retain`.
+	template <IsReflectedAsset T> static bool release(const AssetHandle& p_handle);
+
+	template <IsReflectedAsset T> static uint32_t get_ref_count(const AssetHandle& p_handle);
+
+	/**
+	 * Stamp the asset with the current frame, renderers call this for every asset they
+	 * draw so that the least recently used ones get evicted first.
+	 */
+	template <IsReflectedAsset T> static void mark_used(const AssetHandle& p_handle);
+
+	// Frame counter advanced by `update`.
+	static uint64_t get_frame();
+
+	/**
+	 * Limit the memory resident assets of type T may use, see `enforce_memory_budgets`.
+	 *
+	 * @param p_budget Budget in bytes, zero disables the limit.
+	 */
+	template <IsReflectedAsset T>
+		requires IsEvictableAsset<T>
+	static void set_memory_budget(size_t p_budget);
+
+	template <IsReflectedAsset T> static size_t get_memory_budget();
+
+	// Memory used by the resident assets of type T in bytes.
+	template <IsReflectedAsset T> static size_t get_memory_usage();
+
+	/**
+	 * Evict the least recently used assets of the registries exceeding their budget.
+	 * Assets used in the current or the previous frame are kept resident, textures
+	 * count as used whenever a material depending on them is.
+	 *
+	 * Dependents of the evicted assets are notified like after a reload so that they
+	 * restore them on demand. Called by the application once per frame.
+	 */
+	static void enforce_memory_budgets();
+
+	/**
+	 * Rebuild the dependency edges of the asset from `T::get_dependencies`. Edges are built
+	 * when the asset is registered, this must be called after modifying the dependencies
+	 * of a registered asset.
+	 *
+	 * Dependencies are kept alive by their dependents, the GC collects dependencies left
+	 * without references in the same pass as their dependents.
+	 */
+	template <IsReflectedAsset T>
+		requires IsDependentAsset<T>
+	static void update_dependencies(const AssetHandle& p_handle);
+
+	// Assets `p_handle` depends on directly, might contain duplicates.
+	static std::vector<AssetHandle> get_dependencies(const AssetHandle& p_handle);
+
+	// Assets depending on `p_handle` directly.
+	static std::vector<AssetHandle> get_dependents(const AssetHandle& p_handle);
+
+	/**
+	 * Memory used by the asset and everything it depends on in bytes, shared dependencies
+	 * are counted once. Only types satisfying `IsSizedAsset` are accounted.
+	 */
+	static size_t get_memory_footprint(const AssetHandle& p_handle);
+
 	template <IsReflectedAsset T> static AssetRegistry<T>& get_registry();
 
 	// Fetch all metadata objects of assets in the registry
 	static std::unordered_map<AssetHandle, AssetMetadata> get_asset_metadata();
 
-	// Transforms engine path format with suffix 'res://' to absolute path
+	/**
+	 * Visit every registered asset without allocating, preferred over `get_asset_metadata`
+	 * for code running every frame. `p_fn` must not use asset types that were never
+	 * registered before, their registries can not be added during the visit.
+	 */
+	static void for_each_asset(const AssetVisitor& p_fn);
+
+	/**
+	 * Sum of the versions of every registry, see `IAssetRegistry::get_version`. Callers
+	 * caching results of `for_each_asset` can skip the work while it stays the same.
+	 */
+	static uint64_t get_version();
+
+	// Number of registered assets across every registry.
+	static size_t get_asset_count();
+
+	/**
+	 * Transforms engine path format with suffix 'res://' to absolute path, 'pack://' paths
+	 * are returned as is and should be read through `read_file`.
+	 */
 	static Result<fs::path, PathProcessError> get_absolute_path(std::string_view p_path);
 
-	static void serialize(json& p_json);
-	static void deserialize(const json& p_json);
+	/**
+	 * Mount the pack file to serve `pack://` paths, packs mounted later take precedence
+	 * over the earlier ones.
+	 */
+	static bool mount_pack(const fs::path& p_path);
+
+	static void unmount_packs();
+
+	/**
+	 * Read the whole file, `pack://` paths are served from the mounted packs without
+	 * touching the file system and every other path is resolved by `get_absolute_path`.
+	 */
+	static Result<std::vector<uint8_t>, AssetLoadingError> read_file(std::string_view p_path);
+
+	static bool file_exists(std::string_view p_path);
+
+	/**
+	 * Serialize asset metadata of every loadable asset into `p_json`.
+	 *
+	 * @param p_save_assets Whether to call `T::save` on each asset, incremental saves
+	 * skip this since only the metadata is needed.
+	 */
+	static void serialize(json& p_json, bool p_save_assets = true);
+
+	/**
+	 * Register and load the assets of `p_json`, handles are reallocated.
+	 *
+	 * @param p_remap Filled with the serialized handles mapped to the new ones, should be
+	 * used to resolve handles stored along with the assets.
+	 */
+	static void deserialize(const json& p_json, AssetHandleRemap* p_remap = nullptr);
+
+private:
+	static IAssetRegistry& _add_registry(std::string_view p_type_name, IAssetRegistry& p_registry);
+
+	// Path `find_or_register` registers the assets of the content hash with.
+	template <IsReflectedAsset T> static std::string _get_content_path(uint64_t p_content_hash);
+
+	// Queue the load to be reported by the next `update`, thread safe.
+	static void _complete_load(const AssetHandle& p_handle, AssetLoadState p_state);
+
+	// Generations are unique across registries so handles of other types are never accepted.
+	static uint32_t _next_generation();
+
+	// Returns null if no registry contains the handle.
+	static IAssetRegistry* _find_registry(const AssetHandle& p_handle);
+
+	struct DependencyRef {
+		IAssetRegistry* registry;
+		AssetHandle handle;
+	};
+
+	// Replace outgoing edges of `p_handle`, dependencies that are not alive are skipped.
+	static void _set_dependencies(IAssetRegistry* p_registry, const AssetHandle& p_handle,
+			const std::vector<AssetHandle>& p_dependencies);
+
+	/**
+	 * Remove every edge of the freed asset and release its dependencies.
+	 *
+	 * @returns Released dependencies.
+	 */
+	static std::vector<DependencyRef> _remove_dependency_node(const AssetHandle& p_handle);
+
+	// Notify dependents of the reloaded or evicted assets recursively.
+	static void _notify_dependents(const std::vector<AssetHandle>& p_handles);
+
+	// Latest frame any direct dependent of `p_handle` got used in.
+	static uint64_t _get_dependents_last_used_frame(const AssetHandle& p_handle);
+
+	// Keep the file watcher in sync with the path indices of the registries.
+	static void _watch_path(std::string_view p_path);
+	static void _unwatch_path(std::string_view p_path);
+
+	static void _hot_reload_loop(std::stop_token p_stop_token);
+
+	// Snapshot of the registries, lets loaders register new types while they are reloaded.
+	static std::vector<IAssetRegistry*> _get_registries();
+
+	// Destroy garbage collected entries through the deletion handler.
+	template <typename TEntry> static void _dispose(std::vector<std::shared_ptr<TEntry>> p_entries);
 
 private:
 	// type_name, registry map
 	inline static std::unordered_map<std::string_view, IAssetRegistry*> s_registries;
-};
+	inline static std::shared_mutex s_registries_mutex;
 
-} // namespace gl
+	// Registry the incremental GC continues from
+	inline static size_t s_gc_registry_index = 0;
+	inline static std::function<void(AssetDeletionFn&&)> s_deletion_handler;
 
-namespace std {
-template <> struct hash<gl::AssetHandle> {
-	size_t operator()(const gl::AssetHandle& p_handle) const { // Check for null pointer first
-		if (p_handle.get_ref_count() == 0) {
-			return 0;
-		}
-		return std::hash<gl::UID>{}(p_handle.get_value());
-	}
+	inline static std::atomic_uint64_t s_frame = 0;
+
+	struct DependencyNode {
+		// Registries are stored so the GC does not have to look them up
+		IAssetRegistry* registry = nullptr;
+		std::vector<AssetHandle> dependencies;
+		std::vector<AssetHandle> dependents;
+	};
+
+	inline static std::unordered_map<AssetHandle, DependencyNode> s_dependency_graph;
+	inline static std::mutex s_dependency_mutex;
+
+	// Makes the lookup and registration of `find_or_register` atomic
+	inline static std::mutex s_content_mutex;
+
+	inline static std::vector<std::shared_ptr<AssetPack>> s_packs;
+	inline static std::shared_mutex s_packs_mutex;
+
+	// Null while hot reloading is disabled
+	inline static std::atomic<std::shared_ptr<FileWatcher>> s_file_watcher;
+	inline static std::jthread s_hot_reload_thread;
+	inline static std::vector<std::function<void()>> s_pending_reloads;
+	inline static std::mutex s_reload_mutex;
+
+	inline static std::unordered_map<AssetHandle, std::vector<AssetLoadCallback>>
+			s_load_callbacks;
+	inline static std::vector<std::pair<AssetHandle, AssetLoadState>> s_completed_loads;
+	inline static std::mutex s_load_mutex;
+
+	template <IsReflectedAsset T> friend struct AssetRegistry;
 };
-} //namespace std
+
+} // namespace gl
 
 #include "glitch/asset/asset_system.inl"
@@ -5,34 +5,123 @@
 namespace gl {
 
 template <typename T> static std::string _get_default_mem_path() {
-	static uint32_t s_id = 0;
+	static std::atomic_uint32_t s_id = 0;
 	return std::format("mem://{}/?id={}", T::get_type_name(), s_id++);
 }
 
+template <IsReflectedAsset T> AssetRegistry<T>::~AssetRegistry() {
+	clear();
+
+	for (std::atomic<Page*>& page : pages) {
+		delete page.load(std::memory_order_relaxed);
+	}
+}
+
 template <IsReflectedAsset T> AssetRegistry<T>& AssetRegistry<T>::get() {
 	static AssetRegistry instance;
 	return instance;
 }
 
 template <IsReflectedAsset T> size_t AssetRegistry<T>::get_asset_size() const {
-	return assets.size();
+	return asset_count.load(std::memory_order_relaxed);
+}
+
+template <IsReflectedAsset T> uint64_t AssetRegistry<T>::get_version() const {
+	return version.load(std::memory_order_acquire);
 }
 
 template <IsReflectedAsset T> void AssetRegistry<T>::collect_garbage() {
-	std::erase_if(assets, [](const auto& item) {
-		// get_ref_count() == 1 means only the map holds it
-		// Only delete if it is NOT persistent
-		return item.first.get_ref_count() == 1 && !item.second.is_persistent;
-	});
+	std::vector<std::shared_ptr<const AssetEntry>> removed;
+	{
+		std::lock_guard lock(write_mutex);
+
+		const uint32_t count = slot_count.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; i++) {
+			if (auto entry = _collect_locked(i)) {
+				removed.push_back(std::move(entry));
+			}
+		}
+	}
+
+	// Assets get destroyed outside of the lock, their destructors might release others
+	_on_freed(std::move(removed), true);
+}
+
+template <IsReflectedAsset T>
+bool AssetRegistry<T>::collect_garbage(std::chrono::steady_clock::time_point p_deadline) {
+	// Reading the clock for every slot would cost more than checking the slot itself
+	constexpr uint32_t DEADLINE_CHECK_INTERVAL = 64;
+
+	std::vector<std::shared_ptr<const AssetEntry>> removed;
+	bool finished = false;
+	{
+		std::lock_guard lock(write_mutex);
+
+		const uint32_t count = slot_count.load(std::memory_order_relaxed);
+		for (uint32_t visited = 1; gc_cursor < count; visited++) {
+			if (visited % DEADLINE_CHECK_INTERVAL == 0 &&
+					std::chrono::steady_clock::now() >= p_deadline) {
+				break;
+			}
+
+			if (auto entry = _collect_locked(gc_cursor)) {
+				removed.push_back(std::move(entry));
+			}
+			gc_cursor++;
+		}
+
+		if (gc_cursor >= count) {
+			gc_cursor = 0;
+			finished = true;
+		}
+	}
+
+	_on_freed(std::move(removed), true);
+
+	return finished;
 }
 
 template <IsReflectedAsset T>
 AssetHandle AssetRegistry<T>::register_asset(std::shared_ptr<T> p_asset, const std::string& p_path,
 		std::optional<AssetHandle> p_prev_handle) {
-	AssetHandle handle = p_prev_handle ? *p_prev_handle : AssetHandle();
+	std::vector<AssetHandle> dependencies;
+	if constexpr (IsDependentAsset<T>) {
+		if (p_asset) {
+			dependencies = p_asset->get_dependencies();
+		}
+	}
+
+	AssetEntry entry = {};
+	entry.instance = std::move(p_asset);
+	entry.path = !p_path.empty() ? p_path : _get_default_mem_path<T>();
+
+	if (p_prev_handle) {
+		entry.handle = *p_prev_handle;
+
+		// Keep the handle and its references if it is still alive
+		const bool replaced = _update_entry(*p_prev_handle, [&](AssetEntry& p_entry) {
+			{
+				std::unique_lock lock(path_index_mutex);
+				_unindex_path(p_entry);
+				_index_path(entry);
+			}
+
+			p_entry.instance = std::move(entry.instance);
+			p_entry.path = std::move(entry.path);
+			p_entry.state = AssetLoadState::READY;
+			return true;
+		});
+
+		if (replaced) {
+			AssetSystem::_set_dependencies(this, *p_prev_handle, dependencies);
+			return *p_prev_handle;
+		}
+	}
 
-	assets.insert_or_assign(
-			handle, AssetEntry{ p_asset, !p_path.empty() ? p_path : _get_default_mem_path<T>() });
+	const AssetHandle handle = _insert(std::move(entry));
+	if (!dependencies.empty()) {
+		AssetSystem::_set_dependencies(this, handle, dependencies);
+	}
 
 	return handle;
 }
@@ -40,123 +129,502 @@ AssetHandle AssetRegistry<T>::register_asset(std::shared_ptr<T> p_asset, const s
 template <IsReflectedAsset T>
 AssetHandle AssetRegistry<T>::register_asset_persistent(
 		std::shared_ptr<T> p_asset, const std::string& p_path) {
-	AssetHandle handle = AssetHandle();
+	std::vector<AssetHandle> dependencies;
+	if constexpr (IsDependentAsset<T>) {
+		if (p_asset) {
+			dependencies = p_asset->get_dependencies();
+		}
+	}
 
-	assets.insert_or_assign(handle,
-			AssetEntry{ p_asset, !p_path.empty() ? p_path : _get_default_mem_path<T>(), true });
+	const AssetHandle handle = _insert(AssetEntry{
+			INVALID_ASSET_HANDLE,
+			std::move(p_asset),
+			!p_path.empty() ? p_path : _get_default_mem_path<T>(),
+			true,
+	});
+
+	if (!dependencies.empty()) {
+		AssetSystem::_set_dependencies(this, handle, dependencies);
+	}
 
 	return handle;
 }
 
-template <IsReflectedAsset T> std::shared_ptr<T> AssetRegistry<T>::get_asset(const AssetHandle& p_handle) {
-	const auto it = assets.find(p_handle);
-	if (it == assets.end()) {
+template <IsReflectedAsset T>
+std::shared_ptr<T> AssetRegistry<T>::get_asset(const AssetHandle& p_handle) const {
+	const auto entry = _get_entry(p_handle);
+	return entry ? entry->instance : nullptr;
+}
+
+template <IsReflectedAsset T>
+std::shared_ptr<T> AssetRegistry<T>::get_asset_by_path(std::string_view p_path) const {
+	const auto entry = _find_by_path(p_path);
+	if (!entry) {
 		return nullptr;
 	}
 
-	return it->second.instance;
+	return entry->instance;
 }
 
 template <IsReflectedAsset T>
-std::shared_ptr<T> AssetRegistry<T>::get_asset_by_path(const std::string& p_path) {
-	const auto it = std::find_if(assets.begin(), assets.end(),
-			[&p_path](const auto& p_pair) { return p_pair.second.path == p_path; });
-	if (it == assets.end()) {
-		return nullptr;
+std::optional<AssetHandle> AssetRegistry<T>::get_handle_by_path(std::string_view p_path) const {
+	const auto entry = _find_by_path(p_path);
+	if (!entry) {
+		return std::nullopt;
 	}
 
-	return it->second.instance;
+	return entry->handle;
 }
 
 template <IsReflectedAsset T>
-std::optional<AssetHandle> AssetRegistry<T>::get_handle_by_path(const std::string& p_path) const {
-	const auto it = std::find_if(assets.begin(), assets.end(),
-			[&p_path](const auto& p_pair) { return p_pair.second.path == p_path; });
-	if (it == assets.end()) {
+std::optional<AssetMetadata> AssetRegistry<T>::get_metadata(const AssetHandle& p_handle) const {
+	const auto entry = _get_entry(p_handle);
+	if (!entry) {
 		return std::nullopt;
 	}
 
-	return it->first;
+	return AssetMetadata{ T::get_type_name(), entry->path, get_ref_count(p_handle) };
 }
 
 template <IsReflectedAsset T>
-std::optional<AssetMetadata> AssetRegistry<T>::get_metadata(const AssetHandle& p_handle) {
-	const auto it = assets.find(p_handle);
-	if (it == assets.end()) {
+std::optional<AssetLoadState> AssetRegistry<T>::get_state(const AssetHandle& p_handle) const {
+	const auto entry = _get_entry(p_handle);
+	if (!entry) {
 		return std::nullopt;
 	}
 
-	return AssetMetadata{ T::get_type_name(), it->second.path };
+	return entry->state;
 }
 
-template <IsReflectedAsset T> bool AssetRegistry<T>::erase(AssetHandle p_handle) {
-	return assets.erase(p_handle) > 0;
+template <IsReflectedAsset T> bool AssetRegistry<T>::retain(const AssetHandle& p_handle) {
+	Slot* slot = p_handle ? _get_slot(p_handle.index) : nullptr;
+	if (!slot) {
+		return false;
+	}
+
+	uint64_t state = slot->state.load(std::memory_order_relaxed);
+	do {
+		if ((state >> 32) != p_handle.generation) {
+			return false;
+		}
+	} while (!slot->state.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel));
+
+	return true;
 }
 
-template <IsReflectedAsset T> void AssetRegistry<T>::clear() { assets.clear(); }
+template <IsReflectedAsset T> bool AssetRegistry<T>::release(const AssetHandle& p_handle) {
+	Slot* slot = p_handle ? _get_slot(p_handle.index) : nullptr;
+	if (!slot) {
+		return false;
+	}
 
-template <IsReflectedAsset T> void AssetRegistry<T>::clear_non_persistent() {
-	for (auto it = assets.begin(); it != assets.end();) {
-		// Only erase non persistent assets
-		if (!it->second.is_persistent) {
-			it = assets.erase(it);
-			continue;
+	uint64_t state = slot->state.load(std::memory_order_relaxed);
+	do {
+		if ((state >> 32) != p_handle.generation || (state & UINT32_MAX) == 0) {
+			return false;
+		}
+	} while (!slot->state.compare_exchange_weak(state, state - 1, std::memory_order_acq_rel));
+
+	return true;
+}
+
+template <IsReflectedAsset T>
+uint32_t AssetRegistry<T>::get_ref_count(const AssetHandle& p_handle) const {
+	const Slot* slot = p_handle ? _get_slot(p_handle.index) : nullptr;
+	if (!slot) {
+		return 0;
+	}
+
+	const uint64_t state = slot->state.load(std::memory_order_acquire);
+	return (state >> 32) == p_handle.generation ? uint32_t(state & UINT32_MAX) : 0;
+}
+
+template <IsReflectedAsset T> bool AssetRegistry<T>::contains(const AssetHandle& p_handle) const {
+	return _get_entry(p_handle) != nullptr;
+}
+
+template <IsReflectedAsset T> bool AssetRegistry<T>::collect(const AssetHandle& p_handle) {
+	std::shared_ptr<const AssetEntry> removed;
+	{
+		std::lock_guard lock(write_mutex);
+		if (!_get_entry(p_handle)) {
+			return false;
+		}
+
+		removed = _collect_locked(p_handle.index);
+	}
+
+	if (!removed) {
+		return false;
+	}
+
+	_on_freed({ std::move(removed) }, true);
+
+	return true;
+}
+
+template <IsReflectedAsset T>
+size_t AssetRegistry<T>::get_memory_size(const AssetHandle& p_handle) const {
+	if constexpr (IsSizedAsset<T>) {
+		const auto entry = _get_entry(p_handle);
+		return entry && entry->instance ? size_t(entry->instance->get_memory_size()) : 0;
+	} else {
+		return 0;
+	}
+}
+
+template <IsReflectedAsset T>
+void AssetRegistry<T>::notify_dependency_reloaded(const AssetHandle& p_handle) {
+	if constexpr (requires(T& p_asset) { p_asset.on_dependency_reloaded(); }) {
+		const auto entry = _get_entry(p_handle);
+		if (entry && entry->instance) {
+			entry->instance->on_dependency_reloaded();
+		}
+	}
+}
+
+template <IsReflectedAsset T>
+void AssetRegistry<T>::mark_used(const AssetHandle& p_handle, uint64_t p_frame) {
+	Slot* slot = p_handle ? _get_slot(p_handle.index) : nullptr;
+	if (!slot || (slot->state.load(std::memory_order_relaxed) >> 32) != p_handle.generation) {
+		return;
+	}
+
+	slot->last_used_frame.store(p_frame, std::memory_order_relaxed);
+}
+
+template <IsReflectedAsset T>
+uint64_t AssetRegistry<T>::get_last_used_frame(const AssetHandle& p_handle) const {
+	const Slot* slot = p_handle ? _get_slot(p_handle.index) : nullptr;
+	if (!slot || (slot->state.load(std::memory_order_relaxed) >> 32) != p_handle.generation) {
+		return 0;
+	}
+
+	return slot->last_used_frame.load(std::memory_order_relaxed);
+}
+
+template <IsReflectedAsset T> void AssetRegistry<T>::set_memory_budget(size_t p_budget) {
+	memory_budget.store(p_budget, std::memory_order_relaxed);
+}
+
+template <IsReflectedAsset T> size_t AssetRegistry<T>::get_memory_budget() const {
+	return memory_budget.load(std::memory_order_relaxed);
+}
+
+template <IsReflectedAsset T> size_t AssetRegistry<T>::get_memory_usage() const {
+	if constexpr (IsSizedAsset<T>) {
+		size_t usage = 0;
+
+		const uint32_t count = slot_count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++) {
+			const auto entry = _get_slot(i)->entry.load(std::memory_order_acquire);
+			if (entry && entry->instance) {
+				usage += size_t(entry->instance->get_memory_size());
+			}
 		}
-		it++;
+
+		return usage;
+	} else {
+		return 0;
 	}
 }
 
 template <IsReflectedAsset T>
-std::unordered_map<AssetHandle, AssetMetadata> AssetRegistry<T>::get_asset_metadata() const {
-	std::unordered_map<AssetHandle, AssetMetadata> result;
-	result.reserve(assets.size());
+std::vector<AssetHandle> AssetRegistry<T>::enforce_memory_budget(uint64_t p_frame) {
+	if constexpr (IsEvictableAsset<T>) {
+		const size_t budget = get_memory_budget();
+		if (budget == 0) {
+			return {};
+		}
+
+		struct Candidate {
+			uint64_t last_used_frame;
+			size_t size;
+			std::shared_ptr<const AssetEntry> entry;
+		};
+
+		size_t usage = 0;
+		std::vector<Candidate> candidates;
+
+		const uint32_t count = slot_count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++) {
+			Slot* slot = _get_slot(i);
+
+			auto entry = slot->entry.load(std::memory_order_acquire);
+			if (!entry || !entry->instance || !entry->instance->is_resident()) {
+				continue;
+			}
+
+			const size_t size = entry->instance->get_memory_size();
+			usage += size;
+
+			// Assets are in use as long as something depending on them is
+			const uint64_t last_used_frame =
+					std::max(slot->last_used_frame.load(std::memory_order_relaxed),
+							AssetSystem::_get_dependents_last_used_frame(entry->handle));
+			if (last_used_frame < p_frame) {
+				candidates.push_back({ last_used_frame, size, std::move(entry) });
+			}
+		}
+
+		if (usage <= budget) {
+			return {};
+		}
+
+		std::sort(candidates.begin(), candidates.end(),
+				[](const Candidate& p_lhs, const Candidate& p_rhs) {
+					return p_lhs.last_used_frame < p_rhs.last_used_frame;
+				});
+
+		std::vector<AssetHandle> evicted;
+		if constexpr (IsBatchEvictableAsset<T>) {
+			// Evict as many as cover the excess at once, retry with the next ones if some fail
+			size_t next = 0;
+			while (usage > budget && next < candidates.size()) {
+				const size_t begin = next;
+
+				std::vector<T*> instances;
+				for (size_t covered = 0; next < candidates.size() && usage - covered > budget;
+						next++) {
+					covered += candidates[next].size;
+					instances.push_back(candidates[next].entry->instance.get());
+				}
+
+				const std::vector<uint8_t> results = T::evict_batch(instances);
+				for (size_t i = 0; i < instances.size(); i++) {
+					if (results[i]) {
+						usage -= candidates[begin + i].size;
+						evicted.push_back(candidates[begin + i].entry->handle);
+					}
+				}
+			}
+		} else {
+			for (const Candidate& candidate : candidates) {
+				if (usage <= budget) {
+					break;
+				}
+
+				if (candidate.entry->instance->evict()) {
+					usage -= candidate.size;
+					evicted.push_back(candidate.entry->handle);
+				}
+			}
+		}
+
+		if (usage > budget) {
+			GL_LOG_WARNING("[AssetRegistry::enforce_memory_budget] Assets of type '{}' use {} "
+						   "bytes, exceeding the budget of {} bytes.",
+					T::get_type_name(), usage, budget);
+		}
+
+		return evicted;
+	} else {
+		return {};
+	}
+}
+
+template <IsReflectedAsset T> bool AssetRegistry<T>::erase(const AssetHandle& p_handle) {
+	std::shared_ptr<const AssetEntry> removed;
+	{
+		std::lock_guard lock(write_mutex);
+		if (!_get_entry(p_handle)) {
+			return false;
+		}
 
-	for (auto& [handle, entry] : assets) {
-		result.emplace(handle, AssetMetadata{ T::get_type_name(), entry.path });
+		removed = _free_locked(p_handle.index);
 	}
 
-	return result;
+	if (!removed) {
+		return false;
+	}
+
+	// Asset gets destroyed outside of the lock
+	_on_freed({ std::move(removed) }, false);
+
+	return true;
+}
+
+template <IsReflectedAsset T> void AssetRegistry<T>::clear() {
+	_free_if([](const AssetEntry& p_entry) { return true; });
+}
+
+template <IsReflectedAsset T> void AssetRegistry<T>::clear_non_persistent() {
+	// Only erase non persistent assets
+	_free_if([](const AssetEntry& p_entry) { return !p_entry.is_persistent; });
+}
+
+template <IsReflectedAsset T>
+void AssetRegistry<T>::for_each_asset(const AssetVisitor& p_fn) const {
+	const uint32_t count = slot_count.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < count; i++) {
+		// Keeps the path alive during the visit even if the asset gets freed meanwhile
+		const auto entry = _get_slot(i)->entry.load(std::memory_order_acquire);
+		if (entry) {
+			p_fn(entry->handle,
+					AssetMetadataView{
+							T::get_type_name(), entry->path, get_ref_count(entry->handle) });
+		}
+	}
 }
 
 template <IsReflectedAsset T> void AssetRegistry<T>::reload_all() {
 	if constexpr (IsLoadableAsset<T>) {
-		auto it = assets.begin();
-		while (it != assets.end()) {
-			const auto path = AssetSystem::get_absolute_path(it->second.path);
+		// Load outside of the lock, loaders might take a long time
+		std::vector<std::pair<std::shared_ptr<const AssetEntry>, std::shared_ptr<T>>> reloaded;
+
+		const uint32_t count = slot_count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++) {
+			const auto entry = _get_slot(i)->entry.load(std::memory_order_acquire);
+			// Asynchronous loads in flight will publish the latest state anyway
+			if (!entry || entry->state == AssetLoadState::QUEUED ||
+					entry->state == AssetLoadState::LOADING) {
+				continue;
+			}
+
+			const auto path = AssetSystem::get_absolute_path(entry->path);
 			if (!path) {
-				it++;
 				continue;
 			}
 
-			if (const auto instance = T::load(path.get_value())) {
-				it->second.instance = instance;
+			reloaded.emplace_back(entry, T::load(path.get_value()));
+		}
+
+		std::vector<std::shared_ptr<const AssetEntry>> removed;
+		{
+			std::lock_guard lock(write_mutex);
+
+			for (auto& [old_entry, instance] : reloaded) {
+				Slot* slot = _get_slot(old_entry->handle.index);
+
+				// Skip entries that got replaced or erased in the meantime
+				if (slot->entry.load(std::memory_order_acquire) != old_entry) {
+					continue;
+				}
+
+				if (instance) {
+					slot->entry.store(std::make_shared<const AssetEntry>(AssetEntry{
+											  old_entry->handle,
+											  std::move(instance),
+											  old_entry->path,
+											  old_entry->is_persistent,
+											  AssetLoadState::READY,
+									  }),
+							std::memory_order_release);
+				} else {
+					removed.push_back(_free_locked(old_entry->handle.index));
+				}
+			}
+		}
+
+		_on_freed(std::move(removed), false);
+	}
+}
+
+template <IsReflectedAsset T>
+std::function<void()> AssetRegistry<T>::reload(std::string_view p_path) {
+	if constexpr (IsLoadableAsset<T>) {
+		std::vector<std::shared_ptr<const AssetEntry>> entries;
+		{
+			std::shared_lock lock(path_index_mutex);
 
-				it++;
-			} else {
-				it = assets.erase(it);
+			const auto [begin, end] = path_index.equal_range(p_path);
+			for (auto it = begin; it != end; it++) {
+				// Asynchronous loads in flight will publish the latest state anyway
+				const auto entry = _get_entry(it->second);
+				if (entry && entry->state != AssetLoadState::QUEUED &&
+						entry->state != AssetLoadState::LOADING) {
+					entries.push_back(entry);
+				}
 			}
 		}
+
+		const auto path = AssetSystem::get_absolute_path(p_path);
+		if (entries.empty() || !path) {
+			return nullptr;
+		}
+
+		// Handles sharing the path share the reloaded instance as well
+		std::shared_ptr<T> instance = T::load(path.get_value());
+		if (!instance) {
+			GL_LOG_WARNING("[AssetRegistry::reload] Unable to reload asset from path '{}', "
+						   "keeping the previous one.",
+					p_path);
+			return nullptr;
+		}
+
+		return [this, entries = std::move(entries), instance = std::move(instance)]() {
+			std::vector<std::shared_ptr<const AssetEntry>> replaced;
+			{
+				std::lock_guard lock(write_mutex);
+
+				for (const auto& old_entry : entries) {
+					Slot* slot = _get_slot(old_entry->handle.index);
+
+					// Skip entries that got replaced or erased in the meantime
+					if (slot->entry.load(std::memory_order_acquire) != old_entry) {
+						continue;
+					}
+
+					slot->entry.store(std::make_shared<const AssetEntry>(AssetEntry{
+											  old_entry->handle,
+											  instance,
+											  old_entry->path,
+											  old_entry->is_persistent,
+											  AssetLoadState::READY,
+									  }),
+							std::memory_order_release);
+
+					replaced.push_back(old_entry);
+				}
+			}
+
+			std::vector<AssetHandle> handles;
+			handles.reserve(replaced.size());
+			for (const auto& old_entry : replaced) {
+				handles.push_back(old_entry->handle);
+			}
+
+			if constexpr (IsDependentAsset<T>) {
+				for (const AssetHandle& handle : handles) {
+					AssetSystem::_set_dependencies(this, handle, instance->get_dependencies());
+				}
+			}
+
+			// Previous instances might still be in use by the frames in flight
+			AssetSystem::_dispose(std::move(replaced));
+
+			AssetSystem::_notify_dependents(handles);
+		};
+	} else {
+		return nullptr;
 	}
 }
 
-template <IsReflectedAsset T> void AssetRegistry<T>::serialize(json& p_json) const {
+template <IsReflectedAsset T>
+void AssetRegistry<T>::serialize(json& p_json, bool p_save_assets) const {
 	// Only loadable assets can be (de)serialized
 	if constexpr (IsLoadableAsset<T>) {
 		json j;
-		for (auto& [handle, entry] : assets) {
+
+		const uint32_t count = slot_count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++) {
+			const auto entry = _get_slot(i)->entry.load(std::memory_order_acquire);
+
 			// Do not serialize uninitialized assets
-			if (!entry.instance) {
+			if (!entry || !entry->instance) {
 				continue;
 			}
 
 			// Only serialize non memory types
-			if (!entry.path.empty() && !entry.path.starts_with("mem://")) {
+			if (!entry->path.empty() && !entry->path.starts_with("mem://")) {
 				// Serialize metadata
-				entry.instance->save(entry.path, entry.instance);
+				if (p_save_assets) {
+					entry->instance->save(entry->path, entry->instance);
+				}
 
 				j.push_back(json{
-						{ "handle", handle },
-						{ "path", entry.path },
+						{ "handle", entry->handle },
+						{ "path", entry->path },
 				});
 			}
 		}
@@ -165,7 +633,8 @@ template <IsReflectedAsset T> void AssetRegistry<T>::serialize(json& p_json) con
 	}
 }
 
-template <IsReflectedAsset T> void AssetRegistry<T>::deserialize(const json& p_in_json) {
+template <IsReflectedAsset T>
+void AssetRegistry<T>::deserialize(const json& p_in_json, AssetHandleRemap& p_remap) {
 	// Only loadable assets can be (de)serialized
 	if constexpr (IsLoadableAsset<T>) {
 		if (!p_in_json.is_array()) {
@@ -174,17 +643,232 @@ template <IsReflectedAsset T> void AssetRegistry<T>::deserialize(const json& p_i
 		}
 
 		for (const auto& asset : p_in_json) {
-			AssetHandle handle;
 			AssetEntry entry;
-
-			asset["handle"].get_to(handle);
 			asset["path"].get_to(entry.path);
 
-			assets[handle] = entry;
+			// Slots of the saved handles might be taken, so they are always reallocated
+			const AssetHandle saved_handle = asset["handle"].get<AssetHandle>();
+			p_remap[saved_handle] = _insert(std::move(entry));
 		}
 	}
 }
 
+template <IsReflectedAsset T>
+typename AssetRegistry<T>::Slot* AssetRegistry<T>::_get_slot(uint32_t p_index) const {
+	if (p_index >= slot_count.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	Page* page = pages[p_index / PAGE_SIZE].load(std::memory_order_acquire);
+	return &(*page)[p_index % PAGE_SIZE];
+}
+
+template <IsReflectedAsset T>
+std::shared_ptr<const typename AssetRegistry<T>::AssetEntry> AssetRegistry<T>::_get_entry(
+		const AssetHandle& p_handle) const {
+	const Slot* slot = p_handle ? _get_slot(p_handle.index) : nullptr;
+	if (!slot) {
+		return nullptr;
+	}
+
+	auto entry = slot->entry.load(std::memory_order_acquire);
+	if (!entry || entry->handle != p_handle) {
+		return nullptr;
+	}
+
+	return entry;
+}
+
+template <IsReflectedAsset T> AssetHandle AssetRegistry<T>::_allocate_locked(AssetEntry p_entry) {
+	uint32_t index;
+	if (!free_slots.empty()) {
+		index = free_slots.back();
+		free_slots.pop_back();
+	} else {
+		index = slot_count.load(std::memory_order_relaxed);
+
+		const uint32_t page_index = index / PAGE_SIZE;
+		GL_ASSERT(page_index < MAX_PAGES, "Asset registry is full!");
+
+		if (!pages[page_index].load(std::memory_order_relaxed)) {
+			pages[page_index].store(new Page(), std::memory_order_release);
+		}
+
+		// Publish the slot once its page exists
+		slot_count.store(index + 1, std::memory_order_release);
+	}
+
+	p_entry.handle = AssetHandle{ index, AssetSystem::_next_generation() };
+
+	Slot* slot = _get_slot(index);
+	{
+		std::unique_lock lock(path_index_mutex);
+		_index_path(p_entry);
+	}
+
+	const AssetHandle handle = p_entry.handle;
+	// New assets count as used so that they are not evicted before their first draw
+	slot->last_used_frame.store(AssetSystem::get_frame(), std::memory_order_relaxed);
+	slot->entry.store(std::make_shared<const AssetEntry>(std::move(p_entry)),
+			std::memory_order_release);
+	slot->state.store(uint64_t(handle.generation) << 32, std::memory_order_release);
+
+	asset_count.fetch_add(1, std::memory_order_relaxed);
+	version.fetch_add(1, std::memory_order_release);
+
+	return handle;
+}
+
+template <IsReflectedAsset T>
+std::shared_ptr<const typename AssetRegistry<T>::AssetEntry> AssetRegistry<T>::_free_locked(
+		uint32_t p_index) {
+	Slot* slot = _get_slot(p_index);
+
+	std::shared_ptr<const AssetEntry> entry =
+			slot->entry.exchange(nullptr, std::memory_order_acq_rel);
+	if (!entry) {
+		return nullptr;
+	}
+
+	// Handles of the slot are rejected from now on
+	slot->state.store(0, std::memory_order_release);
+
+	{
+		std::unique_lock lock(path_index_mutex);
+		_unindex_path(*entry);
+	}
+
+	free_slots.push_back(p_index);
+	asset_count.fetch_sub(1, std::memory_order_relaxed);
+	version.fetch_add(1, std::memory_order_release);
+
+	return entry;
+}
+
+template <IsReflectedAsset T>
+std::shared_ptr<const typename AssetRegistry<T>::AssetEntry> AssetRegistry<T>::_collect_locked(
+		uint32_t p_index) {
+	Slot* slot = _get_slot(p_index);
+
+	// Only delete if it is NOT persistent and not loading in the background
+	const auto entry = slot->entry.load(std::memory_order_acquire);
+	if (!entry || entry->is_persistent || entry->state == AssetLoadState::QUEUED ||
+			entry->state == AssetLoadState::LOADING) {
+		return nullptr;
+	}
+
+	// Fails if the asset got retained in the meantime
+	uint64_t unreferenced = uint64_t(entry->handle.generation) << 32;
+	if (!slot->state.compare_exchange_strong(unreferenced, 0, std::memory_order_acq_rel)) {
+		return nullptr;
+	}
+
+	return _free_locked(p_index);
+}
+
+template <IsReflectedAsset T>
+void AssetRegistry<T>::_on_freed(
+		std::vector<std::shared_ptr<const AssetEntry>> p_entries, bool p_collected) {
+	std::vector<AssetSystem::DependencyRef> released;
+	for (const auto& entry : p_entries) {
+		const auto dependencies = AssetSystem::_remove_dependency_node(entry->handle);
+		released.insert(released.end(), dependencies.begin(), dependencies.end());
+	}
+
+	AssetSystem::_dispose(std::move(p_entries));
+
+	// Dependencies kept alive only by the collected assets are garbage as well
+	if (p_collected) {
+		for (const auto& [registry, handle] : released) {
+			registry->collect(handle);
+		}
+	}
+}
+
+template <IsReflectedAsset T> AssetHandle AssetRegistry<T>::_insert(AssetEntry p_entry) {
+	std::lock_guard lock(write_mutex);
+	return _allocate_locked(std::move(p_entry));
+}
+
+template <IsReflectedAsset T>
+template <typename Pred>
+size_t AssetRegistry<T>::_free_if(Pred&& p_pred) {
+	std::vector<std::shared_ptr<const AssetEntry>> removed;
+	{
+		std::lock_guard lock(write_mutex);
+
+		const uint32_t count = slot_count.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; i++) {
+			Slot* slot = _get_slot(i);
+
+			const auto entry = slot->entry.load(std::memory_order_acquire);
+			if (!entry || !p_pred(*entry)) {
+				continue;
+			}
+
+			removed.push_back(_free_locked(i));
+		}
+	}
+
+	const size_t count = removed.size();
+	_on_freed(std::move(removed), false);
+
+	return count;
+}
+
+template <IsReflectedAsset T>
+std::shared_ptr<const typename AssetRegistry<T>::AssetEntry> AssetRegistry<T>::_find_by_path(
+		std::string_view p_path) const {
+	std::shared_lock lock(path_index_mutex);
+
+	const auto [begin, end] = path_index.equal_range(p_path);
+	for (auto it = begin; it != end; it++) {
+		// Index is updated before the slot gets published
+		if (auto entry = _get_entry(it->second)) {
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+template <IsReflectedAsset T> void AssetRegistry<T>::_index_path(const AssetEntry& p_entry) {
+	path_index.emplace(p_entry.path, p_entry.handle);
+	AssetSystem::_watch_path(p_entry.path);
+}
+
+template <IsReflectedAsset T> void AssetRegistry<T>::_unindex_path(const AssetEntry& p_entry) {
+	const auto [begin, end] = path_index.equal_range(p_entry.path);
+	for (auto it = begin; it != end; it++) {
+		if (it->second == p_entry.handle) {
+			path_index.erase(it);
+			AssetSystem::_unwatch_path(p_entry.path);
+			return;
+		}
+	}
+}
+
+template <IsReflectedAsset T>
+template <typename Fn>
+bool AssetRegistry<T>::_update_entry(const AssetHandle& p_handle, Fn&& p_fn) {
+	std::lock_guard lock(write_mutex);
+
+	const auto entry = _get_entry(p_handle);
+	if (!entry) {
+		return false;
+	}
+
+	auto new_entry = std::make_shared<AssetEntry>(*entry);
+	if (!p_fn(*new_entry)) {
+		return false;
+	}
+
+	_get_slot(p_handle.index)->entry.store(std::move(new_entry), std::memory_order_release);
+	version.fetch_add(1, std::memory_order_release);
+
+	return true;
+}
+
 template <IsReflectedAsset T>
 	requires IsLoadableAsset<T>
 Result<AssetHandle, AssetLoadingError> AssetSystem::load(
@@ -194,6 +878,8 @@ Result<AssetHandle, AssetLoadingError> AssetSystem::load(
 		return make_err<AssetHandle>(AssetLoadingError::FILE_ERROR);
 	}
 
+	AssetLoadTrace::LoadScope trace(p_path, T::get_type_name());
+
 	auto& registry = get_registry<T>();
 
 	std::shared_ptr<T> asset = nullptr;
@@ -201,6 +887,9 @@ Result<AssetHandle, AssetLoadingError> AssetSystem::load(
 	// If asset already exists then use that
 	if (const auto old_handle = registry.get_handle_by_path(p_path)) {
 		asset = AssetSystem::get<T>(*old_handle);
+		if (asset && !p_prev_handle) {
+			return *old_handle;
+		}
 	}
 
 	// Load the asset if not existing or failed to load from previous asset
@@ -211,9 +900,141 @@ Result<AssetHandle, AssetLoadingError> AssetSystem::load(
 		}
 	}
 
+	AssetLoadTrace::StageScope stage(AssetLoadStage::REGISTER);
+	trace.set_succeeded(true);
+
 	return registry.register_asset(asset, p_path, p_prev_handle);
 }
 
+template <IsReflectedAsset T>
+	requires IsLoadableAsset<T>
+AssetHandle AssetSystem::load_async(
+		const std::string& p_path, AssetLoadCallback p_callback, JobPriority p_priority) {
+	using AssetEntry = typename AssetRegistry<T>::AssetEntry;
+
+	auto& registry = get_registry<T>();
+
+	// Join the load in flight or the already loaded asset, failed loads are retried
+	if (const auto old_handle = registry.get_handle_by_path(p_path)) {
+		// Lock before reading the state so that the completion can not be reported in between
+		std::lock_guard lock(s_load_mutex);
+
+		const auto state = registry.get_state(*old_handle);
+		if (state && *state != AssetLoadState::FAILED) {
+			if (p_callback) {
+				s_load_callbacks[*old_handle].push_back(std::move(p_callback));
+			}
+
+			if (*state == AssetLoadState::READY) {
+				s_completed_loads.emplace_back(*old_handle, AssetLoadState::READY);
+			}
+
+			return *old_handle;
+		}
+	}
+
+	const auto absolute_path = get_absolute_path(p_path);
+
+	const AssetHandle handle = registry._insert(AssetEntry{
+			INVALID_ASSET_HANDLE,
+			nullptr,
+			p_path,
+			false,
+			absolute_path ? AssetLoadState::QUEUED : AssetLoadState::FAILED,
+	});
+
+	if (p_callback) {
+		std::lock_guard lock(s_load_mutex);
+		s_load_callbacks[handle].push_back(std::move(p_callback));
+	}
+
+	if (!absolute_path) {
+		_complete_load(handle, AssetLoadState::FAILED);
+		return handle;
+	}
+
+	// Garbage collection skips the entry until the load finishes
+	JobHandle job = JobSystem::schedule(
+			[handle, path = absolute_path.get_value()]() {
+				auto& registry = get_registry<T>();
+
+				// Entry might be erased or replaced while waiting in the queue
+				const bool started = registry._update_entry(handle, [](AssetEntry& p_entry) {
+					if (p_entry.state != AssetLoadState::QUEUED) {
+						return false;
+					}
+
+					p_entry.state = AssetLoadState::LOADING;
+					return true;
+				});
+
+				if (!started) {
+					return;
+				}
+
+				AssetLoadTrace::LoadScope trace(path.string(), T::get_type_name());
+
+				std::shared_ptr<T> asset = T::load(path);
+				const AssetLoadState state =
+						asset ? AssetLoadState::READY : AssetLoadState::FAILED;
+
+				trace.set_succeeded(asset != nullptr);
+				AssetLoadTrace::StageScope stage(AssetLoadStage::REGISTER);
+
+				const bool published = registry._update_entry(handle, [&](AssetEntry& p_entry) {
+					p_entry.instance = asset;
+					p_entry.state = state;
+					return true;
+				});
+
+				if (published) {
+					if constexpr (IsDependentAsset<T>) {
+						if (asset) {
+							_set_dependencies(&registry, handle, asset->get_dependencies());
+						}
+					}
+
+					_complete_load(handle, state);
+				}
+			},
+			p_priority);
+
+	registry._update_entry(handle, [&](AssetEntry& p_entry) {
+		p_entry.job = job;
+		return true;
+	});
+
+	return handle;
+}
+
+template <IsReflectedAsset T> bool AssetSystem::cancel_load(const AssetHandle& p_handle) {
+	using AssetEntry = typename AssetRegistry<T>::AssetEntry;
+
+	auto& registry = get_registry<T>();
+
+	const bool cancelled = registry._update_entry(p_handle, [](AssetEntry& p_entry) {
+		// Running loads can not be interrupted
+		if (p_entry.state != AssetLoadState::QUEUED || !p_entry.job.cancel()) {
+			return false;
+		}
+
+		p_entry.state = AssetLoadState::FAILED;
+		return true;
+	});
+
+	if (cancelled) {
+		_complete_load(p_handle, AssetLoadState::FAILED);
+	}
+
+	return cancelled;
+}
+
+template <IsReflectedAsset T>
+std::optional<AssetLoadState> AssetSystem::get_state(const AssetHandle& p_handle) {
+	auto& registry = get_registry<T>();
+	return registry.get_state(p_handle);
+}
+
 template <IsReflectedAsset T, typename... Args>
 	requires IsCreatableAsset<T> || IsCreatableAsset<T, Args...>
 std::optional<AssetHandle> AssetSystem::create(Args&&... p_args) {
@@ -232,7 +1053,7 @@ template <IsReflectedAsset T> std::shared_ptr<T> AssetSystem::get(const AssetHan
 }
 
 template <IsReflectedAsset T>
-std::shared_ptr<T> AssetSystem::get_by_path(const std::string& p_path) {
+std::shared_ptr<T> AssetSystem::get_by_path(std::string_view p_path) {
 	auto& registry = get_registry<T>();
 	return registry.get_asset_by_path(p_path);
 }
@@ -250,6 +1071,39 @@ AssetHandle AssetSystem::register_asset(std::shared_ptr<T> p_asset, const std::s
 	return registry.register_asset(p_asset, p_path, p_prev_handle);
 }
 
+template <IsReflectedAsset T>
+AssetHandle AssetSystem::find_or_register(
+		uint64_t p_content_hash, const std::function<std::shared_ptr<T>()>& p_create) {
+	if (const AssetHandle handle = find<T>(p_content_hash)) {
+		return handle;
+	}
+
+	// Create outside of the lock, uploads might take a long time
+	std::shared_ptr<T> asset = p_create();
+	if (!asset) {
+		return INVALID_ASSET_HANDLE;
+	}
+
+	std::lock_guard lock(s_content_mutex);
+
+	if (const AssetHandle handle = find<T>(p_content_hash)) {
+		return handle;
+	}
+
+	return get_registry<T>().register_asset(std::move(asset), _get_content_path<T>(p_content_hash));
+}
+
+template <IsReflectedAsset T> AssetHandle AssetSystem::find(uint64_t p_content_hash) {
+	auto& registry = get_registry<T>();
+
+	const auto handle = registry.get_handle_by_path(_get_content_path<T>(p_content_hash));
+	return handle && registry.get_asset(*handle) ? *handle : INVALID_ASSET_HANDLE;
+}
+
+template <IsReflectedAsset T> std::string AssetSystem::_get_content_path(uint64_t p_content_hash) {
+	return std::format("mem://{}/Content/?hash={:016x}", T::get_type_name(), p_content_hash);
+}
+
 template <IsReflectedAsset T>
 AssetHandle AssetSystem::register_asset_persistent(
 		std::shared_ptr<T> p_asset, const std::string& p_path) {
@@ -262,16 +1116,71 @@ template <IsReflectedAsset T> bool AssetSystem::free(const AssetHandle& p_handle
 	return registry.erase(p_handle);
 }
 
-template <IsReflectedAsset T> AssetRegistry<T>& AssetSystem::get_registry() {
-	auto& reg = AssetRegistry<T>::get();
+template <IsReflectedAsset T> bool AssetSystem::retain(const AssetHandle& p_handle) {
+	auto& registry = get_registry<T>();
+	return registry.retain(p_handle);
+}
+
+template <IsReflectedAsset T> bool AssetSystem::release(const AssetHandle& p_handle) {
+	auto& registry = get_registry<T>();
+	return registry.release(p_handle);
+}
+
+template <IsReflectedAsset T>
+	requires IsDependentAsset<T>
+void AssetSystem::update_dependencies(const AssetHandle& p_handle) {
+	auto& registry = get_registry<T>();
 
-	// Add asset registry to the asset system if not already existing
-	constexpr const char* type_name = T::get_type_name();
-	if (s_registries.find(type_name) == s_registries.end()) {
-		s_registries[T::get_type_name()] = &reg;
+	const std::shared_ptr<T> asset = registry.get_asset(p_handle);
+	if (!asset) {
+		return;
 	}
 
-	return reg;
+	_set_dependencies(&registry, p_handle, asset->get_dependencies());
+}
+
+template <IsReflectedAsset T> uint32_t AssetSystem::get_ref_count(const AssetHandle& p_handle) {
+	auto& registry = get_registry<T>();
+	return registry.get_ref_count(p_handle);
+}
+
+template <IsReflectedAsset T> void AssetSystem::mark_used(const AssetHandle& p_handle) {
+	auto& registry = get_registry<T>();
+	registry.mark_used(p_handle, get_frame());
+}
+
+template <IsReflectedAsset T>
+	requires IsEvictableAsset<T>
+void AssetSystem::set_memory_budget(size_t p_budget) {
+	auto& registry = get_registry<T>();
+	registry.set_memory_budget(p_budget);
+}
+
+template <IsReflectedAsset T> size_t AssetSystem::get_memory_budget() {
+	auto& registry = get_registry<T>();
+	return registry.get_memory_budget();
+}
+
+template <IsReflectedAsset T> size_t AssetSystem::get_memory_usage() {
+	auto& registry = get_registry<T>();
+	return registry.get_memory_usage();
+}
+
+template <typename TEntry>
+void AssetSystem::_dispose(std::vector<std::shared_ptr<TEntry>> p_entries) {
+	if (p_entries.empty()) {
+		return;
+	}
+
+	// Entries are destroyed along with the deletion function
+	defer_deletion([entries = std::move(p_entries)]() {});
+}
+
+template <IsReflectedAsset T> AssetRegistry<T>& AssetSystem::get_registry() {
+	// Add asset registry to the asset system only once per type
+	static AssetRegistry<T>& s_registry = static_cast<AssetRegistry<T>&>(
+			_add_registry(T::get_type_name(), AssetRegistry<T>::get()));
+	return s_registry;
 }
 
 }; //namespace gl
\ No newline at end of file
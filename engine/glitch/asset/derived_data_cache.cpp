@@ -0,0 +1,131 @@
+#include "glitch/asset/derived_data_cache.h"
+
+#include "glitch/asset/asset_load_trace.h"
+#include "glitch/platform/mapped_file.h"
+
+namespace gl {
+
+static constexpr uint32_t DERIVED_DATA_MAGIC = 0x44444c47; // "GLDD"
+static constexpr const char* DERIVED_DATA_EXTENSION = ".ddc";
+
+// Stored in front of the payload to detect stale and truncated entries
+struct DerivedDataHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t content_hash;
+	uint64_t size;
+};
+
+void DerivedDataCache::set_directory(const fs::path& p_directory) {
+	std::lock_guard lock(s_directory_mutex);
+	s_directory = p_directory;
+}
+
+fs::path DerivedDataCache::get_directory() {
+	std::lock_guard lock(s_directory_mutex);
+	return s_directory;
+}
+
+void DerivedDataCache::set_enabled(bool p_enabled) { s_enabled = p_enabled; }
+
+bool DerivedDataCache::is_enabled() { return s_enabled; }
+
+std::optional<std::vector<uint8_t>> DerivedDataCache::load(const DerivedDataKey& p_key) {
+	GL_PROFILE_SCOPE;
+
+	if (!s_enabled) {
+		return std::nullopt;
+	}
+
+	AssetLoadTrace::StageScope stage(AssetLoadStage::IO);
+
+	const std::unique_ptr<MappedFile> file = MappedFile::open(_get_entry_path(p_key));
+	if (!file || file->size() < sizeof(DerivedDataHeader)) {
+		return std::nullopt;
+	}
+
+	DerivedDataHeader header;
+	memcpy(&header, file->data(), sizeof(header));
+
+	if (header.magic != DERIVED_DATA_MAGIC || header.version != p_key.version ||
+			header.content_hash != p_key.content_hash ||
+			header.size != file->size() - sizeof(header)) {
+		GL_LOG_WARNING("[DerivedDataCache::load] Ignoring invalid {} entry {:016x}.",
+				p_key.importer, p_key.content_hash);
+		return std::nullopt;
+	}
+
+	AssetLoadTrace::add_bytes_read(file->size());
+
+	const uint8_t* payload = file->data() + sizeof(header);
+	return std::vector<uint8_t>(payload, payload + header.size);
+}
+
+bool DerivedDataCache::store(const DerivedDataKey& p_key, std::span<const uint8_t> p_data) {
+	GL_PROFILE_SCOPE;
+
+	if (!s_enabled) {
+		return false;
+	}
+
+	const fs::path path = _get_entry_path(p_key);
+
+	std::error_code err;
+	fs::create_directories(path.parent_path(), err);
+
+	// Write to a unique file first so that readers never see partially written entries
+	const fs::path temp_path = path.string() +
+			std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+	{
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			GL_LOG_WARNING("[DerivedDataCache::store] Unable to open file '{}'.",
+					temp_path.string());
+			return false;
+		}
+
+		const DerivedDataHeader header = {
+			DERIVED_DATA_MAGIC,
+			p_key.version,
+			p_key.content_hash,
+			p_data.size(),
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(p_data.data()), p_data.size());
+
+		if (!file.good()) {
+			file.close();
+			fs::remove(temp_path, err);
+			return false;
+		}
+	}
+
+	fs::rename(temp_path, path, err);
+	if (err) {
+		fs::remove(temp_path, err);
+		return false;
+	}
+
+	return true;
+}
+
+void DerivedDataCache::clear() {
+	const fs::path directory = get_directory();
+
+	std::error_code err;
+	for (const fs::directory_entry& entry : fs::directory_iterator(directory, err)) {
+		if (entry.path().extension() == DERIVED_DATA_EXTENSION) {
+			fs::remove(entry.path(), err);
+		}
+	}
+}
+
+fs::path DerivedDataCache::_get_entry_path(const DerivedDataKey& p_key) {
+	return get_directory() /
+			std::format("{}-{}-{:016x}{}", p_key.importer, p_key.version, p_key.content_hash,
+					DERIVED_DATA_EXTENSION);
+}
+
+} //namespace gl
@@ -0,0 +1,58 @@
+/**
+ * @file derived_data_cache.h
+ *
+ */
+
+#pragma once
+
+namespace gl {
+
+/**
+ * Identifies the output of an importer for a specific source content. Bumping the
+ * version of an importer invalidates everything it cached before.
+ */
+struct DerivedDataKey {
+	// Short name of the importer, used in the file names of the cache
+	const char* importer;
+	uint32_t version;
+	// Hash of every input the output depends on, see `content_hash64`
+	uint64_t content_hash;
+};
+
+/**
+ * Local cache of processed asset data, keyed by the content of the source rather than
+ * its path so renamed or duplicated files hit the cache as well. Entries are plain files
+ * under the cache directory and can be deleted at any time.
+ *
+ * Every method is thread safe, concurrent stores of the same key keep one of the outputs.
+ */
+class GL_API DerivedDataCache {
+public:
+	// Defaults to '.glitch/cache' next to the other caches of the engine.
+	static void set_directory(const fs::path& p_directory);
+
+	static fs::path get_directory();
+
+	static void set_enabled(bool p_enabled);
+
+	static bool is_enabled();
+
+	// Returns `std::nullopt` on misses, entries written by other versions are misses.
+	static std::optional<std::vector<uint8_t>> load(const DerivedDataKey& p_key);
+
+	static bool store(const DerivedDataKey& p_key, std::span<const uint8_t> p_data);
+
+	// Remove every entry of the cache.
+	static void clear();
+
+private:
+	static fs::path _get_entry_path(const DerivedDataKey& p_key);
+
+private:
+	inline static fs::path s_directory = ".glitch/cache";
+	inline static std::mutex s_directory_mutex;
+
+	inline static std::atomic_bool s_enabled = true;
+};
+
+} //namespace gl
@@ -2,14 +2,19 @@
 
 #include "glitch/asset/asset_system.h"
 #include "glitch/core/event/event_system.h"
+#include "glitch/core/job_system.h"
 #include "glitch/core/timer.h"
+#include "glitch/platform/os.h"
+#include "glitch/renderer/mesh.h"
+#include "glitch/renderer/texture.h"
 #include "glitch/scripting/script_engine.h"
 
 namespace gl {
 
 static Application* s_instance = nullptr;
 
-Application::Application(const ApplicationCreateInfo& p_info) {
+Application::Application(const ApplicationCreateInfo& p_info) :
+		asset_gc_budget(p_info.asset_gc_budget) {
 	GL_ASSERT(!s_instance, "Only one instance can exists at a time!");
 	s_instance = this;
 
@@ -25,17 +30,53 @@ Application::Application(const ApplicationCreateInfo& p_info) {
 
 	renderer = std::make_shared<Renderer>(window);
 
+	// Collected assets might still be used by the frames in flight
+	AssetSystem::set_deletion_handler([this](AssetSystem::AssetDeletionFn&& p_function) {
+		renderer->defer_deletion(std::move(p_function));
+	});
+
+	AssetSystem::set_memory_budget<Texture>(p_info.texture_memory_budget);
+	AssetSystem::set_memory_budget<StaticMesh>(p_info.mesh_memory_budget);
+
+	const char* trace_path = p_info.asset_trace_path;
+	if (!trace_path) {
+		trace_path = os::getenv("GL_ASSET_TRACE");
+	}
+
+	if (trace_path) {
+		asset_trace_path = trace_path;
+		AssetLoadTrace::set_enabled(true);
+	}
+
+	for (const char* pack_path : p_info.asset_packs) {
+		if (!AssetSystem::mount_pack(pack_path)) {
+			GL_LOG_WARNING("[Application::Application] Unable to mount asset pack '{}'.",
+					pack_path);
+		}
+	}
+
 	// System initialization
 
+	JobSystem::init();
 	ScriptEngine::init();
 }
 
 Application::~Application() {
+	// Loads in flight might still be uploading to the GPU
+	AssetSystem::set_hot_reload(false);
+	JobSystem::shutdown();
+
 	renderer->wait_for_device();
 
 	// Destroy systems
+	AssetSystem::set_deletion_handler(nullptr);
 	AssetSystem::clear();
+	AssetSystem::unmount_packs();
 	ScriptEngine::shutdown();
+
+	if (!asset_trace_path.empty()) {
+		AssetLoadTrace::dump(asset_trace_path);
+	}
 }
 
 void Application::run() {
@@ -80,6 +121,10 @@ void Application::_event_loop(float p_dt) {
 
 	_process_main_thread_queue();
 
+	AssetSystem::update();
+	AssetSystem::collect_garbage(asset_gc_budget);
+	AssetSystem::enforce_memory_budgets();
+
 	{
 		GL_PROFILE_SCOPE_N("Application::_on_update");
 
@@ -22,6 +22,16 @@ struct ApplicationPerfStats {
 struct ApplicationCreateInfo {
 	const char* name;
 	VectorView<const char*> args;
+	// Time spent collecting unused assets every frame
+	std::chrono::microseconds asset_gc_budget = std::chrono::microseconds(250);
+	// Device memory textures and meshes may use in bytes, zero disables the limit
+	size_t texture_memory_budget = 0;
+	size_t mesh_memory_budget = 0;
+	// Pack files mounted on startup to serve 'pack://' paths, later ones take precedence
+	VectorView<const char*> asset_packs;
+	// Traces asset loads and writes the trace as json on shutdown, see `AssetLoadTrace`.
+	// Falls back to the 'GL_ASSET_TRACE' environment variable.
+	const char* asset_trace_path = nullptr;
 };
 
 typedef std::function<void(void)> MainThreadFunc;
@@ -74,6 +84,9 @@ private:
 	std::mutex main_thread_queue_mutex;
 
 	ApplicationPerfStats perf_stats = {};
+
+	std::chrono::microseconds asset_gc_budget;
+	std::string asset_trace_path;
 };
 
 } //namespace gl
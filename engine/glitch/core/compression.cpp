@@ -0,0 +1,193 @@
+#include "glitch/core/compression.h"
+
+namespace gl {
+
+/**
+ * Data is a series of sequences, each one is a token followed by literals and a
+ * back reference:
+ *
+ * token (literal length << 4 | match length - MIN_MATCH), literal length extension,
+ * literals, offset (u16 little endian), match length extension
+ *
+ * Lengths of 15 are extended by the following bytes until one of them is not 255.
+ * The last sequence only contains literals.
+ */
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = UINT16_MAX;
+// Matches do not start in the last bytes of the input, keeps the tail in literals
+constexpr size_t MATCH_SEARCH_LIMIT = 12;
+constexpr size_t LAST_LITERALS = 5;
+constexpr uint32_t HASH_BITS = 16;
+constexpr uint32_t EMPTY_POSITION = UINT32_MAX;
+
+static uint32_t _read_u32(const uint8_t* p_ptr) {
+	uint32_t value;
+	memcpy(&value, p_ptr, sizeof(value));
+	return value;
+}
+
+static uint32_t _hash_sequence(uint32_t p_sequence) {
+	return (p_sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void _write_length(std::vector<uint8_t>& p_dst, size_t p_length) {
+	for (; p_length >= 255; p_length -= 255) {
+		p_dst.push_back(255);
+	}
+	p_dst.push_back(uint8_t(p_length));
+}
+
+static bool _read_length(std::span<const uint8_t> p_src, size_t& p_pos, size_t& p_length) {
+	uint8_t byte;
+	do {
+		if (p_pos >= p_src.size()) {
+			return false;
+		}
+		byte = p_src[p_pos++];
+		p_length += byte;
+	} while (byte == 255);
+
+	return true;
+}
+
+static void _write_sequence(std::vector<uint8_t>& p_dst, const uint8_t* p_literals,
+		size_t p_literal_count, size_t p_offset, size_t p_match_length) {
+	const size_t match_code = p_match_length - MIN_MATCH;
+
+	const uint8_t token = uint8_t(std::min<size_t>(p_literal_count, 15) << 4) |
+			uint8_t(std::min<size_t>(match_code, 15));
+	p_dst.push_back(token);
+
+	if (p_literal_count >= 15) {
+		_write_length(p_dst, p_literal_count - 15);
+	}
+	p_dst.insert(p_dst.end(), p_literals, p_literals + p_literal_count);
+
+	p_dst.push_back(uint8_t(p_offset & 0xff));
+	p_dst.push_back(uint8_t(p_offset >> 8));
+
+	if (match_code >= 15) {
+		_write_length(p_dst, match_code - 15);
+	}
+}
+
+size_t lz_compress_bound(size_t p_size) { return p_size + p_size / 255 + 16; }
+
+// Literals are copied one to one, the longest expansion is a match whose every length byte
+// adds 255 bytes
+size_t lz_decompress_bound(size_t p_compressed_size) { return p_compressed_size * 255; }
+
+std::vector<uint8_t> lz_compress(std::span<const uint8_t> p_src) {
+	GL_ASSERT(p_src.size() < UINT32_MAX);
+
+	const uint8_t* src = p_src.data();
+	const size_t size = p_src.size();
+
+	std::vector<uint8_t> dst;
+	dst.reserve(lz_compress_bound(size));
+
+	size_t anchor = 0;
+
+	if (size > MATCH_SEARCH_LIMIT) {
+		// Last position each hashed sequence is seen at
+		std::vector<uint32_t> table(size_t(1) << HASH_BITS, EMPTY_POSITION);
+
+		const size_t search_end = size - MATCH_SEARCH_LIMIT;
+		const size_t match_end = size - LAST_LITERALS;
+
+		size_t pos = 0;
+		while (pos < search_end) {
+			const uint32_t sequence = _read_u32(src + pos);
+			const uint32_t hash = _hash_sequence(sequence);
+
+			const uint32_t candidate = table[hash];
+			table[hash] = uint32_t(pos);
+
+			if (candidate == EMPTY_POSITION || pos - candidate > MAX_OFFSET ||
+					_read_u32(src + candidate) != sequence) {
+				pos++;
+				continue;
+			}
+
+			size_t length = MIN_MATCH;
+			while (pos + length < match_end && src[candidate + length] == src[pos + length]) {
+				length++;
+			}
+
+			_write_sequence(dst, src + anchor, pos - anchor, pos - candidate, length);
+
+			pos += length;
+			anchor = pos;
+		}
+	}
+
+	// Remaining bytes as the literal only sequence
+	const size_t literal_count = size - anchor;
+	dst.push_back(uint8_t(std::min<size_t>(literal_count, 15) << 4));
+	if (literal_count >= 15) {
+		_write_length(dst, literal_count - 15);
+	}
+	dst.insert(dst.end(), src + anchor, src + size);
+
+	return dst;
+}
+
+bool lz_decompress(std::span<const uint8_t> p_src, std::span<uint8_t> p_dst) {
+	size_t src_pos = 0;
+	size_t dst_pos = 0;
+
+	while (src_pos < p_src.size()) {
+		const uint8_t token = p_src[src_pos++];
+
+		size_t literal_count = token >> 4;
+		if (literal_count == 15 && !_read_length(p_src, src_pos, literal_count)) {
+			return false;
+		}
+
+		if (literal_count > p_src.size() - src_pos || literal_count > p_dst.size() - dst_pos) {
+			return false;
+		}
+
+		memcpy(p_dst.data() + dst_pos, p_src.data() + src_pos, literal_count);
+		src_pos += literal_count;
+		dst_pos += literal_count;
+
+		// Last sequence has no back reference
+		if (src_pos == p_src.size()) {
+			break;
+		}
+
+		if (p_src.size() - src_pos < 2) {
+			return false;
+		}
+
+		const size_t offset = size_t(p_src[src_pos]) | (size_t(p_src[src_pos + 1]) << 8);
+		src_pos += 2;
+
+		if (offset == 0 || offset > dst_pos) {
+			return false;
+		}
+
+		size_t length = token & 15;
+		if (length == 15 && !_read_length(p_src, src_pos, length)) {
+			return false;
+		}
+		length += MIN_MATCH;
+
+		if (length > p_dst.size() - dst_pos) {
+			return false;
+		}
+
+		// Source and destination overlap for repeating patterns, copy byte by byte
+		const uint8_t* match = p_dst.data() + dst_pos - offset;
+		uint8_t* out = p_dst.data() + dst_pos;
+		for (size_t i = 0; i < length; i++) {
+			out[i] = match[i];
+		}
+		dst_pos += length;
+	}
+
+	return dst_pos == p_dst.size();
+}
+
+} //namespace gl
@@ -0,0 +1,32 @@
+/**
+ * @file compression.h
+ */
+
+#pragma once
+
+namespace gl {
+
+/**
+ * Upper bound of the size of `lz_compress` output for an input of `p_size` bytes.
+ */
+GL_API size_t lz_compress_bound(size_t p_size);
+
+/**
+ * Upper bound of the size `lz_decompress` can produce from `p_compressed_size` bytes.
+ */
+GL_API size_t lz_decompress_bound(size_t p_compressed_size);
+
+/**
+ * Compress `p_src` with a byte oriented LZ77 codec in the spirit of LZ4, favors
+ * decompression speed over ratio. Input size is limited to 4GB.
+ */
+GL_API std::vector<uint8_t> lz_compress(std::span<const uint8_t> p_src);
+
+/**
+ * Decompress `p_src` into `p_dst`, size of the decompressed data must be known upfront.
+ *
+ * @returns `false` if the data is malformed or does not fill `p_dst` exactly.
+ */
+GL_API bool lz_decompress(std::span<const uint8_t> p_src, std::span<uint8_t> p_dst);
+
+} //namespace gl
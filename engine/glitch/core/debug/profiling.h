@@ -10,7 +10,9 @@
 
 #define GL_PROFILE_SCOPE ZoneScoped
 #define GL_PROFILE_SCOPE_N(p_X) ZoneScopedN(p_X)
+#define GL_PROFILE_PLOT(p_name, p_value) TracyPlot(p_name, p_value)
 #else
 #define GL_PROFILE_SCOPE
 #define GL_PROFILE_SCOPE_N(X)
+#define GL_PROFILE_PLOT(p_name, p_value)
 #endif
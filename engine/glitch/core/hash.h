@@ -6,6 +6,65 @@
 
 namespace gl {
 
+/**
+ * Transparent string hash, lets string keyed containers be searched with
+ * `std::string_view` or `const char*` without allocating a temporary string.
+ * Should be paired with `std::equal_to<>`.
+ */
+struct StringHash {
+	using is_transparent = void;
+
+	size_t operator()(std::string_view p_str) const {
+		return std::hash<std::string_view>{}(p_str);
+	}
+};
+
+/**
+ * FNV-1a hash of `p_data`, unlike `std::hash` the result is stable across builds and
+ * platforms so it can be persisted.
+ */
+constexpr uint64_t fnv1a64(std::string_view p_data) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (const char c : p_data) {
+		hash ^= uint8_t(c);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+/**
+ * Stable hash of large buffers, consumes 8 bytes per step so it is considerably faster than
+ * `fnv1a64` while staying persistable. Not suited for security purposes.
+ */
+inline uint64_t content_hash64(std::span<const uint8_t> p_data) {
+	constexpr uint64_t PRIME = 0x100000001b3ull;
+
+	const uint8_t* data = p_data.data();
+	const size_t size = p_data.size();
+
+	uint64_t hash = 0xcbf29ce484222325ull ^ (size * PRIME);
+
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * PRIME;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; i++) {
+		hash = (hash ^ data[i]) * PRIME;
+	}
+
+	// Final avalanche of MurmurHash3
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb93fe53e1a1bull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
 template <typename T>
 inline void hash_combine(std::size_t& p_seed, T const& p_value) {
 	p_seed ^= std::hash<T>()(p_value) + 0x9e3779b9 + (p_seed << 6) +
@@ -0,0 +1,191 @@
+#include "glitch/core/job_system.h"
+
+namespace gl {
+
+bool JobHandle::is_valid() const { return state != nullptr; }
+
+JobStatus JobHandle::get_status() const {
+	return state ? state->status.load(std::memory_order_acquire) : JobStatus::CANCELLED;
+}
+
+bool JobHandle::is_finished() const {
+	const JobStatus status = get_status();
+	return status == JobStatus::DONE || status == JobStatus::CANCELLED;
+}
+
+bool JobHandle::cancel() {
+	if (!state) {
+		return false;
+	}
+
+	JobStatus expected = JobStatus::QUEUED;
+	if (state->status.compare_exchange_strong(expected, JobStatus::CANCELLED)) {
+		state->status.notify_all();
+		return true;
+	}
+
+	return expected == JobStatus::CANCELLED;
+}
+
+void JobHandle::wait() const {
+	if (!state) {
+		return;
+	}
+
+	JobStatus status = state->status.load(std::memory_order_acquire);
+	while (status == JobStatus::QUEUED || status == JobStatus::RUNNING) {
+		state->status.wait(status);
+		status = state->status.load(std::memory_order_acquire);
+	}
+}
+
+void JobSystem::init(uint32_t p_thread_count) {
+	std::lock_guard lock(s_mutex);
+
+	if (s_running) {
+		return;
+	}
+
+	if (p_thread_count == 0) {
+		// Leave one core for the main thread
+		p_thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+
+	s_running = true;
+
+	s_workers.reserve(p_thread_count);
+	for (uint32_t i = 0; i < p_thread_count; i++) {
+		s_workers.emplace_back(&JobSystem::_worker_loop);
+	}
+}
+
+void JobSystem::shutdown() {
+	std::vector<std::thread> workers;
+	std::array<std::deque<Job>, PRIORITY_COUNT> queues;
+	{
+		std::lock_guard lock(s_mutex);
+		if (!s_running) {
+			return;
+		}
+
+		s_running = false;
+		workers = std::move(s_workers);
+		queues = std::move(s_queues);
+		s_workers.clear();
+	}
+
+	s_condition.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	// Wake up anyone waiting for jobs that will never run
+	for (auto& queue : queues) {
+		for (Job& job : queue) {
+			job.state->status.store(JobStatus::CANCELLED, std::memory_order_release);
+			job.state->status.notify_all();
+		}
+	}
+}
+
+JobHandle JobSystem::schedule(JobFunc p_func, JobPriority p_priority) {
+	JobHandle handle;
+	handle.state = std::make_shared<JobHandle::State>();
+
+	{
+		std::lock_guard lock(s_mutex);
+		GL_ASSERT(s_running, "JobSystem::init must be called before scheduling jobs!");
+
+		s_queues[static_cast<size_t>(p_priority)].push_back(Job{ std::move(p_func), handle.state });
+	}
+
+	s_condition.notify_one();
+
+	return handle;
+}
+
+void JobSystem::parallel_for(
+		uint32_t p_count, const std::function<void(uint32_t)>& p_func, JobPriority p_priority) {
+	if (p_count == 0) {
+		return;
+	}
+
+	std::atomic_uint32_t next_index = 0;
+	const auto run = [&]() {
+		for (uint32_t i = next_index++; i < p_count; i = next_index++) {
+			p_func(i);
+		}
+	};
+
+	std::vector<JobHandle> jobs;
+	if (p_count > 1) {
+		const uint32_t job_count = std::min(std::max(get_thread_count(), 1u), p_count - 1);
+
+		jobs.reserve(job_count);
+		for (uint32_t i = 0; i < job_count; i++) {
+			jobs.push_back(schedule(run, p_priority));
+		}
+	}
+
+	run();
+
+	// Every index is taken, the jobs that did not start have nothing left to do and the
+	// ones that did are finishing their last index
+	for (JobHandle& job : jobs) {
+		if (!job.cancel()) {
+			job.wait();
+		}
+	}
+}
+
+uint32_t JobSystem::get_thread_count() {
+	std::lock_guard lock(s_mutex);
+	return s_workers.size();
+}
+
+void JobSystem::_worker_loop() {
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock(s_mutex);
+			s_condition.wait(lock, [] {
+				return !s_running ||
+						std::any_of(s_queues.begin(), s_queues.end(),
+								[](const auto& p_queue) { return !p_queue.empty(); });
+			});
+
+			if (!s_running) {
+				return;
+			}
+
+			// Highest priority first
+			for (auto it = s_queues.rbegin(); it != s_queues.rend(); it++) {
+				if (!it->empty()) {
+					job = std::move(it->front());
+					it->pop_front();
+					break;
+				}
+			}
+		}
+
+		// Job might be cancelled while it was waiting in the queue
+		JobStatus expected = JobStatus::QUEUED;
+		if (!job.state->status.compare_exchange_strong(expected, JobStatus::RUNNING)) {
+			continue;
+		}
+
+		{
+			GL_PROFILE_SCOPE_N("JobSystem::_worker_loop::job");
+			job.func();
+		}
+
+		// Destroy captured state before notifying the waiters
+		job.func = nullptr;
+
+		job.state->status.store(JobStatus::DONE, std::memory_order_release);
+		job.state->status.notify_all();
+	}
+}
+
+} //namespace gl
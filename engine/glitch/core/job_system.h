@@ -0,0 +1,111 @@
+/**
+ * @file job_system.h
+ */
+
+#pragma once
+
+namespace gl {
+
+enum class JobPriority : uint8_t {
+	LOW = 0,
+	NORMAL,
+	HIGH,
+};
+
+enum class JobStatus : uint8_t {
+	QUEUED,
+	RUNNING,
+	DONE,
+	CANCELLED,
+};
+
+/**
+ * Reference to a scheduled job, can be used to query its status or cancel it
+ * before a worker picks it up.
+ */
+class GL_API JobHandle {
+public:
+	JobHandle() = default;
+
+	bool is_valid() const;
+
+	JobStatus get_status() const;
+
+	// Returns true if the job is either done or cancelled.
+	bool is_finished() const;
+
+	/**
+	 * Cancel the job if it did not start running yet.
+	 *
+	 * @returns `true` if the job will not be executed.
+	 */
+	bool cancel();
+
+	/**
+	 * Block until the job is finished. Must not be called from inside of a job
+	 * since the awaited job might be queued behind the caller.
+	 */
+	void wait() const;
+
+private:
+	struct State {
+		std::atomic<JobStatus> status = JobStatus::QUEUED;
+	};
+
+	std::shared_ptr<State> state = nullptr;
+
+	friend class JobSystem;
+};
+
+typedef std::function<void(void)> JobFunc;
+
+/**
+ * Thread pool executing jobs in priority order, jobs with the same priority
+ * run in the order they were scheduled. Must be initialized before scheduling
+ * and shut down before exit, joinable workers terminate the process.
+ */
+class GL_API JobSystem {
+public:
+	/**
+	 * Start the worker threads.
+	 *
+	 * @param p_thread_count Worker count, default is `hardware_concurrency - 1`.
+	 */
+	static void init(uint32_t p_thread_count = 0);
+
+	// Wait for the running jobs to finish and cancel the queued ones.
+	static void shutdown();
+
+	static JobHandle schedule(JobFunc p_func, JobPriority p_priority = JobPriority::NORMAL);
+
+	/**
+	 * Run `p_func` for every index in `[0, p_count)` across the workers and return once all
+	 * of them are done. The caller works on the indices as well, so unlike `JobHandle::wait`
+	 * it can be called from inside of a job.
+	 */
+	static void parallel_for(uint32_t p_count, const std::function<void(uint32_t)>& p_func,
+			JobPriority p_priority = JobPriority::NORMAL);
+
+	static uint32_t get_thread_count();
+
+private:
+	static void _worker_loop();
+
+private:
+	struct Job {
+		JobFunc func;
+		std::shared_ptr<JobHandle::State> state;
+	};
+
+	static constexpr size_t PRIORITY_COUNT = 3;
+
+	// Indexed by `JobPriority`
+	inline static std::array<std::deque<Job>, PRIORITY_COUNT> s_queues;
+	inline static std::vector<std::thread> s_workers;
+	inline static bool s_running = false;
+
+	inline static std::mutex s_mutex;
+	inline static std::condition_variable s_condition;
+};
+
+} //namespace gl
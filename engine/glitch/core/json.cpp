@@ -10,16 +10,15 @@ Result<json, JSONLoadError> json_load(std::string_view p_path) {
 		return make_err<json>(JSONLoadError::INVALID_PATH);
 	}
 
-	std::ifstream f(*abs_path);
-	if (!f.is_open()) {
+	const auto file = AssetSystem::read_file(p_path);
+	if (!file) {
 		return make_err<json>(JSONLoadError::FILE_OPEN_ERROR);
 	}
 
-	try {
-		json j;
-		f >> j;
+	const std::vector<uint8_t>& data = *file;
 
-		return j;
+	try {
+		return json::parse(data.begin(), data.end());
 	} catch (const std::runtime_error&) {
 		return make_err<json>(JSONLoadError::PARSING_ERROR);
 	}
@@ -13,6 +13,9 @@ using json = nlohmann::json;
 
 // just to make things look better
 #define GL_DEFINE_SERIALIZABLE(Type, ...) NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Type, __VA_ARGS__)
+// Missing fields keep their default values, for types that got new fields over time
+#define GL_DEFINE_SERIALIZABLE_WITH_DEFAULT(Type, ...)                                            \
+	NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(Type, __VA_ARGS__)
 #define GL_SERIALIZE_ENUM(Type, ...) NLOHMANN_JSON_SERIALIZE_ENUM(Type, __VA_ARGS__)
 
 namespace glm {
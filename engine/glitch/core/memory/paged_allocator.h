@@ -8,7 +8,7 @@ namespace gl {
 
 /**
  * Class representing a dynamic allocator that will grow when
- * the underlying data exceeds `page_size`
+ * the underlying data exceeds `page_size`, safe to use from multiple threads.
  */
 template <typename T> class PagedAllocator {
 public:
@@ -23,6 +23,8 @@ public:
 	}
 
 	T* alloc() {
+		std::lock_guard lock(mutex);
+
 		if (free_list.empty()) {
 			_allocate_new_page();
 		}
@@ -31,9 +33,14 @@ public:
 		return obj;
 	}
 
-	void free(T* obj) { free_list.push_back(obj); }
+	void free(T* obj) {
+		std::lock_guard lock(mutex);
+		free_list.push_back(obj);
+	}
 
 private:
+	std::mutex mutex;
+
 	size_t page_size;
 	std::vector<T*> pages;
 	std::vector<T*> free_list;
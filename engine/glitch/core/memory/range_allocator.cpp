@@ -0,0 +1,117 @@
+#include "glitch/core/memory/range_allocator.h"
+
+#include "glitch/core/memory/memory.h"
+
+namespace gl {
+
+RangeAllocator::RangeAllocator(uint64_t p_size) : size(p_size) {
+	if (p_size > 0) {
+		_insert_free(0, p_size);
+	}
+}
+
+std::optional<uint64_t> RangeAllocator::allocate(uint64_t p_size, uint64_t p_alignment) {
+	if (p_size == 0) {
+		return std::nullopt;
+	}
+
+	// Smallest free range that fits the range even with the worst alignment padding
+	const auto it = free_sizes.lower_bound({ p_size + p_alignment - 1, 0 });
+	if (it == free_sizes.end()) {
+		return std::nullopt;
+	}
+
+	const auto [free_size, free_offset] = *it;
+	_erase_free(free_ranges.find(free_offset));
+
+	const uint64_t offset = align_up(free_offset, p_alignment);
+	const uint64_t padding = offset - free_offset;
+
+	// Padding is kept free, only the tail of the free range is returned
+	if (padding > 0) {
+		_insert_free(free_offset, padding);
+	}
+	if (free_size > padding + p_size) {
+		_insert_free(offset + p_size, free_size - padding - p_size);
+	}
+
+	allocations[offset] = p_size;
+	used_size += p_size;
+
+	return offset;
+}
+
+void RangeAllocator::free(uint64_t p_offset) {
+	const auto allocation = allocations.find(p_offset);
+	if (allocation == allocations.end()) {
+		GL_LOG_ERROR("[RangeAllocator::free] No range is allocated at offset {}.", p_offset);
+		return;
+	}
+
+	uint64_t offset = p_offset;
+	uint64_t range_size = allocation->second;
+
+	used_size -= range_size;
+	allocations.erase(allocation);
+
+	// Merge with the free neighbours
+	auto next = free_ranges.lower_bound(offset);
+	if (next != free_ranges.end() && next->first == offset + range_size) {
+		range_size += next->second;
+		next = std::next(next);
+		_erase_free(std::prev(next));
+	}
+
+	if (next != free_ranges.begin()) {
+		const auto prev = std::prev(next);
+		if (prev->first + prev->second == offset) {
+			offset = prev->first;
+			range_size += prev->second;
+			_erase_free(prev);
+		}
+	}
+
+	_insert_free(offset, range_size);
+}
+
+void RangeAllocator::grow(uint64_t p_size) {
+	if (p_size <= size) {
+		return;
+	}
+
+	uint64_t offset = size;
+	uint64_t range_size = p_size - size;
+
+	// Extend the free range at the end
+	if (!free_ranges.empty()) {
+		const auto last = std::prev(free_ranges.end());
+		if (last->first + last->second == size) {
+			offset = last->first;
+			range_size += last->second;
+			_erase_free(last);
+		}
+	}
+
+	_insert_free(offset, range_size);
+	size = p_size;
+}
+
+uint64_t RangeAllocator::get_size() const { return size; }
+
+uint64_t RangeAllocator::get_used_size() const { return used_size; }
+
+uint64_t RangeAllocator::get_largest_free_size() const {
+	return free_sizes.empty() ? 0 : free_sizes.rbegin()->first;
+}
+
+void RangeAllocator::_insert_free(uint64_t p_offset, uint64_t p_size) {
+	free_ranges[p_offset] = p_size;
+	free_sizes.emplace(p_size, p_offset);
+}
+
+void RangeAllocator::_erase_free(std::map<uint64_t, uint64_t>::iterator p_it) {
+	free_sizes.erase({ p_it->second, p_it->first });
+	free_ranges.erase(p_it);
+}
+
+} //namespace gl
@@ -0,0 +1,54 @@
+/**
+ * @file range_allocator.h
+ */
+
+#pragma once
+
+namespace gl {
+
+/**
+ * Best fit allocator of ranges within a linear space such as a GPU buffer, it only does the
+ * bookkeeping. Freed ranges are merged with their free neighbours so they can be reused by
+ * larger allocations. Not thread safe.
+ */
+class GL_API RangeAllocator {
+public:
+	RangeAllocator(uint64_t p_size = 0);
+
+	/**
+	 * @param p_alignment Power of two the offset is aligned to.
+	 * @returns Offset of the range or `std::nullopt` if no free range fits it.
+	 */
+	std::optional<uint64_t> allocate(uint64_t p_size, uint64_t p_alignment = 1);
+
+	// Free the range allocated at `p_offset`.
+	void free(uint64_t p_offset);
+
+	// Extend the space, ranges allocated so far keep their offsets.
+	void grow(uint64_t p_size);
+
+	uint64_t get_size() const;
+
+	// Size of the allocated ranges, alignment padding is kept free.
+	uint64_t get_used_size() const;
+
+	uint64_t get_largest_free_size() const;
+
+private:
+	void _insert_free(uint64_t p_offset, uint64_t p_size);
+	void _erase_free(std::map<uint64_t, uint64_t>::iterator p_it);
+
+private:
+	uint64_t size;
+	uint64_t used_size = 0;
+
+	// Offset to size of the free ranges, neighbours are always merged
+	std::map<uint64_t, uint64_t> free_ranges;
+	// Free ranges ordered by their size for best fit lookups
+	std::set<std::pair<uint64_t, uint64_t>> free_sizes;
+
+	// Offset to size of the allocated ranges
+	std::unordered_map<uint64_t, uint64_t> allocations;
+};
+
+} //namespace gl
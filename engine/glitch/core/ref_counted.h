@@ -66,6 +66,10 @@ public:
 				delete ref_count;
 			}
 		}
+
+		// Released references must not be released again by the destructor.
+		value = nullptr;
+		ref_count = nullptr;
 	}
 
 	constexpr bool is_valid() const { return ref_count && value; }
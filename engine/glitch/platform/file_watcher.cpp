@@ -0,0 +1,48 @@
+#include "glitch/platform/file_watcher.h"
+
+namespace gl {
+
+static fs::file_time_type _get_last_write_time(const fs::path& p_path) {
+	std::error_code err;
+	const fs::file_time_type time = fs::last_write_time(p_path, err);
+	return err ? fs::file_time_type::min() : time;
+}
+
+void PollingFileWatcher::watch(const fs::path& p_path) {
+	std::lock_guard lock(mutex);
+
+	const auto [it, inserted] = files.try_emplace(p_path.string(), WatchedFile{ {}, 0 });
+	if (inserted) {
+		it->second.last_write_time = _get_last_write_time(p_path);
+	}
+	it->second.watch_count++;
+}
+
+void PollingFileWatcher::unwatch(const fs::path& p_path) {
+	std::lock_guard lock(mutex);
+
+	const auto it = files.find(p_path.string());
+	if (it != files.end() && --it->second.watch_count == 0) {
+		files.erase(it);
+	}
+}
+
+std::vector<fs::path> PollingFileWatcher::wait(std::chrono::milliseconds p_timeout) {
+	std::this_thread::sleep_for(p_timeout);
+
+	std::vector<fs::path> changed;
+
+	std::lock_guard lock(mutex);
+	for (auto& [path, file] : files) {
+		const fs::file_time_type time = _get_last_write_time(path);
+		// Deleted files are reported once they are written again
+		if (time != fs::file_time_type::min() && time != file.last_write_time) {
+			file.last_write_time = time;
+			changed.push_back(path);
+		}
+	}
+
+	return changed;
+}
+
+} //namespace gl
@@ -0,0 +1,57 @@
+/**
+ * @file file_watcher.h
+ */
+
+#pragma once
+
+namespace gl {
+
+/**
+ * Reports modifications of watched files, every method is thread safe.
+ */
+class GL_API FileWatcher {
+public:
+	virtual ~FileWatcher() = default;
+
+	// Watching the same file multiple times requires as many `unwatch` calls.
+	virtual void watch(const fs::path& p_path) = 0;
+
+	virtual void unwatch(const fs::path& p_path) = 0;
+
+	/**
+	 * Block until a watched file changes or `p_timeout` passes.
+	 *
+	 * @returns Files modified since the previous call.
+	 */
+	virtual std::vector<fs::path> wait(std::chrono::milliseconds p_timeout) = 0;
+
+	/**
+	 * Create the native watcher of the platform, falls back to polling if it is not available.
+	 * Linux uses inotify, Windows always uses the `PollingFileWatcher`.
+	 */
+	static std::unique_ptr<FileWatcher> create();
+};
+
+/**
+ * Watcher comparing modification times of the files, works on every platform but
+ * does a `stat` per file on each `wait`.
+ */
+class GL_API PollingFileWatcher : public FileWatcher {
+public:
+	void watch(const fs::path& p_path) override;
+
+	void unwatch(const fs::path& p_path) override;
+
+	std::vector<fs::path> wait(std::chrono::milliseconds p_timeout) override;
+
+private:
+	struct WatchedFile {
+		fs::file_time_type last_write_time;
+		uint32_t watch_count;
+	};
+
+	std::unordered_map<std::string, WatchedFile> files;
+	std::mutex mutex;
+};
+
+} //namespace gl
@@ -0,0 +1,27 @@
+/**
+ * @file mapped_file.h
+ */
+
+#pragma once
+
+namespace gl {
+
+/**
+ * Read only view of a file mapped into memory, pages are loaded by the OS on first access.
+ * The view stays valid for the lifetime of the object.
+ */
+class GL_API MappedFile {
+public:
+	virtual ~MappedFile() = default;
+
+	virtual const uint8_t* data() const = 0;
+
+	virtual size_t size() const = 0;
+
+	std::span<const uint8_t> get_view() const { return { data(), size() }; }
+
+	// Returns null if the file could not be opened or mapped.
+	static std::unique_ptr<MappedFile> open(const fs::path& p_path);
+};
+
+} //namespace gl
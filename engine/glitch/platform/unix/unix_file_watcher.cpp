@@ -0,0 +1,133 @@
+#if !defined(GL_PLATFORM_LINUX)
+#error "Unix platform specific code can not run on this system."
+#else
+
+#include "glitch/platform/file_watcher.h"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace gl {
+
+/**
+ * Watches parent directories of the files rather than the files themselves, editors
+ * usually save by replacing the file which would invalidate a watch on it.
+ */
+class InotifyFileWatcher : public FileWatcher {
+public:
+	InotifyFileWatcher(int p_fd) : fd(p_fd) {}
+
+	~InotifyFileWatcher() { close(fd); }
+
+	void watch(const fs::path& p_path) override {
+		std::lock_guard lock(mutex);
+
+		const std::string dir_path = p_path.parent_path().string();
+
+		auto it = directories.find(dir_path);
+		if (it == directories.end()) {
+			const int wd = inotify_add_watch(fd, dir_path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if (wd < 0) {
+				GL_LOG_WARNING("[InotifyFileWatcher::watch] Unable to watch directory '{}'",
+						dir_path);
+				return;
+			}
+
+			it = directories.emplace(dir_path, WatchedDirectory{ wd, {} }).first;
+			watch_descriptors[wd] = dir_path;
+		}
+
+		it->second.files[p_path.filename().string()]++;
+	}
+
+	void unwatch(const fs::path& p_path) override {
+		std::lock_guard lock(mutex);
+
+		const auto dir_it = directories.find(p_path.parent_path().string());
+		if (dir_it == directories.end()) {
+			return;
+		}
+
+		WatchedDirectory& dir = dir_it->second;
+
+		const auto file_it = dir.files.find(p_path.filename().string());
+		if (file_it == dir.files.end() || --file_it->second > 0) {
+			return;
+		}
+
+		dir.files.erase(file_it);
+
+		if (dir.files.empty()) {
+			inotify_rm_watch(fd, dir.wd);
+			watch_descriptors.erase(dir.wd);
+			directories.erase(dir_it);
+		}
+	}
+
+	std::vector<fs::path> wait(std::chrono::milliseconds p_timeout) override {
+		pollfd pfd = { fd, POLLIN, 0 };
+		if (poll(&pfd, 1, int(p_timeout.count())) <= 0) {
+			return {};
+		}
+
+		alignas(inotify_event) char buffer[4096];
+
+		std::vector<fs::path> changed;
+
+		std::lock_guard lock(mutex);
+
+		ssize_t len;
+		while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+			for (char* ptr = buffer; ptr < buffer + len;) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+
+				const auto wd_it = watch_descriptors.find(event->wd);
+				if (wd_it == watch_descriptors.end() || event->len == 0) {
+					continue;
+				}
+
+				// Other files of the directory are not of interest
+				const WatchedDirectory& dir = directories.at(wd_it->second);
+				if (!dir.files.contains(event->name)) {
+					continue;
+				}
+
+				fs::path path = fs::path(wd_it->second) / event->name;
+				if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+					changed.push_back(std::move(path));
+				}
+			}
+		}
+
+		return changed;
+	}
+
+private:
+	struct WatchedDirectory {
+		int wd;
+		// file name, watch count map
+		std::unordered_map<std::string, uint32_t> files;
+	};
+
+	int fd;
+	std::unordered_map<std::string, WatchedDirectory> directories;
+	std::unordered_map<int, std::string> watch_descriptors;
+	std::mutex mutex;
+};
+
+std::unique_ptr<FileWatcher> FileWatcher::create() {
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0) {
+		GL_LOG_WARNING("[FileWatcher::create] Unable to initialize inotify, falling back to "
+					   "polling.");
+		return std::make_unique<PollingFileWatcher>();
+	}
+
+	return std::make_unique<InotifyFileWatcher>(fd);
+}
+
+} //namespace gl
+
+#endif
@@ -0,0 +1,64 @@
+#if !defined(GL_PLATFORM_LINUX)
+#error "Unix platform specific code can not run on this system."
+#else
+
+#include "glitch/platform/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gl {
+
+class UnixMappedFile : public MappedFile {
+public:
+	UnixMappedFile(void* p_data, size_t p_size) : mapping(p_data), mapping_size(p_size) {}
+
+	~UnixMappedFile() {
+		if (mapping) {
+			munmap(mapping, mapping_size);
+		}
+	}
+
+	const uint8_t* data() const override { return static_cast<const uint8_t*>(mapping); }
+
+	size_t size() const override { return mapping_size; }
+
+private:
+	void* mapping;
+	size_t mapping_size;
+};
+
+std::unique_ptr<MappedFile> MappedFile::open(const fs::path& p_path) {
+	const int fd = ::open(p_path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return nullptr;
+	}
+
+	// Mapping an empty file fails, represent it with an empty view instead
+	if (st.st_size == 0) {
+		close(fd);
+		return std::make_unique<UnixMappedFile>(nullptr, 0);
+	}
+
+	void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping holds its own reference to the file
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return nullptr;
+	}
+
+	return std::make_unique<UnixMappedFile>(data, size_t(st.st_size));
+}
+
+} //namespace gl
+
+#endif
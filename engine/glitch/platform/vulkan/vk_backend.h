@@ -49,6 +49,8 @@ public:
 
 	BufferDeviceAddress buffer_get_device_address(Buffer p_buffer) override;
 
+	uint64_t buffer_get_allocation_size(Buffer p_buffer) override;
+
 	uint8_t* buffer_map(Buffer p_buffer) override;
 
 	void buffer_unmap(Buffer p_buffer) override;
@@ -62,12 +64,15 @@ public:
 		VkExtent3D image_extent;
 		VkFormat image_format;
 		uint32_t mip_levels;
+		uint64_t allocation_size;
 	};
 
 	Image image_create(DataFormat p_format, glm::uvec2 p_size, const void* p_data = nullptr,
 			BitField<ImageUsageBits> p_usage = IMAGE_USAGE_SAMPLED_BIT, bool p_mipmapped = false,
 			uint32_t p_samples = 1) override;
 
+	std::vector<Image> image_create_batch(std::span<const ImageUploadInfo> p_infos) override;
+
 	void image_free(Image p_image) override;
 
 	glm::uvec3 image_get_size(Image p_image) override;
@@ -76,6 +81,8 @@ public:
 
 	uint32_t image_get_mip_levels(Image p_image) override;
 
+	uint64_t image_get_allocation_size(Image p_image) override;
+
 	Sampler sampler_create(ImageFiltering p_min_filter = ImageFiltering::LINEAR,
 			ImageFiltering p_mag_filter = ImageFiltering::LINEAR,
 			ImageWrappingMode p_wrap_u = ImageWrappingMode::CLAMP_TO_EDGE,
@@ -192,6 +199,8 @@ public:
 
 	void fence_reset(Fence p_fence) override;
 
+	bool fence_is_signaled(Fence p_fence) override;
+
 	Semaphore semaphore_create() override;
 
 	void semaphore_free(Semaphore p_semaphore) override;
@@ -237,6 +246,8 @@ public:
 			Semaphore p_wait_semaphore = GL_NULL_HANDLE,
 			Semaphore p_signal_semaphore = GL_NULL_HANDLE) override;
 
+	void queue_wait_idle(CommandQueue p_queue) override;
+
 	bool queue_present(CommandQueue p_queue, Swapchain p_swapchain,
 			Semaphore p_wait_semaphore = GL_NULL_HANDLE) override;
 
@@ -347,6 +358,10 @@ private:
 
 	void _generate_image_mipmaps(CommandBuffer p_cmd, Image p_image, glm::uvec2 p_size);
 
+	// Copy the pixels at `p_src_offset` into the image and leave it ready for sampling.
+	void _record_image_upload(CommandBuffer p_cmd, Image p_image, Buffer p_src,
+			uint64_t p_src_offset, glm::uvec2 p_size, bool p_mipmapped);
+
 	void _swapchain_release(VulkanSwapchain* p_swapchain);
 
 	VmaPool _find_or_create_small_allocs_pool(uint32_t p_mem_type_index);
@@ -380,8 +395,11 @@ private:
 
 	VmaAllocator allocator = nullptr;
 	std::unordered_map<uint32_t, VmaPool> small_allocs_pools;
+	std::mutex small_allocs_pools_mutex;
 
+	// Guards the pools along with the descriptor sets allocated from them.
 	DescriptorSetPools descriptor_set_pools;
+	std::mutex descriptor_set_pools_mutex;
 
 	PagedAllocator<VersatileResource> resources_allocator;
 
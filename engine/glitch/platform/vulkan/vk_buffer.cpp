@@ -90,6 +90,11 @@ BufferDeviceAddress VulkanRenderBackend::buffer_get_device_address(
 	return vkGetBufferDeviceAddress(device, &info);
 }
 
+uint64_t VulkanRenderBackend::buffer_get_allocation_size(Buffer p_buffer) {
+	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
+	return buffer->allocation.size;
+}
+
 uint8_t* VulkanRenderBackend::buffer_map(Buffer p_buffer) {
 	VulkanBuffer* buffer = (VulkanBuffer*)p_buffer;
 
@@ -107,6 +112,8 @@ void VulkanRenderBackend::buffer_unmap(Buffer p_buffer) {
 
 VmaPool VulkanRenderBackend::_find_or_create_small_allocs_pool(
 		uint32_t p_mem_type_index) {
+	std::lock_guard lock(small_allocs_pools_mutex);
+
 	if (small_allocs_pools.find(p_mem_type_index) != small_allocs_pools.end()) {
 		return small_allocs_pools[p_mem_type_index];
 	}
@@ -60,8 +60,9 @@ Image VulkanRenderBackend::_image_create(VkFormat p_format, VkExtent3D p_size,
 	// allocate and create the image
 	VkImage vk_image = VK_NULL_HANDLE;
 	VmaAllocation vma_allocation = {};
+	VmaAllocationInfo vma_allocation_info = {};
 	VK_CHECK(vmaCreateImage(allocator, &img_info, &alloc_info, &vk_image,
-			&vma_allocation, nullptr));
+			&vma_allocation, &vma_allocation_info));
 
 	// if the format is a depth format, we will need to have it use the correct
 	// aspect flag
@@ -96,6 +97,7 @@ Image VulkanRenderBackend::_image_create(VkFormat p_format, VkExtent3D p_size,
 	image->image_extent = p_size;
 	image->image_format = p_format;
 	image->mip_levels = mip_levels;
+	image->allocation_size = vma_allocation_info.size;
 
 	return Image(image);
 }
@@ -132,6 +134,39 @@ void VulkanRenderBackend::_generate_image_mipmaps(
 			ImageLayout::SHADER_READ_ONLY_OPTIMAL, mip_levels - 1, 1);
 }
 
+void VulkanRenderBackend::_record_image_upload(CommandBuffer p_cmd,
+		Image p_image, Buffer p_src, uint64_t p_src_offset, glm::uvec2 p_size,
+		bool p_mipmapped) {
+	command_transition_image(p_cmd, p_image, ImageLayout::UNDEFINED,
+			ImageLayout::TRANSFER_DST_OPTIMAL);
+
+	BufferImageCopyRegion copy_region = {};
+	copy_region.buffer_offset = p_src_offset;
+	copy_region.buffer_row_length = 0;
+	copy_region.buffer_image_height = 0;
+	copy_region.image_subresource = {};
+	copy_region.image_subresource.aspect_mask = IMAGE_ASPECT_COLOR_BIT;
+	copy_region.image_subresource.mip_level = 0;
+	copy_region.image_subresource.base_array_layer = 0;
+	copy_region.image_subresource.layer_count = 1;
+	copy_region.image_extent = { p_size.x, p_size.y, 1 };
+	copy_region.image_offset = { 0, 0, 0 };
+
+	VectorView<BufferImageCopyRegion> copy_view(copy_region);
+
+	// copy the buffer into the image
+	command_copy_buffer_to_image(p_cmd, p_src, p_image, copy_view);
+
+	// generate mipmaps
+	if (p_mipmapped) {
+		_generate_image_mipmaps(p_cmd, p_image, p_size);
+	} else {
+		command_transition_image(p_cmd, p_image,
+				ImageLayout::TRANSFER_DST_OPTIMAL,
+				ImageLayout::SHADER_READ_ONLY_OPTIMAL);
+	}
+}
+
 Image VulkanRenderBackend::image_create(DataFormat p_format, glm::uvec2 p_size,
 		const void* p_data, BitField<ImageUsageBits> p_usage, bool p_mipmapped,
 		uint32_t p_samples) {
@@ -165,37 +200,8 @@ Image VulkanRenderBackend::image_create(DataFormat p_format, glm::uvec2 p_size,
 
 		command_immediate_submit(
 				[&](CommandBuffer p_cmd) {
-					command_transition_image(p_cmd, new_image,
-							ImageLayout::UNDEFINED,
-							ImageLayout::TRANSFER_DST_OPTIMAL);
-
-					BufferImageCopyRegion copy_region = {};
-					copy_region.buffer_offset = 0;
-					copy_region.buffer_row_length = 0;
-					copy_region.buffer_image_height = 0;
-					copy_region.image_subresource = {};
-					copy_region.image_subresource.aspect_mask =
-							IMAGE_ASPECT_COLOR_BIT;
-					copy_region.image_subresource.mip_level = 0;
-					copy_region.image_subresource.base_array_layer = 0;
-					copy_region.image_subresource.layer_count = 1;
-					copy_region.image_extent = { p_size.x, p_size.y, 1 };
-					copy_region.image_offset = { 0, 0, 0 };
-
-					VectorView<BufferImageCopyRegion> copy_view(copy_region);
-
-					// copy the buffer into the image
-					command_copy_buffer_to_image(
-							p_cmd, staging_buffer, new_image, copy_view);
-
-					// generate mipmaps
-					if (p_mipmapped) {
-						_generate_image_mipmaps(p_cmd, new_image, p_size);
-					} else {
-						command_transition_image(p_cmd, new_image,
-								ImageLayout::TRANSFER_DST_OPTIMAL,
-								ImageLayout::SHADER_READ_ONLY_OPTIMAL);
-					}
+					_record_image_upload(p_cmd, new_image, staging_buffer, 0,
+							p_size, p_mipmapped);
 				},
 				QueueType::GRAPHICS);
 
@@ -205,6 +211,60 @@ Image VulkanRenderBackend::image_create(DataFormat p_format, glm::uvec2 p_size,
 	}
 }
 
+std::vector<Image> VulkanRenderBackend::image_create_batch(
+		std::span<const ImageUploadInfo> p_infos) {
+	std::vector<Image> images;
+	if (p_infos.empty()) {
+		return images;
+	}
+	images.reserve(p_infos.size());
+
+	// Pack the pixels of every image into one staging buffer
+	std::vector<uint64_t> offsets(p_infos.size());
+	uint64_t staging_size = 0;
+	for (size_t i = 0; i < p_infos.size(); i++) {
+		// Copies must be aligned to the texel size, 16 covers every format
+		offsets[i] = (staging_size + 15) & ~uint64_t(15);
+		staging_size = offsets[i] +
+				uint64_t(p_infos[i].size.x) * p_infos[i].size.y *
+						get_data_format_size(p_infos[i].format);
+	}
+
+	Buffer staging_buffer = buffer_create(staging_size,
+			BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocationType::CPU);
+
+	uint8_t* mapped_data = buffer_map(staging_buffer);
+	for (size_t i = 0; i < p_infos.size(); i++) {
+		const ImageUploadInfo& info = p_infos[i];
+
+		memcpy(mapped_data + offsets[i], info.data,
+				size_t(info.size.x) * info.size.y *
+						get_data_format_size(info.format));
+
+		const VkImageUsageFlags image_usage = VK_IMAGE_USAGE_SAMPLED_BIT |
+				VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+				VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+		images.push_back(_image_create(static_cast<VkFormat>(info.format),
+				{ info.size.x, info.size.y, 1 }, image_usage, info.mipmapped,
+				VK_SAMPLE_COUNT_1_BIT));
+	}
+	buffer_unmap(staging_buffer);
+
+	command_immediate_submit(
+			[&](CommandBuffer p_cmd) {
+				for (size_t i = 0; i < p_infos.size(); i++) {
+					_record_image_upload(p_cmd, images[i], staging_buffer,
+							offsets[i], p_infos[i].size, p_infos[i].mipmapped);
+				}
+			},
+			QueueType::GRAPHICS);
+
+	buffer_free(staging_buffer);
+
+	return images;
+}
+
 void VulkanRenderBackend::image_free(Image p_image) {
 	VulkanImage* image = (VulkanImage*)p_image;
 
@@ -232,6 +292,11 @@ uint32_t VulkanRenderBackend::image_get_mip_levels(Image p_image) {
 	return image->mip_levels;
 }
 
+uint64_t VulkanRenderBackend::image_get_allocation_size(Image p_image) {
+	VulkanImage* image = (VulkanImage*)p_image;
+	return image->allocation_size;
+}
+
 Sampler VulkanRenderBackend::sampler_create(ImageFiltering p_min_filter,
 		ImageFiltering p_mag_filter, ImageWrappingMode p_wrap_u,
 		ImageWrappingMode p_wrap_v, ImageWrappingMode p_wrap_w,
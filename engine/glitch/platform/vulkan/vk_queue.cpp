@@ -70,6 +70,15 @@ void VulkanRenderBackend::queue_submit(CommandQueue p_queue,
 	VK_CHECK(vkQueueSubmit2(queue->queue, 1, &submit_info, (VkFence)p_fence));
 }
 
+void VulkanRenderBackend::queue_wait_idle(CommandQueue p_queue) {
+	VulkanQueue* queue = (VulkanQueue*)p_queue;
+
+	// Lock queue for thread safe access
+	std::lock_guard<std::mutex> lock(queue->mutex);
+
+	VK_CHECK(vkQueueWaitIdle(queue->queue));
+}
+
 bool VulkanRenderBackend::queue_present(CommandQueue p_queue,
 		Swapchain p_swapchain, Semaphore p_wait_semaphore) {
 	VulkanSwapchain* swapchain = (VulkanSwapchain*)p_swapchain;
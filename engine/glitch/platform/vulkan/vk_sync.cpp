@@ -26,6 +26,10 @@ void VulkanRenderBackend::fence_reset(Fence p_fence) {
 	VK_CHECK(vkResetFences(device, 1, (VkFence*)&p_fence));
 }
 
+bool VulkanRenderBackend::fence_is_signaled(Fence p_fence) {
+	return vkGetFenceStatus(device, (VkFence)p_fence) == VK_SUCCESS;
+}
+
 Semaphore VulkanRenderBackend::semaphore_create() {
 	VkSemaphoreCreateInfo create_info = {};
 	create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -119,6 +119,9 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 		pool_key.uniform_type[uniform.type] += num_descriptors;
 	}
 
+	// Pools are shared, and descriptor pools must be externally synchronized.
+	std::unique_lock pools_lock(descriptor_set_pools_mutex);
+
 	// Need a descriptor pool.
 	VkDescriptorPool vk_pool = (VkDescriptorPool)_uniform_pool_find_or_create(pool_key);
 	GL_ASSERT(vk_pool);
@@ -144,6 +147,8 @@ UniformSet VulkanRenderBackend::uniform_set_create(
 		return UniformSet();
 	}
 
+	pools_lock.unlock();
+
 	for (const auto& img_info : vk_image_infos) {
 		vk_writes[img_info.first].pImageInfo = img_info.second.data();
 	}
@@ -174,9 +179,13 @@ void VulkanRenderBackend::uniform_set_free(UniformSet p_uniform_set) {
 
 	VulkanUniformSet* usi = (VulkanUniformSet*)p_uniform_set;
 
-	vkFreeDescriptorSets(device, usi->vk_descriptor_pool, 1, &usi->vk_descriptor_set);
+	{
+		std::lock_guard lock(descriptor_set_pools_mutex);
 
-	_uniform_pool_unreference(usi->pool_key, usi->vk_descriptor_pool);
+		vkFreeDescriptorSets(device, usi->vk_descriptor_pool, 1, &usi->vk_descriptor_set);
+
+		_uniform_pool_unreference(usi->pool_key, usi->vk_descriptor_pool);
+	}
 
 	VersatileResource::free(resources_allocator, usi);
 }
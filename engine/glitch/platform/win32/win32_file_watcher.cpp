@@ -0,0 +1,15 @@
+#if !defined(GL_PLATFORM_WINDOWS)
+#error "Windows platform specific code can not run on this system."
+#else
+
+#include "glitch/platform/file_watcher.h"
+
+namespace gl {
+
+std::unique_ptr<FileWatcher> FileWatcher::create() {
+	return std::make_unique<PollingFileWatcher>();
+}
+
+} //namespace gl
+
+#endif
@@ -0,0 +1,68 @@
+#if !defined(GL_PLATFORM_WINDOWS)
+#error "Windows platform specific code can not run on this system."
+#else
+
+#include "glitch/platform/mapped_file.h"
+
+#include <windows.h>
+
+namespace gl {
+
+class Win32MappedFile : public MappedFile {
+public:
+	Win32MappedFile(const void* p_data, size_t p_size) : view(p_data), view_size(p_size) {}
+
+	~Win32MappedFile() {
+		if (view) {
+			UnmapViewOfFile(view);
+		}
+	}
+
+	const uint8_t* data() const override { return static_cast<const uint8_t*>(view); }
+
+	size_t size() const override { return view_size; }
+
+private:
+	const void* view;
+	size_t view_size;
+};
+
+std::unique_ptr<MappedFile> MappedFile::open(const fs::path& p_path) {
+	HANDLE file = CreateFileW(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size)) {
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	// Mapping an empty file fails, represent it with an empty view instead
+	if (file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return std::make_unique<Win32MappedFile>(nullptr, 0);
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) {
+		return nullptr;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	// The view holds its own reference to the mapping
+	CloseHandle(mapping);
+
+	if (!view) {
+		return nullptr;
+	}
+
+	return std::make_unique<Win32MappedFile>(view, size_t(file_size.QuadPart));
+}
+
+} //namespace gl
+
+#endif
@@ -0,0 +1,340 @@
+#include "glitch/renderer/geometry_arena.h"
+
+#include "glitch/renderer/render_backend.h"
+#include "glitch/renderer/renderer.h"
+
+namespace gl {
+
+// Vertex ranges are read through buffer references, which are 16 byte aligned
+static uint64_t _get_alignment(GeometryBufferType p_type) {
+	return p_type == GeometryBufferType::VERTEX ? 16 : sizeof(uint32_t);
+}
+
+void GeometryArena::init(uint64_t p_vertex_capacity, uint64_t p_index_capacity) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	GL_ASSERT(!s_initialized, "Geometry arena is already initialized!");
+
+	const uint64_t capacities[] = { p_vertex_capacity, p_index_capacity };
+	for (uint32_t i = 0; i < s_pools.size(); i++) {
+		const GeometryBufferType type = static_cast<GeometryBufferType>(i);
+
+		Pool& pool = s_pools[i];
+		pool.allocator = RangeAllocator(capacities[i]);
+		_replace_buffer(type, _create_buffer(type, capacities[i]));
+	}
+
+	s_initialized = true;
+}
+
+void GeometryArena::destroy() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_initialized) {
+		return;
+	}
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	for (Pool& pool : s_pools) {
+		backend->buffer_free(pool.buffer);
+		pool = Pool{};
+	}
+
+	for (Buffer buffer : s_retired_buffers) {
+		backend->buffer_free(buffer);
+	}
+	s_retired_buffers.clear();
+
+	if (s_ranges.size() != s_free_range_ids.size()) {
+		GL_LOG_WARNING("[GEOMETRY_ARENA] {} ranges are still allocated on destruction.",
+				s_ranges.size() - s_free_range_ids.size());
+	}
+
+	s_ranges.clear();
+	s_free_range_ids.clear();
+
+	s_initialized = false;
+}
+
+bool GeometryArena::is_initialized() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return s_initialized;
+}
+
+GeometryRange GeometryArena::allocate(GeometryBufferType p_type, uint64_t p_size) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	GL_ASSERT(s_initialized, "Geometry arena is not initialized!");
+
+	Pool& pool = s_pools[static_cast<uint32_t>(p_type)];
+	const uint64_t alignment = _get_alignment(p_type);
+
+	std::optional<uint64_t> offset = pool.allocator.allocate(p_size, alignment);
+	if (!offset && _grow(p_type, p_size + alignment)) {
+		offset = pool.allocator.allocate(p_size, alignment);
+	}
+
+	if (!offset) {
+		GL_LOG_ERROR("[GEOMETRY_ARENA] Unable to allocate {} bytes.", p_size);
+		return {};
+	}
+
+	uint32_t id;
+	if (!s_free_range_ids.empty()) {
+		id = s_free_range_ids.back();
+		s_free_range_ids.pop_back();
+	} else {
+		id = s_ranges.size();
+		s_ranges.emplace_back();
+	}
+
+	s_ranges[id] = { p_type, *offset, p_size };
+
+	return { id };
+}
+
+void GeometryArena::free(GeometryRange p_range) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_initialized || !p_range.is_valid()) {
+		return;
+	}
+
+	const RangeEntry& entry = s_ranges[p_range.id];
+	s_pools[static_cast<uint32_t>(entry.type)].allocator.free(entry.offset);
+
+	s_free_range_ids.push_back(p_range.id);
+}
+
+void GeometryArena::upload(Buffer p_src, std::span<const GeometryCopy> p_copies) {
+	GL_PROFILE_SCOPE;
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	// Held through the submit so the ranges can not move in the meantime
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	backend->command_immediate_submit(
+			[&](CommandBuffer p_cmd) { _record_copies(p_cmd, p_src, p_copies, true); });
+}
+
+void GeometryArena::submit_upload(CommandBuffer p_cmd, Fence p_fence, Buffer p_src,
+		std::span<const GeometryCopy> p_copies) {
+	GL_PROFILE_SCOPE;
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	// Submitted before the lock is released so that moves of the buffers wait for it
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	_record_copies(p_cmd, p_src, p_copies, true);
+	backend->command_end(p_cmd);
+
+	backend->queue_submit(backend->queue_get(QueueType::TRANSFER), p_cmd, p_fence);
+}
+
+void GeometryArena::download(Buffer p_dst, std::span<const GeometryCopy> p_copies) {
+	GL_PROFILE_SCOPE;
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	backend->command_immediate_submit(
+			[&](CommandBuffer p_cmd) { _record_copies(p_cmd, p_dst, p_copies, false); });
+}
+
+Buffer GeometryArena::get_buffer(GeometryBufferType p_type) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return s_pools[static_cast<uint32_t>(p_type)].buffer;
+}
+
+uint64_t GeometryArena::get_offset(GeometryRange p_range) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return s_ranges[p_range.id].offset;
+}
+
+uint64_t GeometryArena::get_size(GeometryRange p_range) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return s_ranges[p_range.id].size;
+}
+
+BufferDeviceAddress GeometryArena::get_device_address(GeometryRange p_range) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	const RangeEntry& entry = s_ranges[p_range.id];
+	GL_ASSERT(entry.type == GeometryBufferType::VERTEX,
+			"Only vertex ranges can be accessed through device addresses!");
+
+	return s_pools[static_cast<uint32_t>(entry.type)].address + entry.offset;
+}
+
+void GeometryArena::compact() {
+	GL_PROFILE_SCOPE;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_initialized) {
+		return;
+	}
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	_wait_uploads();
+
+	std::vector<bool> free_ids(s_ranges.size(), false);
+	for (uint32_t id : s_free_range_ids) {
+		free_ids[id] = true;
+	}
+
+	for (uint32_t i = 0; i < s_pools.size(); i++) {
+		const GeometryBufferType type = static_cast<GeometryBufferType>(i);
+		Pool& pool = s_pools[i];
+
+		std::vector<uint32_t> ids;
+		for (uint32_t id = 0; id < s_ranges.size(); id++) {
+			if (!free_ids[id] && s_ranges[id].type == type) {
+				ids.push_back(id);
+			}
+		}
+
+		// Keeping the order makes the new offsets a prefix sum of the sizes
+		std::sort(ids.begin(), ids.end(), [](uint32_t p_lhs, uint32_t p_rhs) {
+			return s_ranges[p_lhs].offset < s_ranges[p_rhs].offset;
+		});
+
+		const uint64_t capacity = pool.allocator.get_size();
+		RangeAllocator allocator(capacity);
+
+		std::vector<BufferCopyRegion> regions;
+		regions.reserve(ids.size());
+
+		for (uint32_t id : ids) {
+			RangeEntry& entry = s_ranges[id];
+
+			const uint64_t offset = *allocator.allocate(entry.size, _get_alignment(type));
+			regions.push_back({ entry.offset, offset, entry.size });
+
+			entry.offset = offset;
+		}
+
+		Buffer buffer = _create_buffer(type, capacity);
+		if (!regions.empty()) {
+			backend->command_immediate_submit([&](CommandBuffer p_cmd) {
+				backend->command_copy_buffer(p_cmd, pool.buffer, buffer, regions);
+			});
+		}
+
+		_replace_buffer(type, buffer);
+		pool.allocator = std::move(allocator);
+	}
+}
+
+GeometryArenaStats GeometryArena::get_stats() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	const Pool& vertex_pool = s_pools[static_cast<uint32_t>(GeometryBufferType::VERTEX)];
+	const Pool& index_pool = s_pools[static_cast<uint32_t>(GeometryBufferType::INDEX)];
+
+	return {
+		.vertex_capacity = vertex_pool.allocator.get_size(),
+		.vertex_used = vertex_pool.allocator.get_used_size(),
+		.index_capacity = index_pool.allocator.get_size(),
+		.index_used = index_pool.allocator.get_used_size(),
+		.range_count = uint32_t(s_ranges.size() - s_free_range_ids.size()),
+	};
+}
+
+std::vector<Buffer> GeometryArena::take_retired_buffers() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return std::exchange(s_retired_buffers, {});
+}
+
+Buffer GeometryArena::_create_buffer(GeometryBufferType p_type, uint64_t p_size) {
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	BitField<BufferUsageBits> usage =
+			BUFFER_USAGE_TRANSFER_DST_BIT | BUFFER_USAGE_TRANSFER_SRC_BIT;
+	if (p_type == GeometryBufferType::VERTEX) {
+		usage.set_flag(BUFFER_USAGE_STORAGE_BUFFER_BIT);
+		usage.set_flag(BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+	} else {
+		usage.set_flag(BUFFER_USAGE_INDEX_BUFFER_BIT);
+	}
+
+	return backend->buffer_create(p_size, usage, MemoryAllocationType::GPU);
+}
+
+void GeometryArena::_replace_buffer(GeometryBufferType p_type, Buffer p_buffer) {
+	Pool& pool = s_pools[static_cast<uint32_t>(p_type)];
+
+	// Frames in flight might still read the old buffer
+	if (pool.buffer != GL_NULL_HANDLE) {
+		s_retired_buffers.push_back(pool.buffer);
+	}
+
+	pool.buffer = p_buffer;
+	pool.address = p_type == GeometryBufferType::VERTEX
+			? Renderer::get_backend()->buffer_get_device_address(p_buffer)
+			: 0;
+}
+
+bool GeometryArena::_grow(GeometryBufferType p_type, uint64_t p_min_free_size) {
+	GL_PROFILE_SCOPE;
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	Pool& pool = s_pools[static_cast<uint32_t>(p_type)];
+
+	const uint64_t size = pool.allocator.get_size();
+	const uint64_t new_size = std::max(size * 2, size + p_min_free_size);
+
+	Buffer buffer = _create_buffer(p_type, new_size);
+	if (buffer == GL_NULL_HANDLE) {
+		return false;
+	}
+
+	_wait_uploads();
+
+	backend->command_immediate_submit([&](CommandBuffer p_cmd) {
+		backend->command_copy_buffer(p_cmd, pool.buffer, buffer, BufferCopyRegion{ 0, 0, size });
+	});
+
+	_replace_buffer(p_type, buffer);
+	pool.allocator.grow(new_size);
+
+	GL_LOG_TRACE("[GEOMETRY_ARENA] Grown {} buffer to {} bytes.",
+			p_type == GeometryBufferType::VERTEX ? "vertex" : "index", new_size);
+
+	return true;
+}
+
+void GeometryArena::_record_copies(CommandBuffer p_cmd, Buffer p_buffer,
+		std::span<const GeometryCopy> p_copies, bool p_upload) {
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	for (const GeometryCopy& copy : p_copies) {
+		GL_ASSERT(copy.range.is_valid(), "Copy of an invalid range!");
+
+		const RangeEntry& entry = s_ranges[copy.range.id];
+		GL_ASSERT(copy.size <= entry.size, "Copy is out of the bounds of the range!");
+
+		Buffer arena_buffer = s_pools[static_cast<uint32_t>(entry.type)].buffer;
+
+		if (p_upload) {
+			backend->command_copy_buffer(p_cmd, p_buffer, arena_buffer,
+					BufferCopyRegion{ copy.buffer_offset, entry.offset, copy.size });
+		} else {
+			backend->command_copy_buffer(p_cmd, arena_buffer, p_buffer,
+					BufferCopyRegion{ entry.offset, copy.buffer_offset, copy.size });
+		}
+	}
+}
+
+void GeometryArena::_wait_uploads() {
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+	backend->queue_wait_idle(backend->queue_get(QueueType::TRANSFER));
+}
+
+} //namespace gl
@@ -0,0 +1,147 @@
+/**
+ * @file geometry_arena.h
+ *
+ */
+
+#pragma once
+
+#include "glitch/core/memory/range_allocator.h"
+#include "glitch/renderer/types.h"
+
+namespace gl {
+
+constexpr uint64_t GEOMETRY_ARENA_VERTEX_CAPACITY = 64ull * 1024 * 1024;
+constexpr uint64_t GEOMETRY_ARENA_INDEX_CAPACITY = 16ull * 1024 * 1024;
+
+enum class GeometryBufferType : uint32_t {
+	VERTEX,
+	INDEX,
+};
+
+/**
+ * Handle of a range within one of the buffers of `GeometryArena`. Ranges move when the
+ * buffers grow or get compacted, so offsets are looked up through the handle.
+ */
+struct GeometryRange {
+	uint32_t id = UINT32_MAX;
+
+	bool is_valid() const { return id != UINT32_MAX; }
+};
+
+// Copy between the start of a range and an offset of another buffer.
+struct GeometryCopy {
+	GeometryRange range;
+	uint64_t buffer_offset;
+	uint64_t size;
+};
+
+struct GeometryArenaStats {
+	uint64_t vertex_capacity;
+	uint64_t vertex_used;
+	uint64_t index_capacity;
+	uint64_t index_used;
+	uint32_t range_count;
+};
+
+/**
+ * Large device local vertex and index buffers that every mesh sub-allocates its geometry
+ * from, instead of creating a pair of buffers for each one. Vertices are read through the
+ * device address of their range and indices by binding the index buffer at its offset.
+ *
+ * The buffers double in size when they run out of space and `compact` packs the ranges
+ * together. Both wait for the uploads on the transfer queue and replace the buffers, the
+ * old ones are handed to the renderer through `take_retired_buffers` so frames in flight
+ * can finish with them.
+ *
+ * Every method is thread safe.
+ */
+class GL_API GeometryArena {
+public:
+	static void init(uint64_t p_vertex_capacity = GEOMETRY_ARENA_VERTEX_CAPACITY,
+			uint64_t p_index_capacity = GEOMETRY_ARENA_INDEX_CAPACITY);
+
+	// Free the buffers, the device must be idle.
+	static void destroy();
+
+	static bool is_initialized();
+
+	// Returns an invalid range if the buffer can not grow any further.
+	static GeometryRange allocate(GeometryBufferType p_type, uint64_t p_size);
+
+	/**
+	 * Return the range to the arena, it is reused right away so the caller must make sure
+	 * the GPU is done with it. Does nothing if the arena is destroyed.
+	 */
+	static void free(GeometryRange p_range);
+
+	// Copy from `p_src` into the ranges and wait for the copies to finish.
+	static void upload(Buffer p_src, std::span<const GeometryCopy> p_copies);
+
+	/**
+	 * Record the copies from `p_src` into the ranges to `p_cmd`, which must be begun, and
+	 * submit it to the transfer queue without waiting. `p_fence` is signaled once the
+	 * copies are done.
+	 */
+	static void submit_upload(CommandBuffer p_cmd, Fence p_fence, Buffer p_src,
+			std::span<const GeometryCopy> p_copies);
+
+	// Copy the ranges into `p_dst` and wait for the copies to finish.
+	static void download(Buffer p_dst, std::span<const GeometryCopy> p_copies);
+
+	static Buffer get_buffer(GeometryBufferType p_type);
+
+	// Offset of the range within its buffer in bytes.
+	static uint64_t get_offset(GeometryRange p_range);
+
+	static uint64_t get_size(GeometryRange p_range);
+
+	// Device address of the start of a vertex range.
+	static BufferDeviceAddress get_device_address(GeometryRange p_range);
+
+	// Move the ranges to the start of the buffers, merging the gaps left by freed ones.
+	static void compact();
+
+	static GeometryArenaStats get_stats();
+
+	// Buffers replaced since the last call, to be freed once no frame uses them.
+	static std::vector<Buffer> take_retired_buffers();
+
+private:
+	struct Pool {
+		Buffer buffer;
+		BufferDeviceAddress address;
+		RangeAllocator allocator;
+	};
+
+	struct RangeEntry {
+		GeometryBufferType type;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	static Buffer _create_buffer(GeometryBufferType p_type, uint64_t p_size);
+
+	static void _replace_buffer(GeometryBufferType p_type, Buffer p_buffer);
+
+	static bool _grow(GeometryBufferType p_type, uint64_t p_min_free_size);
+
+	static void _record_copies(CommandBuffer p_cmd, Buffer p_buffer,
+			std::span<const GeometryCopy> p_copies, bool p_upload);
+
+	// Wait for the asynchronous uploads before the contents of the buffers are moved.
+	static void _wait_uploads();
+
+private:
+	inline static std::mutex s_mutex;
+	inline static bool s_initialized = false;
+
+	// Indexed by `GeometryBufferType`
+	inline static std::array<Pool, 2> s_pools = {};
+
+	inline static std::vector<RangeEntry> s_ranges;
+	inline static std::vector<uint32_t> s_free_range_ids;
+
+	inline static std::vector<Buffer> s_retired_buffers;
+};
+
+} //namespace gl
@@ -98,7 +98,8 @@ std::shared_ptr<MaterialDefinition> MaterialDefinition::create(
 			.add_shader_stage(ShaderStage::VERTEX, spirv_vert)
 			.add_shader_stage(ShaderStage::FRAGMENT, spirv_frag)
 			.with_multisample(Application::get()->get_renderer()->get_msaa_samples(), true)
-			.set_render_primitive(p_pipeline_options.primitive);
+			.set_render_primitive(p_pipeline_options.primitive)
+			.with_cull_mode(p_pipeline_options.cull_mode);
 
 	if (p_pipeline_options.depth_test) {
 		builder.with_depth_test(p_pipeline_options.compare_op, p_pipeline_options.depth_write);
@@ -143,6 +144,7 @@ bool MaterialDefinition::save(
 	j["pipeline"]["depth_write"] = p_definition->pipeline_options.depth_write;
 	j["pipeline"]["blend"] = p_definition->pipeline_options.blend;
 	j["pipeline"]["primitive"] = p_definition->pipeline_options.primitive;
+	j["pipeline"]["cull_mode"] = p_definition->pipeline_options.cull_mode;
 
 	j["uniforms"] = json::array();
 	for (const auto& uniform : p_definition->uniforms) {
@@ -169,7 +171,7 @@ bool MaterialDefinition::save(
 }
 
 std::shared_ptr<MaterialDefinition> MaterialDefinition::load(const fs::path& p_path) {
-	if (!fs::exists(p_path)) {
+	if (!AssetSystem::file_exists(p_path.string())) {
 		GL_LOG_ERROR("[MaterialDefinition::load] Unable to load material, given metadata path do "
 					 "not exists.");
 		return nullptr;
@@ -251,6 +253,9 @@ std::shared_ptr<MaterialDefinition> MaterialDefinition::load(const fs::path& p_p
 		if (j["pipeline"].contains("primitive")) {
 			j["pipeline"]["primitive"].get_to(pipeline_options.primitive);
 		}
+		if (j["pipeline"].contains("cull_mode")) {
+			j["pipeline"]["cull_mode"].get_to(pipeline_options.cull_mode);
+		}
 	}
 
 	std::vector<ShaderUniformMetadata> uniforms;
@@ -277,12 +282,14 @@ std::shared_ptr<MaterialDefinition> MaterialDefinition::load(const fs::path& p_p
 }
 
 Material::~Material() {
-	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
-
-	backend->device_wait();
-
-	backend->uniform_set_free(material_set);
-	backend->buffer_free(material_data_buffer);
+	// Frames in flight might still use the set
+	Renderer::defer_deletion(
+			[material_set = material_set, material_data_buffer = material_data_buffer]() {
+				std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+				backend->uniform_set_free(material_set);
+				backend->buffer_free(material_data_buffer);
+			});
 }
 
 std::shared_ptr<MaterialDefinition> Material::get_definition() const { return definition; }
@@ -321,12 +328,32 @@ bool Material::set_param(const std::string& p_name, ShaderUniformVariable p_valu
 	return true;
 }
 
-bool Material::is_dirty() const { return dirty; }
+std::vector<AssetHandle> Material::get_dependencies() const {
+	std::vector<AssetHandle> dependencies;
+	for (const auto& [_, param] : params) {
+		if (const auto handle = std::get_if<AssetHandle>(&param.second); handle && *handle) {
+			dependencies.push_back(*handle);
+		}
+	}
+
+	return dependencies;
+}
+
+void Material::on_dependency_reloaded() { dirty = true; }
+
+bool Material::is_dirty() const {
+	return dirty ||
+			std::any_of(pending_textures.begin(), pending_textures.end(),
+					[](const AssetHandle& p_handle) {
+						const auto state = AssetSystem::get_state<Texture>(p_handle);
+						return state != AssetLoadState::QUEUED && state != AssetLoadState::LOADING;
+					});
+}
 
 static AssetHandle _get_default_texture() {
 	static AssetHandle s_default_texture = INVALID_ASSET_HANDLE;
 	if (!s_default_texture || !AssetSystem::get<Texture>(s_default_texture)) {
-		s_default_texture = AssetSystem::register_asset(
+		s_default_texture = AssetSystem::register_asset_persistent(
 				Texture::create(COLOR_WHITE), "mem://texture/material_default");
 	}
 	return s_default_texture;
@@ -413,6 +440,8 @@ bool Material::upload() {
 	// Texture, binding
 	std::vector<std::pair<std::shared_ptr<Texture>, int>> textures;
 
+	pending_textures.clear();
+
 	std::vector<std::byte> cpu_buffer;
 
 	for (const auto& [name, pair] : params) {
@@ -421,8 +450,23 @@ bool Material::upload() {
 		if (meta.type == ShaderUniformVariableType::TEXTURE) {
 			AssetHandle texture_handle = std::get<AssetHandle>(value);
 
-			// Resolve pointer and store
-			if (auto texture = AssetSystem::get<Texture>(texture_handle)) {
+			// Resolve pointer and store, evicted textures are restored on demand
+			auto texture = AssetSystem::get<Texture>(texture_handle);
+			if (texture && !texture->make_resident()) {
+				texture = nullptr;
+			}
+
+			if (!texture) {
+				// Bind the default texture until the asset is ready
+				const auto state = AssetSystem::get_state<Texture>(texture_handle);
+				if (state == AssetLoadState::QUEUED || state == AssetLoadState::LOADING) {
+					pending_textures.push_back(texture_handle);
+				}
+
+				texture = AssetSystem::get<Texture>(_get_default_texture());
+			}
+
+			if (texture) {
 				textures.push_back(std::make_pair(texture, meta.binding));
 			}
 
@@ -451,11 +495,7 @@ bool Material::upload() {
 		std::visit(
 				[&cpu_buffer, &write_offset](auto&& arg) {
 					using T = std::decay_t<decltype(arg)>;
-					if constexpr (std::is_same_v<T, AssetHandle>) {
-						std::memcpy(cpu_buffer.data() + write_offset, &arg.get_value(), sizeof(T));
-					} else {
-						std::memcpy(cpu_buffer.data() + write_offset, &arg, sizeof(T));
-					}
+					std::memcpy(cpu_buffer.data() + write_offset, &arg, sizeof(T));
 				},
 				value);
 	}
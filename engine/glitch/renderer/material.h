@@ -50,6 +50,7 @@ struct MaterialPipelineOptions {
 	bool depth_write = true;
 	bool blend = false;
 	RenderPrimitive primitive = RenderPrimitive::LINE_LIST;
+	PolygonCullMode cull_mode = PolygonCullMode::DISABLED;
 };
 
 class GL_API MaterialDefinition {
@@ -114,6 +115,17 @@ public:
 	 */
 	bool set_param(const std::string& p_name, ShaderUniformVariable p_value);
 
+	/**
+	 * Textures sampled by the material, they are kept alive through the dependency graph.
+	 * `AssetSystem::update_dependencies<Material>` must be called after changing a texture
+	 * parameter of a registered material.
+	 */
+	std::vector<AssetHandle> get_dependencies() const;
+
+	// Rebind the textures on the next upload.
+	void on_dependency_reloaded();
+
+	// Returns true if a parameter changed or a texture still loading became ready.
 	bool is_dirty() const;
 
 	bool upload(); // upload to GPU buffer, descriptor sets, etc.
@@ -132,8 +144,12 @@ private:
 
 	std::map<std::string, std::pair<ShaderUniformMetadata, ShaderUniformVariable>> params;
 	bool dirty = false;
+
+	// Textures bound as placeholders until their asynchronous load finishes
+	std::vector<AssetHandle> pending_textures;
 };
 
 static_assert(IsCreatableAsset<Material, std::string>);
+static_assert(IsDependentAsset<Material>);
 
 } //namespace gl
@@ -1,5 +1,8 @@
 #include "glitch/renderer/mesh.h"
 
+#include "glitch/asset/asset_load_trace.h"
+#include "glitch/asset/asset_system.h"
+#include "glitch/renderer/mesh_processing.h"
 #include "glitch/renderer/render_backend.h"
 #include "glitch/renderer/renderer.h"
 
@@ -18,77 +21,216 @@ static AABB _get_aabb_from_vertices(const std::span<MeshVertex>& p_vertices) {
 }
 
 StaticMesh::~StaticMesh() {
-	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+	// Frames in flight might still read the ranges and a pending copy would write into them
+	// once they are reused
+	Renderer::defer_deletion([vertex_range = vertex_range, index_range = index_range,
+									 upload_value = upload_value]() {
+		UploadManager::wait(upload_value);
+
+		GeometryArena::free(vertex_range);
+		GeometryArena::free(index_range);
+	});
+}
+
+// Allocate the ranges of the mesh and queue the uploads, the mesh is pending until they are
+// complete
+static bool _upload_buffers(StaticMesh& p_mesh, const void* p_vertices, size_t p_vertex_size,
+		const void* p_indices, size_t p_index_size) {
+	p_mesh.vertex_range = GeometryArena::allocate(GeometryBufferType::VERTEX, p_vertex_size);
+	p_mesh.index_range = GeometryArena::allocate(GeometryBufferType::INDEX, p_index_size);
+
+	if (!p_mesh.vertex_range.is_valid() || !p_mesh.index_range.is_valid()) {
+		GeometryArena::free(p_mesh.vertex_range);
+		GeometryArena::free(p_mesh.index_range);
+
+		p_mesh.vertex_range = {};
+		p_mesh.index_range = {};
+
+		return false;
+	}
 
-	backend->device_wait();
+	// Copies larger than the ring are complete right away with a value of zero, so the
+	// later upload does not necessarily cover the earlier one
+	const UploadValue vertex_value =
+			UploadManager::upload(p_mesh.vertex_range, p_vertices, p_vertex_size);
+	const UploadValue index_value =
+			UploadManager::upload(p_mesh.index_range, p_indices, p_index_size);
+	p_mesh.upload_value = std::max(vertex_value, index_value);
 
-	backend->buffer_free(vertex_buffer);
-	backend->buffer_free(index_buffer);
+	p_mesh.memory_size = p_vertex_size + p_index_size;
+
+	return true;
 }
 
-std::shared_ptr<StaticMesh> StaticMesh::create(
-		const std::span<MeshVertex>& p_vertices, const std::span<uint32_t>& p_indices) {
-	if (p_vertices.empty() || p_indices.empty()) {
-		return nullptr;
+size_t StaticMesh::get_memory_size() const { return is_resident() ? memory_size : 0; }
+
+size_t StaticMesh::get_vertex_size() const {
+	return vertex_format == MeshVertexFormat::QUANTIZED ? sizeof(QuantizedMeshVertex)
+														: sizeof(MeshVertex);
+}
+
+size_t StaticMesh::get_index_size() const {
+	return index_type == IndexType::UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+bool StaticMesh::is_resident() const { return vertex_range.is_valid(); }
+
+bool StaticMesh::is_ready() const {
+	return is_resident() && UploadManager::is_complete(upload_value);
+}
+
+bool StaticMesh::evict() {
+	StaticMesh* const meshes[] = { this };
+	return evict_batch(meshes)[0];
+}
+
+std::vector<uint8_t> StaticMesh::evict_batch(std::span<StaticMesh* const> p_meshes) {
+	std::vector<uint8_t> results(p_meshes.size(), false);
+
+	// Vertices and indices of each mesh are packed one after another in the readback
+	std::vector<GeometryCopy> copies;
+	std::vector<size_t> offsets(p_meshes.size());
+	size_t readback_size = 0;
+
+	for (size_t i = 0; i < p_meshes.size(); i++) {
+		StaticMesh* mesh = p_meshes[i];
+		if (!mesh->is_resident()) {
+			continue;
+		}
+
+		const size_t vertex_size = mesh->vertex_count * mesh->get_vertex_size();
+		const size_t index_size = mesh->index_count * mesh->get_index_size();
+
+		UploadManager::wait(mesh->upload_value);
+
+		offsets[i] = readback_size;
+		copies.push_back({ mesh->vertex_range, readback_size, vertex_size });
+		copies.push_back({ mesh->index_range, readback_size + vertex_size, index_size });
+		readback_size += vertex_size + index_size;
+
+		results[i] = true;
+	}
+
+	if (copies.empty()) {
+		return results;
 	}
 
 	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
-	std::shared_ptr<StaticMesh> smesh = std::make_shared<StaticMesh>();
 
-	const size_t vertex_size = p_vertices.size() * sizeof(MeshVertex);
-	const size_t index_size = p_indices.size() * sizeof(uint32_t);
+	// Read the data back so that the meshes can be restored without their source
+	Buffer readback_buffer = backend->buffer_create(
+			readback_size, BUFFER_USAGE_TRANSFER_DST_BIT, MemoryAllocationType::CPU);
+
+	GeometryArena::download(readback_buffer, copies);
+
+	const uint8_t* mapped_data = backend->buffer_map(readback_buffer);
+
+	for (size_t i = 0; i < p_meshes.size(); i++) {
+		if (!results[i]) {
+			continue;
+		}
 
-	const size_t data_size = vertex_size + index_size;
+		StaticMesh* mesh = p_meshes[i];
 
-	Buffer staging_buffer = backend->buffer_create(
-			data_size, BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocationType::CPU);
+		const size_t size = mesh->vertex_count * mesh->get_vertex_size() +
+				mesh->index_count * mesh->get_index_size();
 
-	uint8_t* mapped_data = backend->buffer_map(staging_buffer);
-	{
-		// Copy vertex data
-		memcpy(mapped_data, p_vertices.data(), vertex_size);
+		mesh->evicted_data.resize(size);
+		memcpy(mesh->evicted_data.data(), mapped_data + offsets[i], size);
 
-		// Copy index data
-		memcpy(mapped_data + vertex_size, p_indices.data(), index_size);
+		// Frames in flight might still read the ranges
+		Renderer::defer_deletion(
+				[vertex_range = mesh->vertex_range, index_range = mesh->index_range]() {
+					GeometryArena::free(vertex_range);
+					GeometryArena::free(index_range);
+				});
+
+		mesh->vertex_range = {};
+		mesh->index_range = {};
 	}
-	backend->buffer_unmap(staging_buffer);
 
-	// Create vertex buffer
-	smesh->vertex_buffer = backend->buffer_create(p_vertices.size() * sizeof(MeshVertex),
-			BUFFER_USAGE_STORAGE_BUFFER_BIT | BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
-					BUFFER_USAGE_TRANSFER_DST_BIT,
-			MemoryAllocationType::GPU);
+	backend->buffer_unmap(readback_buffer);
+	backend->buffer_free(readback_buffer);
+
+	return results;
+}
+
+bool StaticMesh::make_resident() {
+	if (is_resident()) {
+		return true;
+	}
 
-	// Create index buffer
-	smesh->index_buffer = backend->buffer_create(p_indices.size() * sizeof(uint32_t),
-			BUFFER_USAGE_INDEX_BUFFER_BIT | BUFFER_USAGE_TRANSFER_DST_BIT,
-			MemoryAllocationType::GPU);
+	const size_t vertex_size = vertex_count * get_vertex_size();
+	const size_t index_size = index_count * get_index_size();
 
-	backend->command_immediate_submit([&](CommandBuffer p_cmd) {
-		BufferCopyRegion region;
+	if (!_upload_buffers(*this, evicted_data.data(), vertex_size,
+				evicted_data.data() + vertex_size, index_size)) {
+		return false;
+	}
 
-		// Copy vertex buffer
-		region.src_offset = 0;
-		region.size = vertex_size;
-		region.dst_offset = 0;
+	evicted_data.clear();
+	evicted_data.shrink_to_fit();
 
-		backend->command_copy_buffer(p_cmd, staging_buffer, smesh->vertex_buffer, region);
+	return true;
+}
 
-		// Copy index buffer
-		region.src_offset = vertex_size;
-		region.size = index_size;
-		region.dst_offset = 0;
+std::shared_ptr<StaticMesh> StaticMesh::create(const std::span<MeshVertex>& p_vertices,
+		const std::span<uint32_t>& p_indices, MeshVertexFormat p_format,
+		std::span<const MeshLod> p_lods) {
+	return create(p_vertices, p_indices, _get_aabb_from_vertices(p_vertices), p_format, p_lods);
+}
 
-		backend->command_copy_buffer(p_cmd, staging_buffer, smesh->index_buffer, region);
-	});
+std::shared_ptr<StaticMesh> StaticMesh::create(const std::span<MeshVertex>& p_vertices,
+		const std::span<uint32_t>& p_indices, const AABB& p_aabb, MeshVertexFormat p_format,
+		std::span<const MeshLod> p_lods) {
+	if (p_vertices.empty() || p_indices.empty()) {
+		return nullptr;
+	}
 
-	backend->buffer_free(staging_buffer);
+	AssetLoadTrace::StageScope stage(AssetLoadStage::UPLOAD);
 
-	smesh->vertex_buffer_address = backend->buffer_get_device_address(smesh->vertex_buffer);
+	std::shared_ptr<StaticMesh> smesh = std::make_shared<StaticMesh>();
+	smesh->vertex_count = p_vertices.size();
+	smesh->vertex_format = p_format;
 	smesh->index_count = p_indices.size();
-	smesh->aabb = _get_aabb_from_vertices(p_vertices);
+	smesh->index_type =
+			p_vertices.size() <= UINT16_MAX ? IndexType::UINT16 : IndexType::UINT32;
+
+	std::vector<QuantizedMeshVertex> quantized_vertices;
+	const void* vertex_data = p_vertices.data();
+	if (p_format == MeshVertexFormat::QUANTIZED) {
+		quantized_vertices = quantize_vertices(p_vertices, p_aabb);
+		vertex_data = quantized_vertices.data();
+	}
+
+	std::vector<uint16_t> narrow_indices;
+	const void* index_data = p_indices.data();
+	if (smesh->index_type == IndexType::UINT16) {
+		narrow_indices.assign(p_indices.begin(), p_indices.end());
+		index_data = narrow_indices.data();
+	}
+
+	if (!_upload_buffers(*smesh, vertex_data, smesh->vertex_count * smesh->get_vertex_size(),
+				index_data, smesh->index_count * smesh->get_index_size())) {
+		return nullptr;
+	}
+	smesh->aabb = p_aabb;
+
+	if (p_lods.empty()) {
+		smesh->lods = { { 0, uint32_t(p_indices.size()), 0.0f } };
+	} else {
+		smesh->lods.assign(p_lods.begin(), p_lods.end());
+	}
+
+	smesh->meshlets = build_meshlets(p_vertices,
+			p_indices.subspan(smesh->lods[0].index_offset, smesh->lods[0].index_count));
+	for (Meshlet& meshlet : smesh->meshlets) {
+		meshlet.index_offset += smesh->lods[0].index_offset;
+	}
+
+	AssetLoadTrace::add_gpu_bytes(smesh->memory_size);
 
 	return smesh;
 }
 
-} //namespace gl
\ No newline at end of file
+} //namespace gl
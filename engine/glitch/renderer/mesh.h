@@ -8,6 +8,7 @@
 #include "glitch/asset/asset.h"
 #include "glitch/renderer/frustum.h"
 #include "glitch/renderer/types.h"
+#include "glitch/renderer/upload_manager.h"
 
 namespace gl {
 
@@ -20,6 +21,61 @@ struct MeshVertex {
 	float uv_y;
 };
 
+/**
+ * Compressed counterpart of `MeshVertex`, see `quantize_vertex`. Positions are 16-bit
+ * normalized within the bounding box of the mesh, normals are octahedral encoded into
+ * two 16-bit signed normalized values and UVs are half floats.
+ */
+struct QuantizedMeshVertex {
+	// x in the lower 16 bits, y in the upper ones
+	uint32_t position_xy;
+	// z in the lower 16 bits
+	uint32_t position_z;
+	uint32_t normal;
+	uint32_t uv;
+};
+
+static_assert(sizeof(QuantizedMeshVertex) == 16);
+
+/**
+ * Cluster of neighbouring triangles, drawn as a range of the index buffer of its mesh.
+ * Bounds are in model space.
+ */
+struct Meshlet {
+	uint32_t index_offset;
+	uint32_t index_count;
+
+	glm::vec3 center;
+	float radius;
+
+	// Average normal of the triangles
+	glm::vec3 cone_axis;
+	// Sine of the angle between the axis and the farthest normal, 1 if the normals spread
+	// over more than a hemisphere and the meshlet can not be back face culled
+	float cone_cutoff;
+};
+
+// Simplified version of a mesh, drawn as a range of its index buffer.
+struct MeshLod {
+	uint32_t index_offset;
+	uint32_t index_count;
+	// Maximum deviation from the full detail mesh in model space
+	float error;
+};
+
+enum class MeshVertexFormat : uint32_t {
+	// `MeshVertex`, 32 bytes
+	FULL,
+	// `QuantizedMeshVertex`, 16 bytes
+	QUANTIZED,
+};
+
+GL_SERIALIZE_ENUM(MeshVertexFormat,
+		{
+				{ MeshVertexFormat::FULL, "full" },
+				{ MeshVertexFormat::QUANTIZED, "quantized" },
+		})
+
 /**
  * Asset type of Mesh defining a static mesh primitive.
  *
@@ -27,17 +83,73 @@ struct MeshVertex {
 struct GL_API StaticMesh {
 	GL_REFLECT_ASSET("Mesh")
 
-	Buffer vertex_buffer;
-	Buffer index_buffer;
-	BufferDeviceAddress vertex_buffer_address;
+	// Ranges of the buffers of `GeometryArena`
+	GeometryRange vertex_range;
+	GeometryRange index_range;
+	// The ranges can not be drawn before the upload is complete, see `is_ready`
+	UploadValue upload_value = 0;
+	uint32_t vertex_count;
 	uint32_t index_count;
+	MeshVertexFormat vertex_format = MeshVertexFormat::FULL;
+	// 16-bit if every vertex can be indexed with it
+	IndexType index_type = IndexType::UINT32;
 
+	// Quantized positions are relative to the bounding box
 	AABB aabb;
 
+	// From the most to the least detailed, the first one is the full mesh. See `select_lod`
+	std::vector<MeshLod> lods;
+
+	// Built on creation from the first level of detail, see `cull_meshlets`
+	std::vector<Meshlet> meshlets;
+
+	// Device memory of the ranges in bytes
+	size_t memory_size = 0;
+	// Vertices followed by the indices while the ranges are evicted
+	std::vector<std::byte> evicted_data;
+
 	~StaticMesh();
 
-	static std::shared_ptr<StaticMesh> create(
-			const std::span<MeshVertex>& p_vertices, const std::span<uint32_t>& p_indices);
+	// Size of the device memory of the ranges in bytes, zero while evicted.
+	size_t get_memory_size() const;
+
+	// Size of a single vertex in the vertex buffer in bytes.
+	size_t get_vertex_size() const;
+
+	// Size of a single index in the index buffer in bytes.
+	size_t get_index_size() const;
+
+	bool is_resident() const;
+
+	// Whether the mesh is resident and its upload is complete.
+	bool is_ready() const;
+
+	// Read the ranges back into host memory and free them.
+	bool evict();
+
+	// Evict the meshes with a single readback, see `IsBatchEvictableAsset`.
+	static std::vector<uint8_t> evict_batch(std::span<StaticMesh* const> p_meshes);
+
+	bool make_resident();
+
+	/**
+	 * @param p_format Layout of the vertex buffer, vertices are quantized before the upload
+	 * if it is `MeshVertexFormat::QUANTIZED`.
+	 * @param p_lods Levels of detail within `p_indices`, see `build_lods`. All of the indices
+	 * are a single level if empty.
+	 */
+	static std::shared_ptr<StaticMesh> create(const std::span<MeshVertex>& p_vertices,
+			const std::span<uint32_t>& p_indices,
+			MeshVertexFormat p_format = MeshVertexFormat::FULL,
+			std::span<const MeshLod> p_lods = {});
+
+	// Create with a precomputed bounding box, skips iterating over the vertices.
+	static std::shared_ptr<StaticMesh> create(const std::span<MeshVertex>& p_vertices,
+			const std::span<uint32_t>& p_indices, const AABB& p_aabb,
+			MeshVertexFormat p_format = MeshVertexFormat::FULL,
+			std::span<const MeshLod> p_lods = {});
 };
 
+static_assert(IsEvictableAsset<StaticMesh>);
+
 } //namespace gl
\ No newline at end of file
@@ -0,0 +1,1037 @@
+#include "glitch/renderer/mesh_processing.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GL_MESH_PROCESSING_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace gl {
+
+static float _sign_not_zero(float p_value) { return p_value >= 0.0f ? 1.0f : -1.0f; }
+
+// Project the unit vector onto the octahedron and unfold its lower half onto the upper one
+static glm::vec2 _encode_octahedral(const glm::vec3& p_normal) {
+	const float l1_norm = std::abs(p_normal.x) + std::abs(p_normal.y) + std::abs(p_normal.z);
+	if (l1_norm == 0.0f) {
+		return glm::vec2(0.0f);
+	}
+
+	const glm::vec2 projected(p_normal.x / l1_norm, p_normal.y / l1_norm);
+	if (p_normal.z >= 0.0f) {
+		return projected;
+	}
+
+	return glm::vec2((1.0f - std::abs(projected.y)) * _sign_not_zero(projected.x),
+			(1.0f - std::abs(projected.x)) * _sign_not_zero(projected.y));
+}
+
+static glm::vec3 _decode_octahedral(const glm::vec2& p_encoded) {
+	glm::vec3 normal(p_encoded.x, p_encoded.y,
+			1.0f - std::abs(p_encoded.x) - std::abs(p_encoded.y));
+
+	const float fold = std::max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+
+	return glm::normalize(normal);
+}
+
+// Flat meshes have a zero extent on at least one of the axes
+static float _normalize_in_range(float p_value, float p_min, float p_extent) {
+	return p_extent > 0.0f ? std::clamp((p_value - p_min) / p_extent, 0.0f, 1.0f) : 0.0f;
+}
+
+QuantizedMeshVertex quantize_vertex(const MeshVertex& p_vertex, const AABB& p_aabb) {
+	const glm::vec3 extent = p_aabb.max - p_aabb.min;
+
+	const float x = _normalize_in_range(p_vertex.position.x, p_aabb.min.x, extent.x);
+	const float y = _normalize_in_range(p_vertex.position.y, p_aabb.min.y, extent.y);
+	const float z = _normalize_in_range(p_vertex.position.z, p_aabb.min.z, extent.z);
+
+	QuantizedMeshVertex vertex;
+	vertex.position_xy = glm::packUnorm2x16(glm::vec2(x, y));
+	vertex.position_z = glm::packUnorm2x16(glm::vec2(z, 0.0f));
+	vertex.normal = glm::packSnorm2x16(_encode_octahedral(p_vertex.normal));
+	vertex.uv = glm::packHalf2x16(glm::vec2(p_vertex.uv_x, p_vertex.uv_y));
+
+	return vertex;
+}
+
+MeshVertex dequantize_vertex(const QuantizedMeshVertex& p_vertex, const AABB& p_aabb) {
+	const glm::vec2 xy = glm::unpackUnorm2x16(p_vertex.position_xy);
+	const float z = glm::unpackUnorm2x16(p_vertex.position_z).x;
+	const glm::vec2 uv = glm::unpackHalf2x16(p_vertex.uv);
+
+	MeshVertex vertex;
+	vertex.position = p_aabb.min + glm::vec3(xy.x, xy.y, z) * (p_aabb.max - p_aabb.min);
+	vertex.normal = _decode_octahedral(glm::unpackSnorm2x16(p_vertex.normal));
+	vertex.uv_x = uv.x;
+	vertex.uv_y = uv.y;
+
+	return vertex;
+}
+
+std::vector<QuantizedMeshVertex> quantize_vertices(
+		std::span<const MeshVertex> p_vertices, const AABB& p_aabb) {
+	std::vector<QuantizedMeshVertex> vertices(p_vertices.size());
+	for (size_t i = 0; i < p_vertices.size(); i++) {
+		vertices[i] = quantize_vertex(p_vertices[i], p_aabb);
+	}
+
+	return vertices;
+}
+
+void gather_vertices(const VertexAttributeStream& p_positions,
+		const VertexAttributeStream& p_normals, const VertexAttributeStream& p_uvs,
+		std::span<MeshVertex> p_out_vertices) {
+	// Missing attributes are read from zeros that do not advance
+	static constexpr float ZEROS[4] = {};
+	const auto get_stream = [](const VertexAttributeStream& p_stream) {
+		return p_stream.data ? p_stream
+							 : VertexAttributeStream{ reinterpret_cast<const uint8_t*>(ZEROS),
+									   0, sizeof(ZEROS) };
+	};
+
+	const VertexAttributeStream positions = get_stream(p_positions);
+	const VertexAttributeStream normals = get_stream(p_normals);
+	const VertexAttributeStream uvs = get_stream(p_uvs);
+
+	const size_t count = p_out_vertices.size();
+	size_t i = 0;
+
+#ifdef GL_MESH_PROCESSING_SSE2
+	// Elements are loaded whole, vec3 ones as 16 bytes, so the last ones might not be safe to
+	// load this way
+	const auto get_load_count = [count](const VertexAttributeStream& p_stream,
+										size_t p_load_size) -> size_t {
+		if (p_stream.size < p_load_size) {
+			return 0;
+		}
+		if (p_stream.stride == 0) {
+			return count;
+		}
+		return std::min(count, (p_stream.size - p_load_size) / p_stream.stride + 1);
+	};
+
+	const size_t load_count = std::min({ get_load_count(positions, 16),
+			get_load_count(normals, 16), get_load_count(uvs, 8) });
+
+	for (; i < load_count; i++) {
+		const __m128 position =
+				_mm_loadu_ps(reinterpret_cast<const float*>(positions.data + i * positions.stride));
+		const __m128 normal =
+				_mm_loadu_ps(reinterpret_cast<const float*>(normals.data + i * normals.stride));
+		const __m128 uv = _mm_castpd_ps(
+				_mm_load_sd(reinterpret_cast<const double*>(uvs.data + i * uvs.stride)));
+
+		// (z, z, u, u) and (z, z, v, v), then (x, y, z, u) and (x, y, z, v)
+		const __m128 position_zu = _mm_shuffle_ps(position, uv, _MM_SHUFFLE(0, 0, 2, 2));
+		const __m128 normal_zv = _mm_shuffle_ps(normal, uv, _MM_SHUFFLE(1, 1, 2, 2));
+
+		float* vertex = reinterpret_cast<float*>(&p_out_vertices[i]);
+		_mm_storeu_ps(vertex, _mm_shuffle_ps(position, position_zu, _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storeu_ps(vertex + 4, _mm_shuffle_ps(normal, normal_zv, _MM_SHUFFLE(2, 0, 1, 0)));
+	}
+#endif
+
+	for (; i < count; i++) {
+		float position[3];
+		float normal[3];
+		float uv[2];
+		memcpy(position, positions.data + i * positions.stride, sizeof(position));
+		memcpy(normal, normals.data + i * normals.stride, sizeof(normal));
+		memcpy(uv, uvs.data + i * uvs.stride, sizeof(uv));
+
+		p_out_vertices[i] = {
+			glm::vec3(position[0], position[1], position[2]),
+			uv[0],
+			glm::vec3(normal[0], normal[1], normal[2]),
+			uv[1],
+		};
+	}
+}
+
+void widen_indices(const uint8_t* p_indices, std::span<uint32_t> p_out_indices) {
+	const size_t count = p_out_indices.size();
+	size_t i = 0;
+
+#ifdef GL_MESH_PROCESSING_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= count; i += 16) {
+		const __m128i indices =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_indices + i));
+		const __m128i low = _mm_unpacklo_epi8(indices, zero);
+		const __m128i high = _mm_unpackhi_epi8(indices, zero);
+
+		__m128i* out = reinterpret_cast<__m128i*>(p_out_indices.data() + i);
+		_mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+	}
+#endif
+
+	for (; i < count; i++) {
+		p_out_indices[i] = p_indices[i];
+	}
+}
+
+void widen_indices(const uint16_t* p_indices, std::span<uint32_t> p_out_indices) {
+	const size_t count = p_out_indices.size();
+	size_t i = 0;
+
+#ifdef GL_MESH_PROCESSING_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 8 <= count; i += 8) {
+		const __m128i indices =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_indices + i));
+
+		__m128i* out = reinterpret_cast<__m128i*>(p_out_indices.data() + i);
+		_mm_storeu_si128(out, _mm_unpacklo_epi16(indices, zero));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(indices, zero));
+	}
+#endif
+
+	for (; i < count; i++) {
+		p_out_indices[i] = p_indices[i];
+	}
+}
+
+// FIFO post transform cache, vertices are cached if they were transformed recently enough
+struct VertexCache {
+	std::vector<uint32_t> timestamps;
+	uint32_t time;
+	uint32_t size;
+
+	VertexCache(size_t p_vertex_count, uint32_t p_size) :
+			timestamps(p_vertex_count, 0), time(p_size + 1), size(p_size) {}
+
+	void reset() { time += size + 1; }
+
+	// Returns whether the vertex had to be transformed
+	bool fetch(uint32_t p_vertex) {
+		if (time - timestamps[p_vertex] <= size) {
+			return false;
+		}
+		timestamps[p_vertex] = time++;
+		return true;
+	}
+};
+
+VertexCacheStats analyze_vertex_cache(
+		std::span<const uint32_t> p_indices, size_t p_vertex_count, uint32_t p_cache_size) {
+	VertexCache cache(p_vertex_count, p_cache_size);
+
+	VertexCacheStats stats = {};
+	for (const uint32_t index : p_indices) {
+		stats.transformed_count += cache.fetch(index);
+	}
+
+	const size_t triangle_count = p_indices.size() / 3;
+	stats.acmr = triangle_count > 0 ? float(stats.transformed_count) / triangle_count : 0.0f;
+
+	return stats;
+}
+
+void optimize_vertex_cache(
+		std::span<uint32_t> p_indices, size_t p_vertex_count, uint32_t p_cache_size) {
+	const size_t triangle_count = p_indices.size() / 3;
+	if (triangle_count == 0) {
+		return;
+	}
+
+	// Triangles of each vertex
+	std::vector<uint32_t> triangle_offsets(p_vertex_count + 1, 0);
+	for (size_t i = 0; i < triangle_count * 3; i++) {
+		triangle_offsets[p_indices[i] + 1]++;
+	}
+	for (size_t i = 1; i < triangle_offsets.size(); i++) {
+		triangle_offsets[i] += triangle_offsets[i - 1];
+	}
+
+	std::vector<uint32_t> vertex_triangles(triangle_offsets.back());
+	{
+		std::vector<uint32_t> cursors(triangle_offsets.begin(), triangle_offsets.end() - 1);
+		for (size_t i = 0; i < triangle_count * 3; i++) {
+			vertex_triangles[cursors[p_indices[i]]++] = i / 3;
+		}
+	}
+
+	// Triangles of each vertex that are not emitted yet
+	std::vector<uint32_t> live_counts(p_vertex_count);
+	for (size_t i = 0; i < p_vertex_count; i++) {
+		live_counts[i] = triangle_offsets[i + 1] - triangle_offsets[i];
+	}
+
+	std::vector<uint32_t> cache_times(p_vertex_count, 0);
+	uint32_t time = p_cache_size + 1;
+
+	std::vector<uint8_t> emitted(triangle_count, 0);
+	std::vector<uint32_t> result;
+	result.reserve(triangle_count * 3);
+
+	std::vector<uint32_t> dead_end_stack;
+	std::vector<uint32_t> candidates;
+	size_t cursor = 0;
+
+	int64_t fanning_vertex = p_indices[0];
+	while (fanning_vertex >= 0) {
+		candidates.clear();
+
+		// Emit every remaining triangle around the fanning vertex
+		for (uint32_t i = triangle_offsets[fanning_vertex];
+				i < triangle_offsets[fanning_vertex + 1]; i++) {
+			const uint32_t triangle = vertex_triangles[i];
+			if (emitted[triangle]) {
+				continue;
+			}
+			emitted[triangle] = 1;
+
+			for (uint32_t j = 0; j < 3; j++) {
+				const uint32_t vertex = p_indices[triangle * 3 + j];
+				result.push_back(vertex);
+
+				dead_end_stack.push_back(vertex);
+				candidates.push_back(vertex);
+				live_counts[vertex]--;
+
+				if (time - cache_times[vertex] > p_cache_size) {
+					cache_times[vertex] = time++;
+				}
+			}
+		}
+
+		// Prefer the vertices that will still be in the cache after their remaining
+		// triangles are emitted, the oldest of them first
+		fanning_vertex = -1;
+		int64_t best_priority = -1;
+		for (const uint32_t vertex : candidates) {
+			if (live_counts[vertex] == 0) {
+				continue;
+			}
+
+			int64_t priority = 0;
+			if (time - cache_times[vertex] + 2 * live_counts[vertex] <= p_cache_size) {
+				priority = time - cache_times[vertex];
+			}
+
+			if (priority > best_priority) {
+				best_priority = priority;
+				fanning_vertex = vertex;
+			}
+		}
+
+		if (fanning_vertex >= 0) {
+			continue;
+		}
+
+		// Dead end, continue from a recently used vertex or the next one in the input
+		while (!dead_end_stack.empty() && fanning_vertex < 0) {
+			const uint32_t vertex = dead_end_stack.back();
+			dead_end_stack.pop_back();
+			if (live_counts[vertex] > 0) {
+				fanning_vertex = vertex;
+			}
+		}
+
+		while (fanning_vertex < 0 && cursor < triangle_count * 3) {
+			const uint32_t vertex = p_indices[cursor++];
+			if (live_counts[vertex] > 0) {
+				fanning_vertex = vertex;
+			}
+		}
+	}
+
+	std::copy(result.begin(), result.end(), p_indices.begin());
+}
+
+void optimize_overdraw(std::span<uint32_t> p_indices, std::span<const MeshVertex> p_vertices,
+		float p_threshold, uint32_t p_cache_size) {
+	const size_t triangle_count = p_indices.size() / 3;
+	if (triangle_count == 0) {
+		return;
+	}
+
+	VertexCache cache(p_vertices.size(), p_cache_size);
+	const auto fetch_triangle = [&](size_t p_triangle) {
+		return cache.fetch(p_indices[p_triangle * 3 + 0]) +
+				cache.fetch(p_indices[p_triangle * 3 + 1]) +
+				cache.fetch(p_indices[p_triangle * 3 + 2]);
+	};
+
+	// Hard boundaries are where the cache starts over and all of the vertices miss
+	std::vector<uint32_t> hard_boundaries = { 0 };
+	for (size_t i = 0; i < triangle_count; i++) {
+		if (fetch_triangle(i) == 3 && i > 0) {
+			hard_boundaries.push_back(i);
+		}
+	}
+	hard_boundaries.push_back(triangle_count);
+
+	// Split further wherever the cluster so far is nearly as cache efficient as the whole
+	std::vector<uint32_t> clusters;
+	for (size_t i = 0; i + 1 < hard_boundaries.size(); i++) {
+		const uint32_t begin = hard_boundaries[i];
+		const uint32_t end = hard_boundaries[i + 1];
+
+		cache.reset();
+		uint32_t cluster_misses = 0;
+		for (uint32_t j = begin; j < end; j++) {
+			cluster_misses += fetch_triangle(j);
+		}
+		const float cluster_threshold = p_threshold * float(cluster_misses) / (end - begin);
+
+		clusters.push_back(begin);
+
+		cache.reset();
+		uint32_t running_misses = 0;
+		uint32_t running_triangles = 0;
+		for (uint32_t j = begin; j < end; j++) {
+			running_misses += fetch_triangle(j);
+			running_triangles++;
+
+			if (j + 1 < end && float(running_misses) / running_triangles <= cluster_threshold) {
+				clusters.push_back(j + 1);
+				cache.reset();
+				running_misses = 0;
+				running_triangles = 0;
+			}
+		}
+	}
+	clusters.push_back(triangle_count);
+
+	glm::vec3 mesh_centroid(0.0f);
+	for (const uint32_t index : p_indices) {
+		mesh_centroid += p_vertices[index].position;
+	}
+	mesh_centroid /= float(p_indices.size());
+
+	struct ClusterSortKey {
+		float key;
+		uint32_t cluster;
+	};
+
+	std::vector<ClusterSortKey> sort_keys(clusters.size() - 1);
+	for (uint32_t i = 0; i + 1 < clusters.size(); i++) {
+		glm::vec3 centroid(0.0f);
+		glm::vec3 normal(0.0f);
+		float area = 0.0f;
+
+		for (uint32_t j = clusters[i]; j < clusters[i + 1]; j++) {
+			const glm::vec3& p0 = p_vertices[p_indices[j * 3 + 0]].position;
+			const glm::vec3& p1 = p_vertices[p_indices[j * 3 + 1]].position;
+			const glm::vec3& p2 = p_vertices[p_indices[j * 3 + 2]].position;
+
+			const glm::vec3 triangle_normal = glm::cross(p1 - p0, p2 - p0);
+			const float triangle_area = glm::length(triangle_normal);
+
+			centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+			normal += triangle_normal;
+			area += triangle_area;
+		}
+
+		if (area > 0.0f) {
+			centroid /= area;
+		}
+
+		const float normal_length = glm::length(normal);
+		if (normal_length > 0.0f) {
+			normal /= normal_length;
+		}
+
+		sort_keys[i] = { glm::dot(centroid - mesh_centroid, normal), i };
+	}
+
+	// Outer clusters facing away from the center first
+	std::stable_sort(sort_keys.begin(), sort_keys.end(),
+			[](const ClusterSortKey& p_a, const ClusterSortKey& p_b) {
+				return p_a.key > p_b.key;
+			});
+
+	std::vector<uint32_t> result;
+	result.reserve(p_indices.size());
+	for (const ClusterSortKey& sort_key : sort_keys) {
+		result.insert(result.end(), p_indices.begin() + clusters[sort_key.cluster] * 3,
+				p_indices.begin() + clusters[sort_key.cluster + 1] * 3);
+	}
+
+	std::copy(result.begin(), result.end(), p_indices.begin());
+}
+
+void optimize_vertex_fetch(std::vector<MeshVertex>& p_vertices, std::span<uint32_t> p_indices) {
+	std::vector<uint32_t> remap(p_vertices.size(), UINT32_MAX);
+	uint32_t vertex_count = 0;
+
+	for (uint32_t& index : p_indices) {
+		if (remap[index] == UINT32_MAX) {
+			remap[index] = vertex_count++;
+		}
+		index = remap[index];
+	}
+
+	std::vector<MeshVertex> vertices(vertex_count);
+	for (size_t i = 0; i < p_vertices.size(); i++) {
+		if (remap[i] != UINT32_MAX) {
+			vertices[remap[i]] = p_vertices[i];
+		}
+	}
+
+	p_vertices = std::move(vertices);
+}
+
+void optimize_mesh(std::vector<MeshVertex>& p_vertices, std::span<uint32_t> p_indices) {
+	optimize_vertex_cache(p_indices, p_vertices.size());
+	optimize_overdraw(p_indices, p_vertices);
+	optimize_vertex_fetch(p_vertices, p_indices);
+}
+
+// Bounding sphere around the center of the bounding box and the normal cone of the triangles
+static void _compute_meshlet_bounds(Meshlet& p_meshlet, std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices) {
+	const std::span<const uint32_t> indices =
+			p_indices.subspan(p_meshlet.index_offset, p_meshlet.index_count);
+
+	glm::vec3 min(std::numeric_limits<float>::max());
+	glm::vec3 max(std::numeric_limits<float>::lowest());
+	for (const uint32_t index : indices) {
+		min = glm::min(min, p_vertices[index].position);
+		max = glm::max(max, p_vertices[index].position);
+	}
+
+	p_meshlet.center = (min + max) * 0.5f;
+	p_meshlet.radius = 0.0f;
+	for (const uint32_t index : indices) {
+		p_meshlet.radius = std::max(
+				p_meshlet.radius, glm::distance(p_meshlet.center, p_vertices[index].position));
+	}
+
+	const auto get_triangle_normal = [&](size_t p_triangle) {
+		const glm::vec3& p0 = p_vertices[indices[p_triangle * 3 + 0]].position;
+		const glm::vec3& p1 = p_vertices[indices[p_triangle * 3 + 1]].position;
+		const glm::vec3& p2 = p_vertices[indices[p_triangle * 3 + 2]].position;
+		return glm::cross(p1 - p0, p2 - p0);
+	};
+
+	const size_t triangle_count = indices.size() / 3;
+
+	// Area weighted, larger triangles are more likely to be seen
+	glm::vec3 axis(0.0f);
+	for (size_t i = 0; i < triangle_count; i++) {
+		axis += get_triangle_normal(i);
+	}
+
+	p_meshlet.cone_axis = glm::vec3(0.0f, 0.0f, 1.0f);
+	p_meshlet.cone_cutoff = 1.0f;
+
+	const float axis_length = glm::length(axis);
+	if (axis_length == 0.0f) {
+		return;
+	}
+	axis /= axis_length;
+
+	float min_dot = 1.0f;
+	for (size_t i = 0; i < triangle_count; i++) {
+		const glm::vec3 normal = get_triangle_normal(i);
+		const float normal_length = glm::length(normal);
+		if (normal_length > 0.0f) {
+			min_dot = std::min(min_dot, glm::dot(normal / normal_length, axis));
+		}
+	}
+
+	p_meshlet.cone_axis = axis;
+	if (min_dot > 0.0f) {
+		p_meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+	}
+}
+
+std::vector<Meshlet> build_meshlets(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, uint32_t p_max_vertices, uint32_t p_max_triangles) {
+	GL_ASSERT(p_max_vertices >= 3 && p_max_triangles > 0, "Meshlets must fit a triangle.");
+
+	std::vector<Meshlet> meshlets;
+
+	// Index of the meshlet each vertex got last added to, avoids clearing a set per meshlet
+	std::vector<uint32_t> vertex_meshlets(p_vertices.size(), UINT32_MAX);
+	uint32_t vertex_count = 0;
+
+	Meshlet meshlet = {};
+
+	const auto count_new_vertices = [&](const uint32_t* p_triangle) {
+		const uint32_t meshlet_index = meshlets.size();
+
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < 3; i++) {
+			const bool repeated = (i > 0 && p_triangle[i] == p_triangle[0]) ||
+					(i > 1 && p_triangle[i] == p_triangle[1]);
+			if (!repeated && vertex_meshlets[p_triangle[i]] != meshlet_index) {
+				count++;
+			}
+		}
+		return count;
+	};
+
+	const auto flush = [&]() {
+		_compute_meshlet_bounds(meshlet, p_vertices, p_indices);
+		meshlets.push_back(meshlet);
+
+		meshlet = {};
+		meshlet.index_offset = meshlets.back().index_offset + meshlets.back().index_count;
+		vertex_count = 0;
+	};
+
+	for (size_t i = 0; i + 3 <= p_indices.size(); i += 3) {
+		const uint32_t* triangle = p_indices.data() + i;
+
+		uint32_t new_vertices = count_new_vertices(triangle);
+		if (vertex_count + new_vertices > p_max_vertices ||
+				meshlet.index_count / 3 >= p_max_triangles) {
+			flush();
+			new_vertices = count_new_vertices(triangle);
+		}
+
+		for (uint32_t j = 0; j < 3; j++) {
+			vertex_meshlets[triangle[j]] = meshlets.size();
+		}
+
+		vertex_count += new_vertices;
+		meshlet.index_count += 3;
+	}
+
+	if (meshlet.index_count > 0) {
+		flush();
+	}
+
+	return meshlets;
+}
+
+static bool _is_sphere_inside_frustum(
+		const Frustum& p_frustum, const glm::vec3& p_center, float p_radius) {
+	for (int i = 0; i < 6; ++i) {
+		const glm::vec4& plane = p_frustum.planes[i];
+		if (glm::dot(glm::vec3(plane), p_center) + plane.w < -p_radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t cull_meshlets(std::span<const Meshlet> p_meshlets, const glm::mat4& p_transform,
+		const Frustum& p_frustum, const glm::vec3& p_camera_position, bool p_cull_back_faces,
+		std::vector<MeshletDrawRange>& p_out_ranges) {
+	const glm::vec3 axis_x(p_transform[0]);
+	const glm::vec3 axis_y(p_transform[1]);
+	const glm::vec3 axis_z(p_transform[2]);
+	const glm::vec3 translation(p_transform[3]);
+
+	const float scale_x = glm::length(axis_x);
+	const float scale_y = glm::length(axis_y);
+	const float scale_z = glm::length(axis_z);
+	const float max_scale = std::max({ scale_x, scale_y, scale_z });
+	const float min_scale = std::min({ scale_x, scale_y, scale_z });
+
+	// Normal cones are only preserved by rotations and uniform scales, mirroring flips them
+	const bool cull_back_faces = p_cull_back_faces && max_scale > 0.0f &&
+			max_scale - min_scale <= max_scale * 0.001f &&
+			glm::dot(glm::cross(axis_x, axis_y), axis_z) > 0.0f;
+
+	const auto to_world = [&](const glm::vec3& p_vector) {
+		return axis_x * p_vector.x + axis_y * p_vector.y + axis_z * p_vector.z;
+	};
+
+	uint32_t visible_count = 0;
+	for (const Meshlet& meshlet : p_meshlets) {
+		const glm::vec3 center = translation + to_world(meshlet.center);
+		const float radius = meshlet.radius * max_scale;
+
+		if (!_is_sphere_inside_frustum(p_frustum, center, radius)) {
+			continue;
+		}
+
+		// Every triangle faces away if the view direction is within the cone, widened by
+		// the extent of the meshlet
+		if (cull_back_faces && meshlet.cone_cutoff < 1.0f) {
+			const glm::vec3 cone_axis = to_world(meshlet.cone_axis) / max_scale;
+			const glm::vec3 view = center - p_camera_position;
+			if (glm::dot(view, cone_axis) >= meshlet.cone_cutoff * glm::length(view) + radius) {
+				continue;
+			}
+		}
+
+		visible_count++;
+
+		if (!p_out_ranges.empty() &&
+				p_out_ranges.back().index_offset + p_out_ranges.back().index_count ==
+						meshlet.index_offset) {
+			p_out_ranges.back().index_count += meshlet.index_count;
+		} else {
+			p_out_ranges.push_back({ meshlet.index_offset, meshlet.index_count });
+		}
+	}
+
+	return visible_count;
+}
+
+// Sum of the squared distances to a set of planes, weighted by the area of their triangles
+struct SimplifyQuadric {
+	double a00, a01, a02, a11, a12, a22;
+	double b0, b1, b2;
+	double c;
+	double weight;
+
+	void add_plane(const glm::vec3& p_normal, float p_distance, float p_weight) {
+		a00 += p_weight * p_normal.x * p_normal.x;
+		a01 += p_weight * p_normal.x * p_normal.y;
+		a02 += p_weight * p_normal.x * p_normal.z;
+		a11 += p_weight * p_normal.y * p_normal.y;
+		a12 += p_weight * p_normal.y * p_normal.z;
+		a22 += p_weight * p_normal.z * p_normal.z;
+		b0 += p_weight * p_normal.x * p_distance;
+		b1 += p_weight * p_normal.y * p_distance;
+		b2 += p_weight * p_normal.z * p_distance;
+		c += p_weight * p_distance * p_distance;
+		weight += p_weight;
+	}
+
+	void add(const SimplifyQuadric& p_other) {
+		a00 += p_other.a00;
+		a01 += p_other.a01;
+		a02 += p_other.a02;
+		a11 += p_other.a11;
+		a12 += p_other.a12;
+		a22 += p_other.a22;
+		b0 += p_other.b0;
+		b1 += p_other.b1;
+		b2 += p_other.b2;
+		c += p_other.c;
+		weight += p_other.weight;
+	}
+
+	// Mean squared distance of the point to the planes
+	float evaluate(const glm::vec3& p_point) const {
+		const double x = p_point.x, y = p_point.y, z = p_point.z;
+		const double error = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + a11 * y * y +
+				2 * a12 * y * z + a22 * z * z + 2 * (b0 * x + b1 * y + b2 * z) + c;
+		return weight > 0.0 ? float(std::max(error / weight, 0.0)) : 0.0f;
+	}
+};
+
+struct SimplifyCollapse {
+	uint32_t from;
+	uint32_t to;
+	float error;
+};
+
+// Map each vertex to the first one sharing its position so seams are treated as connected
+static std::vector<uint32_t> _weld_vertices(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, std::vector<uint32_t>& p_out_wedge_counts) {
+	std::vector<uint8_t> referenced(p_vertices.size(), 0);
+	for (const uint32_t index : p_indices) {
+		referenced[index] = 1;
+	}
+
+	std::vector<uint32_t> order;
+	for (uint32_t i = 0; i < p_vertices.size(); i++) {
+		if (referenced[i]) {
+			order.push_back(i);
+		}
+	}
+
+	const auto less = [&](uint32_t p_a, uint32_t p_b) {
+		const glm::vec3& a = p_vertices[p_a].position;
+		const glm::vec3& b = p_vertices[p_b].position;
+		return std::tie(a.x, a.y, a.z, p_a) < std::tie(b.x, b.y, b.z, p_b);
+	};
+	std::sort(order.begin(), order.end(), less);
+
+	std::vector<uint32_t> remap(p_vertices.size());
+	std::iota(remap.begin(), remap.end(), 0);
+	p_out_wedge_counts.assign(p_vertices.size(), 1);
+
+	for (size_t begin = 0; begin < order.size();) {
+		size_t end = begin + 1;
+		while (end < order.size() &&
+				p_vertices[order[end]].position == p_vertices[order[begin]].position) {
+			remap[order[end]] = order[begin];
+			end++;
+		}
+
+		p_out_wedge_counts[order[begin]] = end - begin;
+		begin = end;
+	}
+
+	return remap;
+}
+
+// Whether moving `p_from` onto `p_to` keeps the orientation of the remaining triangles
+static bool _is_collapse_valid(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, std::span<const uint32_t> p_remap,
+		std::span<const uint32_t> p_triangles, std::span<const uint8_t> p_removed,
+		uint32_t p_from, uint32_t p_to) {
+	const glm::vec3& target = p_vertices[p_to].position;
+
+	for (const uint32_t triangle : p_triangles) {
+		if (p_removed[triangle]) {
+			continue;
+		}
+
+		const uint32_t* corners = p_indices.data() + triangle * 3;
+		if (p_remap[corners[0]] == p_remap[p_to] || p_remap[corners[1]] == p_remap[p_to] ||
+				p_remap[corners[2]] == p_remap[p_to]) {
+			// Becomes degenerate and gets removed
+			continue;
+		}
+
+		glm::vec3 positions[3];
+		glm::vec3 moved_positions[3];
+		for (uint32_t i = 0; i < 3; i++) {
+			positions[i] = p_vertices[corners[i]].position;
+			moved_positions[i] = corners[i] == p_from ? target : positions[i];
+		}
+
+		const glm::vec3 normal =
+				glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+		const glm::vec3 moved_normal = glm::cross(
+				moved_positions[1] - moved_positions[0], moved_positions[2] - moved_positions[0]);
+		if (glm::dot(normal, moved_normal) <= 0.0f) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::vector<uint32_t> simplify_mesh(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, size_t p_target_index_count, float* p_out_error) {
+	std::vector<uint32_t> indices(p_indices.begin(), p_indices.end() - p_indices.size() % 3);
+	const size_t triangle_count = indices.size() / 3;
+
+	float max_error = 0.0f;
+	if (p_out_error) {
+		*p_out_error = 0.0f;
+	}
+
+	if (indices.size() <= p_target_index_count) {
+		return indices;
+	}
+
+	std::vector<uint32_t> wedge_counts;
+	const std::vector<uint32_t> remap = _weld_vertices(p_vertices, indices, wedge_counts);
+
+	// Moving vertices of borders or seams would open cracks or stretch the attributes
+	std::vector<uint8_t> locked(p_vertices.size(), 0);
+	{
+		std::unordered_map<uint64_t, uint32_t> edge_counts;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (uint32_t j = 0; j < 3; j++) {
+				const uint32_t a = remap[indices[i + j]];
+				const uint32_t b = remap[indices[i + (j + 1) % 3]];
+				edge_counts[(uint64_t(std::min(a, b)) << 32) | std::max(a, b)]++;
+			}
+		}
+
+		for (const auto& [edge, count] : edge_counts) {
+			if (count == 1) {
+				locked[edge >> 32] = 1;
+				locked[edge & UINT32_MAX] = 1;
+			}
+		}
+
+		for (size_t i = 0; i < p_vertices.size(); i++) {
+			if (wedge_counts[remap[i]] > 1) {
+				locked[i] = 1;
+			}
+		}
+	}
+
+	std::vector<SimplifyQuadric> quadrics(p_vertices.size(), SimplifyQuadric{});
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const glm::vec3& p0 = p_vertices[indices[i + 0]].position;
+		const glm::vec3& p1 = p_vertices[indices[i + 1]].position;
+		const glm::vec3& p2 = p_vertices[indices[i + 2]].position;
+
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		const float double_area = glm::length(normal);
+		if (double_area == 0.0f) {
+			continue;
+		}
+		normal /= double_area;
+
+		for (uint32_t j = 0; j < 3; j++) {
+			quadrics[remap[indices[i + j]]].add_plane(
+					normal, -glm::dot(normal, p0), double_area * 0.5f);
+		}
+	}
+
+	std::vector<uint8_t> removed(triangle_count, 0);
+	size_t index_count = indices.size();
+
+	std::vector<uint32_t> triangle_offsets(p_vertices.size() + 1);
+	std::vector<uint32_t> vertex_triangles;
+	std::vector<SimplifyCollapse> collapses;
+	std::vector<uint8_t> collapsed(p_vertices.size());
+
+	// Collapse the cheapest edges in passes, each vertex changes at most once per pass
+	while (index_count > p_target_index_count) {
+		std::fill(triangle_offsets.begin(), triangle_offsets.end(), 0);
+		for (size_t i = 0; i < triangle_count; i++) {
+			for (uint32_t j = 0; !removed[i] && j < 3; j++) {
+				triangle_offsets[indices[i * 3 + j] + 1]++;
+			}
+		}
+		for (size_t i = 1; i < triangle_offsets.size(); i++) {
+			triangle_offsets[i] += triangle_offsets[i - 1];
+		}
+
+		vertex_triangles.resize(triangle_offsets.back());
+		std::vector<uint32_t> cursors(triangle_offsets.begin(), triangle_offsets.end() - 1);
+		for (size_t i = 0; i < triangle_count; i++) {
+			for (uint32_t j = 0; !removed[i] && j < 3; j++) {
+				vertex_triangles[cursors[indices[i * 3 + j]]++] = i;
+			}
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < triangle_count; i++) {
+			for (uint32_t j = 0; !removed[i] && j < 3; j++) {
+				const uint32_t a = indices[i * 3 + j];
+				const uint32_t b = indices[i * 3 + (j + 1) % 3];
+
+				for (const auto& [from, to] : { std::pair(a, b), std::pair(b, a) }) {
+					if (locked[from]) {
+						continue;
+					}
+
+					SimplifyQuadric quadric = quadrics[remap[from]];
+					quadric.add(quadrics[remap[to]]);
+					collapses.push_back({ from, to, quadric.evaluate(p_vertices[to].position) });
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(),
+				[](const SimplifyCollapse& p_a, const SimplifyCollapse& p_b) {
+					return p_a.error < p_b.error;
+				});
+
+		std::fill(collapsed.begin(), collapsed.end(), 0);
+
+		size_t collapse_count = 0;
+		for (const SimplifyCollapse& collapse : collapses) {
+			if (index_count <= p_target_index_count) {
+				break;
+			}
+
+			const uint32_t from = remap[collapse.from];
+			const uint32_t to = remap[collapse.to];
+			if (collapsed[from] || collapsed[to]) {
+				continue;
+			}
+
+			const std::span<const uint32_t> triangles(
+					vertex_triangles.data() + triangle_offsets[collapse.from],
+					triangle_offsets[collapse.from + 1] - triangle_offsets[collapse.from]);
+			if (!_is_collapse_valid(p_vertices, indices, remap, triangles, removed, collapse.from,
+						collapse.to)) {
+				continue;
+			}
+
+			for (const uint32_t triangle : triangles) {
+				if (removed[triangle]) {
+					continue;
+				}
+
+				uint32_t* corners = indices.data() + triangle * 3;
+				for (uint32_t i = 0; i < 3; i++) {
+					if (corners[i] == collapse.from) {
+						corners[i] = collapse.to;
+					}
+				}
+
+				if (remap[corners[0]] == remap[corners[1]] ||
+						remap[corners[1]] == remap[corners[2]] ||
+						remap[corners[0]] == remap[corners[2]]) {
+					removed[triangle] = 1;
+					index_count -= 3;
+				}
+			}
+
+			quadrics[to].add(quadrics[from]);
+			max_error = std::max(max_error, collapse.error);
+
+			collapsed[from] = 1;
+			collapsed[to] = 1;
+			collapse_count++;
+		}
+
+		if (collapse_count == 0) {
+			break;
+		}
+	}
+
+	std::vector<uint32_t> result;
+	result.reserve(index_count);
+	for (size_t i = 0; i < triangle_count; i++) {
+		if (!removed[i]) {
+			result.insert(result.end(), indices.begin() + i * 3, indices.begin() + i * 3 + 3);
+		}
+	}
+
+	if (p_out_error) {
+		*p_out_error = std::sqrt(max_error);
+	}
+
+	return result;
+}
+
+std::vector<MeshLod> build_lods(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, std::vector<uint32_t>& p_out_indices,
+		uint32_t p_lod_count) {
+	p_out_indices.assign(p_indices.begin(), p_indices.end());
+
+	std::vector<MeshLod> lods = { { 0, uint32_t(p_indices.size()), 0.0f } };
+
+	size_t target_index_count = p_indices.size();
+	for (uint32_t i = 0; i < p_lod_count; i++) {
+		target_index_count = target_index_count / 6 * 3;
+		if (target_index_count == 0) {
+			break;
+		}
+
+		// Simplify the full mesh each time so that the errors do not add up
+		float error;
+		std::vector<uint32_t> indices =
+				simplify_mesh(p_vertices, p_indices, target_index_count, &error);
+
+		// Locked borders and seams keep the mesh from getting any simpler
+		if (indices.size() > lods.back().index_count * 3 / 4) {
+			break;
+		}
+
+		optimize_vertex_cache(indices, p_vertices.size());
+
+		lods.push_back({ uint32_t(p_out_indices.size()), uint32_t(indices.size()),
+				std::max(error, lods.back().error) });
+		p_out_indices.insert(p_out_indices.end(), indices.begin(), indices.end());
+	}
+
+	return lods;
+}
+
+uint32_t select_lod(std::span<const MeshLod> p_lods, float p_distance, float p_screen_scale,
+		float p_max_screen_error) {
+	if (p_distance <= 0.0f) {
+		return 0;
+	}
+
+	uint32_t lod = 0;
+	for (uint32_t i = 1; i < p_lods.size(); i++) {
+		if (p_lods[i].error * p_screen_scale > p_max_screen_error * p_distance) {
+			break;
+		}
+		lod = i;
+	}
+
+	return lod;
+}
+
+} //namespace gl
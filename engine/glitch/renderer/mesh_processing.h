@@ -0,0 +1,152 @@
+/**
+ * @file mesh_processing.h
+ *
+ */
+
+#pragma once
+
+#include "glitch/renderer/mesh.h"
+
+namespace gl {
+
+/**
+ * Compress the vertex into a `QuantizedMeshVertex`, positions are stored relative to
+ * `p_aabb` and clamped into it. Normals are expected to be unit length.
+ */
+GL_API QuantizedMeshVertex quantize_vertex(const MeshVertex& p_vertex, const AABB& p_aabb);
+
+// Inverse of `quantize_vertex`, matches the decoding of the vertex shaders.
+GL_API MeshVertex dequantize_vertex(const QuantizedMeshVertex& p_vertex, const AABB& p_aabb);
+
+GL_API std::vector<QuantizedMeshVertex> quantize_vertices(
+		std::span<const MeshVertex> p_vertices, const AABB& p_aabb);
+
+// Strided view of an attribute with float components, e.g. a glTF accessor.
+struct VertexAttributeStream {
+	const uint8_t* data = nullptr;
+	// Bytes between the starts of consecutive elements
+	size_t stride = 0;
+	// Bytes readable from `data`, vectorized loads stop before passing it
+	size_t size = 0;
+};
+
+/**
+ * Interleave the positions, normals and UVs into `p_out_vertices`, one vertex for each
+ * element of the streams. Streams without data are read as zeros. Uses SSE2 if available.
+ */
+GL_API void gather_vertices(const VertexAttributeStream& p_positions,
+		const VertexAttributeStream& p_normals, const VertexAttributeStream& p_uvs,
+		std::span<MeshVertex> p_out_vertices);
+
+// Zero extend the indices into `p_out_indices`, uses SSE2 if available.
+GL_API void widen_indices(const uint8_t* p_indices, std::span<uint32_t> p_out_indices);
+
+GL_API void widen_indices(const uint16_t* p_indices, std::span<uint32_t> p_out_indices);
+
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats {
+	// Vertex shader invocations with a FIFO post transform cache
+	uint32_t transformed_count;
+	// Average cache miss ratio, transformed vertices per triangle. 0.5 is the best case for
+	// regular grids and 3 the worst
+	float acmr;
+};
+
+GL_API VertexCacheStats analyze_vertex_cache(std::span<const uint32_t> p_indices,
+		size_t p_vertex_count, uint32_t p_cache_size = VERTEX_CACHE_SIZE);
+
+/**
+ * Reorder the triangles so that consecutive ones reuse the vertices in the post transform
+ * cache, using Tipsify (Sander et al. 2007).
+ */
+GL_API void optimize_vertex_cache(std::span<uint32_t> p_indices, size_t p_vertex_count,
+		uint32_t p_cache_size = VERTEX_CACHE_SIZE);
+
+/**
+ * Split the cache optimized triangles into clusters and draw the ones facing away from
+ * the center of the mesh first, so they occlude the rest. Clusters end where the cache
+ * efficiency within them would drop under `p_threshold` times the original one.
+ */
+GL_API void optimize_overdraw(std::span<uint32_t> p_indices,
+		std::span<const MeshVertex> p_vertices, float p_threshold = 1.05f,
+		uint32_t p_cache_size = VERTEX_CACHE_SIZE);
+
+/**
+ * Reorder the vertices in the order they are first referenced so the vertex fetches are
+ * sequential, vertices that are not referenced are removed.
+ */
+GL_API void optimize_vertex_fetch(
+		std::vector<MeshVertex>& p_vertices, std::span<uint32_t> p_indices);
+
+// Optimize the vertex cache, overdraw and vertex fetch, in that order.
+GL_API void optimize_mesh(std::vector<MeshVertex>& p_vertices, std::span<uint32_t> p_indices);
+
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+/**
+ * Split the triangles into meshlets of at most `p_max_vertices` unique vertices and
+ * `p_max_triangles` triangles. Triangles are grouped in index order so meshes whose
+ * indices are ordered for locality give tighter meshlets.
+ */
+GL_API std::vector<Meshlet> build_meshlets(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, uint32_t p_max_vertices = MESHLET_MAX_VERTICES,
+		uint32_t p_max_triangles = MESHLET_MAX_TRIANGLES);
+
+struct MeshletDrawRange {
+	uint32_t index_offset;
+	uint32_t index_count;
+};
+
+/**
+ * Append the index ranges of the meshlets that are inside of the frustum to `p_out_ranges`,
+ * consecutive meshlets are merged into a single range.
+ *
+ * @param p_transform Model matrix of the mesh.
+ * @param p_cull_back_faces Whether to discard meshlets facing away from the camera,
+ * counter-clockwise triangles are front facing.
+ * @returns Number of visible meshlets.
+ */
+GL_API uint32_t cull_meshlets(std::span<const Meshlet> p_meshlets, const glm::mat4& p_transform,
+		const Frustum& p_frustum, const glm::vec3& p_camera_position, bool p_cull_back_faces,
+		std::vector<MeshletDrawRange>& p_out_ranges);
+
+/**
+ * Reduce the triangle count towards `p_target_index_count` by collapsing the edges that
+ * deviate the least from the surface, measured with quadric error metrics. Vertices on
+ * open borders and on attribute seams are kept in place so no cracks open up.
+ *
+ * @param p_out_error Optional, set to the deviation from the original surface in model
+ * space.
+ * @returns Indices of the simplified mesh into `p_vertices`, may have more indices than
+ * the target if no more edges could be collapsed.
+ */
+GL_API std::vector<uint32_t> simplify_mesh(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, size_t p_target_index_count,
+		float* p_out_error = nullptr);
+
+constexpr uint32_t MESH_LOD_MAX_COUNT = 4;
+
+/**
+ * Build a chain of levels of detail, each halving the triangle count of the previous one.
+ * The chain ends early if the mesh can not be simplified any further. Simplified levels
+ * are optimized for the vertex cache.
+ *
+ * @param p_out_indices Indices of all of the levels, starting with `p_indices`.
+ * @param p_lod_count Maximum number of simplified levels to build.
+ */
+GL_API std::vector<MeshLod> build_lods(std::span<const MeshVertex> p_vertices,
+		std::span<const uint32_t> p_indices, std::vector<uint32_t>& p_out_indices,
+		uint32_t p_lod_count = MESH_LOD_MAX_COUNT);
+
+/**
+ * Pick the least detailed level whose error covers at most `p_max_screen_error` pixels.
+ *
+ * @param p_distance Distance from the camera to the bounds of the mesh.
+ * @param p_screen_scale Pixels covered by a unit of model space at a distance of one.
+ */
+GL_API uint32_t select_lod(std::span<const MeshLod> p_lods, float p_distance,
+		float p_screen_scale, float p_max_screen_error = 1.0f);
+
+} //namespace gl
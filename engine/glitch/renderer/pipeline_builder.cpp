@@ -80,6 +80,12 @@ PipelineBuilder& PipelineBuilder::set_render_primitive(RenderPrimitive p_prim) {
 	return *this;
 }
 
+PipelineBuilder& PipelineBuilder::with_cull_mode(PolygonCullMode p_cull_mode) {
+	rasterization.cull_mode = p_cull_mode;
+
+	return *this;
+}
+
 std::pair<Shader, Pipeline> PipelineBuilder::build(RenderPass p_render_pass) {
 	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
 
@@ -29,6 +29,8 @@ public:
 
 	PipelineBuilder& set_render_primitive(RenderPrimitive p_prim);
 
+	PipelineBuilder& with_cull_mode(PolygonCullMode p_cull_mode);
+
 	/**
 	 * @param p_render_pass Optional render pass to build pipeline with. Default
 	 * will assume dynamic rendering.
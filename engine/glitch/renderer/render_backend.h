@@ -44,6 +44,9 @@ public:
 
 	virtual BufferDeviceAddress buffer_get_device_address(Buffer p_buffer) = 0;
 
+	// Size of the device memory backing the buffer, might be larger than the requested size.
+	virtual uint64_t buffer_get_allocation_size(Buffer p_buffer) = 0;
+
 	virtual uint8_t* buffer_map(Buffer p_buffer) = 0;
 
 	virtual void buffer_unmap(Buffer p_buffer) = 0;
@@ -54,6 +57,12 @@ public:
 			BitField<ImageUsageBits> p_usage = IMAGE_USAGE_SAMPLED_BIT, bool p_mipmapped = false,
 			uint32_t p_samples = 1) = 0;
 
+	/**
+	 * Create sampled images from their pixels, the data of every image is copied through a
+	 * single staging buffer and uploaded with one submission.
+	 */
+	virtual std::vector<Image> image_create_batch(std::span<const ImageUploadInfo> p_infos) = 0;
+
 	virtual void image_free(Image p_image) = 0;
 
 	virtual glm::uvec3 image_get_size(Image p_image) = 0;
@@ -62,6 +71,9 @@ public:
 
 	virtual uint32_t image_get_mip_levels(Image p_image) = 0;
 
+	// Size of the device memory backing the image including its mipmaps.
+	virtual uint64_t image_get_allocation_size(Image p_image) = 0;
+
 	virtual Sampler sampler_create(ImageFiltering p_min_filter = ImageFiltering::LINEAR,
 			ImageFiltering p_mag_filter = ImageFiltering::LINEAR,
 			ImageWrappingMode p_wrap_u = ImageWrappingMode::CLAMP_TO_EDGE,
@@ -134,6 +146,9 @@ public:
 
 	virtual void fence_reset(Fence p_fence) = 0;
 
+	// Returns without blocking, `true` if the fence is signaled.
+	virtual bool fence_is_signaled(Fence p_fence) = 0;
+
 	virtual Semaphore semaphore_create() = 0;
 
 	virtual void semaphore_free(Semaphore p_semaphore) = 0;
@@ -165,6 +180,9 @@ public:
 			Fence p_fence = GL_NULL_HANDLE, Semaphore p_wait_semaphore = GL_NULL_HANDLE,
 			Semaphore p_signal_semaphore = GL_NULL_HANDLE) = 0;
 
+	// Block until every submission to the queue has finished.
+	virtual void queue_wait_idle(CommandQueue p_queue) = 0;
+
 	// returns `true` if succeed `false` if resize needed
 	virtual bool queue_present(CommandQueue p_queue, Swapchain p_swapchain,
 			Semaphore p_wait_semaphore = GL_NULL_HANDLE) = 0;
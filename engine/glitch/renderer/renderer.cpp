@@ -1,8 +1,10 @@
 #include "glitch/renderer/renderer.h"
 
 #include "glitch/platform/vulkan/vk_backend.h"
+#include "glitch/renderer/geometry_arena.h"
 #include "glitch/renderer/graphics_pass.h"
 #include "glitch/renderer/types.h"
+#include "glitch/renderer/upload_manager.h"
 
 #include <imgui.h>
 
@@ -11,6 +13,10 @@ namespace gl {
 static Renderer* s_instance = nullptr;
 static std::shared_ptr<RenderBackend> s_backend = nullptr;
 
+// Guards the deletion queues and the frame state they are chosen by, resources are released
+// from any thread
+static std::mutex s_deletion_mutex;
+
 void FrameData::init(CommandQueue p_queue) {
 	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
 
@@ -63,11 +69,24 @@ Renderer::Renderer(std::shared_ptr<Window> p_window, RendererSettings p_settings
 		FrameData& frame_data = frames[i];
 		frame_data.init(graphics_queue);
 	}
+
+	GeometryArena::init();
+	UploadManager::init();
 }
 
 Renderer::~Renderer() {
 	s_backend->device_wait();
 
+	// Nothing is in flight anymore, deletions deferred from now on run right away
+	{
+		std::lock_guard<std::mutex> lock(s_deletion_mutex);
+		s_instance = nullptr;
+	}
+
+	for (auto& frame_data : frames) {
+		_flush_deletion_queue(frame_data);
+	}
+
 	// destroy image and renderpass resources
 	s_backend->image_free(final_image);
 	for (auto& [name, render_image] : renderpass_images) {
@@ -84,6 +103,9 @@ Renderer::~Renderer() {
 		frame_data.destroy();
 	}
 
+	UploadManager::destroy();
+	GeometryArena::destroy();
+
 	// swapchain cleanup
 	s_backend->swapchain_free(swapchain);
 
@@ -99,6 +121,16 @@ CommandBuffer Renderer::begin_render() {
 
 	s_backend->fence_wait(_get_current_frame().render_fence);
 
+	// Resources deferred while this frame was last recorded are not used anymore
+	_flush_deletion_queue(_get_current_frame());
+
+	for (Buffer buffer : GeometryArena::take_retired_buffers()) {
+		defer_deletion([buffer]() { s_backend->buffer_free(buffer); });
+	}
+
+	// Submit the uploads queued since the last frame as a single batch
+	UploadManager::flush();
+
 	const Result<Image, SwapchainAcquireError> swapchain_image = s_backend->swapchain_acquire_image(
 			swapchain, _get_current_frame().image_available_semaphore, &image_index);
 	if (!swapchain_image) {
@@ -112,7 +144,10 @@ CommandBuffer Renderer::begin_render() {
 		}
 	}
 
-	current_swapchain_image = *swapchain_image;
+	{
+		std::lock_guard<std::mutex> lock(s_deletion_mutex);
+		current_swapchain_image = *swapchain_image;
+	}
 
 	s_backend->fence_reset(_get_current_frame().render_fence);
 
@@ -233,8 +268,11 @@ void Renderer::end_render() {
 
 	// reset the state
 	imgui_being_used = false;
-	current_swapchain_image = nullptr;
-	frame_number++;
+	{
+		std::lock_guard<std::mutex> lock(s_deletion_mutex);
+		current_swapchain_image = nullptr;
+		frame_number++;
+	}
 }
 
 void Renderer::add_pass(std::shared_ptr<GraphicsPass> p_pass, int p_priority) {
@@ -328,6 +366,34 @@ void Renderer::set_swapchain_target(const std::string& p_name) {
 
 void Renderer::wait_for_device() { s_backend->device_wait(); }
 
+void Renderer::defer_deletion(std::function<void()>&& p_function) {
+	std::unique_lock<std::mutex> lock(s_deletion_mutex);
+
+	if (!s_instance) {
+		lock.unlock();
+		p_function();
+		return;
+	}
+
+	// Between frames the last submitted one is the latest that might be using the resource
+	const bool recording = s_instance->current_swapchain_image != nullptr;
+	const uint32_t frame = recording ? s_instance->frame_number
+									 : s_instance->frame_number + SWAPCHAIN_BUFFER_SIZE - 1;
+
+	s_instance->frames[frame % SWAPCHAIN_BUFFER_SIZE].deletion_queue.push_function(
+			std::move(p_function));
+}
+
+void Renderer::_flush_deletion_queue(FrameData& p_frame) {
+	DeletionQueue deletion_queue;
+	{
+		std::lock_guard<std::mutex> lock(s_deletion_mutex);
+		std::swap(deletion_queue, p_frame.deletion_queue);
+	}
+
+	deletion_queue.flush();
+}
+
 void Renderer::imgui_begin() {
 	GL_PROFILE_SCOPE;
 
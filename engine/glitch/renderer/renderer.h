@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "glitch/core/deletion_queue.h"
 #include "glitch/core/window.h"
 #include "glitch/renderer/render_backend.h"
 #include "glitch/renderer/types.h"
@@ -27,6 +28,9 @@ struct FrameData {
 			  render_finished_semaphore = GL_NULL_HANDLE;
 	Fence render_fence = GL_NULL_HANDLE;
 
+	// Flushed once `render_fence` signals
+	DeletionQueue deletion_queue;
+
 	void init(CommandQueue p_queue);
 	void destroy();
 };
@@ -92,6 +96,13 @@ public:
 	// Wait for rendering device operations to finish
 	void wait_for_device();
 
+	/**
+	 * Defer `p_function` until the GPU is done with the frames in flight, resources
+	 * still in use can be destroyed without waiting for the device.
+	 * Can be called from any thread, `p_function` runs right away if there is no renderer.
+	 */
+	static void defer_deletion(std::function<void()>&& p_function);
+
 	/**
 	 * Begin ImGui rendering context, all imgui functions
 	 * must be runned inside of this scope and this operation is
@@ -144,6 +155,9 @@ private:
 
 	void _reset_stats();
 
+	// Run the deletions deferred to the frame, outside of the lock so they can defer more.
+	void _flush_deletion_queue(FrameData& p_frame);
+
 	inline FrameData& _get_current_frame() { return frames[frame_number % SWAPCHAIN_BUFFER_SIZE]; };
 
 private:
@@ -1,5 +1,7 @@
 #include "glitch/renderer/shader_library.h"
 
+#include "glitch/asset/asset_system.h"
+
 #include "shader_bundle.gen.h"
 
 namespace gl {
@@ -32,18 +34,18 @@ std::vector<uint32_t> ShaderLibrary::get_bundled_spirv(const char* p_path) {
 }
 
 std::vector<uint32_t> ShaderLibrary::get_spirv_data(const fs::path& p_filepath) {
-	size_t file_size = fs::file_size(p_filepath);
-
-	std::ifstream file(p_filepath, std::ios::in | std::ios::binary);
-	if (!file.is_open()) {
+	const auto file = AssetSystem::read_file(p_filepath.string());
+	if (!file) {
 		GL_LOG_ERROR("[ShaderLibrary::get_spirv_data] Unable to open SPIRV file at path: '{}'.",
 				p_filepath.string());
 		return {};
 	}
 
-	std::vector<uint32_t> buffer(file_size);
-	file.read(reinterpret_cast<char*>(buffer.data()), file_size);
+	const std::vector<uint8_t>& data = *file;
+
+	std::vector<uint32_t> buffer(data.size() / sizeof(uint32_t));
+	memcpy(buffer.data(), data.data(), buffer.size() * sizeof(uint32_t));
 	return buffer;
 }
 
-} //namespace gl
\ No newline at end of file
+} //namespace gl
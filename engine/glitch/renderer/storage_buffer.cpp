@@ -5,8 +5,8 @@
 namespace gl {
 
 StorageBuffer::~StorageBuffer() {
-	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
-	backend->buffer_free(buffer);
+	// Frames in flight might still read the buffer
+	Renderer::defer_deletion([buffer = buffer]() { Renderer::get_backend()->buffer_free(buffer); });
 }
 
 std::shared_ptr<StorageBuffer> StorageBuffer::create(size_t p_size, const void* p_data) {
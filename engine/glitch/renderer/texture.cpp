@@ -1,7 +1,10 @@
 #include "glitch/renderer/texture.h"
 
+#include "glitch/asset/asset_load_trace.h"
 #include "glitch/asset/asset_system.h"
+#include "glitch/asset/derived_data_cache.h"
 #include "glitch/core/hash.h"
+#include "glitch/core/job_system.h"
 #include "glitch/core/json.h"
 #include "glitch/renderer/renderer.h"
 #include "glitch/renderer/types.h"
@@ -12,11 +15,124 @@
 
 namespace gl {
 
+// Bumping invalidates the images decoded by the previous versions.
+constexpr uint32_t TEXTURE_IMPORTER_VERSION = 1;
+
+// Derived data cache entry, followed by the RGBA8 pixels.
+struct DecodedImageHeader {
+	uint32_t width;
+	uint32_t height;
+};
+
+struct DecodedImage {
+	glm::uvec2 size;
+	std::vector<uint8_t> data;
+
+	const uint8_t* get_pixels() const { return data.data() + sizeof(DecodedImageHeader); }
+};
+
+/**
+ * Decode the image as RGBA8, files are read through the AssetSystem so that packed paths
+ * work. Decoded images are kept in the derived data cache.
+ */
+static std::optional<DecodedImage> _load_image(std::string_view p_path) {
+	GL_PROFILE_SCOPE;
+
+	const auto file = AssetSystem::read_file(p_path);
+	if (!file) {
+		return std::nullopt;
+	}
+
+	const std::vector<uint8_t>& file_data = *file;
+
+	const DerivedDataKey key = {
+		"texture",
+		TEXTURE_IMPORTER_VERSION,
+		content_hash64(file_data),
+	};
+
+	DecodedImage image;
+
+	if (auto cached = DerivedDataCache::load(key);
+			cached && cached->size() >= sizeof(DecodedImageHeader)) {
+		DecodedImageHeader header;
+		memcpy(&header, cached->data(), sizeof(header));
+
+		if (cached->size() == sizeof(header) + size_t(header.width) * header.height * 4) {
+			image.size = { header.width, header.height };
+			image.data = std::move(*cached);
+			return image;
+		}
+	}
+
+	int w, h;
+	stbi_uc* pixels = stbi_load_from_memory(
+			file_data.data(), int(file_data.size()), &w, &h, nullptr, STBI_rgb_alpha);
+	if (!pixels) {
+		return std::nullopt;
+	}
+
+	const DecodedImageHeader header = { uint32_t(w), uint32_t(h) };
+	const size_t pixels_size = size_t(w) * h * 4;
+
+	image.size = { w, h };
+	image.data.resize(sizeof(header) + pixels_size);
+	memcpy(image.data.data(), &header, sizeof(header));
+	memcpy(image.data.data() + sizeof(header), pixels, pixels_size);
+
+	stbi_image_free(pixels);
+
+	DerivedDataCache::store(key, image.data);
+
+	return image;
+}
+
+struct CookedTexture {
+	CookedTextureHeader header;
+	std::vector<uint8_t> data;
+
+	const uint8_t* get_pixels() const { return data.data() + sizeof(CookedTextureHeader); }
+};
+
+static bool _is_cooked_texture(std::string_view p_path) { return p_path.ends_with(".gltex"); }
+
+// Read and validate a '.gltex' file with a single read.
+static std::optional<CookedTexture> _load_cooked_texture(std::string_view p_path) {
+	GL_PROFILE_SCOPE;
+
+	auto file = AssetSystem::read_file(p_path);
+	if (!file || (*file).size() < sizeof(CookedTextureHeader)) {
+		return std::nullopt;
+	}
+
+	CookedTexture texture;
+	texture.data = std::move(*file);
+	memcpy(&texture.header, texture.data.data(), sizeof(texture.header));
+
+	const CookedTextureHeader& header = texture.header;
+	if (header.magic != COOKED_TEXTURE_MAGIC || header.version != COOKED_TEXTURE_VERSION) {
+		return std::nullopt;
+	}
+
+	const size_t pixels_size =
+			size_t(header.width) * header.height * get_data_format_size(header.format);
+	if (pixels_size == 0 || texture.data.size() != sizeof(header) + pixels_size) {
+		return std::nullopt;
+	}
+
+	return texture;
+}
+
 Texture::~Texture() {
-	auto backend = Renderer::get_backend();
+	// Frames in flight might still sample the image
+	Renderer::defer_deletion([image = image, sampler = sampler]() {
+		auto backend = Renderer::get_backend();
 
-	backend->image_free(image);
-	backend->sampler_free(sampler);
+		if (image) {
+			backend->image_free(image);
+		}
+		backend->sampler_free(sampler);
+	});
 }
 
 std::shared_ptr<Texture> Texture::create(
@@ -30,6 +146,7 @@ std::shared_ptr<Texture> Texture::create(
 	tx->size = p_size;
 	tx->image = backend->image_create(
 			DataFormat::R8G8B8A8_UNORM, p_size, &color_data, IMAGE_USAGE_SAMPLED_BIT, true);
+	tx->memory_size = backend->image_get_allocation_size(tx->image);
 	tx->sampler =
 			backend->sampler_create(p_sampler.min_filter, p_sampler.mag_filter, p_sampler.wrap_u,
 					p_sampler.wrap_v, p_sampler.wrap_w, backend->image_get_mip_levels(tx->image));
@@ -39,12 +156,16 @@ std::shared_ptr<Texture> Texture::create(
 
 std::shared_ptr<Texture> Texture::create(DataFormat p_format, const glm::uvec2& p_size,
 		const void* p_data, TextureSamplerOptions p_sampler) {
+	AssetLoadTrace::StageScope stage(AssetLoadStage::UPLOAD);
+
 	auto backend = Renderer::get_backend();
 
 	std::shared_ptr<Texture> tx = std::make_shared<Texture>();
 	tx->format = p_format;
 	tx->size = p_size;
 	tx->image = backend->image_create(p_format, p_size, p_data, IMAGE_USAGE_SAMPLED_BIT, true);
+	tx->memory_size = backend->image_get_allocation_size(tx->image);
+	AssetLoadTrace::add_gpu_bytes(tx->memory_size);
 	tx->sampler =
 			backend->sampler_create(p_sampler.min_filter, p_sampler.mag_filter, p_sampler.wrap_u,
 					p_sampler.wrap_v, p_sampler.wrap_w, backend->image_get_mip_levels(tx->image));
@@ -54,6 +175,18 @@ std::shared_ptr<Texture> Texture::create(DataFormat p_format, const glm::uvec2&
 	return tx;
 }
 
+std::vector<std::shared_ptr<Texture>> Texture::create_batch(
+		std::span<const TextureCreateInfo> p_infos) {
+	std::vector<ImageUploadInfo> images(p_infos.size());
+	std::vector<TextureSamplerOptions> samplers(p_infos.size());
+	for (size_t i = 0; i < p_infos.size(); i++) {
+		images[i] = { p_infos[i].format, p_infos[i].size, p_infos[i].data, true };
+		samplers[i] = p_infos[i].sampler;
+	}
+
+	return _create_batch(images, samplers);
+}
+
 bool Texture::save(const fs::path& p_metadata_path, std::shared_ptr<Texture> p_texture) {
 	if (!p_texture) {
 		GL_LOG_ERROR(
@@ -61,6 +194,11 @@ bool Texture::save(const fs::path& p_metadata_path, std::shared_ptr<Texture> p_t
 		return false;
 	}
 
+	// Cooked files are the source themselves, there is no metadata to write
+	if (_is_cooked_texture(p_metadata_path.string())) {
+		return true;
+	}
+
 	if (p_texture->asset_path.empty()) {
 		GL_LOG_ERROR("[Texture::save] Unable to save Texture metadata to path, asset path should "
 					 "not be empty.");
@@ -102,7 +240,23 @@ std::shared_ptr<Texture> Texture::load(const fs::path& p_path) {
 	 * }
 	 */
 
-	if (!fs::exists(p_path)) {
+	if (_is_cooked_texture(p_path.string())) {
+		const std::optional<CookedTexture> cooked = _load_cooked_texture(p_path.string());
+		if (!cooked) {
+			GL_LOG_ERROR("[Texture::load] Unable to load cooked texture from path '{}'.",
+					p_path.string());
+			return nullptr;
+		}
+
+		std::shared_ptr<Texture> tx = create(cooked->header.format,
+				{ cooked->header.width, cooked->header.height }, cooked->get_pixels(),
+				cooked->header.sampler);
+		tx->asset_path = p_path.string();
+
+		return tx;
+	}
+
+	if (!AssetSystem::file_exists(p_path.string())) {
 		GL_LOG_ERROR("[Texture::load] Unable to load texture, given metadata path do not exists.");
 		return nullptr;
 	}
@@ -122,7 +276,7 @@ std::shared_ptr<Texture> Texture::load(const fs::path& p_path) {
 
 	const auto asset_path_rel = j["path"].get<std::string>();
 	const auto asset_path = AssetSystem::get_absolute_path(asset_path_rel);
-	if (!asset_path || !fs::exists(*asset_path)) {
+	if (!asset_path || !AssetSystem::file_exists(asset_path.get_value().string())) {
 		GL_LOG_ERROR("[Texture::load] Unable to load texture, invalid textue path in metadata.");
 		return nullptr;
 	}
@@ -149,32 +303,123 @@ std::shared_ptr<Texture> Texture::load(const fs::path& p_path) {
 
 std::shared_ptr<Texture> Texture::load_from_file(
 		const fs::path& p_asset_path, const TextureSamplerOptions& p_sampler) {
-	if (!fs::exists(p_asset_path)) {
+	AssetLoadTrace::LoadScope trace(p_asset_path.string(), get_type_name());
+
+	std::optional<DecodedImage> decoded;
+	{
+		AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+		decoded = _load_image(p_asset_path.string());
+	}
+
+	if (!decoded) {
 		GL_LOG_ERROR(
 				"[Texture::load_from_file] Unable to load texture from file, file do not exist.");
 		return nullptr;
 	}
 
-	auto backend = Renderer::get_backend();
+	AssetLoadTrace::StageScope stage(AssetLoadStage::UPLOAD);
 
-	int w, h;
-	stbi_uc* data = stbi_load(p_asset_path.string().c_str(), &w, &h, nullptr, STBI_rgb_alpha);
+	auto backend = Renderer::get_backend();
 
 	std::shared_ptr<Texture> tx = std::make_shared<Texture>();
 	tx->format = DataFormat::R8G8B8A8_UNORM;
-	tx->size = { w, h };
-	tx->image =
-			backend->image_create(DataFormat::R8G8B8A8_UNORM, { (uint32_t)w, (uint32_t)h }, data);
+	tx->size = decoded->size;
+	tx->image = backend->image_create(
+			DataFormat::R8G8B8A8_UNORM, decoded->size, decoded->get_pixels());
+	tx->memory_size = backend->image_get_allocation_size(tx->image);
 	tx->sampler = backend->sampler_create(p_sampler.min_filter, p_sampler.mag_filter,
 			p_sampler.wrap_u, p_sampler.wrap_v, p_sampler.wrap_w);
 	tx->sampler_options = p_sampler;
 	tx->asset_path = p_asset_path.string();
 
-	stbi_image_free(data);
+	AssetLoadTrace::add_gpu_bytes(tx->memory_size);
+	trace.set_succeeded(true);
 
 	return tx;
 }
 
+std::vector<std::shared_ptr<Texture>> Texture::load_from_files(
+		std::span<const fs::path> p_asset_paths,
+		std::span<const TextureSamplerOptions> p_samplers) {
+	GL_PROFILE_SCOPE;
+
+	GL_ASSERT(p_asset_paths.size() == p_samplers.size(), "Every file needs a sampler!");
+
+	std::vector<std::optional<DecodedImage>> decoded(p_asset_paths.size());
+
+	// Every file is traced as a load nested into the current one, like `load_from_file`
+	AssetLoadTrace::ParallelScope parallel_trace;
+	JobSystem::parallel_for(uint32_t(p_asset_paths.size()), [&](uint32_t p_index) {
+		AssetLoadTrace::WorkerScope worker_trace(parallel_trace);
+
+		const std::string path = p_asset_paths[p_index].string();
+
+		AssetLoadTrace::LoadScope trace(path, get_type_name());
+		{
+			AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+			decoded[p_index] = _load_image(path);
+		}
+
+		if (!decoded[p_index]) {
+			GL_LOG_ERROR("[Texture::load_from_files] Unable to load texture from file '{}'.",
+					path);
+			return;
+		}
+
+		trace.set_succeeded(true);
+	});
+
+	std::vector<ImageUploadInfo> images;
+	std::vector<TextureSamplerOptions> samplers;
+	for (size_t i = 0; i < decoded.size(); i++) {
+		if (decoded[i]) {
+			images.push_back({ DataFormat::R8G8B8A8_UNORM, decoded[i]->size,
+					decoded[i]->get_pixels(), false });
+			samplers.push_back(p_samplers[i]);
+		}
+	}
+
+	const std::vector<std::shared_ptr<Texture>> created = _create_batch(images, samplers);
+
+	std::vector<std::shared_ptr<Texture>> textures(p_asset_paths.size());
+	for (size_t i = 0, created_idx = 0; i < decoded.size(); i++) {
+		if (decoded[i]) {
+			textures[i] = created[created_idx++];
+			textures[i]->asset_path = p_asset_paths[i].string();
+		}
+	}
+
+	return textures;
+}
+
+bool Texture::save_cooked(const fs::path& p_path, DataFormat p_format, const glm::uvec2& p_size,
+		std::span<const uint8_t> p_pixels, const TextureSamplerOptions& p_sampler) {
+	if (p_pixels.size() != size_t(p_size.x) * p_size.y * get_data_format_size(p_format)) {
+		GL_LOG_ERROR("[Texture::save_cooked] Pixel data does not match the size of the image.");
+		return false;
+	}
+
+	std::ofstream file(p_path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		GL_LOG_ERROR("[Texture::save_cooked] Unable to open file '{}'.", p_path.string());
+		return false;
+	}
+
+	const CookedTextureHeader header = {
+		COOKED_TEXTURE_MAGIC,
+		COOKED_TEXTURE_VERSION,
+		p_size.x,
+		p_size.y,
+		p_format,
+		p_sampler,
+	};
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(p_pixels.data()), p_pixels.size());
+
+	return file.good();
+}
+
 ShaderUniform Texture::get_uniform(uint32_t p_binding) const {
 	ShaderUniform uniform;
 	uniform.type = UNIFORM_TYPE_SAMPLER_WITH_TEXTURE;
@@ -195,6 +440,110 @@ const Sampler Texture::get_sampler() const { return sampler; }
 
 const std::string& Texture::get_path() const { return asset_path; }
 
+size_t Texture::get_memory_size() const { return image ? memory_size : 0; }
+
+bool Texture::is_resident() const { return image != GL_NULL_HANDLE; }
+
+bool Texture::evict() {
+	if (!image || asset_path.empty()) {
+		return false;
+	}
+
+	// Frames in flight might still sample the image
+	Renderer::defer_deletion([image = image]() { Renderer::get_backend()->image_free(image); });
+	image = GL_NULL_HANDLE;
+
+	return true;
+}
+
+bool Texture::make_resident() {
+	if (image) {
+		return true;
+	}
+
+	auto backend = Renderer::get_backend();
+
+	if (_is_cooked_texture(asset_path)) {
+		const std::optional<CookedTexture> cooked = _load_cooked_texture(asset_path);
+		if (!cooked) {
+			GL_LOG_ERROR(
+					"[Texture::make_resident] Unable to reload texture from '{}'.", asset_path);
+			return false;
+		}
+
+		size = { cooked->header.width, cooked->header.height };
+		image = backend->image_create(
+				format, size, cooked->get_pixels(), IMAGE_USAGE_SAMPLED_BIT, true);
+		memory_size = backend->image_get_allocation_size(image);
+
+		return true;
+	}
+
+	const std::optional<DecodedImage> decoded = _load_image(asset_path);
+	if (!decoded) {
+		GL_LOG_ERROR("[Texture::make_resident] Unable to reload texture from '{}'.", asset_path);
+		return false;
+	}
+
+	size = decoded->size;
+	image = backend->image_create(format, size, decoded->get_pixels());
+	memory_size = backend->image_get_allocation_size(image);
+
+	return true;
+}
+
+std::vector<std::shared_ptr<Texture>> Texture::_create_batch(
+		std::span<const ImageUploadInfo> p_images,
+		std::span<const TextureSamplerOptions> p_samplers) {
+	AssetLoadTrace::StageScope stage(AssetLoadStage::UPLOAD);
+
+	auto backend = Renderer::get_backend();
+
+	std::vector<std::shared_ptr<Texture>> textures;
+	textures.reserve(p_images.size());
+
+	const auto upload = [&](size_t p_begin, size_t p_end) {
+		const std::vector<Image> images =
+				backend->image_create_batch(p_images.subspan(p_begin, p_end - p_begin));
+
+		for (size_t i = p_begin; i < p_end; i++) {
+			const TextureSamplerOptions& sampler = p_samplers[i];
+
+			std::shared_ptr<Texture> tx = std::make_shared<Texture>();
+			tx->format = p_images[i].format;
+			tx->size = p_images[i].size;
+			tx->image = images[i - p_begin];
+			tx->memory_size = backend->image_get_allocation_size(tx->image);
+			AssetLoadTrace::add_gpu_bytes(tx->memory_size);
+			tx->sampler = backend->sampler_create(sampler.min_filter, sampler.mag_filter,
+					sampler.wrap_u, sampler.wrap_v, sampler.wrap_w,
+					backend->image_get_mip_levels(tx->image));
+			tx->sampler_options = sampler;
+
+			textures.push_back(tx);
+		}
+	};
+
+	// Bound the staging memory, a single image larger than the batch is uploaded by itself
+	size_t batch_begin = 0;
+	uint64_t batch_size = 0;
+	for (size_t i = 0; i < p_images.size(); i++) {
+		const uint64_t size = uint64_t(p_images[i].size.x) * p_images[i].size.y *
+				get_data_format_size(p_images[i].format);
+
+		if (i > batch_begin && batch_size + size > TEXTURE_UPLOAD_BATCH_SIZE) {
+			upload(batch_begin, i);
+			batch_begin = i;
+			batch_size = 0;
+		}
+
+		batch_size += size;
+	}
+	upload(batch_begin, p_images.size());
+
+	return textures;
+}
+
 template <> size_t hash64(const Texture& p_texture) {
 	size_t seed = 0;
 	hash_combine(seed, static_cast<int>(p_texture.get_format()));
@@ -18,6 +18,33 @@ struct TextureSamplerOptions {
 	ImageWrappingMode wrap_w = ImageWrappingMode::CLAMP_TO_EDGE;
 };
 
+/**
+ * Header of the engine native '.gltex' files written by `gl-cooker`, followed by the
+ * pixels of the image. Loading one needs a single read and no decoding.
+ */
+struct CookedTextureHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	DataFormat format;
+	TextureSamplerOptions sampler;
+};
+
+// Pixels of a texture to create with `Texture::create_batch`.
+struct TextureCreateInfo {
+	DataFormat format;
+	glm::uvec2 size;
+	const void* data;
+	TextureSamplerOptions sampler = {};
+};
+
+// Staging memory of a single submission of `Texture::create_batch` and `load_from_files`.
+inline constexpr uint64_t TEXTURE_UPLOAD_BATCH_SIZE = 64ull * 1024 * 1024;
+
+inline constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x58544c47; // "GLTX"
+inline constexpr uint32_t COOKED_TEXTURE_VERSION = 1;
+
 /**
  * High level abstraction over Image handle.  Provides functionality to load
  * image files as well as constructing from raw data.
@@ -36,12 +63,35 @@ public:
 	static std::shared_ptr<Texture> create(DataFormat p_format, const glm::uvec2& p_size,
 			const void* p_data = nullptr, TextureSamplerOptions p_sampler = {});
 
+	/**
+	 * Same as `create` for each of the textures, their pixels are uploaded together in
+	 * submissions of up to `TEXTURE_UPLOAD_BATCH_SIZE` bytes.
+	 */
+	static std::vector<std::shared_ptr<Texture>> create_batch(
+			std::span<const TextureCreateInfo> p_infos);
+
+	// Cooked '.gltex' files are read only, saving them is a no-op.
 	static bool save(const fs::path& p_metadata_path, std::shared_ptr<Texture> p_texture);
+
+	// Loads either the json metadata or a cooked '.gltex' file.
 	static std::shared_ptr<Texture> load(const fs::path& p_metadata_path);
 
+	// Write a '.gltex' file, does not require a renderer.
+	static bool save_cooked(const fs::path& p_path, DataFormat p_format,
+			const glm::uvec2& p_size, std::span<const uint8_t> p_pixels,
+			const TextureSamplerOptions& p_sampler = {});
+
 	static std::shared_ptr<Texture> load_from_file(
 			const fs::path& p_asset_path, const TextureSamplerOptions& p_sampler = {});
 
+	/**
+	 * Same as `load_from_file` for each of the files. They are decoded across the job system
+	 * and uploaded like `create_batch`, textures that fail to load are null.
+	 */
+	static std::vector<std::shared_ptr<Texture>> load_from_files(
+			std::span<const fs::path> p_asset_paths,
+			std::span<const TextureSamplerOptions> p_samplers);
+
 	ShaderUniform get_uniform(uint32_t p_binding) const;
 
 	DataFormat get_format() const;
@@ -54,11 +104,32 @@ public:
 
 	const std::string& get_path() const;
 
+	// Size of the device memory of the image in bytes, zero while evicted.
+	size_t get_memory_size() const;
+
+	bool is_resident() const;
+
+	/**
+	 * Free the image, it is reloaded from the source file by `make_resident`.
+	 *
+	 * @returns `false` if the texture was not loaded from a file.
+	 */
+	bool evict();
+
+	bool make_resident();
+
+private:
+	// Create the textures of the images, `p_images` are uploaded in batches.
+	static std::vector<std::shared_ptr<Texture>> _create_batch(
+			std::span<const ImageUploadInfo> p_images,
+			std::span<const TextureSamplerOptions> p_samplers);
+
 private:
 	DataFormat format;
 	Image image;
 	Sampler sampler;
 	glm::uvec2 size;
+	size_t memory_size = 0;
 
 	std::string asset_path;
 	TextureSamplerOptions sampler_options;
@@ -66,6 +137,7 @@ private:
 
 static_assert(IsCreatableAsset<Texture, Color, glm::uvec2, TextureSamplerOptions>);
 static_assert(IsLoadableAsset<Texture>);
+static_assert(IsEvictableAsset<Texture>);
 
 template <> size_t hash64(const Texture& p_texture);
 
@@ -298,6 +298,14 @@ struct BufferImageCopyRegion {
 	glm::uvec3 image_extent;
 };
 
+// Image to create along with its pixels, see `RenderBackend::image_create_batch`.
+struct ImageUploadInfo {
+	DataFormat format;
+	glm::uvec2 size;
+	const void* data;
+	bool mipmapped;
+};
+
 inline const uint32_t MAX_UNIFORM_SETS = 16;
 
 enum ShaderUniformType : size_t {
@@ -414,6 +422,13 @@ enum class PolygonCullMode : int {
 	BACK,
 };
 
+GL_SERIALIZE_ENUM(PolygonCullMode,
+		{
+				{ PolygonCullMode::DISABLED, "disabled" },
+				{ PolygonCullMode::FRONT, "front" },
+				{ PolygonCullMode::BACK, "back" },
+		})
+
 enum class PolygonFrontFace : int {
 	CLOCKWISE,
 	COUNTER_CLOCKWISE,
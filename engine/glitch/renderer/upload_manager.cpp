@@ -0,0 +1,235 @@
+#include "glitch/renderer/upload_manager.h"
+
+#include "glitch/core/memory/memory.h"
+#include "glitch/renderer/render_backend.h"
+#include "glitch/renderer/renderer.h"
+
+namespace gl {
+
+static constexpr uint64_t UPLOAD_ALIGNMENT = 16;
+
+void UploadManager::init(uint64_t p_ring_size) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	GL_ASSERT(!s_initialized, "Upload manager is already initialized!");
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	s_ring_size = p_ring_size;
+	s_ring_buffer = backend->buffer_create(
+			s_ring_size, BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocationType::CPU);
+	s_ring_data = backend->buffer_map(s_ring_buffer);
+	s_ring_head = 0;
+	s_ring_used = 0;
+
+	const CommandQueue queue = backend->queue_get(QueueType::TRANSFER);
+	for (uint32_t i = 0; i < UPLOAD_BATCH_COUNT; i++) {
+		Batch batch = {};
+		batch.command_pool = backend->command_pool_create(queue);
+		batch.command_buffer = backend->command_pool_allocate(batch.command_pool);
+		batch.fence = backend->fence_create();
+
+		s_free_batches.push_back(batch);
+	}
+
+	s_initialized = true;
+}
+
+void UploadManager::destroy() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_initialized) {
+		return;
+	}
+
+	while (!s_submitted_batches.empty()) {
+		_retire(true);
+	}
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	for (const Batch& batch : s_free_batches) {
+		backend->command_pool_free(batch.command_pool);
+		backend->fence_free(batch.fence);
+	}
+	s_free_batches.clear();
+
+	backend->buffer_unmap(s_ring_buffer);
+	backend->buffer_free(s_ring_buffer);
+	s_ring_buffer = GL_NULL_HANDLE;
+	s_ring_data = nullptr;
+
+	s_ring_head = 0;
+	s_ring_used = 0;
+
+	s_pending_copies.clear();
+	s_pending_ring_size = 0;
+
+	s_initialized = false;
+}
+
+UploadValue UploadManager::upload(GeometryRange p_range, const void* p_data, uint64_t p_size) {
+	GL_PROFILE_SCOPE;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	GL_ASSERT(s_initialized, "Upload manager is not initialized!");
+
+	if (align_up(p_size, UPLOAD_ALIGNMENT) > s_ring_size) {
+		std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+		Buffer staging_buffer = backend->buffer_create(
+				p_size, BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocationType::CPU);
+
+		memcpy(backend->buffer_map(staging_buffer), p_data, p_size);
+		backend->buffer_unmap(staging_buffer);
+
+		const GeometryCopy copy = { p_range, 0, p_size };
+		GeometryArena::upload(staging_buffer, { &copy, 1 });
+
+		backend->buffer_free(staging_buffer);
+
+		return 0;
+	}
+
+	std::optional<uint64_t> offset = _ring_allocate(p_size);
+	while (!offset) {
+		// Make room by waiting for the oldest batch, the pending copies are the oldest ones
+		// if nothing is submitted
+		if (s_submitted_batches.empty()) {
+			_submit();
+		}
+		_retire(true);
+
+		offset = _ring_allocate(p_size);
+	}
+
+	memcpy(s_ring_data + *offset, p_data, p_size);
+	s_pending_copies.push_back({ p_range, *offset, p_size });
+
+	return s_pending_value;
+}
+
+bool UploadManager::is_complete(UploadValue p_value) {
+	return p_value <= s_completed_value.load(std::memory_order_acquire);
+}
+
+void UploadManager::wait(UploadValue p_value) {
+	if (is_complete(p_value)) {
+		return;
+	}
+
+	GL_PROFILE_SCOPE;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_initialized) {
+		return;
+	}
+
+	if (p_value >= s_pending_value) {
+		_submit();
+	}
+
+	while (!is_complete(p_value) && _retire(true)) {
+	}
+}
+
+void UploadManager::flush() {
+	GL_PROFILE_SCOPE;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_initialized) {
+		return;
+	}
+
+	while (_retire(false)) {
+	}
+
+	_submit();
+}
+
+UploadValue UploadManager::get_completed_value() {
+	return s_completed_value.load(std::memory_order_acquire);
+}
+
+void UploadManager::_submit() {
+	if (s_pending_copies.empty()) {
+		return;
+	}
+
+	while (s_free_batches.empty()) {
+		_retire(true);
+	}
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	Batch batch = s_free_batches.back();
+	s_free_batches.pop_back();
+
+	batch.value = s_pending_value++;
+	batch.ring_size = std::exchange(s_pending_ring_size, 0);
+
+	backend->fence_reset(batch.fence);
+	backend->command_reset(batch.command_buffer);
+	backend->command_begin(batch.command_buffer);
+
+	GeometryArena::submit_upload(
+			batch.command_buffer, batch.fence, s_ring_buffer, s_pending_copies);
+	s_pending_copies.clear();
+
+	s_submitted_batches.push_back(batch);
+}
+
+bool UploadManager::_retire(bool p_wait) {
+	if (s_submitted_batches.empty()) {
+		return false;
+	}
+
+	std::shared_ptr<RenderBackend> backend = Renderer::get_backend();
+
+	Batch& batch = s_submitted_batches.front();
+	if (p_wait) {
+		backend->fence_wait(batch.fence);
+	} else if (!backend->fence_is_signaled(batch.fence)) {
+		return false;
+	}
+
+	s_ring_used -= batch.ring_size;
+	s_completed_value.store(batch.value, std::memory_order_release);
+
+	s_free_batches.push_back(batch);
+	s_submitted_batches.pop_front();
+
+	return true;
+}
+
+std::optional<uint64_t> UploadManager::_ring_allocate(uint64_t p_size) {
+	const uint64_t size = align_up(p_size, UPLOAD_ALIGNMENT);
+
+	// Start over once everything is reclaimed so large copies do not need to wrap around
+	if (s_ring_used == 0) {
+		s_ring_head = 0;
+	}
+
+	// Copies are contiguous, skip the end of the ring if the copy does not fit in it
+	uint64_t offset = s_ring_head;
+	uint64_t padding = 0;
+	if (offset + size > s_ring_size) {
+		padding = s_ring_size - offset;
+		offset = 0;
+	}
+
+	if (s_ring_used + padding + size > s_ring_size) {
+		return std::nullopt;
+	}
+
+	s_ring_used += padding + size;
+	s_pending_ring_size += padding + size;
+	s_ring_head = offset + size;
+
+	return offset;
+}
+
+} //namespace gl
@@ -0,0 +1,95 @@
+/**
+ * @file upload_manager.h
+ *
+ */
+
+#pragma once
+
+#include "glitch/renderer/geometry_arena.h"
+
+namespace gl {
+
+constexpr uint64_t UPLOAD_RING_SIZE = 32ull * 1024 * 1024;
+constexpr uint32_t UPLOAD_BATCH_COUNT = 4;
+
+// Uploads complete in the order of their values, zero is always complete.
+typedef uint64_t UploadValue;
+
+/**
+ * Uploads geometry without blocking the caller. Data is copied into a persistently mapped
+ * staging ring and the copies are submitted to the transfer queue as a single batch once
+ * per frame, see `flush`.
+ *
+ * Every batch gets the next value of a counter, like a timeline semaphore, and an upload
+ * is complete once the completed value reaches the value of its batch.
+ *
+ * Every method is thread safe.
+ */
+class GL_API UploadManager {
+public:
+	static void init(uint64_t p_ring_size = UPLOAD_RING_SIZE);
+
+	// Wait for the submitted batches and free the ring, pending copies are dropped.
+	static void destroy();
+
+	/**
+	 * Copy `p_data` into the ring to be uploaded into the start of `p_range` with the next
+	 * batch. Blocks until a batch completes if the ring is full, data that does not fit in
+	 * the ring at all is uploaded right away.
+	 *
+	 * @returns Value the upload is complete at.
+	 */
+	static UploadValue upload(GeometryRange p_range, const void* p_data, uint64_t p_size);
+
+	static bool is_complete(UploadValue p_value);
+
+	// Block until the upload is complete, submits its batch if it is still pending.
+	static void wait(UploadValue p_value);
+
+	// Submit the pending copies and reclaim the ring space of the completed batches.
+	static void flush();
+
+	static UploadValue get_completed_value();
+
+private:
+	struct Batch {
+		CommandPool command_pool;
+		CommandBuffer command_buffer;
+		Fence fence;
+		UploadValue value;
+		// Bytes of the ring used by the copies, including the padding of wrapping around
+		uint64_t ring_size;
+	};
+
+	// Must be called with the lock held, same for the methods below.
+	static void _submit();
+
+	// Reclaim the oldest submitted batch, returns `false` if it is still running.
+	static bool _retire(bool p_wait);
+
+	static std::optional<uint64_t> _ring_allocate(uint64_t p_size);
+
+private:
+	inline static std::mutex s_mutex;
+	inline static bool s_initialized = false;
+
+	inline static Buffer s_ring_buffer = GL_NULL_HANDLE;
+	inline static uint8_t* s_ring_data = nullptr;
+	inline static uint64_t s_ring_size = 0;
+	inline static uint64_t s_ring_head = 0;
+	inline static uint64_t s_ring_used = 0;
+
+	// Copies of the batch that is not submitted yet
+	inline static std::vector<GeometryCopy> s_pending_copies;
+	inline static uint64_t s_pending_ring_size = 0;
+
+	inline static std::vector<Batch> s_free_batches;
+	// In the order of submission
+	inline static std::deque<Batch> s_submitted_batches;
+
+	// Value of the batch that is not submitted yet
+	inline static UploadValue s_pending_value = 1;
+	inline static std::atomic<UploadValue> s_completed_value = 0;
+};
+
+} //namespace gl
@@ -0,0 +1,324 @@
+#include "glitch/scene/cooked_model.h"
+
+#include "glitch/asset/asset_load_trace.h"
+#include "glitch/asset/asset_system.h"
+#include "glitch/renderer/material.h"
+#include "glitch/renderer/mesh.h"
+#include "glitch/renderer/texture.h"
+#include "glitch/scene/components.h"
+#include "glitch/scene/scene_renderer.h"
+
+namespace gl {
+
+CookedModelLayout get_cooked_model_layout(const CookedModelHeader& p_header) {
+	CookedModelLayout layout;
+	layout.nodes_offset = sizeof(CookedModelHeader);
+	layout.submeshes_offset = layout.nodes_offset + p_header.node_count * sizeof(CookedModelNode);
+	layout.materials_offset =
+			layout.submeshes_offset + p_header.submesh_count * sizeof(CookedSubmesh);
+	layout.strings_offset =
+			layout.materials_offset + p_header.material_count * sizeof(CookedMaterialPath);
+	layout.vertices_offset =
+			(layout.strings_offset + p_header.string_table_size + 15) & ~size_t(15);
+	layout.indices_offset = layout.vertices_offset + p_header.vertex_count * sizeof(MeshVertex);
+	layout.lods_offset = layout.indices_offset + p_header.index_count * sizeof(uint32_t);
+	layout.size = layout.lods_offset + p_header.lod_count * sizeof(MeshLod);
+
+	return layout;
+}
+
+// Load a '.glmat' file, texture paths are relative to `p_dir`.
+static AssetHandle _load_cooked_material(
+		const std::string& p_path, const std::string& p_dir, const GLTFDefaultAssets& p_defaults) {
+	const auto res = json_load(p_path);
+	if (!res) {
+		GL_LOG_ERROR("[CookedModelLoader::load] Unable to load material from path '{}'.", p_path);
+		return p_defaults.material;
+	}
+
+	const json& j = *res;
+
+	const std::optional<AssetHandle> handle =
+			AssetSystem::create<Material>(j.value("definition_path", DEFINITION_PATH_PBR_STANDARD));
+	if (!handle) {
+		GL_LOG_ERROR("[CookedModelLoader::load] Unable to create material '{}'.", p_path);
+		return p_defaults.material;
+	}
+
+	std::shared_ptr<Material> material = AssetSystem::get<Material>(*handle);
+
+	// Maps missing from the file sample the default texture
+	for (const ShaderUniformMetadata& uniform : material->get_uniforms()) {
+		if (uniform.type == ShaderUniformVariableType::TEXTURE) {
+			material->set_param(uniform.name, p_defaults.texture);
+		}
+	}
+
+	for (const json& uniform : j.value("uniforms", json::array())) {
+		try {
+			const std::string name = uniform.at("name").get<std::string>();
+			const json& value = uniform.at("value");
+
+			switch (uniform.at("type").get<ShaderUniformVariableType>()) {
+				case ShaderUniformVariableType::INT:
+					material->set_param(name, value.get<int>());
+					break;
+				case ShaderUniformVariableType::FLOAT:
+					material->set_param(name, value.get<float>());
+					break;
+				case ShaderUniformVariableType::VEC2:
+					material->set_param(name, value.get<glm::vec2>());
+					break;
+				case ShaderUniformVariableType::VEC3:
+					material->set_param(name, value.get<glm::vec3>());
+					break;
+				case ShaderUniformVariableType::VEC4:
+					material->set_param(name, value.get<glm::vec4>());
+					break;
+				case ShaderUniformVariableType::TEXTURE: {
+					const std::string texture_path = p_dir + value.get<std::string>();
+					if (const auto texture = AssetSystem::load<Texture>(texture_path)) {
+						material->set_param(name, *texture);
+					} else {
+						GL_LOG_ERROR("[CookedModelLoader::load] Unable to load texture from path "
+									 "'{}'.",
+								texture_path);
+					}
+					break;
+				}
+			}
+		} catch (const json::exception&) {
+			GL_LOG_ERROR("[CookedModelLoader::load] Unable to parse uniform of material '{}'.",
+					p_path);
+		}
+	}
+
+	material->upload();
+
+	// Textures were assigned after the material got registered
+	AssetSystem::update_dependencies<Material>(*handle);
+
+	return *handle;
+}
+
+GLTFLoadError CookedModelLoader::load(std::shared_ptr<Scene> p_scene, const std::string& p_path,
+		const GLTFLoadOptions& p_options) {
+	GL_PROFILE_SCOPE;
+
+	AssetLoadTrace::LoadScope trace(p_path, "CookedModel");
+
+	auto file = AssetSystem::read_file(p_path);
+	if (!file) {
+		GL_LOG_ERROR("[CookedModelLoader::load] Unable to read model '{}'.", p_path);
+		return GLTFLoadError::PATH_ERROR;
+	}
+
+	std::vector<uint8_t> data = std::move(*file);
+
+	CookedModelHeader header;
+	if (data.size() < sizeof(header)) {
+		GL_LOG_ERROR("[CookedModelLoader::load] Invalid model '{}'.", p_path);
+		return GLTFLoadError::PARSING_ERROR;
+	}
+
+	memcpy(&header, data.data(), sizeof(header));
+	if (header.magic != COOKED_MODEL_MAGIC || header.version != COOKED_MODEL_VERSION) {
+		GL_LOG_ERROR("[CookedModelLoader::load] Model '{}' is not a cooked model of version {}, "
+					 "it should be cooked again.",
+				p_path, COOKED_MODEL_VERSION);
+		return GLTFLoadError::PARSING_ERROR;
+	}
+
+	const CookedModelLayout layout = get_cooked_model_layout(header);
+	if (data.size() != layout.size) {
+		GL_LOG_ERROR("[CookedModelLoader::load] Size of model '{}' does not match its header.",
+				p_path);
+		return GLTFLoadError::PARSING_ERROR;
+	}
+
+	// Tables are read in place, vertices start at a 16 byte aligned offset
+	const CookedModelNode* nodes =
+			reinterpret_cast<const CookedModelNode*>(data.data() + layout.nodes_offset);
+	const CookedSubmesh* submeshes =
+			reinterpret_cast<const CookedSubmesh*>(data.data() + layout.submeshes_offset);
+	const CookedMaterialPath* materials =
+			reinterpret_cast<const CookedMaterialPath*>(data.data() + layout.materials_offset);
+	const std::string_view strings(
+			reinterpret_cast<const char*>(data.data() + layout.strings_offset),
+			header.string_table_size);
+	MeshVertex* vertices = reinterpret_cast<MeshVertex*>(data.data() + layout.vertices_offset);
+	uint32_t* indices = reinterpret_cast<uint32_t*>(data.data() + layout.indices_offset);
+	const MeshLod* lods = reinterpret_cast<const MeshLod*>(data.data() + layout.lods_offset);
+
+	const auto is_valid_range = [](uint64_t p_offset, uint64_t p_count, uint64_t p_size) {
+		return p_offset + p_count <= p_size;
+	};
+
+	for (uint32_t i = 0; i < header.node_count; i++) {
+		const CookedModelNode& node = nodes[i];
+		if (node.parent_index >= int32_t(i) ||
+				!is_valid_range(node.name_offset, node.name_length, header.string_table_size) ||
+				!is_valid_range(node.submesh_offset, node.submesh_count, header.submesh_count)) {
+			GL_LOG_ERROR("[CookedModelLoader::load] Invalid node table in model '{}'.", p_path);
+			return GLTFLoadError::PARSING_ERROR;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.submesh_count; i++) {
+		const CookedSubmesh& submesh = submeshes[i];
+		if (!is_valid_range(submesh.vertex_offset, submesh.vertex_count, header.vertex_count) ||
+				!is_valid_range(submesh.index_offset, submesh.index_count, header.index_count) ||
+				!is_valid_range(submesh.lod_offset, submesh.lod_count, header.lod_count) ||
+				submesh.material_index >= int32_t(header.material_count)) {
+			GL_LOG_ERROR("[CookedModelLoader::load] Invalid submesh table in model '{}'.", p_path);
+			return GLTFLoadError::PARSING_ERROR;
+		}
+
+		const MeshLod* submesh_lods = lods + submesh.lod_offset;
+		if (std::any_of(submesh_lods, submesh_lods + submesh.lod_count, [&](const MeshLod& p_lod) {
+				return p_lod.index_count == 0 ||
+						!is_valid_range(p_lod.index_offset, p_lod.index_count, submesh.index_count);
+			})) {
+			GL_LOG_ERROR("[CookedModelLoader::load] Invalid LOD table in model '{}'.", p_path);
+			return GLTFLoadError::PARSING_ERROR;
+		}
+
+		const uint32_t* submesh_indices = indices + submesh.index_offset;
+		if (std::any_of(submesh_indices, submesh_indices + submesh.index_count,
+					[&](uint32_t p_index) { return p_index >= submesh.vertex_count; })) {
+			GL_LOG_ERROR("[CookedModelLoader::load] Index out of range in model '{}'.", p_path);
+			return GLTFLoadError::PARSING_ERROR;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.material_count; i++) {
+		if (!is_valid_range(
+					materials[i].path_offset, materials[i].path_length, header.string_table_size)) {
+			GL_LOG_ERROR("[CookedModelLoader::load] Invalid material table in model '{}'.", p_path);
+			return GLTFLoadError::PARSING_ERROR;
+		}
+	}
+
+	AssetLoadTrace::StageScope stage(AssetLoadStage::REGISTER);
+
+	const GLTFDefaultAssets defaults = GLTFLoader::get_default_assets();
+
+	// Materials and textures are referenced relative to the model
+	const std::string dir = p_path.substr(0, p_path.find_last_of('/') + 1);
+
+	std::vector<AssetHandle> material_handles(header.material_count, INVALID_ASSET_HANDLE);
+	const auto get_material = [&](int32_t p_material_index) -> AssetHandle {
+		if (p_material_index < 0) {
+			return defaults.material;
+		}
+
+		AssetHandle& handle = material_handles[p_material_index];
+		if (!handle) {
+			const CookedMaterialPath& material = materials[p_material_index];
+			handle = _load_cooked_material(
+					dir + std::string(strings.substr(material.path_offset, material.path_length)),
+					dir, defaults);
+		}
+
+		return handle;
+	};
+
+	// Submeshes instanced by multiple nodes share the mesh, so do identical submeshes of
+	// other models
+	std::vector<AssetHandle> mesh_handles(header.submesh_count, INVALID_ASSET_HANDLE);
+	const auto get_mesh = [&](uint32_t p_submesh_index) -> AssetHandle {
+		AssetHandle& handle = mesh_handles[p_submesh_index];
+		if (!handle) {
+			const CookedSubmesh& submesh = submeshes[p_submesh_index];
+			const std::span<MeshVertex> submesh_vertices(
+					vertices + submesh.vertex_offset, submesh.vertex_count);
+			const std::span<uint32_t> submesh_indices(
+					indices + submesh.index_offset, submesh.index_count);
+
+			// The full detail level is always kept
+			const std::span<const MeshLod> submesh_lods(lods + submesh.lod_offset,
+					std::min(submesh.lod_count, p_options.lod_count + 1));
+
+			// Same geometry is uploaded once per vertex format
+			const std::array<uint64_t, 4> content_hashes = {
+				content_hash64({ reinterpret_cast<const uint8_t*>(submesh_vertices.data()),
+						submesh_vertices.size_bytes() }),
+				content_hash64({ reinterpret_cast<const uint8_t*>(submesh_indices.data()),
+						submesh_indices.size_bytes() }),
+				uint64_t(p_options.vertex_format),
+				submesh_lods.size(),
+			};
+
+			handle = AssetSystem::find_or_register<StaticMesh>(
+					content_hash64({ reinterpret_cast<const uint8_t*>(content_hashes.data()),
+							sizeof(content_hashes) }),
+					[&]() {
+						return StaticMesh::create(submesh_vertices, submesh_indices,
+								submesh.aabb, p_options.vertex_format, submesh_lods);
+					});
+		}
+
+		return handle;
+	};
+
+	const auto attach_mesh_components = [&](Entity p_entity, uint32_t p_submesh_index) {
+		// Primitives the cooker was unable to convert
+		if (submeshes[p_submesh_index].vertex_count == 0 ||
+				submeshes[p_submesh_index].index_count == 0) {
+			return;
+		}
+
+		MeshComponent* mc = p_entity.add_component<MeshComponent>();
+		mc->mesh = get_mesh(p_submesh_index);
+		mc->visible = true;
+		AssetSystem::retain<StaticMesh>(mc->mesh);
+
+		MaterialComponent* mat_comp = p_entity.add_component<MaterialComponent>();
+		mat_comp->definition_path = DEFINITION_PATH_PBR_STANDARD;
+		mat_comp->handle = get_material(submeshes[p_submesh_index].material_index);
+		AssetSystem::retain<Material>(mat_comp->handle);
+	};
+
+	Entity base_entity = p_scene->create(fs::path(p_path).filename().string());
+	// Add GLTFSourceComponent for scene (de)serialization
+	const GLTFSourceComponent* gltf_sc =
+			base_entity.add_component<GLTFSourceComponent>(UID(), p_path, p_options);
+
+	// Nodes are stored parents first
+	std::vector<Entity> entities;
+	entities.reserve(header.node_count);
+
+	for (uint32_t i = 0; i < header.node_count; i++) {
+		const CookedModelNode& node = nodes[i];
+		const std::string name(strings.substr(node.name_offset, node.name_length));
+
+		Entity entity = p_scene->create(
+				name, node.parent_index < 0 ? base_entity : entities[node.parent_index]);
+		entity.get_transform().local_position = node.position;
+		entity.get_transform().local_rotation = node.rotation;
+		entity.get_transform().local_scale = node.scale;
+
+		if (node.gltf_node_id >= 0) {
+			entity.add_component<GLTFInstanceComponent>(gltf_sc->model_id, node.gltf_node_id);
+
+			// Same hierarchy as `GLTFLoader`, multiple primitives get an entity each
+			if (node.submesh_count == 1) {
+				attach_mesh_components(entity, node.submesh_offset);
+			} else {
+				for (uint32_t j = 0; j < node.submesh_count; j++) {
+					Entity prim_entity =
+							p_scene->create(std::format("{}_prim_{}", name, j), entity);
+					attach_mesh_components(prim_entity, node.submesh_offset + j);
+				}
+			}
+		}
+
+		entities.push_back(entity);
+	}
+
+	trace.set_succeeded(true);
+
+	return GLTFLoadError::NONE;
+}
+
+} //namespace gl
@@ -0,0 +1,104 @@
+/**
+ * @file cooked_model.h
+ *
+ */
+
+#pragma once
+
+#include "glitch/renderer/frustum.h"
+#include "glitch/scene/gltf_loader.h"
+
+namespace gl {
+
+/**
+ * Engine native model files written by `gl-cooker` from glTF models. Every integer is
+ * little endian and the file is laid out as:
+ *
+ * header | nodes | submeshes | materials | strings | vertices | indices | lods
+ *
+ * Vertices start at a 16 byte aligned offset. Submeshes are the primitives of the glTF
+ * meshes, their indices are relative to their first vertex. Materials are paths of '.glmat'
+ * files relative to the directory of the model. Lods are the `MeshLod` levels of detail of
+ * the submeshes, their index ranges are relative to the first index of their submesh.
+ */
+struct CookedModelHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t node_count;
+	uint32_t submesh_count;
+	uint32_t material_count;
+	uint32_t string_table_size;
+	uint32_t vertex_count;
+	uint32_t index_count;
+	uint32_t lod_count;
+	AABB aabb;
+};
+
+struct CookedModelNode {
+	int32_t parent_index;
+	// Value of `GLTFInstanceComponent::gltf_node_id`, negative for nodes without a mesh
+	int32_t gltf_node_id;
+	uint32_t name_offset;
+	uint32_t name_length;
+	glm::vec3 position;
+	// Euler angles in degrees
+	glm::vec3 rotation;
+	glm::vec3 scale;
+	uint32_t submesh_offset;
+	uint32_t submesh_count;
+};
+
+struct CookedSubmesh {
+	uint32_t vertex_offset;
+	uint32_t vertex_count;
+	// Indices of all of the levels of detail
+	uint32_t index_offset;
+	uint32_t index_count;
+	uint32_t lod_offset;
+	uint32_t lod_count;
+	// Negative if the primitive uses the default material
+	int32_t material_index;
+	AABB aabb;
+};
+
+struct CookedMaterialPath {
+	uint32_t path_offset;
+	uint32_t path_length;
+};
+
+inline constexpr uint32_t COOKED_MODEL_MAGIC = 0x534d4c47; // "GLMS"
+inline constexpr uint32_t COOKED_MODEL_VERSION = 2;
+
+// Byte offsets of the tables of a '.glmesh' file described by its header.
+struct CookedModelLayout {
+	size_t nodes_offset;
+	size_t submeshes_offset;
+	size_t materials_offset;
+	size_t strings_offset;
+	size_t vertices_offset;
+	size_t indices_offset;
+	size_t lods_offset;
+	// Size of the whole file
+	size_t size;
+};
+
+GL_API CookedModelLayout get_cooked_model_layout(const CookedModelHeader& p_header);
+
+/**
+ * Loads '.glmesh' files written by `GLTFCooker` into the scene with a single read,
+ * entities are created the same way `GLTFLoader` does so scenes referencing the model
+ * (de)serialize the same.
+ *
+ * '.glmat' files are json documents of the form:
+ * {
+ *  "definition_path" : "...",
+ *  "uniforms" : [ { "name" : "...", "type" : "vec4", "value" : ... } ]
+ * }
+ * Values of texture uniforms are paths of '.gltex' files relative to the material.
+ */
+struct GL_API CookedModelLoader {
+	static GLTFLoadError load(std::shared_ptr<Scene> p_scene, const std::string& p_path,
+			const GLTFLoadOptions& p_options = {});
+};
+
+} //namespace gl
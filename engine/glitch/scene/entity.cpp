@@ -31,6 +31,8 @@ void Entity::set_parent(Entity parent) {
 		(*current_parent).remove_child(*this);
 	}
 
+	scene->mark_dirty(get_uid());
+
 	// If an invalid entity provided then carry this into top levels
 	if (!parent) {
 		return;
@@ -117,6 +119,8 @@ bool Entity::remove_child(Entity child) {
 		child.get_relation().parent_id = INVALID_UID;
 		children_ids.erase(it);
 
+		scene->mark_dirty(child.get_uid());
+
 		return true;
 	}
 
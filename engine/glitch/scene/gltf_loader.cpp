@@ -1,12 +1,17 @@
 #include "glitch/scene/gltf_loader.h"
 
+#include "glitch/asset/asset_load_trace.h"
 #include "glitch/asset/asset_system.h"
+#include "glitch/asset/derived_data_cache.h"
+#include "glitch/core/job_system.h"
 #include "glitch/renderer/material.h"
 #include "glitch/renderer/mesh.h"
 #include "glitch/renderer/texture.h"
 #include "glitch/scene/components.h"
+#include "glitch/scene/cooked_model.h"
 #include "glitch/scene/scene_renderer.h"
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 
@@ -16,36 +21,129 @@
 
 namespace gl {
 
-enum GLTFParsingFlags : uint16_t {
-	GLTF_PARSING_FLAG_NO_UV = 0x1,
-	GLTF_PARSING_FLAG_NO_NORMALS = 0x2,
-};
-
 struct GLTFLoadContext {
 	std::shared_ptr<Scene> scene;
 	const tinygltf::Model* model;
 	size_t model_hash;
+	// Stable hash of the file and its external buffers, keys the derived data
+	uint64_t content_hash;
 	fs::path base_path;
 	UID model_id;
+	GLTFLoadOptions options;
 	std::unordered_map<size_t, AssetHandle> loaded_textures;
+	// Content hashes of the textures by texture index, see `_get_texture_content_hash`
+	std::unordered_map<int, uint64_t> texture_content_hashes;
 	std::unordered_map<int, AssetHandle> loaded_materials;
+	// Meshes of the primitives by mesh and primitive index, decoded before the nodes
+	std::vector<std::vector<AssetHandle>> mesh_handles;
 };
 
 static size_t _hash_gltf_model(const tinygltf::Model& p_model);
 
+// Identifies the texture across models, see `AssetSystem::find_or_register`.
+static uint64_t _get_texture_content_hash(const tinygltf::Image& p_image, const fs::path& p_path,
+		const TextureSamplerOptions& p_sampler);
+
+static uint64_t _get_gltf_content_hash(
+		std::span<const uint8_t> p_file, const tinygltf::Model& p_model);
+
+// Encoded image collected while parsing, decoded across the job system afterwards.
+struct GLTFPendingImage {
+	int image_idx;
+	std::vector<uint8_t> bytes;
+};
+
+// Images collected by `_defer_gltf_image`.
+struct GLTFImageCollector {
+	std::vector<GLTFPendingImage> images;
+	// External images are decoded by `Texture::load_from_files` when they are not collected
+	bool collect_external = true;
+};
+
+// Image loader of tinygltf, collects the images into the `GLTFImageCollector` of
+// `p_user_data` instead of decoding them.
+static bool _defer_gltf_image(tinygltf::Image* p_image, const int p_image_idx, std::string* p_err,
+		std::string* p_warn, int p_req_width, int p_req_height, const unsigned char* p_bytes,
+		int p_size, void* p_user_data);
+
+// Decode the image through the derived data cache, thread safe.
+static bool _load_gltf_image(tinygltf::Image* p_image, int p_image_idx,
+		std::span<const uint8_t> p_bytes, std::string* p_err, std::string* p_warn);
+
+/**
+ * Read and parse the model, `p_file_data` receives the bytes of the file.
+ * External images are left undecoded unless `p_decode_external_images` is set.
+ */
+static GLTFLoadError _parse_gltf(const std::string& p_path, const fs::path& p_abs_path,
+		tinygltf::Model& p_model, std::vector<uint8_t>& p_file_data,
+		bool p_decode_external_images);
+
 static void _parse_gltf_node(GLTFLoadContext& p_ctx, int p_node_idx, Entity p_parent);
 
-static std::shared_ptr<StaticMesh> _load_static_mesh(const tinygltf::Primitive* p_primitive,
-		const tinygltf::Mesh* p_mesh, GLTFLoadContext& p_ctx);
+// Float attribute of the primitive, empty if it is missing or of another component type.
+static VertexAttributeStream _get_attribute_stream(const tinygltf::Model& p_model,
+		const tinygltf::Primitive& p_primitive, const char* p_name);
+
+static void _build_primitive_data(const tinygltf::Model& p_model,
+		const tinygltf::Primitive& p_primitive, std::vector<MeshVertex>& p_vertices,
+		std::vector<uint32_t>& p_indices);
+
+// Identifies the mesh across models, the same geometry is uploaded once per vertex format.
+static uint64_t _get_mesh_content_hash(
+		std::span<const uint8_t> p_geometry, MeshVertexFormat p_format);
+
+// Decode the meshes of the primitives used by the scene across the job system.
+static void _load_static_meshes(GLTFLoadContext& p_ctx, int p_scene_idx);
+
+/**
+ * Identical primitives of every loaded model share the same mesh.
+ * Thread safe, returns an invalid handle if the primitive is not indexed.
+ */
+static AssetHandle _load_static_mesh(const tinygltf::Primitive* p_primitive,
+		const tinygltf::Mesh* p_mesh, const GLTFLoadContext& p_ctx);
 
 static AssetHandle _load_material(int material_index, GLTFLoadContext& p_ctx);
 
+// Create the textures of the materials used by the meshes of `_load_static_meshes` with batched
+// uploads ahead of `_load_texture`.
+static void _load_textures(GLTFLoadContext& p_ctx);
+
 static AssetHandle _load_texture(int texture_index, GLTFLoadContext& p_ctx);
 
+// Bumping invalidates the data cached by the previous versions of the importer.
+constexpr uint32_t GLTF_MESH_IMPORTER_VERSION = 3;
+constexpr uint32_t GLTF_IMAGE_IMPORTER_VERSION = 1;
+
+// Derived data cache entry of a primitive, followed by the vertices, the indices of all of
+// the levels of detail and their `MeshLod` ranges.
+struct GLTFMeshCacheHeader {
+	uint64_t vertex_count;
+	uint64_t index_count;
+	uint64_t lod_count;
+};
+
+// Derived data cache entry of an image, followed by the pixels.
+struct GLTFImageCacheHeader {
+	int32_t width;
+	int32_t height;
+	int32_t component;
+	int32_t bits;
+	int32_t pixel_type;
+};
+
+struct GLTFNodeTransform {
+	glm::vec3 position = VEC3_ZERO;
+	glm::fquat rotation = glm::identity<glm::fquat>();
+	glm::vec3 scale = VEC3_ONE;
+};
+
+static GLTFNodeTransform _get_node_transform(const tinygltf::Node& p_node);
+
 static AssetHandle s_default_texture = INVALID_ASSET_HANDLE;
 static AssetHandle s_default_material = INVALID_ASSET_HANDLE;
 
-GLTFLoadError GLTFLoader::load(std::shared_ptr<Scene> p_scene, const std::string& p_path) {
+GLTFLoadError GLTFLoader::load(std::shared_ptr<Scene> p_scene, const std::string& p_path,
+		const GLTFLoadOptions& p_options) {
 	const auto abs_path_result = AssetSystem::get_absolute_path(p_path);
 	if (!abs_path_result) {
 		GL_LOG_ERROR("[GLTFLoader::load] Unable to parse relative format.");
@@ -54,6 +152,10 @@ GLTFLoadError GLTFLoader::load(std::shared_ptr<Scene> p_scene, const std::string
 
 	const fs::path abs_path = abs_path_result.get_value();
 
+	if (abs_path.extension() == ".glmesh") {
+		return CookedModelLoader::load(p_scene, p_path, p_options);
+	}
+
 	// TODO: better validation
 	if (!abs_path.has_extension() ||
 			!(abs_path.extension() == ".glb" || abs_path.extension() == ".gltf")) {
@@ -61,49 +163,56 @@ GLTFLoadError GLTFLoader::load(std::shared_ptr<Scene> p_scene, const std::string
 		return GLTFLoadError::INVALID_EXTENSION;
 	}
 
-	tinygltf::Model model;
-	tinygltf::TinyGLTF loader;
-	std::string err, warn;
-
-	bool ret;
-	if (abs_path.extension() == ".glb") {
-		ret = loader.LoadBinaryFromFile(&model, &err, &warn, abs_path.string());
-	} else {
-		ret = loader.LoadASCIIFromFile(&model, &err, &warn, abs_path.string());
-	}
+	AssetLoadTrace::LoadScope trace(p_path, "GLTF");
 
-	if (!ret) {
-		GL_LOG_ERROR("[GLTFLoader::load] Unable to parse GLTF file.");
-		if (!err.empty()) {
-			GL_LOG_ERROR("[GLTFLoader::load] [GLTF]:\n%s", err);
+	tinygltf::Model model;
+	std::vector<uint8_t> file_data;
+	{
+		// Images are decoded while parsing
+		AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+		if (const GLTFLoadError err = _parse_gltf(p_path, abs_path, model, file_data, false);
+				err != GLTFLoadError::NONE) {
+			return err;
 		}
-		return GLTFLoadError::PARSING_ERROR;
 	}
 
-#ifdef GL_DEBUG_BUILD
-	GL_LOG_TRACE("[GLTFLoader::load_gltf] Loading GLTF Model from path '{}'", abs_path.string());
-
-	if (!warn.empty()) {
-		GL_LOG_WARNING("[GLTFLoader::load] [GLTF]:\n%s", warn);
-	}
-
-	if (!err.empty()) {
-		GL_LOG_ERROR("[GLTFLoader::load] [GLTF]:\n%s", err);
-	}
-#endif
+	AssetLoadTrace::StageScope stage(AssetLoadStage::REGISTER);
 
 	Entity base_entity = p_scene->create(abs_path.filename().string());
 	// Add GLTFSourceComponent for scene (de)serialization
 	const GLTFSourceComponent* gltf_sc =
-			base_entity.add_component<GLTFSourceComponent>(UID(), p_path);
+			base_entity.add_component<GLTFSourceComponent>(UID(), p_path, p_options);
 
 	GLTFLoadContext ctx;
 	ctx.scene = p_scene;
 	ctx.model = &model;
 	ctx.model_hash = _hash_gltf_model(model);
+	ctx.content_hash = _get_gltf_content_hash(file_data, model);
 	ctx.base_path = abs_path.parent_path();
 	ctx.model_id = gltf_sc->model_id;
+	ctx.options = p_options;
+
+	get_default_assets();
+
+	// Models without scenes are valid, they are loaded as the base entity only
+	if (!model.scenes.empty()) {
+		// The first scene is used if the model does not specify one
+		const int scene_idx = std::max(model.defaultScene, 0);
+
+		_load_static_meshes(ctx, scene_idx);
+		_load_textures(ctx);
 
+		for (int node_index : model.scenes[scene_idx].nodes) {
+			_parse_gltf_node(ctx, node_index, base_entity);
+		}
+	}
+
+	trace.set_succeeded(true);
+
+	return GLTFLoadError::NONE;
+}
+
+GLTFDefaultAssets GLTFLoader::get_default_assets() {
 	// Lazy initialization of defaults
 	if (!s_default_texture || !AssetSystem::get<Texture>(s_default_texture)) {
 		auto tex = Texture::create(COLOR_WHITE, { 1, 1 });
@@ -123,47 +232,132 @@ GLTFLoadError GLTFLoader::load(std::shared_ptr<Scene> p_scene, const std::string
 		s_default_material = AssetSystem::register_asset(mat);
 	}
 
-	for (int node_index : model.scenes[model.defaultScene].nodes) {
-		_parse_gltf_node(ctx, node_index, base_entity);
+	return { s_default_texture, s_default_material };
+}
+
+GLTFLoadError _parse_gltf(const std::string& p_path, const fs::path& p_abs_path,
+		tinygltf::Model& p_model, std::vector<uint8_t>& p_file_data,
+		bool p_decode_external_images) {
+	tinygltf::TinyGLTF loader;
+	std::string err, warn;
+
+	// Read through the AssetSystem so that packed models work and the content can be hashed
+	auto file = AssetSystem::read_file(p_path);
+	if (!file) {
+		GL_LOG_ERROR("[GLTFLoader::load] Unable to read GLTF file '{}'.", p_path);
+		return GLTFLoadError::PATH_ERROR;
+	}
+
+	p_file_data = std::move(*file);
+
+	// External buffers and images are not looked up in the packs, packed models should
+	// be self contained '.glb' files or embed their resources.
+	const std::string base_dir = p_abs_path.parent_path().string();
+
+	// Images are only collected while parsing and decoded afterwards
+	GLTFImageCollector collector;
+	collector.collect_external = p_decode_external_images;
+	loader.SetImageLoader(_defer_gltf_image, &collector);
+
+	bool ret;
+	if (p_abs_path.extension() == ".glb") {
+		ret = loader.LoadBinaryFromMemory(&p_model, &err, &warn, p_file_data.data(),
+				uint32_t(p_file_data.size()), base_dir);
+	} else {
+		ret = loader.LoadASCIIFromString(&p_model, &err, &warn,
+				reinterpret_cast<const char*>(p_file_data.data()), uint32_t(p_file_data.size()),
+				base_dir);
+	}
+
+	if (!ret) {
+		GL_LOG_ERROR("[GLTFLoader::load] Unable to parse GLTF file.");
+		if (!err.empty()) {
+			GL_LOG_ERROR("[GLTFLoader::load] [GLTF]:\n%s", err);
+		}
+		return GLTFLoadError::PARSING_ERROR;
+	}
+
+	const std::vector<GLTFPendingImage>& pending_images = collector.images;
+
+	std::vector<std::string> image_errors(pending_images.size());
+	std::vector<uint8_t> image_results(pending_images.size());
+
+	AssetLoadTrace::ParallelScope trace;
+	JobSystem::parallel_for(uint32_t(pending_images.size()), [&](uint32_t p_index) {
+		AssetLoadTrace::WorkerScope worker_trace(trace);
+		AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+
+		const GLTFPendingImage& pending = pending_images[p_index];
+
+		std::string image_warn;
+		image_results[p_index] = _load_gltf_image(&p_model.images[pending.image_idx],
+				pending.image_idx, pending.bytes, &image_errors[p_index], &image_warn);
+	});
+
+	for (size_t i = 0; i < pending_images.size(); i++) {
+		if (!image_results[i]) {
+			GL_LOG_ERROR("[GLTFLoader::load] Unable to decode GLTF image {}:\n{}",
+					pending_images[i].image_idx, image_errors[i]);
+			return GLTFLoadError::PARSING_ERROR;
+		}
+	}
+
+#ifdef GL_DEBUG_BUILD
+	GL_LOG_TRACE("[GLTFLoader::load_gltf] Loading GLTF Model from path '{}'", p_abs_path.string());
+
+	if (!warn.empty()) {
+		GL_LOG_WARNING("[GLTFLoader::load] [GLTF]:\n%s", warn);
+	}
+
+	if (!err.empty()) {
+		GL_LOG_ERROR("[GLTFLoader::load] [GLTF]:\n%s", err);
 	}
+#endif
 
 	return GLTFLoadError::NONE;
 }
 
-void _parse_gltf_node(GLTFLoadContext& p_ctx, int p_node_idx, Entity p_parent) {
-	const tinygltf::Node& gltf_node = p_ctx.model->nodes[p_node_idx];
-
-	Entity entity = p_ctx.scene->create(gltf_node.name, p_parent);
+// Local transform of the node, either from its matrix or its TRS properties.
+GLTFNodeTransform _get_node_transform(const tinygltf::Node& p_node) {
+	GLTFNodeTransform transform = {};
 
-	if (gltf_node.matrix.size() == 16) {
-		glm::mat4 mat = glm::make_mat4(gltf_node.matrix.data());
+	if (p_node.matrix.size() == 16) {
+		glm::mat4 mat = glm::make_mat4(p_node.matrix.data());
 
 		glm::vec3 skew;
 		glm::vec4 perspective;
-		glm::fquat rotation_quat;
 
-		glm::decompose(mat, entity.get_transform().local_scale, rotation_quat,
-				entity.get_transform().local_position, skew, perspective);
-
-		entity.get_transform().get_rotation() = glm::degrees(glm::eulerAngles(rotation_quat));
+		glm::decompose(mat, transform.scale, transform.rotation, transform.position, skew,
+				perspective);
 	} else {
-		if (gltf_node.translation.size() == 3) {
-			entity.get_transform().local_position = glm::vec3(
-					gltf_node.translation[0], gltf_node.translation[1], gltf_node.translation[2]);
+		if (p_node.translation.size() == 3) {
+			transform.position = glm::vec3(
+					p_node.translation[0], p_node.translation[1], p_node.translation[2]);
 		}
 
-		if (gltf_node.rotation.size() == 4) {
-			entity.get_transform().local_rotation =
-					glm::degrees(glm::eulerAngles(glm::fquat(gltf_node.rotation[3],
-							gltf_node.rotation[0], gltf_node.rotation[1], gltf_node.rotation[2])));
+		if (p_node.rotation.size() == 4) {
+			transform.rotation = glm::fquat(p_node.rotation[3], p_node.rotation[0],
+					p_node.rotation[1], p_node.rotation[2]);
 		}
 
-		if (gltf_node.scale.size() == 3) {
-			entity.get_transform().local_scale =
-					glm::vec3(gltf_node.scale[0], gltf_node.scale[1], gltf_node.scale[2]);
+		if (p_node.scale.size() == 3) {
+			transform.scale = glm::vec3(p_node.scale[0], p_node.scale[1], p_node.scale[2]);
 		}
 	}
 
+	return transform;
+}
+
+void _parse_gltf_node(GLTFLoadContext& p_ctx, int p_node_idx, Entity p_parent) {
+	const tinygltf::Node& gltf_node = p_ctx.model->nodes[p_node_idx];
+
+	Entity entity = p_ctx.scene->create(gltf_node.name, p_parent);
+
+	const GLTFNodeTransform transform = _get_node_transform(gltf_node);
+	entity.get_transform().local_position = transform.position;
+	entity.get_transform().local_rotation = glm::degrees(glm::eulerAngles(transform.rotation));
+	entity.get_transform().local_scale = transform.scale;
+
 	// Load mesh
 	if (gltf_node.mesh >= 0) {
 		entity.add_component<GLTFInstanceComponent>(p_ctx.model_id, gltf_node.mesh);
@@ -171,35 +365,35 @@ void _parse_gltf_node(GLTFLoadContext& p_ctx, int p_node_idx, Entity p_parent) {
 		const tinygltf::Mesh& gltf_mesh = p_ctx.model->meshes[gltf_node.mesh];
 
 		// Lambda to attach components to an entity
-		const auto attach_mesh_components =
-				[&](Entity target_entity, const tinygltf::Primitive& primitive, int prim_index) {
-					// Load Geometry
-					const std::shared_ptr<StaticMesh> static_mesh =
-							_load_static_mesh(&primitive, &gltf_mesh, p_ctx);
-
-					MeshComponent* mc = target_entity.add_component<MeshComponent>();
-					// Register unique mesh asset
-					mc->mesh = AssetSystem::register_asset(static_mesh,
-							std::format("mem://Mesh/GLTF/?node={}&&prim={}&&model={}",
-									p_ctx.model_hash, gltf_node.name, prim_index));
-					mc->visible = true;
-
-					// Load/Attach Material
-					MaterialComponent* mat_comp = target_entity.add_component<MaterialComponent>();
-					mat_comp->definition_path = DEFINITION_PATH_PBR_STANDARD;
-					mat_comp->handle = _load_material(primitive.material, p_ctx);
-				};
+		const auto attach_mesh_components = [&](Entity target_entity, size_t primitive_idx) {
+			// Primitives that could not be decoded
+			const AssetHandle mesh = p_ctx.mesh_handles[gltf_node.mesh][primitive_idx];
+			if (!mesh) {
+				return;
+			}
+
+			MeshComponent* mc = target_entity.add_component<MeshComponent>();
+			mc->mesh = mesh;
+			mc->visible = true;
+			AssetSystem::retain<StaticMesh>(mc->mesh);
+
+			// Load/Attach Material
+			MaterialComponent* mat_comp = target_entity.add_component<MaterialComponent>();
+			mat_comp->definition_path = DEFINITION_PATH_PBR_STANDARD;
+			mat_comp->handle = _load_material(gltf_mesh.primitives[primitive_idx].material, p_ctx);
+			AssetSystem::retain<Material>(mat_comp->handle);
+		};
 
 		// If single primitive, attach to the main Node entity
 		if (gltf_mesh.primitives.size() == 1) {
-			attach_mesh_components(entity, gltf_mesh.primitives[0], 0);
+			attach_mesh_components(entity, 0);
 		}
 		// If multiple primitives, create sub-entities
 		else {
 			for (size_t i = 0; i < gltf_mesh.primitives.size(); ++i) {
 				Entity prim_entity =
 						p_ctx.scene->create(std::format("{}_prim_{}", gltf_node.name, i), entity);
-				attach_mesh_components(prim_entity, gltf_mesh.primitives[i], i);
+				attach_mesh_components(prim_entity, i);
 			}
 		}
 	}
@@ -237,6 +431,38 @@ static ImageWrappingMode _gltf_to_image_wrapping(int p_gltf_wrap) {
 	}
 }
 
+static TextureSamplerOptions _get_sampler_options(
+		const tinygltf::Model& p_model, const tinygltf::Texture& p_texture) {
+	TextureSamplerOptions sampler_options = {};
+	if (p_texture.sampler >= 0) {
+		const tinygltf::Sampler& sampler = p_model.samplers[p_texture.sampler];
+
+		sampler_options.mag_filter = _gltf_to_image_filtering(sampler.magFilter);
+		sampler_options.min_filter = _gltf_to_image_filtering(sampler.minFilter);
+
+		sampler_options.wrap_u = _gltf_to_image_wrapping(sampler.wrapS);
+		sampler_options.wrap_v = _gltf_to_image_wrapping(sampler.wrapT);
+	}
+
+	return sampler_options;
+}
+
+// Format of the decoded image by its component count.
+static std::optional<DataFormat> _get_image_format(const tinygltf::Image& p_image) {
+	switch (p_image.component) {
+		case 1:
+			return DataFormat::R8_UNORM;
+		case 2:
+			return DataFormat::R8G8_UNORM;
+		case 3:
+			return DataFormat::R8G8B8_UNORM;
+		case 4:
+			return DataFormat::R8G8B8A8_UNORM;
+		default:
+			return std::nullopt;
+	}
+}
+
 static int _get_extension_texture_index(
 		const tinygltf::Value& p_extension, const std::string& p_field_name) {
 	if (p_extension.Has(p_field_name)) {
@@ -251,101 +477,264 @@ static int _get_extension_texture_index(
 	return -1;
 }
 
-std::shared_ptr<StaticMesh> _load_static_mesh(const tinygltf::Primitive* p_primitive,
-		const tinygltf::Mesh* p_mesh, GLTFLoadContext& p_ctx) {
-	uint16_t parsing_flags = 0;
+// Parameters of a material regardless of the workflow it is authored with.
+struct GLTFMaterialInfo {
+	glm::vec4 base_color = glm::vec4(1.0f);
+	float metallic = 0.0f;
+	float roughness = 1.0f;
+	// Texture indices, negative if the map is not present
+	int diffuse_texture = -1;
+	int metallic_roughness_texture = -1;
+	int normal_texture = -1;
+	int occlusion_texture = -1;
+};
 
-	const auto& pos_accessor = p_ctx.model->accessors[p_primitive->attributes.at("POSITION")];
-	const auto& pos_view = p_ctx.model->bufferViews[pos_accessor.bufferView];
-	const auto& pos_buffer = p_ctx.model->buffers[pos_view.buffer];
+static GLTFMaterialInfo _get_material_info(const tinygltf::Material& p_material) {
+	GLTFMaterialInfo info = {};
 
-	const auto& index_accessor = p_ctx.model->accessors[p_primitive->indices];
-	const auto& index_view = p_ctx.model->bufferViews[index_accessor.bufferView];
-	const auto& index_buffer = p_ctx.model->buffers[index_view.buffer];
+	if (const auto it = p_material.extensions.find("KHR_materials_pbrSpecularGlossiness");
+			it != p_material.extensions.end()) {
+		const tinygltf::Value& specGloss = it->second;
 
-	uint32_t uv_accessor_offset;
-	uint32_t uv_view_offset;
-	const tinygltf::Buffer* uv_buffer = nullptr;
-	if (p_primitive->attributes.find("TEXCOORD_0") != p_primitive->attributes.end()) {
-		const auto& uv_accessor = p_ctx.model->accessors[p_primitive->attributes.at("TEXCOORD_0")];
-		const auto& uv_view = p_ctx.model->bufferViews[uv_accessor.bufferView];
+		const auto& diffuse_factor = specGloss.Has("diffuseFactor")
+				? specGloss.Get("diffuseFactor").Get<tinygltf::Value::Array>()
+				: tinygltf::Value::Array{ tinygltf::Value(1.0), tinygltf::Value(1.0),
+					  tinygltf::Value(1.0), tinygltf::Value(1.0) };
 
-		uv_accessor_offset = uv_accessor.byteOffset;
-		uv_view_offset = uv_view.byteOffset;
-		uv_buffer = &p_ctx.model->buffers[uv_view.buffer];
-	} else {
-		parsing_flags |= GLTF_PARSING_FLAG_NO_UV;
-	}
+		info.base_color = glm::vec4(float(diffuse_factor[0].GetNumberAsDouble()),
+				float(diffuse_factor[1].GetNumberAsDouble()),
+				float(diffuse_factor[2].GetNumberAsDouble()),
+				float(diffuse_factor[3].GetNumberAsDouble()));
 
-	uint32_t normal_accessor_offset;
-	uint32_t normal_view_offset;
-	const tinygltf::Buffer* normal_buffer = nullptr;
-	if (p_primitive->attributes.find("NORMAL") != p_primitive->attributes.end()) {
-		const auto& normal_accessor = p_ctx.model->accessors[p_primitive->attributes.at("NORMAL")];
-		const auto& normal_view = p_ctx.model->bufferViews[normal_accessor.bufferView];
+		info.diffuse_texture = _get_extension_texture_index(specGloss, "diffuseTexture");
+		info.metallic_roughness_texture =
+				_get_extension_texture_index(specGloss, "specularGlossinessTexture");
 
-		normal_accessor_offset = normal_accessor.byteOffset;
-		normal_view_offset = normal_view.byteOffset;
-		normal_buffer = &p_ctx.model->buffers[normal_view.buffer];
+		info.metallic = 0.0f;
+		info.roughness = 1.0f;
 	} else {
-		parsing_flags |= GLTF_PARSING_FLAG_NO_NORMALS;
+		const auto& base_color = p_material.pbrMetallicRoughness.baseColorFactor;
+		info.base_color = glm::vec4(base_color[0], base_color[1], base_color[2], base_color[3]);
+
+		info.metallic = static_cast<float>(p_material.pbrMetallicRoughness.metallicFactor);
+		info.roughness = static_cast<float>(p_material.pbrMetallicRoughness.roughnessFactor);
+
+		info.diffuse_texture = p_material.pbrMetallicRoughness.baseColorTexture.index;
+		info.metallic_roughness_texture =
+				p_material.pbrMetallicRoughness.metallicRoughnessTexture.index;
 	}
 
-	const size_t vertex_count = pos_accessor.count;
-	std::vector<MeshVertex> prim_vertices(vertex_count);
+	// Common maps
+	info.normal_texture = p_material.normalTexture.index;
+	info.occlusion_texture = p_material.occlusionTexture.index;
+
+	return info;
+}
 
-	constexpr float DEFAULT_NORMAL_DATA[3] = { 0, 0, 0 };
-	constexpr float DEFAULT_UV_DATA[3] = { 0, 0 };
+VertexAttributeStream _get_attribute_stream(const tinygltf::Model& p_model,
+		const tinygltf::Primitive& p_primitive, const char* p_name) {
+	const auto it = p_primitive.attributes.find(p_name);
+	if (it == p_primitive.attributes.end()) {
+		return {};
+	}
 
-	for (size_t i = 0; i < vertex_count; ++i) {
-		const float* pos = reinterpret_cast<const float*>(
-				&pos_buffer.data[pos_view.byteOffset + pos_accessor.byteOffset + i * 12]);
+	const tinygltf::Accessor& accessor = p_model.accessors[it->second];
+	if (accessor.bufferView < 0) {
+		return {};
+	}
 
-		const float* uv = (parsing_flags & GLTF_PARSING_FLAG_NO_UV)
-				? DEFAULT_UV_DATA
-				: reinterpret_cast<const float*>(
-						  &uv_buffer->data[uv_view_offset + uv_accessor_offset + i * 8]);
+	if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.normalized) {
+		GL_LOG_WARNING("[GLTFLoader] Ignoring non float '{}' attribute.", p_name);
+		return {};
+	}
 
-		const float* normal = (parsing_flags & GLTF_PARSING_FLAG_NO_NORMALS)
-				? DEFAULT_NORMAL_DATA
-				: reinterpret_cast<const float*>(&normal_buffer
-								  ->data[normal_view_offset + normal_accessor_offset + i * 12]);
+	const tinygltf::BufferView& view = p_model.bufferViews[accessor.bufferView];
+	const tinygltf::Buffer& buffer = p_model.buffers[view.buffer];
 
-		prim_vertices[i] = {
-			glm::vec3(pos[0], pos[1], pos[2]),
-			uv[0],
-			glm::vec3(normal[0], normal[1], normal[2]),
-			uv[1],
-		};
+	const int stride = accessor.ByteStride(view);
+	const size_t offset = view.byteOffset + accessor.byteOffset;
+	if (stride <= 0 || offset > buffer.data.size()) {
+		return {};
 	}
 
-	const size_t index_count = index_accessor.count;
-	std::vector<uint32_t> prim_indices(index_count);
+	return { buffer.data.data() + offset, size_t(stride), buffer.data.size() - offset };
+}
 
-	switch (index_accessor.componentType) {
-		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-			const uint16_t* indices = reinterpret_cast<const uint16_t*>(
-					&index_buffer.data[index_view.byteOffset + index_accessor.byteOffset]);
-			for (size_t i = 0; i < index_count; ++i) {
-				prim_indices[i] = static_cast<uint32_t>(indices[i]);
-			}
+// Convert the attributes of the primitive into engine vertices and 32 bit indices.
+void _build_primitive_data(const tinygltf::Model& p_model, const tinygltf::Primitive& p_primitive,
+		std::vector<MeshVertex>& p_vertices, std::vector<uint32_t>& p_indices) {
+	const auto& pos_accessor = p_model.accessors[p_primitive.attributes.at("POSITION")];
 
-			break;
-		}
-		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
-			const uint32_t* indices = reinterpret_cast<const uint32_t*>(
-					&index_buffer.data[index_view.byteOffset + index_accessor.byteOffset]);
-			for (size_t i = 0; i < index_count; ++i) {
-				prim_indices[i] = indices[i];
-			}
+	const auto& index_accessor = p_model.accessors[p_primitive.indices];
+	const auto& index_view = p_model.bufferViews[index_accessor.bufferView];
+	const auto& index_buffer = p_model.buffers[index_view.buffer];
 
+	// Attributes may be interleaved, missing normals and UVs are zero
+	p_vertices.resize(pos_accessor.count);
+	gather_vertices(_get_attribute_stream(p_model, p_primitive, "POSITION"),
+			_get_attribute_stream(p_model, p_primitive, "NORMAL"),
+			_get_attribute_stream(p_model, p_primitive, "TEXCOORD_0"), p_vertices);
+
+	p_indices.resize(index_accessor.count);
+
+	const uint8_t* indices =
+			&index_buffer.data[index_view.byteOffset + index_accessor.byteOffset];
+
+	switch (index_accessor.componentType) {
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			widen_indices(indices, p_indices);
+			break;
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			widen_indices(reinterpret_cast<const uint16_t*>(indices), p_indices);
+			break;
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+			memcpy(p_indices.data(), indices, p_indices.size() * sizeof(uint32_t));
 			break;
-		}
 		default:
 			GL_ASSERT(false, "Unsupported index type");
 	}
+}
+
+void _load_static_meshes(GLTFLoadContext& p_ctx, int p_scene_idx) {
+	GL_PROFILE_SCOPE;
+
+	const tinygltf::Model& model = *p_ctx.model;
+
+	p_ctx.mesh_handles.resize(model.meshes.size());
+
+	// Only the meshes the nodes of the scene refer to are loaded
+	std::vector<int> node_stack(
+			model.scenes[p_scene_idx].nodes.begin(), model.scenes[p_scene_idx].nodes.end());
+	std::vector<std::pair<int, uint32_t>> primitives;
+	while (!node_stack.empty()) {
+		const tinygltf::Node& node = model.nodes[node_stack.back()];
+		node_stack.pop_back();
+
+		node_stack.insert(node_stack.end(), node.children.begin(), node.children.end());
+
+		if (node.mesh < 0 || !p_ctx.mesh_handles[node.mesh].empty()) {
+			continue;
+		}
+
+		const size_t primitive_count = model.meshes[node.mesh].primitives.size();
+		p_ctx.mesh_handles[node.mesh].resize(primitive_count, INVALID_ASSET_HANDLE);
+		for (uint32_t i = 0; i < primitive_count; i++) {
+			primitives.push_back({ node.mesh, i });
+		}
+	}
+
+	// Every primitive writes its own slot, the entities are created serially afterwards
+	AssetLoadTrace::ParallelScope trace;
+	JobSystem::parallel_for(uint32_t(primitives.size()), [&](uint32_t p_index) {
+		AssetLoadTrace::WorkerScope worker_trace(trace);
+		AssetLoadTrace::StageScope stage(AssetLoadStage::REGISTER);
 
-	return StaticMesh::create(prim_vertices, prim_indices);
+		const auto [mesh_idx, primitive_idx] = primitives[p_index];
+		const tinygltf::Mesh& mesh = model.meshes[mesh_idx];
+
+		p_ctx.mesh_handles[mesh_idx][primitive_idx] =
+				_load_static_mesh(&mesh.primitives[primitive_idx], &mesh, p_ctx);
+	});
+}
+
+AssetHandle _load_static_mesh(const tinygltf::Primitive* p_primitive,
+		const tinygltf::Mesh* p_mesh, const GLTFLoadContext& p_ctx) {
+	if (p_primitive->indices < 0 || !p_primitive->attributes.contains("POSITION")) {
+		GL_LOG_WARNING("[GLTFLoader::load] Skipping non indexed primitive of mesh '{}'.",
+				p_mesh->name);
+		return INVALID_ASSET_HANDLE;
+	}
+
+	const auto get_attribute = [&](const char* p_name) -> int64_t {
+		const auto it = p_primitive->attributes.find(p_name);
+		return it != p_primitive->attributes.end() ? it->second : -1;
+	};
+
+	// Accessors identify the primitive within the content of the model
+	const std::array<int64_t, 6> key_data = {
+		int64_t(p_ctx.content_hash),
+		get_attribute("POSITION"),
+		get_attribute("TEXCOORD_0"),
+		get_attribute("NORMAL"),
+		p_primitive->indices,
+		p_ctx.options.lod_count,
+	};
+
+	const DerivedDataKey key = {
+		"gltf_mesh",
+		GLTF_MESH_IMPORTER_VERSION,
+		content_hash64({ reinterpret_cast<const uint8_t*>(key_data.data()), sizeof(key_data) }),
+	};
+
+	if (const auto cached = DerivedDataCache::load(key);
+			cached && cached->size() >= sizeof(GLTFMeshCacheHeader)) {
+		GLTFMeshCacheHeader header;
+		memcpy(&header, cached->data(), sizeof(header));
+
+		const size_t vertices_size = header.vertex_count * sizeof(MeshVertex);
+		const size_t indices_size = header.index_count * sizeof(uint32_t);
+		const size_t lods_size = header.lod_count * sizeof(MeshLod);
+
+		if (cached->size() == sizeof(header) + vertices_size + indices_size + lods_size) {
+			// Entries hold nothing but the geometry, their hash identifies the mesh
+			const uint64_t mesh_hash =
+					_get_mesh_content_hash(*cached, p_ctx.options.vertex_format);
+
+			return AssetSystem::find_or_register<StaticMesh>(mesh_hash, [&]() {
+				std::vector<MeshVertex> vertices(header.vertex_count);
+				std::vector<uint32_t> indices(header.index_count);
+				std::vector<MeshLod> lods(header.lod_count);
+
+				const uint8_t* data = cached->data() + sizeof(header);
+				memcpy(vertices.data(), data, vertices_size);
+				memcpy(indices.data(), data + vertices_size, indices_size);
+				memcpy(lods.data(), data + vertices_size + indices_size, lods_size);
+
+				return StaticMesh::create(
+						vertices, indices, p_ctx.options.vertex_format, lods);
+			});
+		}
+	}
+
+	std::vector<MeshVertex> prim_vertices;
+	std::vector<uint32_t> prim_indices;
+	// Simplified levels follow the full detail indices
+	std::vector<uint32_t> lod_indices;
+	std::vector<MeshLod> lods;
+	{
+		AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+		_build_primitive_data(*p_ctx.model, *p_primitive, prim_vertices, prim_indices);
+		optimize_mesh(prim_vertices, prim_indices);
+		lods = build_lods(prim_vertices, prim_indices, lod_indices, p_ctx.options.lod_count);
+	}
+
+	const GLTFMeshCacheHeader header = { prim_vertices.size(), lod_indices.size(), lods.size() };
+	const size_t vertices_size = prim_vertices.size() * sizeof(MeshVertex);
+	const size_t indices_size = lod_indices.size() * sizeof(uint32_t);
+	const size_t lods_size = lods.size() * sizeof(MeshLod);
+
+	std::vector<uint8_t> cache_data(sizeof(header) + vertices_size + indices_size + lods_size);
+	uint8_t* data = cache_data.data();
+	memcpy(data, &header, sizeof(header));
+	memcpy(data + sizeof(header), prim_vertices.data(), vertices_size);
+	memcpy(data + sizeof(header) + vertices_size, lod_indices.data(), indices_size);
+	memcpy(data + sizeof(header) + vertices_size + indices_size, lods.data(), lods_size);
+	DerivedDataCache::store(key, cache_data);
+
+	return AssetSystem::find_or_register<StaticMesh>(
+			_get_mesh_content_hash(cache_data, p_ctx.options.vertex_format), [&]() {
+				return StaticMesh::create(
+						prim_vertices, lod_indices, p_ctx.options.vertex_format, lods);
+			});
+}
+
+uint64_t _get_mesh_content_hash(std::span<const uint8_t> p_geometry, MeshVertexFormat p_format) {
+	const std::array<uint64_t, 2> key_data = {
+		content_hash64(p_geometry),
+		uint64_t(p_format),
+	};
+
+	return content_hash64({ reinterpret_cast<const uint8_t*>(key_data.data()), sizeof(key_data) });
 }
 
 AssetHandle _load_material(int p_material_index, GLTFLoadContext& p_ctx) {
@@ -374,77 +763,150 @@ AssetHandle _load_material(int p_material_index, GLTFLoadContext& p_ctx) {
 	const AssetHandle handle = *handle_opt;
 	std::shared_ptr<Material> material = AssetSystem::get<Material>(*handle_opt);
 
-	// Set Parameters
-	const auto& base_color = gltf_material.pbrMetallicRoughness.baseColorFactor;
+	const GLTFMaterialInfo info = _get_material_info(gltf_material);
 
-	if (const auto it = gltf_material.extensions.find("KHR_materials_pbrSpecularGlossiness");
-			it != gltf_material.extensions.end()) {
-		const tinygltf::Value& specGloss = it->second;
+	const auto load_texture = [&](int p_texture_index) -> AssetHandle {
+		return p_texture_index >= 0 ? _load_texture(p_texture_index, p_ctx) : s_default_texture;
+	};
 
-		const auto& diffuse_factor = specGloss.Has("diffuseFactor")
-				? specGloss.Get("diffuseFactor").Get<tinygltf::Value::Array>()
-				: tinygltf::Value::Array{ tinygltf::Value(1.0), tinygltf::Value(1.0),
-					  tinygltf::Value(1.0), tinygltf::Value(1.0) };
+	material->set_param("base_color", info.base_color);
+	material->set_param("metallic", info.metallic);
+	material->set_param("roughness", info.roughness);
 
-		material->set_param("base_color",
-				glm::vec4(float(diffuse_factor[0].GetNumberAsDouble()),
-						float(diffuse_factor[1].GetNumberAsDouble()),
-						float(diffuse_factor[2].GetNumberAsDouble()),
-						float(diffuse_factor[3].GetNumberAsDouble())));
+	material->set_param("u_diffuse_texture", load_texture(info.diffuse_texture));
+	material->set_param(
+			"u_metallic_roughness_texture", load_texture(info.metallic_roughness_texture));
+	material->set_param("u_normal_texture", load_texture(info.normal_texture));
+	material->set_param("u_ambient_occlusion_texture", load_texture(info.occlusion_texture));
 
-		const int diffuse_texture_index = _get_extension_texture_index(specGloss, "diffuseTexture");
-		AssetHandle diffuse_texture = (diffuse_texture_index >= 0)
-				? _load_texture(diffuse_texture_index, p_ctx)
-				: s_default_texture;
-		material->set_param("u_diffuse_texture", diffuse_texture);
+	material->upload();
 
-		const int specular_texture_index =
-				_get_extension_texture_index(specGloss, "specularGlossinessTexture");
-		AssetHandle specular_texture = (specular_texture_index >= 0)
-				? _load_texture(specular_texture_index, p_ctx)
-				: s_default_texture;
-		material->set_param("u_metallic_roughness_texture", specular_texture);
+	// Textures were assigned after the material got registered
+	AssetSystem::update_dependencies<Material>(handle);
 
-		material->set_param("metallic", 0.0f);
-		material->set_param("roughness", 1.0f);
-	} else {
-		const auto& base_color = gltf_material.pbrMetallicRoughness.baseColorFactor;
-		material->set_param("base_color",
-				glm::vec4(base_color[0], base_color[1], base_color[2], base_color[3]));
+	// Cache and return
+	p_ctx.loaded_materials[p_material_index] = handle;
+	return handle;
+}
+
+void _load_textures(GLTFLoadContext& p_ctx) {
+	GL_PROFILE_SCOPE;
 
-		material->set_param(
-				"metallic", static_cast<float>(gltf_material.pbrMetallicRoughness.metallicFactor));
-		material->set_param("roughness",
-				static_cast<float>(gltf_material.pbrMetallicRoughness.roughnessFactor));
+	const tinygltf::Model& model = *p_ctx.model;
 
-		const int albedo_texture_index = gltf_material.pbrMetallicRoughness.baseColorTexture.index;
-		AssetHandle albedo_texture = (albedo_texture_index >= 0)
-				? _load_texture(albedo_texture_index, p_ctx)
-				: s_default_texture;
-		material->set_param("u_diffuse_texture", albedo_texture);
+	// Textures are created once per content, every texture of the model sharing it gets it
+	std::unordered_map<uint64_t, std::vector<int>> content_textures;
+	std::vector<uint64_t> embedded_hashes;
+	std::vector<TextureCreateInfo> embedded_textures;
+	std::vector<uint64_t> external_hashes;
+	std::vector<fs::path> external_paths;
+	std::vector<TextureSamplerOptions> external_samplers;
 
-		const int metallic_roughness_texture_index =
-				gltf_material.pbrMetallicRoughness.metallicRoughnessTexture.index;
-		AssetHandle metallic_roughness_texture = (metallic_roughness_texture_index >= 0)
-				? _load_texture(metallic_roughness_texture_index, p_ctx)
-				: s_default_texture;
-		material->set_param("u_metallic_roughness_texture", metallic_roughness_texture);
+	// Only the materials of the primitives the scene refers to are used by the entities
+	std::vector<uint8_t> used_materials(model.materials.size(), false);
+	for (size_t mesh_idx = 0; mesh_idx < p_ctx.mesh_handles.size(); mesh_idx++) {
+		if (p_ctx.mesh_handles[mesh_idx].empty()) {
+			continue;
+		}
+
+		for (const tinygltf::Primitive& primitive : model.meshes[mesh_idx].primitives) {
+			if (primitive.material >= 0 && primitive.material < int(model.materials.size())) {
+				used_materials[primitive.material] = true;
+			}
+		}
 	}
 
-	// Common maps
-	const int norm_index = gltf_material.normalTexture.index;
-	material->set_param("u_normal_texture",
-			(norm_index >= 0) ? _load_texture(norm_index, p_ctx) : s_default_texture);
+	for (size_t material_idx = 0; material_idx < model.materials.size(); material_idx++) {
+		if (!used_materials[material_idx]) {
+			continue;
+		}
 
-	const int occ_index = gltf_material.occlusionTexture.index;
-	material->set_param("u_ambient_occlusion_texture",
-			(occ_index >= 0) ? _load_texture(occ_index, p_ctx) : s_default_texture);
+		const GLTFMaterialInfo info = _get_material_info(model.materials[material_idx]);
 
-	material->upload();
+		for (const int texture_idx : { info.diffuse_texture, info.metallic_roughness_texture,
+					 info.normal_texture, info.occlusion_texture }) {
+			if (texture_idx < 0 || texture_idx >= int(model.textures.size())) {
+				continue;
+			}
 
-	// Cache and return
-	p_ctx.loaded_materials[p_material_index] = handle;
-	return handle;
+			const tinygltf::Texture& gltf_texture = model.textures[texture_idx];
+			if (gltf_texture.source < 0) {
+				continue;
+			}
+
+			const tinygltf::Image& gltf_image = model.images[gltf_texture.source];
+
+			const TextureSamplerOptions sampler_options =
+					_get_sampler_options(model, gltf_texture);
+
+			const fs::path texture_path =
+					gltf_image.uri.empty() ? fs::path() : p_ctx.base_path / gltf_image.uri;
+
+			const uint64_t content_hash =
+					_get_texture_content_hash(gltf_image, texture_path, sampler_options);
+			p_ctx.texture_content_hashes[texture_idx] = content_hash;
+
+			std::vector<int>& textures = content_textures[content_hash];
+			if (std::find(textures.begin(), textures.end(), texture_idx) != textures.end()) {
+				continue;
+			}
+
+			textures.push_back(texture_idx);
+
+			// Created already by this or another model
+			if (textures.size() > 1 || AssetSystem::find<Texture>(content_hash)) {
+				continue;
+			}
+
+			if (!gltf_image.uri.empty()) {
+				external_hashes.push_back(content_hash);
+				external_paths.push_back(texture_path);
+				external_samplers.push_back(sampler_options);
+			} else if (const std::optional<DataFormat> format = _get_image_format(gltf_image)) {
+				embedded_hashes.push_back(content_hash);
+				embedded_textures.push_back({
+						*format,
+						glm::uvec2(gltf_image.width, gltf_image.height),
+						gltf_image.image.data(),
+						sampler_options,
+				});
+			}
+		}
+	}
+
+	const std::vector<std::shared_ptr<Texture>> embedded = Texture::create_batch(embedded_textures);
+	const std::vector<std::shared_ptr<Texture>> external =
+			Texture::load_from_files(external_paths, external_samplers);
+
+	const auto register_textures = [&](std::span<const uint64_t> p_hashes,
+										   std::span<const std::shared_ptr<Texture>> p_textures) {
+		for (size_t i = 0; i < p_hashes.size(); i++) {
+			// Failed ones are retried and reported by `_load_texture`
+			if (!p_textures[i]) {
+				continue;
+			}
+
+			AssetSystem::find_or_register<Texture>(p_hashes[i], [&]() { return p_textures[i]; });
+		}
+	};
+
+	register_textures(embedded_hashes, embedded);
+	register_textures(external_hashes, external);
+
+	for (const auto& [content_hash, textures] : content_textures) {
+		const AssetHandle handle = AssetSystem::find<Texture>(content_hash);
+		if (!handle) {
+			continue;
+		}
+
+		for (const int texture_idx : textures) {
+			size_t hash = 0;
+			hash_combine(hash, texture_idx);
+			hash_combine(hash, p_ctx.model_hash);
+
+			p_ctx.loaded_textures[hash] = handle;
+		}
+	}
 }
 
 AssetHandle _load_texture(int p_texture_index, GLTFLoadContext& p_ctx) {
@@ -459,62 +921,77 @@ AssetHandle _load_texture(int p_texture_index, GLTFLoadContext& p_ctx) {
 	const tinygltf::Texture& gltf_texture = p_ctx.model->textures[p_texture_index];
 	const tinygltf::Image& gltf_image = p_ctx.model->images[gltf_texture.source];
 
-	TextureSamplerOptions sampler_options = {};
-	if (gltf_texture.sampler >= 0) {
-		const tinygltf::Sampler& sampler = p_ctx.model->samplers[gltf_texture.sampler];
+	const TextureSamplerOptions sampler_options =
+			_get_sampler_options(*p_ctx.model, gltf_texture);
+
+	const fs::path texture_path =
+			gltf_image.uri.empty() ? fs::path() : p_ctx.base_path / gltf_image.uri;
+
+	// Hashed already if `_load_textures` got to the texture
+	const auto hash_it = p_ctx.texture_content_hashes.find(p_texture_index);
+	const uint64_t content_hash = hash_it != p_ctx.texture_content_hashes.end()
+			? hash_it->second
+			: _get_texture_content_hash(gltf_image, texture_path, sampler_options);
+
+	// Models sharing the image share the texture
+	const AssetHandle texture_handle = AssetSystem::find_or_register<Texture>(content_hash,
+			[&]() -> std::shared_ptr<Texture> {
+				if (gltf_image.uri.empty()) {
+					const std::optional<DataFormat> format = _get_image_format(gltf_image);
+					GL_ASSERT(format, "Unsupported image component count");
+
+					return Texture::create(*format,
+							glm::uvec2(gltf_image.width, gltf_image.height),
+							gltf_image.image.data(), sampler_options);
+				}
+
+				return Texture::load_from_file(texture_path, sampler_options);
+			});
+
+	if (!texture_handle) {
+		GL_LOG_ERROR("[GLTFLoader::_load_texture] Unable to load GLTF texture from path '{}'",
+				texture_path.string());
+		return INVALID_ASSET_HANDLE;
+	}
 
-		sampler_options.mag_filter = _gltf_to_image_filtering(sampler.magFilter);
-		sampler_options.min_filter = _gltf_to_image_filtering(sampler.minFilter);
+	p_ctx.loaded_textures[hash] = texture_handle;
 
-		sampler_options.wrap_u = _gltf_to_image_wrapping(sampler.wrapS);
-		sampler_options.wrap_v = _gltf_to_image_wrapping(sampler.wrapT);
-	}
+	return texture_handle;
+}
 
-	AssetHandle texture_handle;
-	if (gltf_image.uri.empty()) {
-		DataFormat format;
-		switch (gltf_image.component) {
-			case 1:
-				format = DataFormat::R8_UNORM;
-				break;
-			case 2:
-				format = DataFormat::R8G8_UNORM;
-				break;
-			case 3:
-				format = DataFormat::R8G8B8_UNORM;
-				break;
-			case 4:
-				format = DataFormat::R8G8B8A8_UNORM;
-				break;
-			default:
-				GL_ASSERT(false,
-						"Unsupported image component "
-						"count");
-		}
-
-		texture_handle = AssetSystem::register_asset(
-				Texture::create(format, glm::uvec2(gltf_image.width, gltf_image.height),
-						gltf_image.image.data(), sampler_options),
-				std::format(
-						"mem://Texture/GLTF/?id={}&&model={}", p_ctx.model_hash, p_texture_index));
+uint64_t _get_texture_content_hash(const tinygltf::Image& p_image, const fs::path& p_path,
+		const TextureSamplerOptions& p_sampler) {
+	uint64_t source_hash;
+	uint64_t write_time = 0;
+	if (!p_image.image.empty()) {
+		// Decoded pixels identify the image regardless of the file it came from
+		source_hash = content_hash64(p_image.image);
 	} else {
-		const fs::path texture_path = p_ctx.base_path / gltf_image.uri;
-
-		auto texture = Texture::load_from_file(texture_path, sampler_options);
-		if (!texture) {
-			GL_LOG_ERROR("[GLTFLoader::_load_texture] Unable to load GLTF texture from path '{}'",
-					texture_path.string());
-			return INVALID_ASSET_HANDLE;
-		}
+		const std::string path = p_path.string();
+		source_hash =
+				content_hash64({ reinterpret_cast<const uint8_t*>(path.data()), path.size() });
 
-		texture_handle = AssetSystem::register_asset(texture,
-				std::format("mem://Texture/GLTF/?path={}&&model={}", p_ctx.model_hash,
-						texture_path.string()));
+		std::error_code err;
+		write_time = fs::last_write_time(p_path, err).time_since_epoch().count();
 	}
 
-	p_ctx.loaded_textures[hash] = texture_handle;
-
-	return texture_handle;
+	const std::array<uint64_t, 12> key_data = {
+		source_hash,
+		write_time,
+		uint64_t(p_image.width),
+		uint64_t(p_image.height),
+		uint64_t(p_image.component),
+		uint64_t(p_image.bits),
+		// External images are loaded as RGBA, embedded ones keep their component count
+		uint64_t(p_image.uri.empty()),
+		uint64_t(p_sampler.mag_filter),
+		uint64_t(p_sampler.min_filter),
+		uint64_t(p_sampler.wrap_u),
+		uint64_t(p_sampler.wrap_v),
+		uint64_t(p_sampler.wrap_w),
+	};
+
+	return content_hash64({ reinterpret_cast<const uint8_t*>(key_data.data()), sizeof(key_data) });
 }
 
 size_t _hash_gltf_model(const tinygltf::Model& p_model) {
@@ -552,4 +1029,387 @@ size_t _hash_gltf_model(const tinygltf::Model& p_model) {
 	return seed;
 }
 
+uint64_t _get_gltf_content_hash(std::span<const uint8_t> p_file, const tinygltf::Model& p_model) {
+	std::vector<uint64_t> hashes = { content_hash64(p_file) };
+
+	// Embedded buffers are covered by the file itself
+	for (const tinygltf::Buffer& buffer : p_model.buffers) {
+		if (!buffer.uri.empty() && !buffer.uri.starts_with("data:")) {
+			hashes.push_back(content_hash64(buffer.data));
+		}
+	}
+
+	return content_hash64({ reinterpret_cast<const uint8_t*>(hashes.data()),
+			hashes.size() * sizeof(uint64_t) });
+}
+
+bool _defer_gltf_image(tinygltf::Image* p_image, const int p_image_idx, std::string* p_err,
+		std::string* p_warn, int p_req_width, int p_req_height, const unsigned char* p_bytes,
+		int p_size, void* p_user_data) {
+	auto* collector = static_cast<GLTFImageCollector*>(p_user_data);
+
+	// The uri is only assigned to external images before they are handed to the loader
+	if (!collector->collect_external && !p_image->uri.empty()) {
+		return true;
+	}
+
+	// Bytes might be a temporary of the parser
+	collector->images.push_back(
+			{ p_image_idx, std::vector<uint8_t>(p_bytes, p_bytes + p_size) });
+
+	return true;
+}
+
+bool _load_gltf_image(tinygltf::Image* p_image, int p_image_idx, std::span<const uint8_t> p_bytes,
+		std::string* p_err, std::string* p_warn) {
+	const DerivedDataKey key = {
+		"gltf_image",
+		GLTF_IMAGE_IMPORTER_VERSION,
+		content_hash64(p_bytes),
+	};
+
+	if (const auto cached = DerivedDataCache::load(key);
+			cached && cached->size() >= sizeof(GLTFImageCacheHeader)) {
+		GLTFImageCacheHeader header;
+		memcpy(&header, cached->data(), sizeof(header));
+
+		const size_t pixels_size =
+				size_t(header.width) * header.height * header.component * (header.bits / 8);
+		if (cached->size() == sizeof(header) + pixels_size) {
+			p_image->width = header.width;
+			p_image->height = header.height;
+			p_image->component = header.component;
+			p_image->bits = header.bits;
+			p_image->pixel_type = header.pixel_type;
+			p_image->image.assign(cached->begin() + sizeof(header), cached->end());
+
+			return true;
+		}
+	}
+
+	// No user data, tinygltf reads it as its own load options
+	if (!tinygltf::LoadImageData(p_image, p_image_idx, p_err, p_warn, 0, 0, p_bytes.data(),
+				int(p_bytes.size()), nullptr)) {
+		return false;
+	}
+
+	const GLTFImageCacheHeader header = {
+		p_image->width,
+		p_image->height,
+		p_image->component,
+		p_image->bits,
+		p_image->pixel_type,
+	};
+
+	std::vector<uint8_t> cache_data(sizeof(header) + p_image->image.size());
+	memcpy(cache_data.data(), &header, sizeof(header));
+	memcpy(cache_data.data() + sizeof(header), p_image->image.data(), p_image->image.size());
+	DerivedDataCache::store(key, cache_data);
+
+	return true;
+}
+
+struct GLTFCookContext {
+	const tinygltf::Model* model;
+	std::vector<CookedModelNode> nodes;
+	std::vector<CookedSubmesh> submeshes;
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<MeshLod> lods;
+	std::string strings;
+	GLTFCookStats stats;
+	// Submesh range of every cooked mesh, meshes instanced by multiple nodes are stored once
+	std::unordered_map<int, std::pair<uint32_t, uint32_t>> mesh_submeshes;
+	AABB aabb = {
+		.min = glm::vec3(std::numeric_limits<float>::max()),
+		.max = glm::vec3(std::numeric_limits<float>::lowest()),
+	};
+};
+
+static uint32_t _push_cooked_string(GLTFCookContext& p_ctx, std::string_view p_string) {
+	const uint32_t offset = uint32_t(p_ctx.strings.size());
+	p_ctx.strings.append(p_string);
+	return offset;
+}
+
+static std::pair<uint32_t, uint32_t> _cook_gltf_mesh(GLTFCookContext& p_ctx, int p_mesh_idx) {
+	if (const auto it = p_ctx.mesh_submeshes.find(p_mesh_idx); it != p_ctx.mesh_submeshes.end()) {
+		return it->second;
+	}
+
+	const tinygltf::Mesh& gltf_mesh = p_ctx.model->meshes[p_mesh_idx];
+	const uint32_t submesh_offset = uint32_t(p_ctx.submeshes.size());
+
+	for (const tinygltf::Primitive& primitive : gltf_mesh.primitives) {
+		CookedSubmesh submesh = {};
+		submesh.vertex_offset = uint32_t(p_ctx.vertices.size());
+		submesh.index_offset = uint32_t(p_ctx.indices.size());
+		submesh.material_index = primitive.material;
+
+		// Keep the primitive so entities are named the same, it gets no mesh when loaded
+		if (primitive.indices < 0 || !primitive.attributes.contains("POSITION")) {
+			GL_LOG_WARNING("[GLTFCooker::cook] Skipping non indexed primitive of mesh '{}'.",
+					gltf_mesh.name);
+			p_ctx.submeshes.push_back(submesh);
+			continue;
+		}
+
+		std::vector<MeshVertex> vertices;
+		std::vector<uint32_t> indices;
+		_build_primitive_data(*p_ctx.model, primitive, vertices, indices);
+
+		p_ctx.stats.triangle_count += indices.size() / 3;
+		p_ctx.stats.source_transformed_count +=
+				analyze_vertex_cache(indices, vertices.size()).transformed_count;
+
+		optimize_mesh(vertices, indices);
+
+		p_ctx.stats.transformed_count +=
+				analyze_vertex_cache(indices, vertices.size()).transformed_count;
+
+		std::vector<uint32_t> lod_indices;
+		const std::vector<MeshLod> lods = build_lods(vertices, indices, lod_indices);
+
+		submesh.vertex_count = uint32_t(vertices.size());
+		submesh.index_count = uint32_t(lod_indices.size());
+		submesh.lod_offset = uint32_t(p_ctx.lods.size());
+		submesh.lod_count = uint32_t(lods.size());
+		submesh.aabb = {
+			.min = glm::vec3(std::numeric_limits<float>::max()),
+			.max = glm::vec3(std::numeric_limits<float>::lowest()),
+		};
+		for (const MeshVertex& vertex : vertices) {
+			submesh.aabb.min = glm::min(submesh.aabb.min, vertex.position);
+			submesh.aabb.max = glm::max(submesh.aabb.max, vertex.position);
+		}
+
+		p_ctx.vertices.insert(p_ctx.vertices.end(), vertices.begin(), vertices.end());
+		p_ctx.indices.insert(p_ctx.indices.end(), lod_indices.begin(), lod_indices.end());
+		p_ctx.lods.insert(p_ctx.lods.end(), lods.begin(), lods.end());
+		p_ctx.submeshes.push_back(submesh);
+	}
+
+	const std::pair<uint32_t, uint32_t> range = {
+		submesh_offset,
+		uint32_t(p_ctx.submeshes.size()) - submesh_offset,
+	};
+	p_ctx.mesh_submeshes[p_mesh_idx] = range;
+
+	return range;
+}
+
+static void _cook_gltf_node(GLTFCookContext& p_ctx, int p_node_idx, int32_t p_parent_index,
+		const glm::mat4& p_parent_transform) {
+	const tinygltf::Node& gltf_node = p_ctx.model->nodes[p_node_idx];
+
+	const GLTFNodeTransform transform = _get_node_transform(gltf_node);
+
+	CookedModelNode node = {};
+	node.parent_index = p_parent_index;
+	node.gltf_node_id = gltf_node.mesh;
+	node.name_offset = _push_cooked_string(p_ctx, gltf_node.name);
+	node.name_length = uint32_t(gltf_node.name.size());
+	node.position = transform.position;
+	node.rotation = glm::degrees(glm::eulerAngles(transform.rotation));
+	node.scale = transform.scale;
+
+	const glm::mat4 world_transform = p_parent_transform *
+			glm::translate(glm::mat4(1.0f), transform.position) *
+			glm::mat4_cast(transform.rotation) * glm::scale(glm::mat4(1.0f), transform.scale);
+
+	if (gltf_node.mesh >= 0) {
+		std::tie(node.submesh_offset, node.submesh_count) =
+				_cook_gltf_mesh(p_ctx, gltf_node.mesh);
+
+		for (uint32_t i = 0; i < node.submesh_count; i++) {
+			const CookedSubmesh& submesh = p_ctx.submeshes[node.submesh_offset + i];
+			if (submesh.vertex_count == 0) {
+				continue;
+			}
+
+			const AABB aabb = submesh.aabb.transform(world_transform);
+			p_ctx.aabb.min = glm::min(p_ctx.aabb.min, aabb.min);
+			p_ctx.aabb.max = glm::max(p_ctx.aabb.max, aabb.max);
+		}
+	}
+
+	const int32_t node_index = int32_t(p_ctx.nodes.size());
+	p_ctx.nodes.push_back(node);
+
+	for (int child_node_idx : gltf_node.children) {
+		_cook_gltf_node(p_ctx, child_node_idx, node_index, world_transform);
+	}
+}
+
+// Write the image of the texture as '.gltex', returns `false` if it is not supported.
+static bool _cook_gltf_texture(
+		const tinygltf::Model& p_model, int p_texture_idx, const fs::path& p_path) {
+	const tinygltf::Texture& gltf_texture = p_model.textures[p_texture_idx];
+	if (gltf_texture.source < 0) {
+		return false;
+	}
+
+	const tinygltf::Image& gltf_image = p_model.images[gltf_texture.source];
+
+	const std::optional<DataFormat> format = _get_image_format(gltf_image);
+	if (!format || gltf_image.bits != 8 || gltf_image.image.empty()) {
+		GL_LOG_WARNING("[GLTFCooker::cook] Unsupported image '{}', using the default texture.",
+				gltf_image.name);
+		return false;
+	}
+
+	return Texture::save_cooked(p_path, *format,
+			glm::uvec2(gltf_image.width, gltf_image.height), gltf_image.image,
+			_get_sampler_options(p_model, gltf_texture));
+}
+
+GLTFLoadError GLTFCooker::cook(
+		const fs::path& p_path, const fs::path& p_output_dir, GLTFCookStats* p_out_stats) {
+	GL_PROFILE_SCOPE;
+
+	if (!(p_path.extension() == ".glb" || p_path.extension() == ".gltf")) {
+		GL_LOG_ERROR("[GLTFCooker::cook] Unable to cook non gltf formats.");
+		return GLTFLoadError::INVALID_EXTENSION;
+	}
+
+	tinygltf::Model model;
+	std::vector<uint8_t> file_data;
+	// Cooked textures are built from the decoded pixels
+	if (const GLTFLoadError err = _parse_gltf(p_path.string(), p_path, model, file_data, true);
+			err != GLTFLoadError::NONE) {
+		return err;
+	}
+
+	std::error_code fs_err;
+	fs::create_directories(p_output_dir, fs_err);
+
+	const std::string stem = p_path.stem().string();
+
+	// Textures are shared by the materials, cook each of them once
+	std::unordered_map<int, std::string> cooked_textures;
+	const auto cook_texture = [&](int p_texture_idx) -> std::optional<std::string> {
+		if (p_texture_idx < 0 || p_texture_idx >= int(model.textures.size())) {
+			return std::nullopt;
+		}
+
+		if (const auto it = cooked_textures.find(p_texture_idx); it != cooked_textures.end()) {
+			return it->second.empty() ? std::nullopt : std::optional(it->second);
+		}
+
+		std::string name = std::format("{}_tex{}.gltex", stem, p_texture_idx);
+		if (!_cook_gltf_texture(model, p_texture_idx, p_output_dir / name)) {
+			name.clear();
+		}
+
+		cooked_textures[p_texture_idx] = name;
+		return name.empty() ? std::nullopt : std::optional(name);
+	};
+
+	GLTFCookContext ctx;
+	ctx.model = &model;
+
+	std::vector<CookedMaterialPath> material_paths;
+	for (size_t i = 0; i < model.materials.size(); i++) {
+		const GLTFMaterialInfo info = _get_material_info(model.materials[i]);
+
+		json j;
+		j["definition_path"] = DEFINITION_PATH_PBR_STANDARD;
+		j["uniforms"] = json::array();
+
+		const auto push_uniform = [&](const char* p_name, ShaderUniformVariableType p_type,
+										  const json& p_value) {
+			j["uniforms"].push_back({ { "name", p_name }, { "type", p_type },
+					{ "value", p_value } });
+		};
+
+		push_uniform("base_color", ShaderUniformVariableType::VEC4, info.base_color);
+		push_uniform("metallic", ShaderUniformVariableType::FLOAT, info.metallic);
+		push_uniform("roughness", ShaderUniformVariableType::FLOAT, info.roughness);
+
+		// Missing maps are bound to the default texture by the loader
+		const std::pair<const char*, int> textures[] = {
+			{ "u_diffuse_texture", info.diffuse_texture },
+			{ "u_metallic_roughness_texture", info.metallic_roughness_texture },
+			{ "u_normal_texture", info.normal_texture },
+			{ "u_ambient_occlusion_texture", info.occlusion_texture },
+		};
+		for (const auto& [name, texture_idx] : textures) {
+			if (const auto texture_name = cook_texture(texture_idx)) {
+				push_uniform(name, ShaderUniformVariableType::TEXTURE, *texture_name);
+			}
+		}
+
+		const std::string material_name = std::format("{}_mat{}.glmat", stem, i);
+		if (json_save((p_output_dir / material_name).string(), j) != JSONLoadError::NONE) {
+			GL_LOG_ERROR("[GLTFCooker::cook] Unable to write material '{}'.", material_name);
+			return GLTFLoadError::WRITE_ERROR;
+		}
+
+		material_paths.push_back({
+				_push_cooked_string(ctx, material_name),
+				uint32_t(material_name.size()),
+		});
+	}
+
+	if (!model.scenes.empty()) {
+		const int scene_idx = std::max(model.defaultScene, 0);
+		for (int node_index : model.scenes[scene_idx].nodes) {
+			_cook_gltf_node(ctx, node_index, -1, glm::mat4(1.0f));
+		}
+	}
+
+	if (ctx.vertices.empty()) {
+		ctx.aabb = { VEC3_ZERO, VEC3_ZERO };
+	}
+
+	const CookedModelHeader header = {
+		COOKED_MODEL_MAGIC,
+		COOKED_MODEL_VERSION,
+		uint32_t(ctx.nodes.size()),
+		uint32_t(ctx.submeshes.size()),
+		uint32_t(material_paths.size()),
+		uint32_t(ctx.strings.size()),
+		uint32_t(ctx.vertices.size()),
+		uint32_t(ctx.indices.size()),
+		uint32_t(ctx.lods.size()),
+		ctx.aabb,
+	};
+
+	std::vector<uint8_t> data;
+	const auto append = [&](const void* p_data, size_t p_size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(p_data);
+		data.insert(data.end(), bytes, bytes + p_size);
+	};
+
+	append(&header, sizeof(header));
+	append(ctx.nodes.data(), ctx.nodes.size() * sizeof(CookedModelNode));
+	append(ctx.submeshes.data(), ctx.submeshes.size() * sizeof(CookedSubmesh));
+	append(material_paths.data(), material_paths.size() * sizeof(CookedMaterialPath));
+	append(ctx.strings.data(), ctx.strings.size());
+
+	// Vertices are read in place by the loader
+	data.resize((data.size() + 15) & ~size_t(15));
+
+	append(ctx.vertices.data(), ctx.vertices.size() * sizeof(MeshVertex));
+	append(ctx.indices.data(), ctx.indices.size() * sizeof(uint32_t));
+	append(ctx.lods.data(), ctx.lods.size() * sizeof(MeshLod));
+	GL_ASSERT(data.size() == get_cooked_model_layout(header).size,
+			"Cooked model does not match the layout of the loader");
+
+	const fs::path output_path = p_output_dir / (stem + ".glmesh");
+
+	std::ofstream file(output_path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open() ||
+			!file.write(reinterpret_cast<const char*>(data.data()), data.size())) {
+		GL_LOG_ERROR("[GLTFCooker::cook] Unable to write model '{}'.", output_path.string());
+		return GLTFLoadError::WRITE_ERROR;
+	}
+
+	if (p_out_stats) {
+		*p_out_stats = ctx.stats;
+	}
+
+	return GLTFLoadError::NONE;
+}
+
 } //namespace gl
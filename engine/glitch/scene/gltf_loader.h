@@ -5,17 +5,30 @@
 
 #pragma once
 
+#include "glitch/asset/asset_system.h"
+#include "glitch/renderer/mesh.h"
+#include "glitch/renderer/mesh_processing.h"
 #include "glitch/scene/scene.h"
 
 namespace gl {
 
+// Import settings of a model, kept along with it so that reloads match.
+struct GLTFLoadOptions {
+	// Layout of the vertex buffers of the meshes
+	MeshVertexFormat vertex_format = MeshVertexFormat::FULL;
+	// Simplified levels of detail built for each mesh, see `build_lods`
+	uint32_t lod_count = MESH_LOD_MAX_COUNT;
+};
+
+GL_DEFINE_SERIALIZABLE_WITH_DEFAULT(GLTFLoadOptions, vertex_format, lod_count);
+
 struct GLTFSourceComponent {
 	UID model_id;
 	std::string asset_path;
-	// TODO: load options
+	GLTFLoadOptions options;
 };
 
-GL_DEFINE_SERIALIZABLE(GLTFSourceComponent, model_id, asset_path);
+GL_DEFINE_SERIALIZABLE_WITH_DEFAULT(GLTFSourceComponent, model_id, asset_path, options);
 
 /**
  * Component representing an entity, loaded from a
@@ -34,14 +47,50 @@ enum class GLTFLoadError {
 	INVALID_EXTENSION,
 	PARSING_ERROR,
 	PATH_ERROR,
+	WRITE_ERROR,
+};
+
+// Used in place of the textures and materials missing from the loaded models.
+struct GLTFDefaultAssets {
+	AssetHandle texture;
+	AssetHandle material;
 };
 
 /**
  * GLTF loader, loads and registers GLTF models to the given scene from path.
+ * Cooked '.glmesh' models are loaded through `CookedModelLoader`.
  *
  */
 struct GL_API GLTFLoader {
-	static GLTFLoadError load(std::shared_ptr<Scene> p_scene, const std::string& p_path);
+	static GLTFLoadError load(std::shared_ptr<Scene> p_scene, const std::string& p_path,
+			const GLTFLoadOptions& p_options = {});
+
+	// Defaults shared by every loaded model, created again if they got freed.
+	static GLTFDefaultAssets get_default_assets();
+};
+
+// Totals over the meshes of a cooked model.
+struct GLTFCookStats {
+	uint64_t triangle_count = 0;
+	// Vertex shader invocations in the order of the source model, see `analyze_vertex_cache`
+	uint64_t source_transformed_count = 0;
+	// Vertex shader invocations after `optimize_mesh`
+	uint64_t transformed_count = 0;
+};
+
+/**
+ * Converts GLTF models into the engine native '.glmesh', '.glmat' and '.gltex' files,
+ * see `CookedModelLoader`. Does not require a renderer so it can run offline.
+ */
+struct GL_API GLTFCooker {
+	/**
+	 * Cook the model at `p_path` into `p_output_dir`, files are named after the model.
+	 * Thread safe, models can be cooked in parallel.
+	 *
+	 * @param p_out_stats Optional, receives the vertex cache statistics of the meshes.
+	 */
+	static GLTFLoadError cook(const fs::path& p_path, const fs::path& p_output_dir,
+			GLTFCookStats* p_out_stats = nullptr);
 };
 
 } //namespace gl
\ No newline at end of file
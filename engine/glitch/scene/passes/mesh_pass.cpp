@@ -9,8 +9,6 @@
 
 namespace gl {
 
-MeshPass::~MeshPass() { Renderer::get_backend()->device_wait(); }
-
 void MeshPass::setup(Renderer& p_renderer) {
 	GL_PROFILE_SCOPE;
 
@@ -19,7 +17,8 @@ void MeshPass::setup(Renderer& p_renderer) {
 
 	default_texture = Texture::create(COLOR_WHITE);
 
-	const AssetHandle texture_handle = AssetSystem::register_asset(default_texture);
+	// The default material is not registered so nothing would keep the texture alive
+	const AssetHandle texture_handle = AssetSystem::register_asset_persistent(default_texture);
 
 	default_material = Material::create("mem://MaterialDefinition/pipelines/pbr_standard");
 	default_material->set_param("base_color", glm::vec4(1.0, 0.2, 1.0, 1.0));
@@ -58,6 +57,11 @@ void MeshPass::execute(CommandBuffer p_cmd, Renderer& p_renderer) {
 	p_renderer.begin_rendering(p_cmd, p_renderer.get_render_image("geo_albedo").value(),
 			p_renderer.get_render_image("geo_depth").value());
 
+	// Pixels covered by a unit at a distance of one, projects the errors of the LODs
+	const float screen_scale = p_renderer.get_final_image_size().y /
+			(2.0f * std::tan(glm::radians(camera.value().fov) * 0.5f));
+	const glm::vec3 camera_position(scene_data.camera_position);
+
 	Pipeline bound_pipeline = GL_NULL_HANDLE;
 	for (Entity entity : scene->view<MeshComponent>()) {
 		const MeshComponent* mc = entity.get_component<MeshComponent>();
@@ -94,7 +98,10 @@ void MeshPass::execute(CommandBuffer p_cmd, Renderer& p_renderer) {
 
 		// Push constants
 		{
-			push_constants.vertex_buffer = smesh->vertex_buffer_address;
+			push_constants.vertex_buffer = GeometryArena::get_device_address(smesh->vertex_range);
+			push_constants.vertex_format = smesh->vertex_format;
+			push_constants.position_min = smesh->aabb.min;
+			push_constants.position_extent = smesh->aabb.max - smesh->aabb.min;
 
 			// Object transformation
 			push_constants.transform = entity.get_transform().to_mat4();
@@ -103,16 +110,44 @@ void MeshPass::execute(CommandBuffer p_cmd, Renderer& p_renderer) {
 					p_cmd, material->get_shader(), 0, sizeof(PushConstants), &push_constants);
 		}
 
+		// Use the least detailed level whose error is not visible from the camera
+		const glm::mat4& transform = push_constants.transform;
+		const float max_scale = std::max({ glm::length(glm::vec3(transform[0])),
+				glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+		const glm::vec3 center(
+				transform * glm::vec4((smesh->aabb.min + smesh->aabb.max) * 0.5f, 1.0f));
+		const float radius = glm::length(smesh->aabb.max - smesh->aabb.min) * 0.5f * max_scale;
+
+		const uint32_t lod = select_lod(smesh->lods,
+				glm::distance(center, camera_position) - radius, screen_scale * max_scale);
+
+		// Discard the clusters outside of the view or facing away, meshes with a single
+		// meshlet were already culled as a whole
+		meshlet_ranges.clear();
+		if (lod == 0 && smesh->meshlets.size() > 1) {
+			const bool cull_back_faces =
+					material->get_definition()->get_pipeline_options().cull_mode ==
+					PolygonCullMode::BACK;
+
+			cull_meshlets(smesh->meshlets, transform, view_frustum, camera_position,
+					cull_back_faces, meshlet_ranges);
+		} else {
+			const MeshLod& mesh_lod = smesh->lods[lod];
+			meshlet_ranges.push_back({ mesh_lod.index_offset, mesh_lod.index_count });
+		}
+
 		// Render
-		backend->command_bind_index_buffer(p_cmd, smesh->index_buffer, 0, IndexType::UINT32);
+		backend->command_bind_index_buffer(p_cmd,
+				GeometryArena::get_buffer(GeometryBufferType::INDEX),
+				GeometryArena::get_offset(smesh->index_range), smesh->index_type);
 
-		backend->command_draw_indexed(p_cmd, smesh->index_count);
+		for (const MeshletDrawRange& range : meshlet_ranges) {
+			backend->command_draw_indexed(p_cmd, range.index_count, 1, range.index_offset);
 
-		{
 			ApplicationPerfStats& stats = Application::get()->get_perf_stats();
 
 			stats.renderer_stats.draw_calls++;
-			stats.renderer_stats.index_count += smesh->index_count;
+			stats.renderer_stats.index_count += range.index_count;
 		}
 	}
 
@@ -176,7 +211,7 @@ MeshPass::ScenePreprocessError MeshPass::_preprocess_scene() {
 	}
 
 	// Construct a frustum culled render queue to render only visible primitives
-	Frustum view_frustum = Frustum::from_view_proj(scene_data.view_projection);
+	view_frustum = Frustum::from_view_proj(scene_data.view_projection);
 
 	// Basic frustum culling and material updating
 	for (Entity entity : scene->view<MeshComponent>()) {
@@ -195,9 +230,19 @@ MeshPass::ScenePreprocessError MeshPass::_preprocess_scene() {
 			continue;
 		}
 
+		// Stamp the assets so that the memory budgets evict the ones not drawn lately
+		AssetSystem::mark_used<StaticMesh>(mc->mesh);
+		// Restored meshes are uploaded asynchronously as well, drawn once complete
+		if (!smesh->make_resident() || !smesh->is_ready()) {
+			mc->visible = false;
+			continue;
+		}
+
 		// If there is a material component attached and is_dirty, reuppload it to the GPU
 		if (entity.has_component<MaterialComponent>()) {
 			const auto handle = entity.get_component<MaterialComponent>()->handle;
+			AssetSystem::mark_used<Material>(handle);
+
 			const auto material = AssetSystem::get<Material>(handle);
 			if (material != nullptr && material->is_dirty()) {
 				material->upload();
@@ -9,6 +9,8 @@
 #include "glitch/renderer/graphics_pass.h"
 #include "glitch/renderer/light_sources.h"
 #include "glitch/renderer/material.h"
+#include "glitch/renderer/mesh.h"
+#include "glitch/renderer/mesh_processing.h"
 #include "glitch/renderer/storage_buffer.h"
 #include "glitch/renderer/texture.h"
 #include "glitch/scene/scene.h"
@@ -36,9 +38,13 @@ public:
 		glm::mat4 transform;
 		BufferDeviceAddress vertex_buffer;
 		BufferDeviceAddress scene_buffer;
+		// Bounding box of the mesh, quantized vertex positions are relative to it
+		glm::vec3 position_min;
+		MeshVertexFormat vertex_format;
+		glm::vec3 position_extent;
 	};
 
-	virtual ~MeshPass();
+	virtual ~MeshPass() = default;
 
 	void setup(Renderer& p_renderer) override;
 	void execute(CommandBuffer p_cmd, Renderer& p_renderer) override;
@@ -57,6 +63,10 @@ private:
 	std::shared_ptr<Scene> scene;
 
 	std::optional<PerspectiveCamera> camera;
+	Frustum view_frustum;
+
+	// Reused across draws to not allocate per mesh
+	std::vector<MeshletDrawRange> meshlet_ranges;
 
 	PushConstants push_constants = {};
 	SceneBuffer scene_data;
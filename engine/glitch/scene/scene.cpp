@@ -3,15 +3,19 @@
 #include "glitch/asset/asset_system.h"
 #include "glitch/renderer/light_sources.h"
 #include "glitch/renderer/material.h"
+#include "glitch/renderer/mesh.h"
 #include "glitch/renderer/texture.h"
 #include "glitch/scene/components.h"
 #include "glitch/scene/entity.h"
 #include "glitch/scene/gltf_loader.h"
+#include "glitch/scene/scene_journal.h"
 #include "glitch/scripting/script.h"
 #include "glitch/scripting/script_system.h"
 
 namespace gl {
 
+Scene::~Scene() { _release_assets(); }
+
 void Scene::start() {
 	GL_PROFILE_SCOPE;
 
@@ -51,8 +55,12 @@ bool Scene::is_running() const { return running; }
 bool Scene::is_paused() const { return paused; }
 
 void Scene::copy_to(Scene& p_dest) {
+	p_dest._release_assets();
+
 	Registry::copy_to(p_dest);
 
+	p_dest._retain_assets();
+
 	p_dest.entity_map.clear();
 
 	// Copy entities
@@ -73,6 +81,24 @@ void Scene::copy_to(Scene& p_dest) {
 	}
 }
 
+void Scene::_retain_assets() {
+	for (Entity entity : view<MeshComponent>()) {
+		AssetSystem::retain<StaticMesh>(entity.get_component<MeshComponent>()->mesh);
+	}
+	for (Entity entity : view<MaterialComponent>()) {
+		AssetSystem::retain<Material>(entity.get_component<MaterialComponent>()->handle);
+	}
+}
+
+void Scene::_release_assets() {
+	for (Entity entity : view<MeshComponent>()) {
+		AssetSystem::release<StaticMesh>(entity.get_component<MeshComponent>()->mesh);
+	}
+	for (Entity entity : view<MaterialComponent>()) {
+		AssetSystem::release<Material>(entity.get_component<MaterialComponent>()->handle);
+	}
+}
+
 Entity Scene::create(const std::string& p_name, Entity p_parent) {
 	return create(UID(), p_name, p_parent);
 }
@@ -90,6 +116,8 @@ Entity Scene::create(UID p_uid, const std::string& p_name, Entity p_parent) {
 
 	entity_map[p_uid] = entity;
 
+	mark_dirty(p_uid);
+
 	return entity;
 }
 
@@ -101,10 +129,12 @@ void Scene::destroy(Entity p_entity) {
 	// Release asset handles for GC
 	// TODO do this dynamically.
 	if (auto mc = p_entity.get_component<MeshComponent>()) {
-		mc->mesh.release();
+		AssetSystem::release<StaticMesh>(mc->mesh);
+		mc->mesh = INVALID_ASSET_HANDLE;
 	}
 	if (auto mc = p_entity.get_component<MaterialComponent>()) {
-		mc->handle.release();
+		AssetSystem::release<Material>(mc->handle);
+		mc->handle = INVALID_ASSET_HANDLE;
 	}
 
 	// Destroy the children if any
@@ -121,6 +151,8 @@ void Scene::destroy(Entity p_entity) {
 
 	entity_map.erase(p_entity.get_uid());
 
+	mark_dirty(p_entity.get_uid());
+
 	despawn(p_entity);
 }
 
@@ -130,6 +162,8 @@ void Scene::destroy(UID p_uid) {
 		return;
 	}
 
+	mark_dirty(p_uid);
+
 	despawn(*entity);
 }
 
@@ -155,6 +189,20 @@ std::optional<Entity> Scene::find_by_name(const std::string& p_name) {
 	return it->second;
 }
 
+void Scene::mark_dirty(UID p_uid) { dirty_entities.insert(p_uid); }
+
+bool Scene::is_dirty() const { return !dirty_entities.empty(); }
+
+static size_t _hash_assets(const json& p_assets) {
+	return std::hash<std::string>{}(p_assets.dump());
+}
+
+// Texture uniforms of memory assets are not saved, they are recreated by their loaders.
+static bool _is_memory_texture(const ShaderUniformVariable& p_value) {
+	const auto meta = AssetSystem::get_metadata<Texture>(std::get<AssetHandle>(p_value));
+	return meta && meta->is_memory_asset();
+}
+
 static json _serialize_entity(const Entity& p_entity) {
 	GL_ASSERT(p_entity.has_component<IdComponent>());
 	GL_ASSERT(p_entity.has_component<Transform>());
@@ -190,13 +238,9 @@ static json _serialize_entity(const Entity& p_entity) {
 					continue;
 				}
 
-				// Skip if texture is a memory asset
-				if (uniform.type == ShaderUniformVariableType::TEXTURE) {
-					const auto& handle = std::get<AssetHandle>(*value);
-					if (const auto meta = AssetSystem::get_metadata<Texture>(handle);
-							meta && meta->is_memory_asset()) {
-						continue;
-					}
+				if (uniform.type == ShaderUniformVariableType::TEXTURE &&
+						_is_memory_texture(*value)) {
+					continue;
 				}
 
 				json uniform_json;
@@ -208,9 +252,24 @@ static json _serialize_entity(const Entity& p_entity) {
 				j["material_component"]["uniforms"].push_back(uniform_json);
 			}
 		} else {
-			GL_LOG_WARNING("[_serialize_entity] Unable to serialize MaterialComponent for entity "
-						   "'{}. Material metadata does not exist.",
-					p_entity.get_name());
+			// Materials are only created for glTF instances, others keep the uniforms they
+			// got deserialized with
+			j["material_component"]["definition_path"] = mc->definition_path;
+			j["material_component"]["uniforms"] = json::array();
+			for (const auto& [name, value] : mc->uniforms) {
+				// Alternatives of the variant are in the order of the uniform types
+				const auto type = ShaderUniformVariableType(value.index());
+				if (type == ShaderUniformVariableType::TEXTURE && _is_memory_texture(value)) {
+					continue;
+				}
+
+				json uniform_json;
+				uniform_json["name"] = name;
+				uniform_json["type"] = type;
+				std::visit([&](auto&& arg) { uniform_json["value"] = arg; }, value);
+
+				j["material_component"]["uniforms"].push_back(uniform_json);
+			}
 		}
 	}
 
@@ -249,6 +308,9 @@ bool Scene::serialize(std::string_view p_path, std::shared_ptr<Scene> p_scene) {
 	j["assets"] = json();
 	AssetSystem::serialize(j["assets"]);
 
+	// Pending records would be replayed on top of the new file otherwise
+	SceneJournal::discard(*abs_path);
+
 	// Write serialized json to the file.
 	if (json_save(p_path, j) != JSONLoadError::NONE) {
 		GL_LOG_ERROR("[Scene::serialize] Unable to open file at path '{}' for serialization",
@@ -256,10 +318,84 @@ bool Scene::serialize(std::string_view p_path, std::shared_ptr<Scene> p_scene) {
 		return false;
 	}
 
+	p_scene->dirty_entities.clear();
+	p_scene->saved_assets_hash = _hash_assets(j["assets"]);
+
+	return true;
+}
+
+bool Scene::serialize_incremental(std::string_view p_path, std::shared_ptr<Scene> p_scene) {
+	GL_PROFILE_SCOPE;
+
+	const auto abs_path = AssetSystem::get_absolute_path(p_path);
+	if (!abs_path) {
+		GL_LOG_ERROR(
+				"[Scene::serialize_incremental] Unable to serialize scene to path: {}", p_path);
+		return false;
+	}
+
+	// Nothing to append to
+	if (!fs::exists(*abs_path)) {
+		return serialize(p_path, p_scene);
+	}
+
+	// Asset files are left untouched, only metadata changes are recorded
+	json assets;
+	AssetSystem::serialize(assets, false);
+
+	const size_t assets_hash = _hash_assets(assets);
+	const bool assets_changed = assets_hash != p_scene->saved_assets_hash;
+
+	// Handles are reallocated on load and the record replaces the saved ones, entities that
+	// refer to textures have to be written with the current handles as well
+	std::unordered_set<UID> written_entities = p_scene->dirty_entities;
+	if (assets_changed) {
+		for (Entity entity : p_scene->view<MaterialComponent>()) {
+			written_entities.insert(entity.get_uid());
+		}
+	}
+
+	std::vector<json> records;
+	records.reserve(written_entities.size() + 1);
+
+	for (const UID& uid : written_entities) {
+		if (const std::optional<Entity> entity = p_scene->find_by_id(uid)) {
+			records.push_back(json{
+					{ "type", "entity" },
+					{ "id", uid },
+					{ "data", _serialize_entity(*entity) },
+			});
+		} else {
+			records.push_back(json{
+					{ "type", "remove" },
+					{ "id", uid },
+			});
+		}
+	}
+
+	if (assets_changed) {
+		records.push_back(json{
+				{ "type", "assets" },
+				{ "data", assets },
+		});
+	}
+
+	if (!SceneJournal::append(*abs_path, records)) {
+		GL_LOG_ERROR("[Scene::serialize_incremental] Unable to append changes of scene '{}'",
+				p_path);
+		return false;
+	}
+
+	p_scene->dirty_entities.clear();
+	p_scene->saved_assets_hash = assets_hash;
+
+	SceneJournal::request_compaction(*abs_path);
+
 	return true;
 }
 
-static Entity _deserialize_entity(const json& p_json, std::shared_ptr<Scene> p_scene) {
+static Entity _deserialize_entity(
+		const json& p_json, std::shared_ptr<Scene> p_scene, const AssetHandleRemap& p_remap) {
 	UID id;
 	if (p_json.contains("id")) {
 		p_json.at("id").get_to(id);
@@ -340,9 +476,13 @@ static Entity _deserialize_entity(const json& p_json, std::shared_ptr<Scene> p_s
 						case ShaderUniformVariableType::VEC4:
 							value = uniform["value"].get<glm::vec4>();
 							break;
-						case ShaderUniformVariableType::TEXTURE:
-							value = uniform["value"].get<AssetHandle>();
+						case ShaderUniformVariableType::TEXTURE: {
+							// Saved handles are reallocated by the asset system
+							const auto handle = uniform["value"].get<AssetHandle>();
+							const auto it = p_remap.find(handle);
+							value = it != p_remap.end() ? it->second : INVALID_ASSET_HANDLE;
 							break;
+						}
 					}
 
 					mc->uniforms[name] = value;
@@ -383,7 +523,12 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 		return false;
 	}
 
-	const json& j = res.get_value();
+	json j = res.get_value();
+
+	// Apply changes made by incremental saves
+	if (const auto abs_path = AssetSystem::get_absolute_path(p_path)) {
+		SceneJournal::replay(*abs_path, j);
+	}
 
 	if (!j.contains("entities") || !j["entities"].is_array()) {
 		GL_LOG_ERROR("[Scene::deserialize] Unable to deserialize scene from path '{}', invalid "
@@ -392,15 +537,16 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 		return false;
 	}
 
+	AssetHandleRemap remap;
 	if (j.contains("assets") && j["assets"].is_object()) {
-		AssetSystem::deserialize(j["assets"]);
+		AssetSystem::deserialize(j["assets"], &remap);
 	} else {
 		GL_LOG_WARNING("[Scene::deserialize] Unable to deserialize asset registry.");
 	}
 
 	std::shared_ptr<Scene> new_scene = std::make_shared<Scene>();
 	for (const json& j_entity : j["entities"]) {
-		Entity _ = _deserialize_entity(j_entity, new_scene);
+		Entity _ = _deserialize_entity(j_entity, new_scene, remap);
 	}
 
 	// Update entity / child hierarchy
@@ -424,7 +570,7 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 		// Load the gltf model
 		// TODO: make this multithreaded
 		std::shared_ptr<Scene> gltf_scene = std::make_shared<Scene>();
-		if (GLTFLoader::load(gltf_scene, sc->asset_path) != GLTFLoadError::NONE) {
+		if (GLTFLoader::load(gltf_scene, sc->asset_path, sc->options) != GLTFLoadError::NONE) {
 			GL_LOG_ERROR(
 					"[Scene::deserialize] Unable to load GLTF model from path ''", sc->asset_path);
 			continue;
@@ -455,6 +601,8 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 					MeshComponent* mc = instance.has_component<MeshComponent>()
 							? instance.get_component<MeshComponent>()
 							: instance.add_component<MeshComponent>();
+					AssetSystem::retain<StaticMesh>(gltf_mesh->mesh);
+					AssetSystem::release<StaticMesh>(mc->mesh);
 					mc->mesh = gltf_mesh->mesh;
 				}
 
@@ -472,7 +620,8 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 										instance.get_name());
 							}
 
-							instance_mc->handle = std::move(gltf_mc->handle);
+							AssetSystem::retain<Material>(gltf_mc->handle);
+							instance_mc->handle = gltf_mc->handle;
 
 							// Update uniforms
 							for (const auto& [name, uniform] : instance_mc->uniforms) {
@@ -485,11 +634,13 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 											instance.get_name());
 								}
 							}
+							AssetSystem::update_dependencies<Material>(gltf_mc->handle);
 						} else {
 							// If definitions differ, initialize our custom material.
 							if (auto handle = AssetSystem::create<Material>(
 										instance_mc->definition_path)) {
-								instance_mc->handle = std::move(*handle);
+								AssetSystem::retain<Material>(*handle);
+								instance_mc->handle = *handle;
 
 								const auto mat = AssetSystem::get<Material>(instance_mc->handle);
 
@@ -503,6 +654,7 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 												instance.get_name());
 									}
 								}
+								AssetSystem::update_dependencies<Material>(instance_mc->handle);
 							} else {
 								GL_LOG_ERROR("[Scene::deserialize] Unable to initialize material "
 											 "from definition '{}' for entity '{}'.",
@@ -512,7 +664,8 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 					} else {
 						// CASE: No serialized material. Use GLTF defaults exactly.
 						MaterialComponent* mc = instance.add_component<MaterialComponent>();
-						mc->handle = std::move(gltf_mc->handle);
+						AssetSystem::retain<Material>(gltf_mc->handle);
+						mc->handle = gltf_mc->handle;
 						mc->definition_path = std::move(gltf_mc->definition_path);
 						mc->uniforms = std::move(gltf_mc->uniforms);
 
@@ -535,6 +688,9 @@ bool Scene::deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene)
 
 	new_scene->copy_to(*p_scene);
 
+	p_scene->dirty_entities.clear();
+	p_scene->saved_assets_hash = j.contains("assets") ? _hash_assets(j["assets"]) : 0;
+
 	return true;
 }
 
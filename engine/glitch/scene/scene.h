@@ -19,7 +19,7 @@ template <typename... TComponents> class EntityView;
 class GL_API Scene : public Registry {
 public:
 	Scene() = default;
-	virtual ~Scene() = default;
+	virtual ~Scene();
 
 	void copy_to(Scene& p_dest);
 
@@ -58,12 +58,43 @@ public:
 	 */
 	template <typename... TComponents> EntityView<TComponents...> view();
 
+	/**
+	 * Mark an entity as modified so that the next incremental save writes it.
+	 * Creating, destroying and re-parenting entities marks them automatically.
+	 */
+	void mark_dirty(UID p_uid);
+
+	// Whether there are entity changes that are not saved yet.
+	bool is_dirty() const;
+
 	static bool serialize(std::string_view p_path, const std::shared_ptr<Scene> p_scene);
+
+	/**
+	 * Append entities modified since the last save to the change log of `p_path`
+	 * instead of rewriting the whole file. Assets are not saved, only their metadata
+	 * is written when it changes, along with every entity with a material since the
+	 * handles of their textures might have changed too. Falls back to `serialize` if the
+	 * base file does not exist yet.
+	 *
+	 * The log is merged back into the base file on a background thread once it grows
+	 * large enough, see `SceneJournal`.
+	 */
+	static bool serialize_incremental(std::string_view p_path, std::shared_ptr<Scene> p_scene);
+
 	static bool deserialize(std::string_view p_path, std::shared_ptr<Scene> p_scene);
 
+private:
+	// Mesh and material components own a reference to their assets.
+	void _retain_assets();
+	void _release_assets();
+
 private:
 	std::unordered_map<UID, Entity> entity_map;
 
+	// Entities changed since the last save, destroyed ones are written as removals.
+	std::unordered_set<UID> dirty_entities;
+	size_t saved_assets_hash = 0;
+
 	bool running = false;
 	bool paused = false;
 	int step_frames = 0;
@@ -0,0 +1,266 @@
+#include "glitch/scene/scene_journal.h"
+
+namespace gl {
+
+static std::unordered_map<uint32_t, size_t> _build_entity_indices(const json& p_scene_json) {
+	std::unordered_map<uint32_t, size_t> indices;
+	if (!p_scene_json.contains("entities") || !p_scene_json["entities"].is_array()) {
+		return indices;
+	}
+
+	const json& entities = p_scene_json["entities"];
+	indices.reserve(entities.size());
+
+	for (size_t i = 0; i < entities.size(); i++) {
+		if (entities[i].contains("id")) {
+			indices[entities[i]["id"].get<uint32_t>()] = i;
+		}
+	}
+
+	return indices;
+}
+
+static void _erase_removed_entities(json& p_scene_json) {
+	if (!p_scene_json.contains("entities") || !p_scene_json["entities"].is_array()) {
+		return;
+	}
+
+	json& entities = p_scene_json["entities"];
+
+	json result = json::array();
+	for (json& entity : entities) {
+		if (!entity.is_null()) {
+			result.push_back(std::move(entity));
+		}
+	}
+
+	entities = std::move(result);
+}
+
+fs::path SceneJournal::get_log_path(const fs::path& p_base_path) {
+	fs::path path = p_base_path;
+	path += ".log";
+	return path;
+}
+
+fs::path SceneJournal::get_compacting_log_path(const fs::path& p_base_path) {
+	fs::path path = p_base_path;
+	path += ".log.compacting";
+	return path;
+}
+
+bool SceneJournal::append(const fs::path& p_base_path, const std::vector<json>& p_records) {
+	GL_PROFILE_SCOPE;
+
+	if (p_records.empty()) {
+		return true;
+	}
+
+	std::ofstream f(get_log_path(p_base_path), std::ios::app);
+	if (!f.is_open()) {
+		GL_LOG_ERROR("[SceneJournal::append] Unable to open scene log of '{}'.",
+				p_base_path.string());
+		return false;
+	}
+
+	// Write the whole batch at once so a single record never gets interleaved
+	std::string buffer;
+	for (const json& record : p_records) {
+		buffer += record.dump();
+		buffer += '\n';
+	}
+
+	f << buffer;
+	f.flush();
+
+	return f.good();
+}
+
+void SceneJournal::replay(const fs::path& p_base_path, json& p_scene_json) {
+	GL_PROFILE_SCOPE;
+
+	// Base file might get replaced in the middle of reading otherwise
+	wait_for_compaction();
+
+	if (!p_scene_json.contains("entities") || !p_scene_json["entities"].is_array()) {
+		p_scene_json["entities"] = json::array();
+	}
+
+	std::unordered_map<uint32_t, size_t> entity_indices = _build_entity_indices(p_scene_json);
+
+	// Order matters, a compacting log is always older than the active one
+	_apply_log(get_compacting_log_path(p_base_path), p_scene_json, entity_indices);
+	_apply_log(get_log_path(p_base_path), p_scene_json, entity_indices);
+
+	_erase_removed_entities(p_scene_json);
+}
+
+void SceneJournal::request_compaction(const fs::path& p_base_path, bool p_force) {
+	if (is_compacting()) {
+		return;
+	}
+
+	// Finish off the previous future so that exceptions do not go unnoticed
+	wait_for_compaction();
+
+	const fs::path compacting_path = get_compacting_log_path(p_base_path);
+
+	// A compacting log left from an interrupted compaction must be merged first
+	if (!fs::exists(compacting_path)) {
+		const fs::path log_path = get_log_path(p_base_path);
+		if (!fs::exists(log_path)) {
+			return;
+		}
+
+		std::error_code ec;
+		const size_t log_size = fs::file_size(log_path, ec);
+		const size_t base_size = fs::exists(p_base_path) ? fs::file_size(p_base_path, ec) : 0;
+		if (!p_force && log_size < std::max(MIN_COMPACTION_LOG_SIZE, base_size)) {
+			return;
+		}
+
+		// New records will be appended to a fresh log while compacting
+		fs::rename(log_path, compacting_path, ec);
+		if (ec) {
+			GL_LOG_ERROR("[SceneJournal::request_compaction] Unable to rotate scene log '{}': {}",
+					log_path.string(), ec.message());
+			return;
+		}
+	}
+
+	s_compaction = std::async(std::launch::async, &SceneJournal::_compact, p_base_path);
+}
+
+bool SceneJournal::is_compacting() {
+	return s_compaction.valid() &&
+			s_compaction.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void SceneJournal::wait_for_compaction() {
+	if (s_compaction.valid()) {
+		s_compaction.get();
+	}
+}
+
+void SceneJournal::discard(const fs::path& p_base_path) {
+	wait_for_compaction();
+
+	std::error_code ec;
+	fs::remove(get_log_path(p_base_path), ec);
+	fs::remove(get_compacting_log_path(p_base_path), ec);
+}
+
+void SceneJournal::_apply_record(const json& p_record, json& p_scene_json,
+		std::unordered_map<uint32_t, size_t>& p_entity_indices) {
+	const std::string type = p_record.value("type", "");
+
+	if (type == "entity") {
+		const uint32_t id = p_record.at("id").get<uint32_t>();
+
+		json& entities = p_scene_json["entities"];
+
+		const auto it = p_entity_indices.find(id);
+		if (it != p_entity_indices.end()) {
+			entities[it->second] = p_record.at("data");
+		} else {
+			p_entity_indices[id] = entities.size();
+			entities.push_back(p_record.at("data"));
+		}
+	} else if (type == "remove") {
+		const uint32_t id = p_record.at("id").get<uint32_t>();
+
+		const auto it = p_entity_indices.find(id);
+		if (it != p_entity_indices.end()) {
+			// Keep indices stable until the whole log is applied
+			p_scene_json["entities"][it->second] = json(json::value_t::null);
+			p_entity_indices.erase(it);
+		}
+	} else if (type == "assets") {
+		p_scene_json["assets"] = p_record.at("data");
+	} else {
+		GL_LOG_WARNING("[SceneJournal::_apply_record] Unknown record type '{}'.", type);
+	}
+}
+
+void SceneJournal::_apply_log(const fs::path& p_log_path, json& p_scene_json,
+		std::unordered_map<uint32_t, size_t>& p_entity_indices) {
+	std::ifstream f(p_log_path);
+	if (!f.is_open()) {
+		return;
+	}
+
+	std::string line;
+	while (std::getline(f, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		try {
+			_apply_record(json::parse(line), p_scene_json, p_entity_indices);
+		} catch (const json::exception&) {
+			// Most likely a record that got cut off by a crash, rest of the log is unusable
+			GL_LOG_WARNING("[SceneJournal::_apply_log] Skipping malformed record in '{}'.",
+					p_log_path.string());
+			break;
+		}
+	}
+}
+
+void SceneJournal::_compact(fs::path p_base_path) {
+	GL_PROFILE_SCOPE;
+
+	json scene_json;
+	{
+		std::ifstream f(p_base_path);
+		if (f.is_open()) {
+			try {
+				f >> scene_json;
+			} catch (const json::exception&) {
+				GL_LOG_ERROR("[SceneJournal::_compact] Unable to parse base scene '{}'.",
+						p_base_path.string());
+				return;
+			}
+		}
+	}
+
+	if (!scene_json.contains("entities") || !scene_json["entities"].is_array()) {
+		scene_json["entities"] = json::array();
+	}
+
+	const fs::path compacting_path = get_compacting_log_path(p_base_path);
+
+	std::unordered_map<uint32_t, size_t> entity_indices = _build_entity_indices(scene_json);
+	_apply_log(compacting_path, scene_json, entity_indices);
+	_erase_removed_entities(scene_json);
+
+	// Write to a temporary file first so the base file is never left half written
+	fs::path tmp_path = p_base_path;
+	tmp_path += ".tmp";
+	{
+		std::ofstream f(tmp_path);
+		if (!f.is_open()) {
+			GL_LOG_ERROR("[SceneJournal::_compact] Unable to open '{}' for writing.",
+					tmp_path.string());
+			return;
+		}
+
+		f << scene_json.dump(2);
+		if (!f.good()) {
+			GL_LOG_ERROR("[SceneJournal::_compact] Unable to write '{}'.", tmp_path.string());
+			return;
+		}
+	}
+
+	std::error_code ec;
+	fs::rename(tmp_path, p_base_path, ec);
+	if (ec) {
+		GL_LOG_ERROR("[SceneJournal::_compact] Unable to replace base scene '{}': {}",
+				p_base_path.string(), ec.message());
+		return;
+	}
+
+	// Records are now part of the base file
+	fs::remove(compacting_path, ec);
+}
+
+} //namespace gl
@@ -0,0 +1,74 @@
+/**
+ * @file scene_journal.h
+ *
+ */
+
+#pragma once
+
+namespace gl {
+
+/**
+ * Append-only change log stored next to a serialized scene file.
+ *
+ * Every line of the log is a self contained JSON record describing the latest
+ * state of an entity (or the asset registry) which is replayed on top of the
+ * base file while loading. Records are full states, so replaying the same
+ * record twice is harmless; this is what makes compaction crash safe.
+ *
+ * Layout on disk:
+ *  - `scene.json`                base file, written by full saves and compaction
+ *  - `scene.json.log`            records appended by incremental saves
+ *  - `scene.json.log.compacting` log being merged into the base file
+ */
+class GL_API SceneJournal {
+public:
+	// Logs smaller than this never trigger a compaction.
+	static constexpr size_t MIN_COMPACTION_LOG_SIZE = 64 * 1024;
+
+	static fs::path get_log_path(const fs::path& p_base_path);
+	static fs::path get_compacting_log_path(const fs::path& p_base_path);
+
+	/**
+	 * Append records to the log of `p_base_path`, one line each.
+	 *
+	 * @returns `false` if the log could not be opened.
+	 */
+	static bool append(const fs::path& p_base_path, const std::vector<json>& p_records);
+
+	/**
+	 * Apply pending records of the log files on top of the loaded base scene.
+	 */
+	static void replay(const fs::path& p_base_path, json& p_scene_json);
+
+	/**
+	 * Merge the log into the base file on a background thread if it grew larger
+	 * than the base file. The main thread only renames the log file.
+	 *
+	 * @param p_force Compact even if the log is small.
+	 */
+	static void request_compaction(const fs::path& p_base_path, bool p_force = false);
+
+	// Returns true while a compaction is being processed in the background.
+	static bool is_compacting();
+
+	// Block until the running compaction (if any) finishes.
+	static void wait_for_compaction();
+
+	// Remove all log files of `p_base_path`, called after full saves.
+	static void discard(const fs::path& p_base_path);
+
+private:
+	// `p_entity_indices` caches `id -> entities[i]` so replay stays linear.
+	static void _apply_record(const json& p_record, json& p_scene_json,
+			std::unordered_map<uint32_t, size_t>& p_entity_indices);
+
+	static void _apply_log(const fs::path& p_log_path, json& p_scene_json,
+			std::unordered_map<uint32_t, size_t>& p_entity_indices);
+
+	static void _compact(fs::path p_base_path);
+
+private:
+	inline static std::future<void> s_compaction;
+};
+
+} //namespace gl
@@ -0,0 +1,94 @@
+#include "glitch/core/job_system.h"
+#include "glitch/scene/gltf_loader.h"
+
+using namespace gl;
+
+static bool _is_gltf_file(const fs::path& p_path) {
+	return p_path.extension() == ".gltf" || p_path.extension() == ".glb";
+}
+
+// Average cache miss ratio, vertex shader invocations per triangle
+static double _get_acmr(uint64_t p_transformed_count, uint64_t p_triangle_count) {
+	return p_triangle_count > 0 ? double(p_transformed_count) / p_triangle_count : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::cerr << "Usage: " << argv[0] << " <input_file_or_dir> <output_dir> [-j <jobs>]\n\n"
+				  << "Cooks glTF models into '.glmesh', '.glmat' and '.gltex' files, directories "
+					 "are searched recursively and their layout is kept in <output_dir>.\n";
+		return 1;
+	}
+
+	const fs::path input_path = argv[1];
+	const fs::path output_dir = argv[2];
+
+	uint32_t job_count = std::max(std::thread::hardware_concurrency(), 1u);
+	for (int i = 3; i < argc; ++i) {
+		if (std::string_view(argv[i]) == "-j" && i + 1 < argc) {
+			job_count = std::max(std::atoi(argv[++i]), 1);
+		} else {
+			std::cerr << "Error: Unknown option " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+
+	// Model, output directory pairs
+	std::vector<std::pair<fs::path, fs::path>> models;
+
+	std::error_code err;
+	if (fs::is_directory(input_path, err)) {
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input_path)) {
+			if (!entry.is_regular_file() || !_is_gltf_file(entry.path())) {
+				continue;
+			}
+
+			const fs::path relative_dir =
+					entry.path().parent_path().lexically_relative(input_path);
+			models.emplace_back(entry.path(), output_dir / relative_dir);
+		}
+	} else if (_is_gltf_file(input_path)) {
+		models.emplace_back(input_path, output_dir);
+	} else {
+		std::cerr << "Error: " << input_path << " is not a glTF model or a directory" << std::endl;
+		return 1;
+	}
+
+	std::atomic<size_t> failed_count = 0;
+
+	std::mutex stats_mutex;
+	GLTFCookStats total_stats;
+
+	// Models and their images share the same workers, the main thread cooks as well
+	JobSystem::init(std::max(job_count - 1, 1u));
+
+	JobSystem::parallel_for(uint32_t(models.size()), [&](uint32_t p_index) {
+		const auto& [model_path, model_output_dir] = models[p_index];
+
+		GLTFCookStats stats;
+		if (GLTFCooker::cook(model_path, model_output_dir, &stats) != GLTFLoadError::NONE) {
+			std::cerr << "Error: Unable to cook model " << model_path << std::endl;
+			failed_count++;
+			return;
+		}
+
+		std::lock_guard lock(stats_mutex);
+		std::cout << model_path.string() << ": ACMR "
+				  << _get_acmr(stats.source_transformed_count, stats.triangle_count) << " -> "
+				  << _get_acmr(stats.transformed_count, stats.triangle_count) << std::endl;
+
+		total_stats.triangle_count += stats.triangle_count;
+		total_stats.source_transformed_count += stats.source_transformed_count;
+		total_stats.transformed_count += stats.transformed_count;
+	});
+
+	JobSystem::shutdown();
+
+	std::cout << "Cooked " << models.size() - failed_count << " of " << models.size()
+			  << " models into " << output_dir << ", ACMR "
+			  << _get_acmr(total_stats.source_transformed_count, total_stats.triangle_count)
+			  << " -> " << _get_acmr(total_stats.transformed_count, total_stats.triangle_count)
+			  << std::endl;
+
+	return failed_count == 0 ? 0 : 1;
+}
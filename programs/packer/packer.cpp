@@ -0,0 +1,78 @@
+#include "glitch/asset/asset_pack.h"
+
+using namespace gl;
+
+static std::vector<uint8_t> _read_file(const fs::path& p_path) {
+	std::ifstream file(p_path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		return {};
+	}
+
+	std::vector<uint8_t> data(size_t(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+	return data;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::cerr << "Usage: " << argv[0] << " <output_file> <input_dir> [--compress]\n\n"
+				  << "Packs every file under <input_dir>, they can be loaded as "
+					 "'pack://<relative_path>' once the pack is mounted.\n";
+		return 1;
+	}
+
+	const fs::path output_file = argv[1];
+	const fs::path input_dir = argv[2];
+
+	AssetPackCompression compression = AssetPackCompression::NONE;
+	for (int i = 3; i < argc; ++i) {
+		if (std::string_view(argv[i]) == "--compress") {
+			compression = AssetPackCompression::LZ;
+		} else {
+			std::cerr << "Error: Unknown option " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+
+	std::error_code err;
+	if (!fs::is_directory(input_dir, err)) {
+		std::cerr << "Error: " << input_dir << " is not a directory" << std::endl;
+		return 1;
+	}
+
+	// Do not pack the previous output if it is written into the input directory
+	const fs::path output_abs = fs::weakly_canonical(output_file, err);
+
+	AssetPackWriter writer;
+	size_t total_size = 0;
+
+	for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input_dir)) {
+		if (!entry.is_regular_file() || fs::weakly_canonical(entry.path(), err) == output_abs) {
+			continue;
+		}
+
+		const std::string path = entry.path().lexically_relative(input_dir).generic_string();
+
+		std::vector<uint8_t> data = _read_file(entry.path());
+		if (data.size() != entry.file_size()) {
+			std::cerr << "Error: Unable to read file " << entry.path() << std::endl;
+			return 1;
+		}
+
+		total_size += data.size();
+		writer.add_file(path, std::move(data), compression);
+	}
+
+	if (!writer.write(output_file)) {
+		std::cerr << "Error: Unable to write pack file " << output_file << std::endl;
+		return 1;
+	}
+
+	std::cout << "Packed " << writer.get_file_count() << " files (" << total_size
+			  << " bytes) into " << output_file << " (" << fs::file_size(output_file, err)
+			  << " bytes)" << std::endl;
+
+	return 0;
+}
@@ -12,10 +12,25 @@ struct MeshVertex {
     float uv_y;
 };
 
+// Matches `MeshVertexFormat`
+#define MESH_VERTEX_FORMAT_FULL 0
+#define MESH_VERTEX_FORMAT_QUANTIZED 1
+
+struct QuantizedMeshVertex {
+    uint position_xy;
+    uint position_z;
+    uint normal;
+    uint uv;
+};
+
 layout(buffer_reference, std430) readonly buffer VertexBuffer {
     MeshVertex vertices[];
 };
 
+layout(buffer_reference, std430) readonly buffer QuantizedVertexBuffer {
+    QuantizedMeshVertex vertices[];
+};
+
 layout(buffer_reference, std430) readonly buffer SceneBuffer {
     mat4 view_projection;
 
@@ -31,9 +46,44 @@ layout(push_constant, std430) uniform constants {
     mat4 transform;
     VertexBuffer vertex_buffer;
     SceneBuffer scene_buffer;
+    vec3 position_min;
+    uint vertex_format;
+    vec3 position_extent;
 }
 u_push_constants;
 
+vec3 decode_octahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+    const float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+
+    return normalize(normal);
+}
+
+// Fetch the vertex from the vertex buffer of the mesh, decoding it if it is quantized
+MeshVertex fetch_vertex(int index) {
+    if (u_push_constants.vertex_format != MESH_VERTEX_FORMAT_QUANTIZED) {
+        return u_push_constants.vertex_buffer.vertices[index];
+    }
+
+    const QuantizedMeshVertex q =
+        QuantizedVertexBuffer(u_push_constants.vertex_buffer).vertices[index];
+
+    const vec3 position =
+        vec3(unpackUnorm2x16(q.position_xy), unpackUnorm2x16(q.position_z).x);
+    const vec2 uv = unpackHalf2x16(q.uv);
+
+    MeshVertex v;
+    v.position = u_push_constants.position_min + position * u_push_constants.position_extent;
+    v.normal = decode_octahedral(unpackSnorm2x16(q.normal));
+    v.uv_x = uv.x;
+    v.uv_y = uv.y;
+
+    return v;
+}
+
 layout(set = 0, binding = 0) uniform MaterialData {
     vec4 base_color;
     float metallic;
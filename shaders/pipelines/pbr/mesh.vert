@@ -7,7 +7,7 @@ layout(location = 1) out vec3 v_normal;
 layout(location = 2) out vec2 v_uv;
 
 void main() {
-    MeshVertex v = u_push_constants.vertex_buffer.vertices[gl_VertexIndex];
+    MeshVertex v = fetch_vertex(gl_VertexIndex);
 
     const vec4 frag_pos = u_push_constants.transform * vec4(v.position, 1.0f);
 
@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+
+#include "glitch/asset/asset_load_trace.h"
+#include "glitch/asset/asset_system.h"
+#include "glitch/core/job_system.h"
+
+using namespace gl;
+
+TEST_CASE("AssetLoadTrace") {
+	AssetLoadTrace::clear();
+	AssetLoadTrace::set_enabled(true);
+
+	SUBCASE("Disabled") {
+		AssetLoadTrace::set_enabled(false);
+		{
+			AssetLoadTrace::LoadScope trace("disabled", "Test");
+			AssetLoadTrace::add_bytes_read(4);
+		}
+		CHECK(AssetLoadTrace::get_records().empty());
+	}
+
+	SUBCASE("Bytes read") {
+		const fs::path path = fs::temp_directory_path() / "glitch_asset_load_trace_test.bin";
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file << "0123456789";
+		}
+
+		{
+			AssetLoadTrace::LoadScope trace(path.string(), "Test");
+			REQUIRE(AssetSystem::read_file(path.string()));
+			AssetLoadTrace::add_gpu_bytes(16);
+			trace.set_succeeded(true);
+		}
+
+		const auto record = AssetLoadTrace::find_record(path.string());
+		REQUIRE(record);
+		CHECK(record->type == "Test");
+		CHECK(record->succeeded);
+		CHECK(record->bytes_read == 10);
+		CHECK(record->gpu_bytes == 16);
+		CHECK(record->get_stage(AssetLoadStage::IO) <= record->total);
+
+		fs::remove(path);
+	}
+
+	SUBCASE("Nested loads") {
+		{
+			AssetLoadTrace::LoadScope outer("outer", "Test");
+			AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+			AssetLoadTrace::add_bytes_read(1);
+			{
+				AssetLoadTrace::LoadScope inner("inner", "Test");
+				AssetLoadTrace::StageScope inner_stage(AssetLoadStage::UPLOAD);
+				AssetLoadTrace::add_gpu_bytes(2);
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			}
+			AssetLoadTrace::add_bytes_read(1);
+		}
+
+		const std::vector<AssetLoadRecord> records = AssetLoadTrace::get_records();
+		REQUIRE(records.size() == 2);
+
+		// Inner loads finish first
+		CHECK(records[0].path == "inner");
+		CHECK(records[0].gpu_bytes == 2);
+		CHECK(records[0].get_stage(AssetLoadStage::UPLOAD) >= std::chrono::milliseconds(20));
+
+		// Stages of the outer load exclude the inner one, its total does not
+		CHECK(records[1].path == "outer");
+		CHECK(records[1].bytes_read == 2);
+		CHECK(records[1].gpu_bytes == 0);
+		CHECK(records[1].get_stage(AssetLoadStage::DECODE) < std::chrono::milliseconds(20));
+		CHECK(records[1].total >= std::chrono::milliseconds(20));
+	}
+
+	SUBCASE("Parallel work") {
+		JobSystem::init(2);
+		{
+			AssetLoadTrace::LoadScope trace("parallel", "Test");
+
+			AssetLoadTrace::ParallelScope parallel;
+			JobSystem::parallel_for(4, [&](uint32_t p_index) {
+				AssetLoadTrace::WorkerScope worker(parallel);
+				AssetLoadTrace::StageScope stage(AssetLoadStage::DECODE);
+				AssetLoadTrace::add_gpu_bytes(1);
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			});
+		}
+		JobSystem::shutdown();
+
+		// Work of every thread is credited to the load, whichever thread did it
+		const auto record = AssetLoadTrace::find_record("parallel");
+		REQUIRE(record);
+		CHECK(record->gpu_bytes == 4);
+		CHECK(record->get_stage(AssetLoadStage::DECODE) >= std::chrono::milliseconds(40));
+		CHECK(AssetLoadTrace::get_records().size() == 1);
+	}
+
+	SUBCASE("JSON") {
+		for (const char* path : { "a", "b" }) {
+			AssetLoadTrace::LoadScope trace(path, "Test");
+			AssetLoadTrace::add_bytes_read(3);
+		}
+
+		const json j = AssetLoadTrace::to_json();
+		REQUIRE(j["records"].size() == 2);
+		CHECK(j["records"][0]["path"] == "a");
+		CHECK(j["records"][1]["succeeded"] == false);
+		CHECK(j["totals"]["count"] == 2);
+		CHECK(j["totals"]["bytes_read"] == 6);
+	}
+
+	AssetLoadTrace::set_enabled(false);
+	AssetLoadTrace::clear();
+}
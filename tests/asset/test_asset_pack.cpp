@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>
+
+#include "glitch/asset/asset_pack.h"
+#include "glitch/asset/asset_system.h"
+
+using namespace gl;
+
+static std::vector<uint8_t> _to_bytes(std::string_view p_str) {
+	return std::vector<uint8_t>(p_str.begin(), p_str.end());
+}
+
+TEST_CASE("AssetPack") {
+	const fs::path dir = fs::temp_directory_path() / "glitch_asset_pack_test";
+	fs::create_directories(dir);
+
+	const fs::path pack_path = dir / "test.glpack";
+
+	const std::string text(10000, 'x');
+
+	AssetPackWriter writer;
+	writer.add_file("textures/a.txt", _to_bytes("first"));
+	writer.add_file("textures/a.txt", _to_bytes("replaced"));
+	writer.add_file("text.txt", _to_bytes(text), AssetPackCompression::LZ);
+	writer.add_file("empty.txt", {});
+	REQUIRE(writer.write(pack_path));
+
+	SUBCASE("Reading") {
+		const std::shared_ptr<AssetPack> pack = AssetPack::open(pack_path);
+		REQUIRE(pack != nullptr);
+
+		CHECK(pack->get_entry_count() == 3);
+		CHECK(pack->contains("textures/a.txt"));
+		CHECK_FALSE(pack->contains("textures/b.txt"));
+		CHECK_FALSE(pack->contains("a.txt"));
+
+		CHECK(pack->read("textures/a.txt") == _to_bytes("replaced"));
+		CHECK(pack->read("text.txt") == _to_bytes(text));
+		CHECK(pack->read("empty.txt") == std::vector<uint8_t>());
+		CHECK_FALSE(pack->read("missing.txt"));
+
+		// Uncompressed payloads are aligned and served without copies
+		const auto view = pack->get_view("textures/a.txt");
+		REQUIRE(view);
+		CHECK(view->size() == 8);
+		CHECK((reinterpret_cast<uintptr_t>(view->data()) % ASSET_PACK_ALIGNMENT) == 0);
+
+		CHECK_FALSE(pack->get_view("text.txt"));
+
+		// Compressed payload is smaller than the file
+		CHECK(fs::file_size(pack_path) < 4 * ASSET_PACK_ALIGNMENT);
+	}
+
+	SUBCASE("Invalid files") {
+		CHECK(AssetPack::open(dir / "missing.glpack") == nullptr);
+
+		const fs::path invalid_path = dir / "invalid.glpack";
+		std::ofstream(invalid_path) << "not a pack file";
+		CHECK(AssetPack::open(invalid_path) == nullptr);
+
+		// Uncompressed size the payload cannot expand to
+		std::vector<uint8_t> data;
+		{
+			std::ifstream file(pack_path, std::ios::binary);
+			data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		AssetPackHeader header;
+		memcpy(&header, data.data(), sizeof(header));
+		for (uint32_t i = 0; i < header.entry_count; i++) {
+			AssetPackEntry* entry = reinterpret_cast<AssetPackEntry*>(
+					data.data() + sizeof(header) + i * sizeof(AssetPackEntry));
+			entry->size = UINT64_MAX;
+		}
+
+		const fs::path oversized_path = dir / "oversized.glpack";
+		std::ofstream(oversized_path, std::ios::binary)
+				.write(reinterpret_cast<const char*>(data.data()), data.size());
+		CHECK(AssetPack::open(oversized_path) == nullptr);
+	}
+
+	SUBCASE("Mounting") {
+		REQUIRE(AssetSystem::mount_pack(pack_path));
+
+		CHECK(AssetSystem::file_exists("pack://text.txt"));
+		CHECK_FALSE(AssetSystem::file_exists("pack://missing.txt"));
+
+		const auto file = AssetSystem::read_file("pack://text.txt");
+		REQUIRE(file);
+		CHECK(*file == _to_bytes(text));
+
+		CHECK_FALSE(AssetSystem::read_file("pack://missing.txt"));
+
+		// Packs mounted later take precedence
+		const fs::path patch_path = dir / "patch.glpack";
+		AssetPackWriter patch_writer;
+		patch_writer.add_file("text.txt", _to_bytes("patched"));
+		REQUIRE(patch_writer.write(patch_path));
+		REQUIRE(AssetSystem::mount_pack(patch_path));
+
+		CHECK(*AssetSystem::read_file("pack://text.txt") == _to_bytes("patched"));
+		CHECK(*AssetSystem::read_file("pack://textures/a.txt") == _to_bytes("replaced"));
+
+		AssetSystem::unmount_packs();
+		CHECK_FALSE(AssetSystem::file_exists("pack://text.txt"));
+	}
+
+	fs::remove_all(dir);
+}
@@ -81,11 +81,195 @@ struct MockSerializedAsset {
 	}
 };
 
+struct MockAsyncAsset {
+	GL_REFLECT_ASSET("MockAsyncAsset");
+
+	fs::path loaded_from;
+	inline static std::atomic_int s_load_count = 0;
+
+	MockAsyncAsset(fs::path p_path) : loaded_from(std::move(p_path)) {}
+
+	static bool save(const fs::path& p_metadata_path, std::shared_ptr<MockAsyncAsset> p_asset) {
+		return true;
+	}
+
+	static std::shared_ptr<MockAsyncAsset> load(const fs::path& p_path) {
+		s_load_count++;
+
+		if (p_path.filename() == "missing.dat") {
+			return nullptr;
+		}
+
+		return std::make_shared<MockAsyncAsset>(p_path);
+	}
+};
+
+struct MockFileAsset {
+	GL_REFLECT_ASSET("MockFileAsset");
+
+	std::string content;
+
+	MockFileAsset(std::string p_content) : content(std::move(p_content)) {}
+
+	static bool save(const fs::path& p_metadata_path, std::shared_ptr<MockFileAsset> p_asset) {
+		return true;
+	}
+
+	static std::shared_ptr<MockFileAsset> load(const fs::path& p_path) {
+		std::ifstream file(p_path);
+		if (!file.is_open()) {
+			return nullptr;
+		}
+
+		std::stringstream ss;
+		ss << file.rdbuf();
+		return std::make_shared<MockFileAsset>(ss.str());
+	}
+};
+
+struct MockSizedAsset {
+	GL_REFLECT_ASSET("MockSizedAsset");
+
+	size_t size;
+
+	MockSizedAsset(size_t p_size) : size(p_size) {}
+
+	size_t get_memory_size() const { return size; }
+
+	static std::shared_ptr<MockSizedAsset> create(size_t p_size) {
+		return std::make_shared<MockSizedAsset>(p_size);
+	}
+};
+
+struct MockDependentAsset {
+	GL_REFLECT_ASSET("MockDependentAsset");
+
+	std::vector<AssetHandle> dependencies;
+	int reload_count = 0;
+
+	MockDependentAsset(std::vector<AssetHandle> p_dependencies) :
+			dependencies(std::move(p_dependencies)) {}
+
+	std::vector<AssetHandle> get_dependencies() const { return dependencies; }
+
+	void on_dependency_reloaded() { reload_count++; }
+
+	size_t get_memory_size() const { return 1; }
+
+	static std::shared_ptr<MockDependentAsset> create(std::vector<AssetHandle> p_dependencies) {
+		return std::make_shared<MockDependentAsset>(std::move(p_dependencies));
+	}
+};
+
+struct MockEvictableAsset {
+	GL_REFLECT_ASSET("MockEvictableAsset");
+
+	size_t size;
+	bool can_evict;
+	bool resident = true;
+
+	MockEvictableAsset(size_t p_size, bool p_can_evict) : size(p_size), can_evict(p_can_evict) {}
+
+	size_t get_memory_size() const { return resident ? size : 0; }
+
+	bool is_resident() const { return resident; }
+
+	bool evict() {
+		if (!can_evict || !resident) {
+			return false;
+		}
+		resident = false;
+		return true;
+	}
+
+	bool make_resident() {
+		resident = true;
+		return true;
+	}
+
+	static std::shared_ptr<MockEvictableAsset> create(size_t p_size, bool p_can_evict = true) {
+		return std::make_shared<MockEvictableAsset>(p_size, p_can_evict);
+	}
+};
+
+struct MockBatchEvictableAsset : MockEvictableAsset {
+	GL_REFLECT_ASSET("MockBatchEvictableAsset");
+
+	inline static std::vector<size_t> s_batch_sizes;
+
+	using MockEvictableAsset::MockEvictableAsset;
+
+	static std::vector<uint8_t> evict_batch(std::span<MockBatchEvictableAsset* const> p_assets) {
+		s_batch_sizes.push_back(p_assets.size());
+
+		std::vector<uint8_t> results;
+		for (MockBatchEvictableAsset* asset : p_assets) {
+			results.push_back(asset->evict());
+		}
+		return results;
+	}
+
+	static std::shared_ptr<MockBatchEvictableAsset> create(size_t p_size, bool p_can_evict) {
+		return std::make_shared<MockBatchEvictableAsset>(p_size, p_can_evict);
+	}
+};
+
+// Only ever registered while reloading `MockNestedLoadAsset`
+struct MockLateAsset {
+	GL_REFLECT_ASSET("MockLateAsset");
+
+	static std::shared_ptr<MockLateAsset> create() { return std::make_shared<MockLateAsset>(); }
+};
+
+// Loaders of composite assets register their sub assets
+struct MockNestedLoadAsset {
+	GL_REFLECT_ASSET("MockNestedLoadAsset");
+
+	AssetHandle child = INVALID_ASSET_HANDLE;
+	inline static bool s_create_child = false;
+
+	static bool save(
+			const fs::path& p_metadata_path, std::shared_ptr<MockNestedLoadAsset> p_asset) {
+		return true;
+	}
+
+	static std::shared_ptr<MockNestedLoadAsset> load(const fs::path& p_path) {
+		auto asset = std::make_shared<MockNestedLoadAsset>();
+		if (s_create_child) {
+			asset->child = *AssetSystem::create<MockLateAsset>();
+		}
+		return asset;
+	}
+};
+
 // --- Concept Sanity Checks ---
 static_assert(IsCreatableAsset<MockCreatableAsset, int>);
 static_assert(IsLoadableAsset<MockLoadableAsset>);
 static_assert(IsCreatableAsset<AnotherMockAsset>);
 static_assert(IsLoadableAsset<MockSerializedAsset>);
+static_assert(IsLoadableAsset<MockAsyncAsset>);
+static_assert(IsLoadableAsset<MockFileAsset>);
+static_assert(IsSizedAsset<MockSizedAsset>);
+static_assert(IsDependentAsset<MockDependentAsset>);
+static_assert(!IsDependentAsset<MockSizedAsset>);
+static_assert(IsEvictableAsset<MockEvictableAsset>);
+static_assert(!IsBatchEvictableAsset<MockEvictableAsset>);
+static_assert(IsBatchEvictableAsset<MockBatchEvictableAsset>);
+static_assert(!IsEvictableAsset<MockSizedAsset>);
+
+// Poll the state of an asynchronous load until it finishes
+static std::optional<AssetLoadState> _wait_for_load(const AssetHandle& p_handle) {
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+	std::optional<AssetLoadState> state = AssetSystem::get_state<MockAsyncAsset>(p_handle);
+	while ((state == AssetLoadState::QUEUED || state == AssetLoadState::LOADING) &&
+			std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		state = AssetSystem::get_state<MockAsyncAsset>(p_handle);
+	}
+
+	return state;
+}
 
 // --- Test Cases ---
 
@@ -210,20 +394,19 @@ TEST_CASE("AssetSystem Lifecycle (Load, Create, Get, Free, GC, Shutdown)") {
 	}
 
 	SUBCASE("Garbage Collection") {
-		// Create an asset and hold a reference to it
+		// Create an asset and hold two references to it
 		auto h_gc_keep_opt = AssetSystem::create<MockCreatableAsset>(100);
 		REQUIRE(h_gc_keep_opt.has_value());
 
-		AssetHandle& h_gc_keep = *h_gc_keep_opt;
-		AssetHandle h_gc_keep2 = h_gc_keep;
-
-		REQUIRE(h_gc_keep2.is_valid());
+		const AssetHandle h_gc_keep = *h_gc_keep_opt;
+		CHECK(AssetSystem::retain<MockCreatableAsset>(h_gc_keep));
+		CHECK(AssetSystem::retain<MockCreatableAsset>(h_gc_keep));
+		CHECK(AssetSystem::get_ref_count<MockCreatableAsset>(h_gc_keep) == 2);
 
 		// Create an asset and don't hold a reference
 		auto h_gc_remove = AssetSystem::create<MockCreatableAsset>(200);
 		REQUIRE(h_gc_remove.has_value());
-		h_gc_remove->release();
-		// use_count in registry is 1
+		CHECK(AssetSystem::get_ref_count<MockCreatableAsset>(*h_gc_remove) == 0);
 
 		// Call GC
 		AssetSystem::collect_garbage();
@@ -236,18 +419,84 @@ TEST_CASE("AssetSystem Lifecycle (Load, Create, Get, Free, GC, Shutdown)") {
 		auto asset_gc_remove = AssetSystem::get<MockCreatableAsset>(*h_gc_remove);
 		CHECK(asset_gc_remove == nullptr); // Should be gone
 
-		// Release our reference and GC again
+		// Stale handles can not be retained
+		CHECK_FALSE(AssetSystem::retain<MockCreatableAsset>(*h_gc_remove));
+
+		// Release our references and GC again
 		asset_gc_keep.reset();
-		h_gc_keep.release();
-		h_gc_keep2.release();
-		// use_count for h_gc_keep in registry is now 1
+		CHECK(AssetSystem::release<MockCreatableAsset>(h_gc_keep));
+		AssetSystem::collect_garbage();
 
+		CHECK(AssetSystem::get<MockCreatableAsset>(h_gc_keep) != nullptr);
+
+		CHECK(AssetSystem::release<MockCreatableAsset>(h_gc_keep));
+		CHECK_FALSE(AssetSystem::release<MockCreatableAsset>(h_gc_keep));
 		AssetSystem::collect_garbage();
 
 		asset_gc_keep = AssetSystem::get<MockCreatableAsset>(h_gc_keep);
 		CHECK(asset_gc_keep == nullptr); // Now it should be gone
 	}
 
+	SUBCASE("Slot Reuse") {
+		auto h_old = AssetSystem::create<MockCreatableAsset>(1);
+		REQUIRE(h_old.has_value());
+		CHECK(AssetSystem::free<MockCreatableAsset>(*h_old));
+
+		// Freed slot gets reused with a new generation
+		auto h_new = AssetSystem::create<MockCreatableAsset>(2);
+		REQUIRE(h_new.has_value());
+		CHECK(h_new->index == h_old->index);
+		CHECK(h_new->generation != h_old->generation);
+
+		CHECK(AssetSystem::get<MockCreatableAsset>(*h_old) == nullptr);
+		CHECK(AssetSystem::get<MockCreatableAsset>(*h_new)->value == 2);
+
+		// Handles survive a round-trip through their serialized form
+		CHECK(AssetHandle::unpack(h_new->pack()) == *h_new);
+		CHECK(json(*h_new).get<AssetHandle>() == *h_new);
+		CHECK(json(INVALID_ASSET_HANDLE).is_null());
+	}
+
+	SUBCASE("Find Or Register By Content") {
+		int create_count = 0;
+		const auto create = [&]() {
+			create_count++;
+			return MockCreatableAsset::create(create_count);
+		};
+
+		CHECK_FALSE(AssetSystem::find<MockCreatableAsset>(0x1234));
+
+		const AssetHandle h_first =
+				AssetSystem::find_or_register<MockCreatableAsset>(0x1234, create);
+		REQUIRE(h_first);
+		CHECK(AssetSystem::find<MockCreatableAsset>(0x1234) == h_first);
+
+		// Identical content shares the asset
+		CHECK(AssetSystem::find_or_register<MockCreatableAsset>(0x1234, create) == h_first);
+		CHECK(create_count == 1);
+
+		const AssetHandle h_other =
+				AssetSystem::find_or_register<MockCreatableAsset>(0x5678, create);
+		REQUIRE(h_other);
+		CHECK(h_other != h_first);
+		CHECK(create_count == 2);
+
+		MockCreatableAsset::s_force_create_failure = true;
+		CHECK_FALSE(AssetSystem::find_or_register<MockCreatableAsset>(0x9abc, create));
+		MockCreatableAsset::s_force_create_failure = false;
+
+		// Collected assets get created again
+		AssetSystem::collect_garbage();
+		CHECK(AssetSystem::get<MockCreatableAsset>(h_first) == nullptr);
+		CHECK_FALSE(AssetSystem::find<MockCreatableAsset>(0x1234));
+
+		const AssetHandle h_recreated =
+				AssetSystem::find_or_register<MockCreatableAsset>(0x1234, create);
+		REQUIRE(h_recreated);
+		CHECK(h_recreated != h_first);
+		CHECK(AssetSystem::get<MockCreatableAsset>(h_recreated)->value == 4);
+	}
+
 	SUBCASE("Shutdown") {
 		// Create one last asset
 		auto h_shutdown_opt = AssetSystem::create<AnotherMockAsset>();
@@ -310,9 +559,13 @@ TEST_CASE("AssetSystem Serialization") {
 		// Verify asset is gone
 		CHECK(AssetSystem::get<MockSerializedAsset>(original_handle) == nullptr);
 
-		AssetSystem::deserialize(serialized_data);
+		AssetHandleRemap remap;
+		AssetSystem::deserialize(serialized_data, &remap);
+
+		// Handles are reallocated while deserializing
+		REQUIRE(remap.contains(original_handle));
 
-		auto restored_asset = AssetSystem::get<MockSerializedAsset>(original_handle);
+		auto restored_asset = AssetSystem::get<MockSerializedAsset>(remap.at(original_handle));
 		REQUIRE(restored_asset != nullptr);
 		CHECK(restored_asset->data == "Restored Data"); // Value set by static load()
 		CHECK(restored_asset->loaded_path == "/home/glitch/save_data.json");
@@ -356,7 +609,7 @@ TEST_CASE("AssetSystem Serialization") {
 		json fake_save;
 		fake_save["MockSerializedAsset"] = json::array({
 				{
-						{ "handle", AssetHandle() }, // Random valid UID
+						{ "handle", AssetHandle{ 7, 1 } },
 						{ "path", "/home/glitch/missing_file.json" },
 				},
 		});
@@ -372,3 +625,664 @@ TEST_CASE("AssetSystem Serialization") {
 	AssetSystem::clear();
 	os::setenv("GL_WORKING_DIR", "");
 }
+
+TEST_CASE("AssetRegistry Path Index") {
+	AssetSystem::clear();
+
+	auto& registry = AssetSystem::get_registry<MockCreatableAsset>();
+
+	AssetHandle handle =
+			AssetSystem::register_asset(std::make_shared<MockCreatableAsset>(1), "res://a.dat");
+
+	SUBCASE("Lookup") {
+		const std::string_view path = "res://a.dat";
+
+		const auto found = registry.get_handle_by_path(path);
+		REQUIRE(found.has_value());
+		CHECK(*found == handle);
+
+		const auto asset = AssetSystem::get_by_path<MockCreatableAsset>(path);
+		REQUIRE(asset != nullptr);
+		CHECK(asset->value == 1);
+
+		CHECK_FALSE(registry.get_handle_by_path("res://b.dat").has_value());
+	}
+
+	SUBCASE("Duplicate paths") {
+		AssetHandle duplicate = AssetSystem::register_asset(
+				std::make_shared<MockCreatableAsset>(2), "res://a.dat");
+
+		// Path stays resolvable as long as one of the handles is alive
+		CHECK(AssetSystem::free<MockCreatableAsset>(handle));
+
+		const auto found = registry.get_handle_by_path("res://a.dat");
+		REQUIRE(found.has_value());
+		CHECK(*found == duplicate);
+
+		CHECK(AssetSystem::free<MockCreatableAsset>(duplicate));
+		CHECK_FALSE(registry.get_handle_by_path("res://a.dat").has_value());
+	}
+
+	SUBCASE("Re-registering a handle") {
+		AssetSystem::register_asset(std::make_shared<MockCreatableAsset>(3), "res://b.dat", handle);
+
+		CHECK_FALSE(registry.get_handle_by_path("res://a.dat").has_value());
+
+		const auto found = registry.get_handle_by_path("res://b.dat");
+		REQUIRE(found.has_value());
+		CHECK(*found == handle);
+	}
+
+	SUBCASE("Garbage Collection") {
+		// No references are held
+		AssetSystem::collect_garbage();
+
+		CHECK_FALSE(registry.get_handle_by_path("res://a.dat").has_value());
+		CHECK(AssetSystem::get_by_path<MockCreatableAsset>("res://a.dat") == nullptr);
+	}
+
+	SUBCASE("Clear") {
+		AssetSystem::clear();
+
+		CHECK_FALSE(registry.get_handle_by_path("res://a.dat").has_value());
+
+		// Index must not keep stale entries of previous registrations
+		AssetHandle new_handle =
+				AssetSystem::register_asset(std::make_shared<MockCreatableAsset>(4), "res://a.dat");
+
+		const auto found = registry.get_handle_by_path("res://a.dat");
+		REQUIRE(found.has_value());
+		CHECK(*found == new_handle);
+	}
+
+	AssetSystem::clear();
+}
+
+TEST_CASE("AssetSystem Enumeration") {
+	AssetSystem::clear();
+
+	auto& registry = AssetSystem::get_registry<MockCreatableAsset>();
+
+	const AssetHandle h_a =
+			AssetSystem::register_asset(std::make_shared<MockCreatableAsset>(1), "res://a.dat");
+	const auto h_b = AssetSystem::create<AnotherMockAsset>();
+	REQUIRE(h_b.has_value());
+
+	SUBCASE("Visit") {
+		std::unordered_map<AssetHandle, std::string> visited;
+		AssetSystem::for_each_asset(
+				[&](const AssetHandle& p_handle, const AssetMetadataView& p_metadata) {
+					visited.emplace(p_handle, p_metadata.type_name);
+				});
+
+		CHECK(visited.size() == 2);
+		CHECK(visited[h_a] == "MockCreatableAsset");
+		CHECK(visited[*h_b] == "AnotherMockAsset");
+		CHECK(AssetSystem::get_asset_count() == 2);
+
+		const auto metadata = AssetSystem::get_asset_metadata();
+		REQUIRE(metadata.contains(h_a));
+		CHECK(metadata.at(h_a).path == "res://a.dat");
+	}
+
+	SUBCASE("Version") {
+		const uint64_t version = registry.get_version();
+		const uint64_t total_version = AssetSystem::get_version();
+
+		// Reference counts and lookups do not change the version
+		CHECK(AssetSystem::retain<MockCreatableAsset>(h_a));
+		CHECK(AssetSystem::get<MockCreatableAsset>(h_a) != nullptr);
+		CHECK(registry.get_version() == version);
+		CHECK(AssetSystem::release<MockCreatableAsset>(h_a));
+
+		AssetSystem::register_asset(std::make_shared<MockCreatableAsset>(2), "res://b.dat", h_a);
+		CHECK(registry.get_version() > version);
+
+		const uint64_t replaced_version = registry.get_version();
+		CHECK(AssetSystem::free<MockCreatableAsset>(h_a));
+		CHECK(registry.get_version() > replaced_version);
+
+		// Other registries are not affected
+		CHECK(AssetSystem::get_version() - total_version == registry.get_version() - version);
+	}
+
+	AssetSystem::clear();
+}
+
+TEST_CASE("AssetSystem Incremental Garbage Collection") {
+	AssetSystem::clear();
+
+	constexpr size_t ASSET_COUNT = 512;
+
+	std::vector<AssetHandle> handles;
+	std::vector<std::weak_ptr<MockCreatableAsset>> assets;
+	for (size_t i = 0; i < ASSET_COUNT; i++) {
+		auto asset = std::make_shared<MockCreatableAsset>(int(i));
+		handles.push_back(AssetSystem::register_asset(asset));
+		assets.push_back(asset);
+	}
+
+	// Keep every other asset alive
+	for (size_t i = 0; i < ASSET_COUNT; i += 2) {
+		AssetSystem::retain<MockCreatableAsset>(handles[i]);
+	}
+
+	std::vector<AssetSystem::AssetDeletionFn> deferred;
+	AssetSystem::set_deletion_handler([&](AssetSystem::AssetDeletionFn&& p_function) {
+		deferred.push_back(std::move(p_function));
+	});
+
+	// Zero budget still makes progress but does not finish in a single call
+	AssetSystem::collect_garbage(std::chrono::microseconds(0));
+
+	auto& registry = AssetSystem::get_registry<MockCreatableAsset>();
+	CHECK(registry.get_asset_size() > ASSET_COUNT / 2);
+
+	for (size_t i = 0; i < ASSET_COUNT && registry.get_asset_size() > ASSET_COUNT / 2; i++) {
+		AssetSystem::collect_garbage(std::chrono::microseconds(0));
+	}
+	REQUIRE(registry.get_asset_size() == ASSET_COUNT / 2);
+
+	for (size_t i = 0; i < ASSET_COUNT; i++) {
+		CHECK((AssetSystem::get<MockCreatableAsset>(handles[i]) != nullptr) == (i % 2 == 0));
+	}
+
+	// Collected assets are alive until the deletion handler runs them
+	CHECK_FALSE(deferred.empty());
+	CHECK_FALSE(assets[1].expired());
+
+	for (auto& function : deferred) {
+		function();
+	}
+	deferred.clear();
+
+	for (size_t i = 0; i < ASSET_COUNT; i++) {
+		CHECK(assets[i].expired() == (i % 2 == 1));
+	}
+
+	AssetSystem::set_deletion_handler(nullptr);
+	AssetSystem::clear();
+}
+
+TEST_CASE("AssetSystem Dependency Graph") {
+	AssetSystem::clear();
+
+	const AssetHandle texture_a = *AssetSystem::create<MockSizedAsset>(size_t(100));
+	const AssetHandle texture_b = *AssetSystem::create<MockSizedAsset>(size_t(200));
+
+	const AssetHandle material = *AssetSystem::create<MockDependentAsset>(
+			std::vector<AssetHandle>{ texture_a, texture_b });
+
+	SUBCASE("Edges hold references") {
+		CHECK(AssetSystem::get_dependencies(material) ==
+				std::vector<AssetHandle>{ texture_a, texture_b });
+		CHECK(AssetSystem::get_dependents(texture_a) == std::vector<AssetHandle>{ material });
+
+		CHECK(AssetSystem::get_ref_count<MockSizedAsset>(texture_a) == 1);
+		CHECK(AssetSystem::get_ref_count<MockDependentAsset>(material) == 0);
+	}
+
+	SUBCASE("Dependencies are collected in the same pass") {
+		AssetSystem::collect_garbage();
+
+		CHECK(AssetSystem::get<MockDependentAsset>(material) == nullptr);
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_a) == nullptr);
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_b) == nullptr);
+
+		CHECK(AssetSystem::get_dependents(texture_a).empty());
+	}
+
+	SUBCASE("Retained dependents keep dependencies alive") {
+		AssetSystem::retain<MockDependentAsset>(material);
+
+		// Shared dependency outlives one of its dependents
+		const AssetHandle other = *AssetSystem::create<MockDependentAsset>(
+				std::vector<AssetHandle>{ texture_a });
+		CHECK(AssetSystem::get_ref_count<MockSizedAsset>(texture_a) == 2);
+
+		AssetSystem::collect_garbage();
+
+		CHECK(AssetSystem::get<MockDependentAsset>(other) == nullptr);
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_a) != nullptr);
+		CHECK(AssetSystem::get_ref_count<MockSizedAsset>(texture_a) == 1);
+
+		// Everything goes once the last owner lets go
+		AssetSystem::release<MockDependentAsset>(material);
+		AssetSystem::collect_garbage();
+
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_a) == nullptr);
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_b) == nullptr);
+	}
+
+	SUBCASE("Updating dependencies") {
+		AssetSystem::retain<MockDependentAsset>(material);
+
+		AssetSystem::get<MockDependentAsset>(material)->dependencies = { texture_b };
+		AssetSystem::update_dependencies<MockDependentAsset>(material);
+
+		CHECK(AssetSystem::get_dependencies(material) == std::vector<AssetHandle>{ texture_b });
+		CHECK(AssetSystem::get_dependents(texture_a).empty());
+		CHECK(AssetSystem::get_ref_count<MockSizedAsset>(texture_a) == 0);
+
+		AssetSystem::collect_garbage();
+
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_a) == nullptr);
+		CHECK(AssetSystem::get<MockSizedAsset>(texture_b) != nullptr);
+	}
+
+	SUBCASE("Freeing a dependency") {
+		AssetSystem::retain<MockDependentAsset>(material);
+
+		CHECK(AssetSystem::free<MockSizedAsset>(texture_a));
+		CHECK(AssetSystem::get_dependencies(material) == std::vector<AssetHandle>{ texture_b });
+	}
+
+	SUBCASE("Memory footprint") {
+		// Shared dependencies are counted once
+		const AssetHandle other = *AssetSystem::create<MockDependentAsset>(
+				std::vector<AssetHandle>{ material, texture_a });
+
+		CHECK(AssetSystem::get_memory_footprint(texture_a) == 100);
+		CHECK(AssetSystem::get_memory_footprint(material) == 301);
+		CHECK(AssetSystem::get_memory_footprint(other) == 302);
+		CHECK(AssetSystem::get_memory_footprint(INVALID_ASSET_HANDLE) == 0);
+	}
+
+	AssetSystem::clear();
+}
+
+TEST_CASE("AssetSystem Memory Budgets") {
+	AssetSystem::clear();
+
+	const auto create = [](bool p_can_evict = true) {
+		return *AssetSystem::create<MockEvictableAsset>(size_t(100), p_can_evict);
+	};
+
+	const auto is_resident = [](const AssetHandle& p_handle) {
+		return AssetSystem::get<MockEvictableAsset>(p_handle)->is_resident();
+	};
+
+	SUBCASE("Least recently used assets are evicted") {
+		const AssetHandle a = create();
+		const AssetHandle b = create();
+		const AssetHandle c = create();
+		const AssetHandle d = create();
+
+		CHECK(AssetSystem::get_memory_usage<MockEvictableAsset>() == 400);
+
+		// Nothing is evicted without a budget
+		AssetSystem::enforce_memory_budgets();
+		CHECK(AssetSystem::get_memory_usage<MockEvictableAsset>() == 400);
+
+		AssetSystem::set_memory_budget<MockEvictableAsset>(250);
+
+		AssetSystem::update();
+		AssetSystem::mark_used<MockEvictableAsset>(a);
+		AssetSystem::mark_used<MockEvictableAsset>(b);
+
+		AssetSystem::update();
+		AssetSystem::mark_used<MockEvictableAsset>(c);
+
+		AssetSystem::update();
+		AssetSystem::enforce_memory_budgets();
+
+		CHECK(AssetSystem::get_memory_usage<MockEvictableAsset>() == 200);
+		CHECK_FALSE(is_resident(d));
+		CHECK(is_resident(a) != is_resident(b));
+		// Used by the previous frame
+		CHECK(is_resident(c));
+
+		// Evicted assets stay registered and are restored on demand
+		CHECK(AssetSystem::get<MockEvictableAsset>(d)->make_resident());
+		CHECK(AssetSystem::get_memory_usage<MockEvictableAsset>() == 300);
+	}
+
+	SUBCASE("Assets that can not be evicted are skipped") {
+		const AssetHandle pinned = create(false);
+		const AssetHandle evictable = create();
+
+		AssetSystem::set_memory_budget<MockEvictableAsset>(100);
+
+		AssetSystem::update();
+		AssetSystem::update();
+		AssetSystem::enforce_memory_budgets();
+
+		CHECK(is_resident(pinned));
+		CHECK_FALSE(is_resident(evictable));
+	}
+
+	SUBCASE("Dependents keep their dependencies resident") {
+		const AssetHandle used = create();
+		const AssetHandle unused = create();
+		const AssetHandle dependent =
+				*AssetSystem::create<MockDependentAsset>(std::vector<AssetHandle>{ used });
+
+		AssetSystem::set_memory_budget<MockEvictableAsset>(100);
+
+		AssetSystem::update();
+		AssetSystem::mark_used<MockDependentAsset>(dependent);
+
+		AssetSystem::update();
+		AssetSystem::enforce_memory_budgets();
+
+		CHECK(is_resident(used));
+		CHECK_FALSE(is_resident(unused));
+		CHECK(AssetSystem::get<MockDependentAsset>(dependent)->reload_count == 0);
+
+		// Dependents are notified once their dependencies get evicted
+		AssetSystem::get<MockEvictableAsset>(unused)->make_resident();
+		AssetSystem::mark_used<MockEvictableAsset>(unused);
+
+		AssetSystem::update();
+		AssetSystem::update();
+		AssetSystem::mark_used<MockEvictableAsset>(unused);
+		AssetSystem::enforce_memory_budgets();
+
+		CHECK_FALSE(is_resident(used));
+		CHECK(is_resident(unused));
+		CHECK(AssetSystem::get<MockDependentAsset>(dependent)->reload_count == 1);
+	}
+
+	SUBCASE("Assets are evicted in batches") {
+		MockBatchEvictableAsset::s_batch_sizes.clear();
+
+		const AssetHandle pinned =
+				*AssetSystem::create<MockBatchEvictableAsset>(size_t(100), false);
+		std::vector<AssetHandle> evictable;
+		for (int i = 0; i < 3; i++) {
+			evictable.push_back(*AssetSystem::create<MockBatchEvictableAsset>(size_t(100), true));
+		}
+
+		AssetSystem::set_memory_budget<MockBatchEvictableAsset>(100);
+
+		AssetSystem::update();
+		AssetSystem::update();
+		AssetSystem::enforce_memory_budgets();
+
+		CHECK(AssetSystem::get_memory_usage<MockBatchEvictableAsset>() == 100);
+		CHECK(AssetSystem::get<MockBatchEvictableAsset>(pinned)->is_resident());
+		for (const AssetHandle& handle : evictable) {
+			CHECK_FALSE(AssetSystem::get<MockBatchEvictableAsset>(handle)->is_resident());
+		}
+
+		// The first batch covers the whole excess, the pinned one is made up for afterwards
+		REQUIRE(!MockBatchEvictableAsset::s_batch_sizes.empty());
+		CHECK(MockBatchEvictableAsset::s_batch_sizes[0] == 3);
+		CHECK(MockBatchEvictableAsset::s_batch_sizes.size() <= 2);
+
+		AssetSystem::set_memory_budget<MockBatchEvictableAsset>(0);
+	}
+
+	AssetSystem::set_memory_budget<MockEvictableAsset>(0);
+	AssetSystem::clear();
+}
+
+TEST_CASE("AssetSystem Concurrent Access") {
+	AssetSystem::clear();
+
+	constexpr int WRITER_COUNT = 4;
+	constexpr int ASSETS_PER_WRITER = 256;
+
+	// Asset that readers keep resolving while writers register new ones
+	AssetHandle stable_handle = AssetSystem::create<MockCreatableAsset>(-1).value();
+
+	std::atomic_bool writers_done = false;
+	std::atomic_int failures = 0;
+
+	std::thread reader([&]() {
+		while (!writers_done) {
+			const auto asset = AssetSystem::get<MockCreatableAsset>(stable_handle);
+			if (!asset || asset->value != -1) {
+				failures++;
+			}
+		}
+	});
+
+	std::array<std::vector<AssetHandle>, WRITER_COUNT> handles;
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < WRITER_COUNT; i++) {
+		writers.emplace_back([&, i]() {
+			for (int j = 0; j < ASSETS_PER_WRITER; j++) {
+				const auto handle =
+						AssetSystem::create<MockCreatableAsset>(i * ASSETS_PER_WRITER + j);
+				if (!handle) {
+					failures++;
+					continue;
+				}
+
+				handles[i].push_back(*handle);
+			}
+		});
+	}
+
+	for (std::thread& writer : writers) {
+		writer.join();
+	}
+
+	writers_done = true;
+	reader.join();
+
+	CHECK(failures == 0);
+
+	for (int i = 0; i < WRITER_COUNT; i++) {
+		REQUIRE(handles[i].size() == ASSETS_PER_WRITER);
+		for (int j = 0; j < ASSETS_PER_WRITER; j++) {
+			const auto asset = AssetSystem::get<MockCreatableAsset>(handles[i][j]);
+			REQUIRE(asset != nullptr);
+			CHECK(asset->value == i * ASSETS_PER_WRITER + j);
+		}
+	}
+
+	CHECK(AssetSystem::get_registry<MockCreatableAsset>().get_asset_size() ==
+			WRITER_COUNT * ASSETS_PER_WRITER + 1);
+
+	AssetSystem::clear();
+}
+
+TEST_CASE("AssetSystem Async Loading") {
+	AssetSystem::clear();
+	os::setenv("GL_WORKING_DIR", "/home/glitch");
+
+	// Single worker so that loads run in a predictable order
+	JobSystem::shutdown();
+	JobSystem::init(1);
+
+	MockAsyncAsset::s_load_count = 0;
+
+	int callback_count = 0;
+	AssetHandle callback_handle;
+	std::optional<AssetLoadState> callback_state;
+
+	const auto callback = [&](const AssetHandle& p_handle, AssetLoadState p_state) {
+		callback_count++;
+		callback_handle = p_handle;
+		callback_state = p_state;
+	};
+
+	SUBCASE("Load and Callback") {
+		AssetHandle handle = AssetSystem::load_async<MockAsyncAsset>("res://async.dat", callback);
+		CHECK(handle.is_valid());
+
+		// Loading the same path joins the load in flight
+		AssetHandle joined = AssetSystem::load_async<MockAsyncAsset>("res://async.dat");
+		CHECK(joined == handle);
+
+		CHECK(_wait_for_load(handle) == AssetLoadState::READY);
+		CHECK(MockAsyncAsset::s_load_count == 1);
+
+		const auto asset = AssetSystem::get<MockAsyncAsset>(handle);
+		REQUIRE(asset != nullptr);
+		CHECK(asset->loaded_from == fs::path("/home/glitch/async.dat"));
+
+		// Callbacks only run on update
+		CHECK(callback_count == 0);
+
+		AssetSystem::update();
+
+		CHECK(callback_count == 1);
+		CHECK(callback_handle == handle);
+		CHECK(callback_state == AssetLoadState::READY);
+
+		// Callbacks run only once
+		AssetSystem::update();
+		CHECK(callback_count == 1);
+
+		// Joining a ready asset reports it with the next update
+		AssetSystem::load_async<MockAsyncAsset>("res://async.dat", callback);
+		AssetSystem::update();
+
+		CHECK(callback_count == 2);
+		CHECK(MockAsyncAsset::s_load_count == 1);
+	}
+
+	SUBCASE("Load Failure") {
+		AssetHandle handle = AssetSystem::load_async<MockAsyncAsset>("res://missing.dat", callback);
+
+		CHECK(_wait_for_load(handle) == AssetLoadState::FAILED);
+		CHECK(AssetSystem::get<MockAsyncAsset>(handle) == nullptr);
+
+		AssetSystem::update();
+
+		CHECK(callback_count == 1);
+		CHECK(callback_state == AssetLoadState::FAILED);
+
+		// Invalid paths fail without being queued
+		AssetHandle invalid_handle =
+				AssetSystem::load_async<MockAsyncAsset>("bad://path.dat", callback);
+		CHECK(AssetSystem::get_state<MockAsyncAsset>(invalid_handle) == AssetLoadState::FAILED);
+
+		AssetSystem::update();
+
+		CHECK(callback_count == 2);
+		CHECK(callback_handle == invalid_handle);
+		CHECK(MockAsyncAsset::s_load_count == 1);
+	}
+
+	SUBCASE("Cancellation") {
+		// Keep the only worker busy so the load stays in the queue
+		std::atomic_bool release = false;
+		JobHandle blocker = JobSystem::schedule([&]() {
+			while (!release) {
+				std::this_thread::yield();
+			}
+		});
+
+		AssetHandle handle = AssetSystem::load_async<MockAsyncAsset>("res://async.dat", callback);
+		CHECK(AssetSystem::get_state<MockAsyncAsset>(handle) == AssetLoadState::QUEUED);
+
+		CHECK(AssetSystem::cancel_load<MockAsyncAsset>(handle));
+		CHECK(AssetSystem::get_state<MockAsyncAsset>(handle) == AssetLoadState::FAILED);
+
+		// Already cancelled
+		CHECK_FALSE(AssetSystem::cancel_load<MockAsyncAsset>(handle));
+
+		release = true;
+		blocker.wait();
+
+		// Any job queued after the cancelled load runs after it
+		JobSystem::schedule([]() {}).wait();
+
+		CHECK(MockAsyncAsset::s_load_count == 0);
+		CHECK(AssetSystem::get<MockAsyncAsset>(handle) == nullptr);
+
+		AssetSystem::update();
+
+		CHECK(callback_count == 1);
+		CHECK(callback_state == AssetLoadState::FAILED);
+	}
+
+	JobSystem::shutdown();
+
+	AssetSystem::clear();
+	os::setenv("GL_WORKING_DIR", "");
+}
+
+TEST_CASE("AssetSystem Hot Reload") {
+	AssetSystem::clear();
+
+	const fs::path dir = fs::temp_directory_path() / "glitch_hot_reload_test";
+	fs::create_directories(dir);
+	os::setenv("GL_WORKING_DIR", dir.string().c_str());
+
+	const auto write_file = [&](const char* p_name, const char* p_content) {
+		std::ofstream file(dir / p_name, std::ios::trunc);
+		file << p_content;
+	};
+
+	// Wait until the asset of `p_handle` has `p_content`, calls update as a frame would
+	const auto wait_for_content = [](const AssetHandle& p_handle, const char* p_content) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (std::chrono::steady_clock::now() < deadline) {
+			AssetSystem::update();
+
+			const auto asset = AssetSystem::get<MockFileAsset>(p_handle);
+			if (asset && asset->content == p_content) {
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return false;
+	};
+
+	write_file("a.txt", "a0");
+	write_file("b.txt", "b0");
+
+	const AssetHandle handle_a = AssetSystem::load<MockFileAsset>("res://a.txt").get_value();
+
+	AssetSystem::set_hot_reload(true);
+	CHECK(AssetSystem::is_hot_reload_enabled());
+
+	// Registered after hot reload got enabled
+	const AssetHandle handle_b = AssetSystem::load<MockFileAsset>("res://b.txt").get_value();
+
+	const auto asset_a = AssetSystem::get<MockFileAsset>(handle_a);
+
+	// Dependents are notified recursively
+	const AssetHandle dependent =
+			*AssetSystem::create<MockDependentAsset>(std::vector<AssetHandle>{ handle_a });
+	const AssetHandle indirect_dependent =
+			*AssetSystem::create<MockDependentAsset>(std::vector<AssetHandle>{ dependent });
+	const AssetHandle unrelated =
+			*AssetSystem::create<MockDependentAsset>(std::vector<AssetHandle>{ handle_b });
+
+	write_file("a.txt", "a1");
+	CHECK(wait_for_content(handle_a, "a1"));
+
+	CHECK(AssetSystem::get<MockDependentAsset>(dependent)->reload_count == 1);
+	CHECK(AssetSystem::get<MockDependentAsset>(indirect_dependent)->reload_count == 1);
+	CHECK(AssetSystem::get<MockDependentAsset>(unrelated)->reload_count == 0);
+
+	// Only the modified asset is reloaded, in place
+	CHECK(AssetSystem::get<MockFileAsset>(handle_b)->content == "b0");
+	CHECK(asset_a->content == "a0");
+
+	write_file("b.txt", "b1");
+	CHECK(wait_for_content(handle_b, "b1"));
+
+	AssetSystem::set_hot_reload(false);
+	CHECK_FALSE(AssetSystem::is_hot_reload_enabled());
+
+	AssetSystem::clear();
+	fs::remove_all(dir);
+	os::setenv("GL_WORKING_DIR", "");
+}
+
+TEST_CASE("AssetSystem Reload registers new asset types") {
+	AssetSystem::clear();
+
+	const AssetHandle handle =
+			AssetSystem::load<MockNestedLoadAsset>("/home/glitch/nested.dat").get_value();
+	CHECK_FALSE(AssetSystem::get<MockNestedLoadAsset>(handle)->child);
+
+	// Adding the registry of the new type while reloading must not deadlock
+	MockNestedLoadAsset::s_create_child = true;
+	AssetSystem::reload_all();
+	MockNestedLoadAsset::s_create_child = false;
+
+	const auto asset = AssetSystem::get<MockNestedLoadAsset>(handle);
+	REQUIRE(asset);
+	CHECK(AssetSystem::get<MockLateAsset>(asset->child));
+
+	AssetSystem::clear();
+}
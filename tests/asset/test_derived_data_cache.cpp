@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include "glitch/asset/derived_data_cache.h"
+#include "glitch/core/hash.h"
+
+using namespace gl;
+
+TEST_CASE("DerivedDataCache") {
+	const fs::path dir = fs::temp_directory_path() / "glitch_derived_data_cache_test";
+	fs::remove_all(dir);
+
+	const fs::path prev_dir = DerivedDataCache::get_directory();
+	DerivedDataCache::set_directory(dir);
+
+	const std::vector<uint8_t> source = { 1, 2, 3, 4 };
+	const std::vector<uint8_t> output = { 5, 6, 7 };
+
+	const DerivedDataKey key = { "test", 1, content_hash64(source) };
+
+	SUBCASE("Store and load") {
+		CHECK_FALSE(DerivedDataCache::load(key));
+
+		REQUIRE(DerivedDataCache::store(key, output));
+		CHECK(DerivedDataCache::load(key) == output);
+
+		// Overwriting keeps the latest output
+		const std::vector<uint8_t> new_output = { 8 };
+		REQUIRE(DerivedDataCache::store(key, new_output));
+		CHECK(DerivedDataCache::load(key) == new_output);
+	}
+
+	SUBCASE("Keys") {
+		REQUIRE(DerivedDataCache::store(key, output));
+
+		// Other versions and contents miss
+		CHECK_FALSE(DerivedDataCache::load(DerivedDataKey{ "test", 2, key.content_hash }));
+		CHECK_FALSE(DerivedDataCache::load(DerivedDataKey{ "other", 1, key.content_hash }));
+
+		const std::vector<uint8_t> other_source = { 1, 2, 3, 5 };
+		const uint64_t other_hash = content_hash64(other_source);
+		CHECK(other_hash != key.content_hash);
+		CHECK_FALSE(DerivedDataCache::load(DerivedDataKey{ "test", 1, other_hash }));
+	}
+
+	SUBCASE("Disabled") {
+		DerivedDataCache::set_enabled(false);
+		CHECK_FALSE(DerivedDataCache::store(key, output));
+		DerivedDataCache::set_enabled(true);
+
+		REQUIRE(DerivedDataCache::store(key, output));
+
+		DerivedDataCache::set_enabled(false);
+		CHECK_FALSE(DerivedDataCache::load(key));
+		DerivedDataCache::set_enabled(true);
+	}
+
+	SUBCASE("Clear") {
+		REQUIRE(DerivedDataCache::store(key, output));
+		DerivedDataCache::clear();
+		CHECK_FALSE(DerivedDataCache::load(key));
+	}
+
+	DerivedDataCache::set_directory(prev_dir);
+	fs::remove_all(dir);
+}
@@ -0,0 +1,59 @@
+#include <doctest/doctest.h>
+
+#include "glitch/core/compression.h"
+
+using namespace gl;
+
+static void _check_round_trip(const std::vector<uint8_t>& p_data) {
+	const std::vector<uint8_t> compressed = lz_compress(p_data);
+	CHECK(compressed.size() <= lz_compress_bound(p_data.size()));
+	CHECK(p_data.size() <= lz_decompress_bound(compressed.size()));
+
+	std::vector<uint8_t> decompressed(p_data.size());
+	REQUIRE(lz_decompress(compressed, decompressed));
+	CHECK(decompressed == p_data);
+}
+
+TEST_CASE("LZ Compression") {
+	SUBCASE("Empty") { _check_round_trip({}); }
+
+	SUBCASE("Short input") { _check_round_trip({ 1, 2, 3, 4, 5 }); }
+
+	SUBCASE("Repeating data") {
+		std::vector<uint8_t> data(100000);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = uint8_t(i % 7);
+		}
+
+		_check_round_trip(data);
+		CHECK(lz_compress(data).size() < data.size() / 10);
+	}
+
+	SUBCASE("Random data") {
+		std::mt19937 rng(42);
+		std::vector<uint8_t> data(70000);
+		for (uint8_t& byte : data) {
+			byte = uint8_t(rng());
+		}
+
+		_check_round_trip(data);
+	}
+
+	SUBCASE("Malformed data") {
+		std::vector<uint8_t> data(1000, 'a');
+		std::vector<uint8_t> compressed = lz_compress(data);
+
+		// Wrong output size
+		std::vector<uint8_t> decompressed(data.size() + 1);
+		CHECK_FALSE(lz_decompress(compressed, decompressed));
+
+		// Truncated input
+		compressed.resize(compressed.size() / 2);
+		decompressed.resize(data.size());
+		CHECK_FALSE(lz_decompress(compressed, decompressed));
+
+		// Back reference before the start of the output
+		const std::vector<uint8_t> invalid_offset = { 0x10, 'a', 0x05, 0x00, 0x00 };
+		CHECK_FALSE(lz_decompress(invalid_offset, decompressed));
+	}
+}
@@ -0,0 +1,142 @@
+#include <doctest/doctest.h>
+
+#include "glitch/core/job_system.h"
+
+using namespace gl;
+
+TEST_CASE("JobSystem") {
+	// Single worker so that jobs run in a predictable order
+	JobSystem::shutdown();
+	JobSystem::init(1);
+
+	CHECK(JobSystem::get_thread_count() == 1);
+
+	// Keeps the worker busy until released
+	std::atomic_bool release = false;
+	JobHandle blocker = JobSystem::schedule([&]() {
+		while (!release) {
+			std::this_thread::yield();
+		}
+	});
+
+	while (blocker.get_status() == JobStatus::QUEUED) {
+		std::this_thread::yield();
+	}
+
+	SUBCASE("Run and wait") {
+		std::atomic_int value = 0;
+		JobHandle job = JobSystem::schedule([&]() { value = 42; });
+		CHECK(job.is_valid());
+
+		release = true;
+		job.wait();
+
+		CHECK(job.get_status() == JobStatus::DONE);
+		CHECK(job.is_finished());
+		CHECK(value == 42);
+	}
+
+	SUBCASE("Priority order") {
+		std::mutex order_mutex;
+		std::vector<JobPriority> order;
+
+		const auto push_order = [&](JobPriority p_priority) {
+			return JobSystem::schedule(
+					[&, p_priority]() {
+						std::lock_guard lock(order_mutex);
+						order.push_back(p_priority);
+					},
+					p_priority);
+		};
+
+		JobHandle low = push_order(JobPriority::LOW);
+		JobHandle normal = push_order(JobPriority::NORMAL);
+		JobHandle high = push_order(JobPriority::HIGH);
+
+		release = true;
+		low.wait();
+		normal.wait();
+		high.wait();
+
+		REQUIRE(order.size() == 3);
+		CHECK(order[0] == JobPriority::HIGH);
+		CHECK(order[1] == JobPriority::NORMAL);
+		CHECK(order[2] == JobPriority::LOW);
+	}
+
+	SUBCASE("Cancellation") {
+		std::atomic_bool executed = false;
+		JobHandle job = JobSystem::schedule([&]() { executed = true; });
+
+		CHECK(job.get_status() == JobStatus::QUEUED);
+		CHECK(job.cancel());
+		CHECK(job.get_status() == JobStatus::CANCELLED);
+
+		// Running jobs can not be cancelled
+		CHECK_FALSE(blocker.cancel());
+
+		release = true;
+		blocker.wait();
+
+		// Queue is processed in order, anything after the cancelled job ran already
+		JobSystem::schedule([]() {}).wait();
+
+		CHECK_FALSE(executed);
+	}
+
+	SUBCASE("Shutdown cancels queued jobs") {
+		std::atomic_bool executed = false;
+		JobHandle job = JobSystem::schedule([&]() { executed = true; });
+
+		// Release the worker while shutdown is joining it
+		std::thread releaser([&]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			release = true;
+		});
+
+		JobSystem::shutdown();
+		releaser.join();
+
+		CHECK(blocker.get_status() == JobStatus::DONE);
+		CHECK(job.get_status() == JobStatus::CANCELLED);
+		CHECK_FALSE(executed);
+	}
+
+	release = true;
+	JobSystem::shutdown();
+
+	CHECK(JobSystem::get_thread_count() == 0);
+}
+
+TEST_CASE("JobSystem parallel for") {
+	JobSystem::shutdown();
+	JobSystem::init(2);
+
+	SUBCASE("Every index once") {
+		std::vector<std::atomic_int> counts(1000);
+		JobSystem::parallel_for(
+				uint32_t(counts.size()), [&](uint32_t p_index) { counts[p_index]++; });
+
+		CHECK(std::all_of(counts.begin(), counts.end(),
+				[](const std::atomic_int& p_count) { return p_count == 1; }));
+	}
+
+	SUBCASE("From inside of jobs") {
+		// Every worker runs a parallel for, nobody is left to pick up the scheduled jobs
+		std::atomic_int sum = 0;
+		std::vector<JobHandle> jobs;
+		for (uint32_t i = 0; i < JobSystem::get_thread_count(); i++) {
+			jobs.push_back(JobSystem::schedule([&]() {
+				JobSystem::parallel_for(100, [&](uint32_t p_index) { sum += p_index; });
+			}));
+		}
+
+		for (JobHandle& job : jobs) {
+			job.wait();
+		}
+
+		CHECK(sum == 2 * 4950);
+	}
+
+	JobSystem::shutdown();
+}
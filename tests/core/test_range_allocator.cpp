@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>
+
+#include "glitch/core/memory/range_allocator.h"
+
+using namespace gl;
+
+TEST_CASE("RangeAllocator") {
+	RangeAllocator allocator(1024);
+
+	SUBCASE("Allocate and free") {
+		const auto a = allocator.allocate(100);
+		const auto b = allocator.allocate(200);
+		REQUIRE(a);
+		REQUIRE(b);
+		CHECK(*a + 100 <= *b);
+		CHECK(allocator.get_used_size() == 300);
+		CHECK(allocator.get_largest_free_size() == 724);
+
+		allocator.free(*a);
+		allocator.free(*b);
+		CHECK(allocator.get_used_size() == 0);
+
+		// Freed ranges are merged back into a single one
+		CHECK(allocator.get_largest_free_size() == 1024);
+		CHECK(allocator.allocate(1024) == 0);
+	}
+
+	SUBCASE("Out of space") {
+		CHECK(allocator.allocate(1024));
+		CHECK_FALSE(allocator.allocate(1));
+		CHECK_FALSE(allocator.allocate(0));
+	}
+
+	SUBCASE("Alignment") {
+		REQUIRE(allocator.allocate(3));
+		const auto aligned = allocator.allocate(16, 16);
+		REQUIRE(aligned);
+		CHECK(*aligned % 16 == 0);
+
+		// Padding stays free
+		CHECK(allocator.get_used_size() == 19);
+		CHECK(allocator.allocate(13) == 3);
+	}
+
+	SUBCASE("Best fit") {
+		const auto a = allocator.allocate(64);
+		const auto b = allocator.allocate(16);
+		const auto c = allocator.allocate(32);
+		const auto d = allocator.allocate(16);
+		REQUIRE((a && b && c && d));
+
+		allocator.free(*a);
+		allocator.free(*c);
+
+		// Smallest hole that fits is reused, larger ones are left for larger ranges
+		CHECK(allocator.allocate(32) == *c);
+		CHECK(allocator.allocate(64) == *a);
+	}
+
+	SUBCASE("Merge neighbours") {
+		const auto a = allocator.allocate(100);
+		const auto b = allocator.allocate(100);
+		const auto c = allocator.allocate(100);
+		REQUIRE((a && b && c));
+		REQUIRE(allocator.allocate(724));
+
+		allocator.free(*a);
+		allocator.free(*c);
+		CHECK_FALSE(allocator.allocate(300));
+
+		allocator.free(*b);
+		CHECK(allocator.allocate(300) == *a);
+	}
+
+	SUBCASE("Grow") {
+		const auto a = allocator.allocate(1000);
+		REQUIRE(a);
+		CHECK_FALSE(allocator.allocate(100));
+
+		allocator.grow(2048);
+		CHECK(allocator.get_size() == 2048);
+
+		// Merged with the free tail of the old space
+		CHECK(allocator.allocate(1048) == 1000);
+		CHECK(allocator.get_used_size() == 2048);
+	}
+}
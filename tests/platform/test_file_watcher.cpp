@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include "glitch/platform/file_watcher.h"
+
+using namespace gl;
+
+static void _write_file(const fs::path& p_path, const std::string& p_content) {
+	std::ofstream file(p_path, std::ios::trunc);
+	file << p_content;
+}
+
+// Wait until `p_path` is reported or the deadline passes
+static bool _wait_for_change(FileWatcher& p_watcher, const fs::path& p_path) {
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < deadline) {
+		const std::vector<fs::path> changed = p_watcher.wait(std::chrono::milliseconds(20));
+		if (std::find(changed.begin(), changed.end(), p_path) != changed.end()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void _test_file_watcher(FileWatcher& p_watcher) {
+	const fs::path dir = fs::temp_directory_path() / "glitch_file_watcher_test";
+	fs::create_directories(dir);
+
+	const fs::path watched = dir / "watched.txt";
+	const fs::path other = dir / "other.txt";
+	_write_file(watched, "a");
+	_write_file(other, "a");
+
+	p_watcher.watch(watched);
+
+	SUBCASE("Modification") {
+		// Make sure the modification time differs on coarse file systems
+		fs::last_write_time(watched, fs::last_write_time(watched) - std::chrono::seconds(1));
+		p_watcher.wait(std::chrono::milliseconds(0));
+
+		_write_file(watched, "b");
+		CHECK(_wait_for_change(p_watcher, watched));
+
+		// Changes are reported once
+		CHECK(p_watcher.wait(std::chrono::milliseconds(20)).empty());
+	}
+
+	SUBCASE("Unwatched files") {
+		_write_file(other, "b");
+		CHECK(p_watcher.wait(std::chrono::milliseconds(20)).empty());
+	}
+
+	SUBCASE("Unwatch") {
+		p_watcher.watch(watched);
+		p_watcher.unwatch(watched);
+		p_watcher.unwatch(watched);
+
+		_write_file(watched, "b");
+		CHECK(p_watcher.wait(std::chrono::milliseconds(20)).empty());
+	}
+
+	fs::remove_all(dir);
+}
+
+TEST_CASE("FileWatcher") {
+	SUBCASE("Native") {
+		std::unique_ptr<FileWatcher> watcher = FileWatcher::create();
+		REQUIRE(watcher != nullptr);
+		_test_file_watcher(*watcher);
+	}
+
+	SUBCASE("Polling") {
+		PollingFileWatcher watcher;
+		_test_file_watcher(watcher);
+	}
+}
@@ -0,0 +1,471 @@
+#include <doctest/doctest.h>
+
+#include "glitch/renderer/mesh_processing.h"
+
+using namespace gl;
+
+TEST_CASE("Vertex Quantization") {
+	const AABB aabb = { glm::vec3(-2.0f, 0.0f, -1.0f), glm::vec3(2.0f, 10.0f, 1.0f) };
+
+	SUBCASE("Round trip") {
+		const std::array<glm::vec3, 6> normals = {
+			glm::vec3(0.0f, 1.0f, 0.0f),
+			glm::vec3(0.0f, 0.0f, -1.0f),
+			glm::normalize(glm::vec3(1.0f, 1.0f, 1.0f)),
+			glm::normalize(glm::vec3(-1.0f, 0.5f, -1.0f)),
+			glm::normalize(glm::vec3(0.3f, -0.9f, -0.2f)),
+			glm::vec3(-1.0f, 0.0f, 0.0f),
+		};
+
+		for (size_t i = 0; i < normals.size(); i++) {
+			MeshVertex vertex;
+			vertex.position = glm::vec3(-2.0f + i * 0.7f, i * 1.9f, 1.0f - i * 0.4f);
+			vertex.normal = normals[i];
+			vertex.uv_x = i * 0.25f;
+			vertex.uv_y = 1.0f - i * 0.125f;
+
+			const MeshVertex decoded = dequantize_vertex(quantize_vertex(vertex, aabb), aabb);
+
+			// 16 bits across the extent of the box
+			CHECK(std::abs(decoded.position.x - vertex.position.x) <= 4.0f / 65535.0f);
+			CHECK(std::abs(decoded.position.y - vertex.position.y) <= 10.0f / 65535.0f);
+			CHECK(std::abs(decoded.position.z - vertex.position.z) <= 2.0f / 65535.0f);
+
+			CHECK(glm::dot(decoded.normal, vertex.normal) > 0.9999f);
+
+			CHECK(decoded.uv_x == doctest::Approx(vertex.uv_x).epsilon(0.001));
+			CHECK(decoded.uv_y == doctest::Approx(vertex.uv_y).epsilon(0.001));
+		}
+	}
+
+	SUBCASE("Flat mesh") {
+		const AABB flat = { glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f) };
+
+		MeshVertex vertex = {};
+		vertex.position = glm::vec3(0.5f, 1.0f, 0.25f);
+		vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+
+		const MeshVertex decoded = dequantize_vertex(quantize_vertex(vertex, flat), flat);
+		CHECK(decoded.position.y == 1.0f);
+		CHECK(decoded.position.x == doctest::Approx(0.5f).epsilon(0.001));
+	}
+
+	SUBCASE("Outside of the bounds") {
+		MeshVertex vertex = {};
+		vertex.position = glm::vec3(5.0f, -1.0f, 0.0f);
+		vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+
+		const MeshVertex decoded = dequantize_vertex(quantize_vertex(vertex, aabb), aabb);
+		CHECK(decoded.position.x == aabb.max.x);
+		CHECK(decoded.position.y == aabb.min.y);
+	}
+
+	SUBCASE("Batch") {
+		std::vector<MeshVertex> vertices(3);
+		vertices[1].position = glm::vec3(1.0f);
+		vertices[2].normal = glm::vec3(0.0f, 0.0f, 1.0f);
+
+		const std::vector<QuantizedMeshVertex> quantized = quantize_vertices(vertices, aabb);
+		REQUIRE(quantized.size() == vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++) {
+			CHECK(quantized[i].position_xy == quantize_vertex(vertices[i], aabb).position_xy);
+			CHECK(quantized[i].normal == quantize_vertex(vertices[i], aabb).normal);
+		}
+	}
+}
+
+// Grid of quads on the XY plane facing +Z
+static void _make_grid(uint32_t p_size, std::vector<MeshVertex>& p_vertices,
+		std::vector<uint32_t>& p_indices) {
+	for (uint32_t y = 0; y <= p_size; y++) {
+		for (uint32_t x = 0; x <= p_size; x++) {
+			MeshVertex vertex = {};
+			vertex.position = glm::vec3(x, y, 0.0f);
+			vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+			p_vertices.push_back(vertex);
+		}
+	}
+
+	for (uint32_t y = 0; y < p_size; y++) {
+		for (uint32_t x = 0; x < p_size; x++) {
+			const uint32_t i = y * (p_size + 1) + x;
+			p_indices.insert(p_indices.end(), { i, i + 1, i + p_size + 2 });
+			p_indices.insert(p_indices.end(), { i, i + p_size + 2, i + p_size + 1 });
+		}
+	}
+}
+
+// Axis aligned box as the six frustum planes, normals pointing inwards
+static Frustum _make_box_frustum(float p_half_size) {
+	Frustum frustum;
+	frustum.planes[0] = glm::vec4(1.0f, 0.0f, 0.0f, p_half_size);
+	frustum.planes[1] = glm::vec4(-1.0f, 0.0f, 0.0f, p_half_size);
+	frustum.planes[2] = glm::vec4(0.0f, 1.0f, 0.0f, p_half_size);
+	frustum.planes[3] = glm::vec4(0.0f, -1.0f, 0.0f, p_half_size);
+	frustum.planes[4] = glm::vec4(0.0f, 0.0f, 1.0f, p_half_size);
+	frustum.planes[5] = glm::vec4(0.0f, 0.0f, -1.0f, p_half_size);
+	return frustum;
+}
+
+TEST_CASE("Vertex Decoding") {
+	SUBCASE("Interleaved") {
+		// Position, padding, normal and UV of every vertex, like an interleaved glTF buffer
+		constexpr size_t STRIDE = 40;
+		constexpr size_t COUNT = 7;
+
+		std::vector<uint8_t> buffer(STRIDE * COUNT);
+		for (size_t i = 0; i < COUNT; i++) {
+			const float position[3] = { float(i), i * 2.0f, i * 3.0f };
+			const float normal[3] = { 0.0f, 1.0f, -float(i) };
+			const float uv[2] = { i * 0.5f, 1.0f - i * 0.5f };
+
+			memcpy(buffer.data() + i * STRIDE, position, sizeof(position));
+			memcpy(buffer.data() + i * STRIDE + 16, normal, sizeof(normal));
+			memcpy(buffer.data() + i * STRIDE + 28, uv, sizeof(uv));
+		}
+
+		// Streams end with their last element so the last loads have to be scalar
+		const VertexAttributeStream positions = { buffer.data(), STRIDE, STRIDE * 6 + 12 };
+		const VertexAttributeStream normals = { buffer.data() + 16, STRIDE, STRIDE * 6 + 12 };
+		const VertexAttributeStream uvs = { buffer.data() + 28, STRIDE, STRIDE * 6 + 8 };
+
+		std::vector<MeshVertex> vertices(COUNT);
+		gather_vertices(positions, normals, uvs, vertices);
+
+		for (size_t i = 0; i < COUNT; i++) {
+			CHECK(vertices[i].position == glm::vec3(float(i), i * 2.0f, i * 3.0f));
+			CHECK(vertices[i].normal == glm::vec3(0.0f, 1.0f, -float(i)));
+			CHECK(vertices[i].uv_x == i * 0.5f);
+			CHECK(vertices[i].uv_y == 1.0f - i * 0.5f);
+		}
+	}
+
+	SUBCASE("Missing attributes") {
+		const std::array<float, 9> data = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		const VertexAttributeStream positions = {
+			reinterpret_cast<const uint8_t*>(data.data()),
+			3 * sizeof(float),
+			sizeof(data),
+		};
+
+		std::vector<MeshVertex> vertices(3);
+		gather_vertices(positions, {}, {}, vertices);
+
+		for (size_t i = 0; i < vertices.size(); i++) {
+			CHECK(vertices[i].position == glm::vec3(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]));
+			CHECK(vertices[i].normal == glm::vec3(0.0f));
+			CHECK(vertices[i].uv_x == 0.0f);
+			CHECK(vertices[i].uv_y == 0.0f);
+		}
+	}
+
+	SUBCASE("Widen indices") {
+		// Not a multiple of the vector width
+		std::vector<uint8_t> indices_8(37);
+		std::vector<uint16_t> indices_16(37);
+		for (size_t i = 0; i < indices_8.size(); i++) {
+			indices_8[i] = uint8_t(255 - i * 3);
+			indices_16[i] = uint16_t(65535 - i * 1021);
+		}
+
+		std::vector<uint32_t> widened(indices_8.size());
+
+		widen_indices(indices_8.data(), widened);
+		CHECK(std::equal(widened.begin(), widened.end(), indices_8.begin()));
+
+		widen_indices(indices_16.data(), widened);
+		CHECK(std::equal(widened.begin(), widened.end(), indices_16.begin()));
+	}
+}
+
+TEST_CASE("Meshlets") {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;
+	_make_grid(32, vertices, indices);
+
+	SUBCASE("Build") {
+		const std::vector<Meshlet> meshlets = build_meshlets(vertices, indices);
+		REQUIRE(meshlets.size() > 1);
+
+		uint32_t index_offset = 0;
+		for (const Meshlet& meshlet : meshlets) {
+			CHECK(meshlet.index_offset == index_offset);
+			CHECK(meshlet.index_count % 3 == 0);
+			CHECK(meshlet.index_count / 3 <= MESHLET_MAX_TRIANGLES);
+
+			std::set<uint32_t> unique_vertices(indices.begin() + meshlet.index_offset,
+					indices.begin() + meshlet.index_offset + meshlet.index_count);
+			CHECK(unique_vertices.size() <= MESHLET_MAX_VERTICES);
+
+			for (const uint32_t index : unique_vertices) {
+				CHECK(glm::distance(vertices[index].position, meshlet.center) <=
+						meshlet.radius + 0.0001f);
+			}
+
+			// Flat meshlets can be culled from every direction behind them
+			CHECK(glm::dot(meshlet.cone_axis, glm::vec3(0.0f, 0.0f, 1.0f)) > 0.9999f);
+			CHECK(meshlet.cone_cutoff < 0.001f);
+
+			index_offset += meshlet.index_count;
+		}
+		CHECK(index_offset == indices.size());
+	}
+
+	SUBCASE("Vertex limit") {
+		const std::vector<Meshlet> meshlets = build_meshlets(vertices, indices, 16, 124);
+		for (const Meshlet& meshlet : meshlets) {
+			std::set<uint32_t> unique_vertices(indices.begin() + meshlet.index_offset,
+					indices.begin() + meshlet.index_offset + meshlet.index_count);
+			CHECK(unique_vertices.size() <= 16);
+		}
+	}
+
+	SUBCASE("Cull") {
+		const std::vector<Meshlet> meshlets = build_meshlets(vertices, indices);
+		const glm::mat4 transform(1.0f);
+
+		std::vector<MeshletDrawRange> ranges;
+
+		// Everything is inside and in front of the camera, drawn as a single range
+		uint32_t visible = cull_meshlets(meshlets, transform, _make_box_frustum(100.0f),
+				glm::vec3(16.0f, 16.0f, 10.0f), true, ranges);
+		CHECK(visible == meshlets.size());
+		REQUIRE(ranges.size() == 1);
+		CHECK(ranges[0].index_offset == 0);
+		CHECK(ranges[0].index_count == indices.size());
+
+		// Looking at the back of the grid, far enough for the cone to cover the meshlet extents
+		ranges.clear();
+		visible = cull_meshlets(meshlets, transform, _make_box_frustum(100.0f),
+				glm::vec3(16.0f, 16.0f, -50.0f), true, ranges);
+		CHECK(visible == 0);
+		CHECK(ranges.empty());
+
+		// Double sided materials keep the back
+		ranges.clear();
+		visible = cull_meshlets(meshlets, transform, _make_box_frustum(100.0f),
+				glm::vec3(16.0f, 16.0f, -50.0f), false, ranges);
+		CHECK(visible == meshlets.size());
+
+		// Mirroring flips the winding, the cone test is skipped
+		glm::mat4 mirror(1.0f);
+		mirror[2][2] = -1.0f;
+
+		ranges.clear();
+		visible = cull_meshlets(meshlets, mirror, _make_box_frustum(100.0f),
+				glm::vec3(16.0f, 16.0f, -50.0f), true, ranges);
+		CHECK(visible == meshlets.size());
+
+		// Only the corner at the origin is inside
+		ranges.clear();
+		visible = cull_meshlets(meshlets, transform, _make_box_frustum(2.0f),
+				glm::vec3(0.0f, 0.0f, 1.0f), true, ranges);
+		CHECK(visible > 0);
+		CHECK(visible < meshlets.size());
+		for (const MeshletDrawRange& range : ranges) {
+			CHECK(range.index_offset + range.index_count <= indices.size());
+		}
+	}
+}
+
+static float _get_surface_area(
+		const std::vector<MeshVertex>& p_vertices, const std::vector<uint32_t>& p_indices) {
+	float area = 0.0f;
+	for (size_t i = 0; i < p_indices.size(); i += 3) {
+		const glm::vec3& p0 = p_vertices[p_indices[i + 0]].position;
+		const glm::vec3& p1 = p_vertices[p_indices[i + 1]].position;
+		const glm::vec3& p2 = p_vertices[p_indices[i + 2]].position;
+		area += glm::length(glm::cross(p1 - p0, p2 - p0)) * 0.5f;
+	}
+	return area;
+}
+
+TEST_CASE("Mesh Simplification") {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;
+	_make_grid(32, vertices, indices);
+
+	SUBCASE("Flat") {
+		float error = -1.0f;
+		const std::vector<uint32_t> simplified =
+				simplify_mesh(vertices, indices, indices.size() / 4, &error);
+
+		CHECK(simplified.size() % 3 == 0);
+		CHECK(simplified.size() <= indices.size() / 4);
+		CHECK(error == doctest::Approx(0.0f));
+
+		// Borders are locked and no triangle flips, so the plane stays covered
+		CHECK(_get_surface_area(vertices, simplified) == doctest::Approx(32.0f * 32.0f));
+		for (const uint32_t index : simplified) {
+			CHECK(index < vertices.size());
+		}
+	}
+
+	SUBCASE("Curved") {
+		for (MeshVertex& vertex : vertices) {
+			vertex.position.z = std::sin(vertex.position.x * 0.2f) * 2.0f;
+		}
+
+		float error = 0.0f;
+		const std::vector<uint32_t> simplified =
+				simplify_mesh(vertices, indices, indices.size() / 8, &error);
+
+		CHECK(simplified.size() < indices.size());
+		CHECK(error > 0.0f);
+		CHECK(error < 2.0f);
+	}
+
+	SUBCASE("Seams") {
+		// Duplicate the vertices of the middle column with different UVs
+		const uint32_t column = 16;
+		for (uint32_t y = 0; y <= 32; y++) {
+			MeshVertex vertex = vertices[y * 33 + column];
+			vertex.uv_x = 1.0f;
+			vertices.push_back(vertex);
+		}
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const bool right_side = vertices[indices[i + 0]].position.x > column ||
+					vertices[indices[i + 1]].position.x > column ||
+					vertices[indices[i + 2]].position.x > column;
+			for (uint32_t j = 0; right_side && j < 3; j++) {
+				if (indices[i + j] % 33 == column && indices[i + j] < 33 * 33) {
+					indices[i + j] = 33 * 33 + indices[i + j] / 33;
+				}
+			}
+		}
+
+		const std::vector<uint32_t> simplified =
+				simplify_mesh(vertices, indices, indices.size() / 4);
+
+		// Every vertex of the seam is still referenced by both sides
+		std::set<uint32_t> used(simplified.begin(), simplified.end());
+		for (uint32_t y = 0; y <= 32; y++) {
+			CHECK(used.count(y * 33 + column) == 1);
+			CHECK(used.count(33 * 33 + y) == 1);
+		}
+		CHECK(_get_surface_area(vertices, simplified) == doctest::Approx(32.0f * 32.0f));
+	}
+}
+
+TEST_CASE("Mesh LODs") {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;
+	_make_grid(32, vertices, indices);
+	for (MeshVertex& vertex : vertices) {
+		vertex.position.z = std::sin(vertex.position.x * 0.3f) * std::cos(vertex.position.y * 0.3f);
+	}
+
+	SUBCASE("Build") {
+		std::vector<uint32_t> lod_indices;
+		const std::vector<MeshLod> lods = build_lods(vertices, indices, lod_indices);
+		REQUIRE(lods.size() > 2);
+		CHECK(lods.size() <= MESH_LOD_MAX_COUNT + 1);
+
+		CHECK(lods[0].index_offset == 0);
+		CHECK(lods[0].index_count == indices.size());
+		CHECK(lods[0].error == 0.0f);
+		CHECK(std::equal(indices.begin(), indices.end(), lod_indices.begin()));
+
+		for (size_t i = 1; i < lods.size(); i++) {
+			CHECK(lods[i].index_offset == lods[i - 1].index_offset + lods[i - 1].index_count);
+			CHECK(lods[i].index_count < lods[i - 1].index_count);
+			CHECK(lods[i].error >= lods[i - 1].error);
+		}
+		CHECK(lods.back().index_offset + lods.back().index_count == lod_indices.size());
+	}
+
+	SUBCASE("Select") {
+		const std::array<MeshLod, 3> lods = { {
+				{ 0, 300, 0.0f },
+				{ 300, 150, 0.01f },
+				{ 450, 75, 0.1f },
+		} };
+
+		// 1000 pixels per unit at a distance of one
+		CHECK(select_lod(lods, 1.0f, 1000.0f) == 0);
+		CHECK(select_lod(lods, 20.0f, 1000.0f) == 1);
+		CHECK(select_lod(lods, 200.0f, 1000.0f) == 2);
+		CHECK(select_lod(lods, 0.0f, 1000.0f) == 0);
+		CHECK(select_lod(lods, 20.0f, 1000.0f, 0.1f) == 0);
+	}
+}
+
+// Triangles rotated to start with their smallest index, keeps the winding
+static std::multiset<std::array<uint32_t, 3>> _get_triangles(
+		const std::vector<MeshVertex>& p_vertices, const std::vector<uint32_t>& p_indices) {
+	std::multiset<std::array<uint32_t, 3>> triangles;
+	for (size_t i = 0; i < p_indices.size(); i += 3) {
+		std::array<uint32_t, 3> triangle = { p_indices[i], p_indices[i + 1], p_indices[i + 2] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()),
+				triangle.end());
+		triangles.insert(triangle);
+	}
+	return triangles;
+}
+
+TEST_CASE("Mesh Optimization") {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;
+	_make_grid(32, vertices, indices);
+
+	// Shuffle the triangles to get a cache unfriendly order
+	{
+		std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+		memcpy(triangles.data(), indices.data(), indices.size() * sizeof(uint32_t));
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+		memcpy(indices.data(), triangles.data(), indices.size() * sizeof(uint32_t));
+	}
+
+	const VertexCacheStats shuffled_stats = analyze_vertex_cache(indices, vertices.size());
+	const auto triangles = _get_triangles(vertices, indices);
+
+	SUBCASE("Analyze") {
+		const std::vector<uint32_t> strip = { 0, 1, 2, 2, 1, 3, 2, 3, 4 };
+		const VertexCacheStats stats = analyze_vertex_cache(strip, 5);
+		CHECK(stats.transformed_count == 5);
+		CHECK(stats.acmr == doctest::Approx(5.0f / 3.0f));
+
+		// Every vertex gets evicted before it is used again
+		const std::vector<uint32_t> thrashing = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+		CHECK(analyze_vertex_cache(thrashing, 6, 4).acmr == 3.0f);
+	}
+
+	SUBCASE("Vertex cache") {
+		optimize_vertex_cache(indices, vertices.size());
+
+		CHECK(_get_triangles(vertices, indices) == triangles);
+
+		const VertexCacheStats stats = analyze_vertex_cache(indices, vertices.size());
+		CHECK(stats.acmr < shuffled_stats.acmr * 0.5f);
+		CHECK(stats.acmr < 1.0f);
+	}
+
+	SUBCASE("Overdraw") {
+		optimize_vertex_cache(indices, vertices.size());
+		const VertexCacheStats cache_stats = analyze_vertex_cache(indices, vertices.size());
+
+		optimize_overdraw(indices, vertices);
+
+		CHECK(_get_triangles(vertices, indices) == triangles);
+		CHECK(analyze_vertex_cache(indices, vertices.size()).acmr < cache_stats.acmr * 1.5f);
+	}
+
+	SUBCASE("Vertex fetch") {
+		// Not referenced by any triangle
+		vertices.push_back(MeshVertex{ glm::vec3(100.0f) });
+
+		const std::vector<MeshVertex> original_vertices = vertices;
+		const std::vector<uint32_t> original_indices = indices;
+
+		optimize_vertex_fetch(vertices, indices);
+		REQUIRE(vertices.size() == original_vertices.size() - 1);
+
+		uint32_t next_vertex = 0;
+		for (size_t i = 0; i < indices.size(); i++) {
+			CHECK(indices[i] <= next_vertex);
+			next_vertex = std::max(next_vertex, indices[i] + 1);
+
+			CHECK(vertices[indices[i]].position == original_vertices[original_indices[i]].position);
+		}
+	}
+}
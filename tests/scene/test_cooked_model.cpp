@@ -0,0 +1,150 @@
+#include <doctest/doctest.h>
+
+#include "glitch/scene/cooked_model.h"
+
+using namespace gl;
+
+// Triangle with a material under an empty root node, the buffer holds the positions
+// followed by the uint16 indices
+static constexpr const char* TRIANGLE_GLTF = R"({
+	"asset": { "version": "2.0" },
+	"scene": 0,
+	"scenes": [ { "nodes": [ 0 ] } ],
+	"nodes": [
+		{ "name": "root", "children": [ 1 ] },
+		{ "name": "triangle", "mesh": 0 }
+	],
+	"meshes": [
+		{ "name": "triangle", "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1,
+			"material": 0 } ] }
+	],
+	"materials": [
+		{ "pbrMetallicRoughness": { "baseColorFactor": [ 1.0, 0.0, 0.0, 1.0 ] } }
+	],
+	"buffers": [
+		{ "byteLength": 44, "uri": "data:application/octet-stream;base64,)"
+		"AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAAAAABAAIAAAA="
+		R"(" }
+	],
+	"bufferViews": [
+		{ "buffer": 0, "byteOffset": 0, "byteLength": 36 },
+		{ "buffer": 0, "byteOffset": 36, "byteLength": 6 }
+	],
+	"accessors": [
+		{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3",
+			"min": [ 0.0, 0.0, 0.0 ], "max": [ 1.0, 1.0, 0.0 ] },
+		{ "bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR" }
+	]
+})";
+
+template <typename T>
+static const T* _get_table(const std::vector<uint8_t>& p_data, size_t p_offset) {
+	return reinterpret_cast<const T*>(p_data.data() + p_offset);
+}
+
+TEST_CASE("GLTFCooker round trip") {
+	const fs::path dir = fs::temp_directory_path() / "glitch_cooked_model_test";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+
+	{
+		std::ofstream file(dir / "triangle.gltf", std::ios::trunc);
+		file << TRIANGLE_GLTF;
+	}
+
+	GLTFCookStats stats;
+	REQUIRE(GLTFCooker::cook(dir / "triangle.gltf", dir / "out", &stats) ==
+			GLTFLoadError::NONE);
+	CHECK(stats.triangle_count == 1);
+
+	std::vector<uint8_t> data;
+	{
+		std::ifstream file(dir / "out" / "triangle.glmesh", std::ios::binary);
+		REQUIRE(file.is_open());
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	REQUIRE(data.size() >= sizeof(CookedModelHeader));
+
+	CookedModelHeader header;
+	memcpy(&header, data.data(), sizeof(header));
+
+	CHECK(header.magic == COOKED_MODEL_MAGIC);
+	CHECK(header.version == COOKED_MODEL_VERSION);
+	CHECK(header.node_count == 2);
+	CHECK(header.submesh_count == 1);
+	CHECK(header.material_count == 1);
+	CHECK(header.vertex_count == 3);
+	CHECK(header.index_count >= 3);
+	CHECK(header.lod_count >= 1);
+	CHECK(header.aabb.min == glm::vec3(0.0f));
+	CHECK(header.aabb.max == glm::vec3(1.0f, 1.0f, 0.0f));
+
+	// Same layout the loader validates the file against
+	const CookedModelLayout layout = get_cooked_model_layout(header);
+	REQUIRE(data.size() == layout.size);
+	CHECK(layout.vertices_offset % 16 == 0);
+	CHECK(layout.vertices_offset >= layout.strings_offset + header.string_table_size);
+
+	const std::string_view strings(
+			reinterpret_cast<const char*>(data.data() + layout.strings_offset),
+			header.string_table_size);
+
+	SUBCASE("Nodes") {
+		const CookedModelNode* nodes = _get_table<CookedModelNode>(data, layout.nodes_offset);
+
+		CHECK(nodes[0].parent_index == -1);
+		CHECK(nodes[0].gltf_node_id < 0);
+		CHECK(nodes[0].submesh_count == 0);
+		CHECK(strings.substr(nodes[0].name_offset, nodes[0].name_length) == "root");
+
+		CHECK(nodes[1].parent_index == 0);
+		CHECK(nodes[1].gltf_node_id == 0);
+		CHECK(nodes[1].submesh_offset == 0);
+		CHECK(nodes[1].submesh_count == 1);
+		CHECK(strings.substr(nodes[1].name_offset, nodes[1].name_length) == "triangle");
+	}
+
+	SUBCASE("Submeshes") {
+		const CookedSubmesh& submesh =
+				*_get_table<CookedSubmesh>(data, layout.submeshes_offset);
+
+		CHECK(submesh.vertex_offset == 0);
+		CHECK(submesh.vertex_count == 3);
+		CHECK(submesh.index_offset == 0);
+		CHECK(submesh.index_count == header.index_count);
+		CHECK(submesh.lod_offset == 0);
+		CHECK(submesh.lod_count == header.lod_count);
+		CHECK(submesh.material_index == 0);
+
+		const MeshLod* lods = _get_table<MeshLod>(data, layout.lods_offset);
+		CHECK(lods[0].index_offset == 0);
+		CHECK(lods[0].index_count == 3);
+		for (uint32_t i = 0; i < submesh.lod_count; i++) {
+			CHECK(lods[i].index_count > 0);
+			CHECK(lods[i].index_offset + lods[i].index_count <= submesh.index_count);
+		}
+
+		const uint32_t* indices = _get_table<uint32_t>(data, layout.indices_offset);
+		for (uint32_t i = 0; i < submesh.index_count; i++) {
+			CHECK(indices[i] < submesh.vertex_count);
+		}
+
+		const MeshVertex* vertices = _get_table<MeshVertex>(data, layout.vertices_offset);
+		for (uint32_t i = 0; i < submesh.vertex_count; i++) {
+			CHECK(glm::min(vertices[i].position, header.aabb.min) == header.aabb.min);
+			CHECK(glm::max(vertices[i].position, header.aabb.max) == header.aabb.max);
+		}
+	}
+
+	SUBCASE("Materials") {
+		const CookedMaterialPath& material =
+				*_get_table<CookedMaterialPath>(data, layout.materials_offset);
+
+		const std::string_view path = strings.substr(material.path_offset, material.path_length);
+		CHECK(path == "triangle_mat0.glmat");
+		CHECK(fs::exists(dir / "out" / path));
+	}
+
+	fs::remove_all(dir);
+}
@@ -5,6 +5,7 @@
 #include "glitch/renderer/light_sources.h"
 #include "glitch/scene/components.h"
 #include "glitch/scene/scene.h"
+#include "glitch/scene/scene_journal.h"
 
 using namespace gl;
 
@@ -24,6 +25,23 @@ struct MockAsset {
 	}
 };
 
+// Loadable asset standing in for textures, their handles are remapped the same way on load
+struct MockTextureAsset {
+	GL_REFLECT_ASSET("MockTextureAsset");
+
+	fs::path path;
+
+	MockTextureAsset(const fs::path& p_path) : path(p_path) {}
+
+	static bool save(const fs::path& p_metadata_path, std::shared_ptr<MockTextureAsset> p_asset) {
+		return true;
+	}
+
+	static std::shared_ptr<MockTextureAsset> load(const fs::path& p_path) {
+		return std::make_shared<MockTextureAsset>(p_path);
+	}
+};
+
 TEST_CASE("Scene entity relations") {
 	Scene scene;
 
@@ -160,4 +178,145 @@ TEST_CASE("Scene Serialization Round-Trip") {
 	}
 
 	os::setenv("GL_WORKING_DIR", "");
-}
\ No newline at end of file
+}
+
+TEST_CASE("Scene Incremental Serialization") {
+	os::setenv("GL_WORKING_DIR", fs::temp_directory_path().string().c_str());
+	const std::string scene_filename = "res://test_scene_incremental.glscene";
+
+	const auto scene_path = AssetSystem::get_absolute_path(scene_filename);
+	REQUIRE(scene_path.has_value());
+
+	std::shared_ptr<Scene> src_scene = std::make_shared<Scene>();
+
+	Entity e1 = src_scene->create("Moved");
+	Entity e2 = src_scene->create("Removed");
+
+	REQUIRE(Scene::serialize(scene_filename, src_scene));
+	CHECK(!src_scene->is_dirty());
+
+	e1.get_transform().local_position = { 1.0f, 2.0f, 3.0f };
+	src_scene->mark_dirty(e1.get_uid());
+
+	const UID e2_uid = e2.get_uid();
+	src_scene->destroy(e2);
+
+	Entity e3 = src_scene->create("Created");
+	CHECK(src_scene->is_dirty());
+
+	REQUIRE(Scene::serialize_incremental(scene_filename, src_scene));
+	CHECK(!src_scene->is_dirty());
+	CHECK(fs::exists(SceneJournal::get_log_path(scene_path.get_value())));
+
+	const auto verify_scene = [&]() {
+		std::shared_ptr<Scene> dst_scene = std::make_shared<Scene>();
+		REQUIRE(Scene::deserialize(scene_filename, dst_scene));
+
+		CHECK(!dst_scene->exists(e2_uid));
+		CHECK(dst_scene->exists(e3.get_uid()));
+
+		const std::optional<Entity> e1_loaded = dst_scene->find_by_id(e1.get_uid());
+		REQUIRE(e1_loaded.has_value());
+		CHECK(e1_loaded->get_transform().local_position == glm::vec3(1.0f, 2.0f, 3.0f));
+	};
+
+	SUBCASE("Replay change log") { verify_scene(); }
+
+	SUBCASE("Compact change log") {
+		SceneJournal::request_compaction(scene_path.get_value(), true);
+		SceneJournal::wait_for_compaction();
+
+		CHECK(!fs::exists(SceneJournal::get_log_path(scene_path.get_value())));
+		CHECK(!fs::exists(SceneJournal::get_compacting_log_path(scene_path.get_value())));
+
+		verify_scene();
+	}
+
+	SceneJournal::discard(scene_path.get_value());
+	if (fs::exists(scene_path.get_value())) {
+		fs::remove(scene_path.get_value());
+	}
+
+	os::setenv("GL_WORKING_DIR", "");
+}
+
+TEST_CASE("Scene Incremental Serialization keeps texture handles") {
+	os::setenv("GL_WORKING_DIR", fs::temp_directory_path().string().c_str());
+	const std::string scene_filename = "res://test_scene_incremental_assets.glscene";
+
+	const auto scene_path = AssetSystem::get_absolute_path(scene_filename);
+	REQUIRE(scene_path.has_value());
+
+	AssetSystem::clear();
+
+	const AssetHandle texture_a =
+			AssetSystem::load<MockTextureAsset>("res://texture_a.dat").get_value();
+	const AssetHandle texture_b =
+			AssetSystem::load<MockTextureAsset>("res://texture_b.dat").get_value();
+	CHECK(texture_a != texture_b);
+
+	std::shared_ptr<Scene> src_scene = std::make_shared<Scene>();
+	Entity moved = src_scene->create("Moved");
+	Entity textured = src_scene->create("Textured");
+
+	REQUIRE(Scene::serialize(scene_filename, src_scene));
+
+	// Bind a texture in the saved file, the entity has no material so it is written as is
+	{
+		json j = json_load(scene_filename).get_value();
+		for (json& j_entity : j["entities"]) {
+			if (j_entity["id"].get<UID>() == textured.get_uid()) {
+				j_entity["material_component"] = json{
+					{ "definition_path", "res://material.def" },
+					{ "uniforms",
+							json::array({ json{
+									{ "name", "u_diffuse_texture" },
+									{ "type", ShaderUniformVariableType::TEXTURE },
+									{ "value", texture_b },
+							} }) },
+				};
+			}
+		}
+		REQUIRE(json_save(scene_filename, j) == JSONLoadError::NONE);
+	}
+
+	// Path of the texture bound to the entity in the scene saved at `scene_filename`
+	const auto load_texture_path = [&](std::shared_ptr<Scene> p_scene) -> std::string {
+		REQUIRE(Scene::deserialize(scene_filename, p_scene));
+
+		const std::optional<Entity> entity = p_scene->find_by_id(textured.get_uid());
+		REQUIRE(entity.has_value());
+
+		const MaterialComponent* mc = entity->get_component<MaterialComponent>();
+		REQUIRE(mc);
+		REQUIRE(mc->uniforms.contains("u_diffuse_texture"));
+
+		const auto handle = std::get<AssetHandle>(mc->uniforms.at("u_diffuse_texture"));
+		const auto metadata = AssetSystem::get_metadata<MockTextureAsset>(handle);
+		return metadata ? metadata->path : "";
+	};
+
+	std::shared_ptr<Scene> loaded_scene = std::make_shared<Scene>();
+	CHECK(load_texture_path(loaded_scene) == "res://texture_b.dat");
+
+	// Handles got reallocated by the load, only the other entity changes
+	std::optional<Entity> loaded_moved = loaded_scene->find_by_id(moved.get_uid());
+	REQUIRE(loaded_moved.has_value());
+	loaded_moved->get_transform().local_position = { 1.0f, 2.0f, 3.0f };
+	loaded_scene->mark_dirty(moved.get_uid());
+
+	REQUIRE(Scene::serialize_incremental(scene_filename, loaded_scene));
+
+	std::shared_ptr<Scene> reloaded_scene = std::make_shared<Scene>();
+	CHECK(load_texture_path(reloaded_scene) == "res://texture_b.dat");
+
+	const std::optional<Entity> reloaded_moved = reloaded_scene->find_by_id(moved.get_uid());
+	REQUIRE(reloaded_moved.has_value());
+	CHECK(reloaded_moved->get_transform().local_position == glm::vec3(1.0f, 2.0f, 3.0f));
+
+	SceneJournal::discard(scene_path.get_value());
+	fs::remove(scene_path.get_value());
+
+	AssetSystem::clear();
+	os::setenv("GL_WORKING_DIR", "");
+}